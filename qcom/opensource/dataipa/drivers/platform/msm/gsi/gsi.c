@@ -642,6 +642,38 @@ uint16_t gsi_find_idx_from_addr(struct gsi_ring_ctx *ctx, uint64_t addr)
 	WARN_ON(addr < ctx->base || addr >= ctx->end);
 	return (uint32_t)(addr - ctx->base) / ctx->elem_sz;
 }
+EXPORT_SYMBOL(gsi_find_idx_from_addr);
+
+uint16_t gsi_ring_resv(struct gsi_ring_ctx *ctx, uint16_t num)
+{
+	uint16_t idx = gsi_find_idx_from_addr(ctx, ctx->wp_local);
+	uint16_t i;
+
+	for (i = 0; i < num; i++)
+		gsi_incr_ring_wp(ctx);
+	ctx->resv_inflight++;
+
+	return idx;
+}
+EXPORT_SYMBOL(gsi_ring_resv);
+
+bool gsi_ring_publish(struct gsi_ring_ctx *ctx, bool resv, bool ring_db)
+{
+	if (resv)
+		ctx->resv_inflight--;
+	if (ring_db)
+		ctx->db_pending = true;
+	/*
+	 * Slots reserved by another producer may still be empty, leave
+	 * the doorbell to whoever publishes last.
+	 */
+	if (!ctx->db_pending || ctx->resv_inflight)
+		return false;
+
+	ctx->db_pending = false;
+	return true;
+}
+EXPORT_SYMBOL(gsi_ring_publish);
 
 static uint16_t gsi_get_complete_num(struct gsi_ring_ctx *ctx, uint64_t addr1,
 		uint64_t addr2)
@@ -2689,6 +2721,45 @@ int gsi_set_evt_ring_cfg(unsigned long evt_ring_hdl,
 }
 EXPORT_SYMBOL(gsi_set_evt_ring_cfg);
 
+int gsi_set_evt_ring_int_mod(unsigned long evt_ring_hdl,
+		uint16_t int_modt, uint8_t int_modc)
+{
+	struct gsihal_reg_ev_ch_k_cntxt_8 ev_ch_k_cntxt_8;
+	struct gsi_evt_ctx *ctx;
+
+	if (!gsi_ctx) {
+		pr_err("%s:%d gsi context not allocated\n", __func__, __LINE__);
+		return -GSI_STATUS_NODEV;
+	}
+
+	if (evt_ring_hdl >= gsi_ctx->max_ev || !int_modc) {
+		GSIERR("bad params evt_ring_hdl=%lu modc=%u\n",
+			evt_ring_hdl, int_modc);
+		return -GSI_STATUS_INVALID_PARAMS;
+	}
+
+	ctx = &gsi_ctx->evtr[evt_ring_hdl];
+
+	if (ctx->state != GSI_EVT_RING_STATE_ALLOCATED) {
+		GSIERR("bad state %d\n", ctx->state);
+		return -GSI_STATUS_UNSUPPORTED_OP;
+	}
+
+	/* no mlock here, this runs from the RX poll */
+	ctx->props.int_modt = int_modt;
+	ctx->props.int_modc = int_modc;
+
+	memset(&ev_ch_k_cntxt_8, 0, sizeof(ev_ch_k_cntxt_8));
+	ev_ch_k_cntxt_8.int_modt = int_modt;
+	ev_ch_k_cntxt_8.int_modc = int_modc;
+	gsihal_write_reg_nk_fields(GSI_EE_n_EV_CH_k_CNTXT_8,
+		gsi_ctx->per.ee, ctx->id,
+		&ev_ch_k_cntxt_8);
+
+	return GSI_STATUS_SUCCESS;
+}
+EXPORT_SYMBOL(gsi_set_evt_ring_int_mod);
+
 static void gsi_program_chan_ctx_qos(struct gsi_chan_props *props,
 	unsigned int ee)
 {
@@ -2784,6 +2855,8 @@ static void gsi_init_chan_ring(struct gsi_chan_props *props,
 	ctx->max_num_elem = ctx->len / ctx->elem_sz - 1;
 	ctx->end = ctx->base + (ctx->max_num_elem + 1) *
 		ctx->elem_sz;
+	ctx->resv_inflight = 0;
+	ctx->db_pending = false;
 }
 
 static int gsi_validate_channel_props(struct gsi_chan_props *props)
@@ -4177,11 +4250,10 @@ int __gsi_populate_gci_tre(struct gsi_chan_ctx *ctx,
 }
 
 int __gsi_populate_tre(struct gsi_chan_ctx *ctx,
-	struct gsi_xfer_elem *xfer)
+	struct gsi_xfer_elem *xfer, uint16_t idx)
 {
 	struct gsi_tre tre;
 	struct gsi_tre *tre_ptr;
-	uint16_t idx;
 
 	memset(&tre, 0, sizeof(tre));
 	tre.buffer_ptr = xfer->addr;
@@ -4208,7 +4280,6 @@ int __gsi_populate_tre(struct gsi_chan_ctx *ctx,
 		return -GSI_STATUS_UNSUPPORTED_OP;
 	}
 
-	idx = gsi_find_idx_from_addr(&ctx->ring, ctx->ring.wp_local);
 	tre_ptr = (struct gsi_tre *)(ctx->ring.base_va +
 		idx * ctx->ring.elem_sz);
 
@@ -4226,9 +4297,11 @@ int gsi_queue_xfer(unsigned long chan_hdl, uint16_t num_xfers,
 	struct gsi_chan_ctx *ctx;
 	uint16_t free;
 	uint64_t wp_rollback;
+	uint16_t idx;
 	int i;
 	spinlock_t *slock;
 	unsigned long flags;
+	bool resv = false;
 
 	if (!gsi_ctx) {
 		pr_err("%s:%d gsi context not allocated\n", __func__, __LINE__);
@@ -4262,11 +4335,40 @@ int gsi_queue_xfer(unsigned long chan_hdl, uint16_t num_xfers,
 	else
 		slock = &ctx->ring.slock;
 
-	spin_lock_irqsave(slock, flags);
+	/*
+	 * TREs of GPI channels are written outside the ring lock, so reject
+	 * a bad batch before any slot is reserved for it.
+	 */
+	if (ctx->props.prot == GSI_CHAN_PROT_GPI) {
+		for (i = 0; i < num_xfers; i++) {
+			if (xfer[i].type != GSI_XFER_ELEM_DATA &&
+				xfer[i].type != GSI_XFER_ELEM_IMME_CMD &&
+				xfer[i].type != GSI_XFER_ELEM_NOP) {
+				GSIERR("chan_hdl=%lu bad RE type=%u\n",
+					chan_hdl, xfer[i].type);
+				return -GSI_STATUS_INVALID_PARAMS;
+			}
+		}
+	}
+
+	/*
+	 * A GPI producer that had to wait for the lock, or that finds
+	 * another producer still filling its slots, reserves its slots
+	 * and fills them without the lock. Otherwise the TREs are written
+	 * under the lock, which then is taken only once.
+	 */
+	if (!spin_trylock_irqsave(slock, flags)) {
+		spin_lock_irqsave(slock, flags);
+		resv = true;
+	}
+	resv = (resv || ctx->ring.resv_inflight) &&
+		ctx->props.prot == GSI_CHAN_PROT_GPI;
 
 	/* allow only ring doorbell */
-	if (!num_xfers)
+	if (!num_xfers) {
+		resv = false;
 		goto ring_doorbell;
+	}
 
 	/*
 	 * for GCI channels the responsibility is on the caller to make sure
@@ -4282,15 +4384,42 @@ int gsi_queue_xfer(unsigned long chan_hdl, uint16_t num_xfers,
 		}
 	}
 
+	if (resv) {
+		idx = gsi_ring_resv(&ctx->ring, num_xfers);
+		spin_unlock_irqrestore(slock, flags);
+
+		for (i = 0; i < num_xfers; i++) {
+			__gsi_populate_tre(ctx, &xfer[i], idx);
+			if (++idx > ctx->ring.max_num_elem)
+				idx = 0;
+		}
+
+		/*
+		 * TRE writes are ordered before the lock is taken again, so
+		 * the producer that rings the doorbell sees them all.
+		 */
+		spin_lock_irqsave(slock, flags);
+		ctx->stats.queued += num_xfers;
+		goto ring_doorbell;
+	}
+
+	if (ctx->props.prot == GSI_CHAN_PROT_GPI) {
+		idx = gsi_find_idx_from_addr(&ctx->ring, ctx->ring.wp_local);
+		for (i = 0; i < num_xfers; i++) {
+			__gsi_populate_tre(ctx, &xfer[i], idx);
+			gsi_incr_ring_wp(&ctx->ring);
+			if (++idx > ctx->ring.max_num_elem)
+				idx = 0;
+		}
+		ctx->stats.queued += num_xfers;
+		goto ring_doorbell;
+	}
+
 	wp_rollback = ctx->ring.wp_local;
+
 	for (i = 0; i < num_xfers; i++) {
-		if (ctx->props.prot == GSI_CHAN_PROT_GCI) {
-			if (__gsi_populate_gci_tre(ctx, &xfer[i]))
-				break;
-		} else {
-			if (__gsi_populate_tre(ctx, &xfer[i]))
-				break;
-		}
+		if (__gsi_populate_gci_tre(ctx, &xfer[i]))
+			break;
 		gsi_incr_ring_wp(&ctx->ring);
 	}
 
@@ -4304,7 +4433,7 @@ int gsi_queue_xfer(unsigned long chan_hdl, uint16_t num_xfers,
 	ctx->stats.queued += num_xfers;
 
 ring_doorbell:
-	if (ring_db) {
+	if (gsi_ring_publish(&ctx->ring, resv, ring_db)) {
 		/* ensure TRE is set before ringing doorbell */
 		wmb();
 		gsi_ring_chan_doorbell(ctx);
@@ -4319,6 +4448,8 @@ EXPORT_SYMBOL(gsi_queue_xfer);
 int gsi_start_xfer(unsigned long chan_hdl)
 {
 	struct gsi_chan_ctx *ctx;
+	spinlock_t *slock;
+	unsigned long flags;
 
 	if (!gsi_ctx) {
 		pr_err("%s:%d gsi context not allocated\n", __func__, __LINE__);
@@ -4343,10 +4474,16 @@ int gsi_start_xfer(unsigned long chan_hdl)
 		return -GSI_STATUS_UNSUPPORTED_OP;
 	}
 
-	if (ctx->ring.wp == ctx->ring.wp_local)
-		return GSI_STATUS_SUCCESS;
+	if (ctx->evtr)
+		slock = &ctx->evtr->ring.slock;
+	else
+		slock = &ctx->ring.slock;
 
-	gsi_ring_chan_doorbell(ctx);
+	spin_lock_irqsave(slock, flags);
+	if (ctx->ring.wp != ctx->ring.wp_local &&
+		gsi_ring_publish(&ctx->ring, false, true))
+		gsi_ring_chan_doorbell(ctx);
+	spin_unlock_irqrestore(slock, flags);
 
 	return GSI_STATUS_SUCCESS;
 };
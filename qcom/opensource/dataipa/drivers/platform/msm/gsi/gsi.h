@@ -1337,6 +1337,8 @@ struct gsi_ring_ctx {
 	uint8_t elem_sz;
 	uint16_t max_num_elem;
 	uint64_t end;
+	uint16_t resv_inflight;
+	bool db_pending;
 };
 
 struct gsi_chan_dp_stats {
@@ -1824,6 +1826,11 @@ int gsi_config_channel_mode(unsigned long chan_hdl, enum gsi_chan_mode mode);
  * @ring_db:   If true, tell HW about these queued xfers
  *             If false, do not notify HW at this time
  *
+ * GPI channels may be fed by several producers at once: under
+ * contention ring slots are reserved under the ring lock, TREs are
+ * written without it and the doorbell is rung by the last producer to
+ * publish its slots.
+ *
  * @Return gsi_status
  */
 int gsi_queue_xfer(unsigned long chan_hdl, uint16_t num_xfers,
@@ -1831,6 +1838,29 @@ int gsi_queue_xfer(unsigned long chan_hdl, uint16_t num_xfers,
 
 void gsi_debugfs_init(void);
 uint16_t gsi_find_idx_from_addr(struct gsi_ring_ctx *ctx, uint64_t addr);
+
+/**
+ * gsi_ring_resv - Reserve ring elements to be filled without the
+ * ring lock. Caller must hold the ring lock.
+ *
+ * @ctx: the ring
+ * @num: number of elements to reserve
+ *
+ * @Return index of the first reserved element
+ */
+uint16_t gsi_ring_resv(struct gsi_ring_ctx *ctx, uint16_t num);
+
+/**
+ * gsi_ring_publish - Publish queued ring elements. Caller must hold
+ * the ring lock.
+ *
+ * @ctx:     the ring
+ * @resv:    the elements were reserved with gsi_ring_resv()
+ * @ring_db: the producer asked for the doorbell
+ *
+ * @Return true if the caller must ring the doorbell now
+ */
+bool gsi_ring_publish(struct gsi_ring_ctx *ctx, bool resv, bool ring_db);
 void gsi_update_ch_dp_stats(struct gsi_chan_ctx *ctx, uint16_t used);
 
 /**
@@ -1985,6 +2015,20 @@ int gsi_get_evt_ring_cfg(unsigned long evt_ring_hdl,
 int gsi_set_evt_ring_cfg(unsigned long evt_ring_hdl,
 		struct gsi_evt_ring_props *props, union gsi_evt_scratch *scr);
 
+/**
+ * gsi_set_evt_ring_int_mod - This function updates the interrupt
+ * moderation of an allocated event ring without resetting it
+ *
+ * @evt_ring_hdl:  Client handle previously obtained from
+ *             gsi_alloc_evt_ring
+ * @int_modt:      moderation timer, 32KHz clock cycles
+ * @int_modc:      moderation packet counter, must not be zero
+ *
+ * @Return gsi_status
+ */
+int gsi_set_evt_ring_int_mod(unsigned long evt_ring_hdl,
+		uint16_t int_modt, uint8_t int_modc);
+
 /**
  * gsi_write_channel_scratch - Peripheral should call this function to
  * write to the scratch area of the channel context
@@ -6040,6 +6040,10 @@ static int ipa3_setup_apps_pipes(void)
 	ipa3_ctx->ctrl->ipa_init_flt6();
 	IPADBG("V6 FLT initialized\n");
 
+	/* sram now holds empty tables, next commits need to rewrite all */
+	ipa3_rt_set_tbls_dirty();
+	ipa3_flt_set_tbls_dirty();
+
 	if (!ipa3_ctx->ipa_fltrt_not_hashable) {
 		if (ipa3_setup_flt_hash_tuple()) {
 			IPAERR(":fail to configure flt hash tuple\n");
@@ -7798,6 +7802,7 @@ static int ipa3_post_init(const struct ipa3_plat_drv_res *resource_p,
 			/* Init force sys to false */
 			flt_tbl->force_sys[IPA_RULE_HASHABLE] = false;
 			flt_tbl->force_sys[IPA_RULE_NON_HASHABLE] = false;
+			flt_tbl->dirty = true;
 
 			flt_tbl->rule_ids = &ipa3_ctx->flt_rule_ids[ip];
 		}
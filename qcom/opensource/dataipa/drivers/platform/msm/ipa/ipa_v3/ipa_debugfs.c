@@ -1571,6 +1571,13 @@ static ssize_t ipa3_read_stats(struct file *file, char __user *ubuf,
 		);
 	cnt += nbytes;
 
+	nbytes = scnprintf(dbg_buff + cnt, IPA_MAX_MSG_LEN - cnt,
+		"fltrt_bdy_cache_hit=%llu\n"
+		"fltrt_bdy_cache_miss=%llu\n",
+		ipa3_ctx->stats.fltrt_bdy_cache_hit,
+		ipa3_ctx->stats.fltrt_bdy_cache_miss);
+	cnt += nbytes;
+
 	for (i = 0; i < IPAHAL_PKT_STATUS_EXCEPTION_MAX; i++) {
 		nbytes = scnprintf(dbg_buff + cnt,
 			IPA_MAX_MSG_LEN - cnt,
@@ -1621,20 +1628,28 @@ static ssize_t ipa3_read_page_recycle_stats(struct file *file,
 			"COAL : Number of page recycled packets  =%llu\n"
 			"COAL : Number of tmp alloc packets  =%llu\n"
 			"COAL  : Number of times tasklet scheduled  =%llu\n"
+			"COAL  : Number of pages reaped on completion  =%llu\n"
+			"COAL  : Number of busy pages rotated  =%llu\n"
 			"DEF  : Total number of packets replenished =%llu\n"
 			"DEF  : Number of page recycled packets =%llu\n"
 			"DEF  : Number of tmp alloc packets  =%llu\n"
 			"DEF  : Number of times tasklet scheduled  =%llu\n"
+			"DEF  : Number of pages reaped on completion  =%llu\n"
+			"DEF  : Number of busy pages rotated  =%llu\n"
 			"COMMON  : Number of page recycled in tasklet  =%llu\n"
 			"COMMON  : Number of times free pages not found in tasklet =%llu\n",
 			ipa3_ctx->stats.page_recycle_stats[0].total_replenished,
 			ipa3_ctx->stats.page_recycle_stats[0].page_recycled,
 			ipa3_ctx->stats.page_recycle_stats[0].tmp_alloc,
 			ipa3_ctx->stats.num_sort_tasklet_sched[0],
+			ipa3_ctx->stats.page_recycle_stats[0].page_reaped,
+			ipa3_ctx->stats.page_recycle_stats[0].reap_busy,
 			ipa3_ctx->stats.page_recycle_stats[1].total_replenished,
 			ipa3_ctx->stats.page_recycle_stats[1].page_recycled,
 			ipa3_ctx->stats.page_recycle_stats[1].tmp_alloc,
 			ipa3_ctx->stats.num_sort_tasklet_sched[1],
+			ipa3_ctx->stats.page_recycle_stats[1].page_reaped,
+			ipa3_ctx->stats.page_recycle_stats[1].reap_busy,
 			ipa3_ctx->stats.page_recycle_cnt_in_tasklet,
 			ipa3_ctx->stats.num_of_times_wq_reschd);
 
@@ -3111,6 +3126,91 @@ static ssize_t ipa3_write_ipa_max_napi_sort_page_thrshld(struct file *file,
 	return count;
 }
 
+static ssize_t ipa3_read_dim(struct file *file,
+	char __user *buf, size_t count, loff_t *ppos)
+{
+	static const enum ipa_client_type clients[] = {
+		IPA_CLIENT_APPS_WAN_COAL_CONS,
+		IPA_CLIENT_APPS_WAN_CONS,
+	};
+	const struct ipa3_dim_profile *prof;
+	struct ipa3_sys_context *sys;
+	int ep_idx;
+	int nbytes;
+	int i;
+
+	nbytes = scnprintf(dbg_buff, IPA_MAX_MSG_LEN,
+		"adaptive moderation = %s\n",
+		ipa3_ctx->ipa_dim_enable ? "enabled" : "disabled");
+
+	for (i = 0; i < ARRAY_SIZE(clients); i++) {
+		ep_idx = ipa3_get_ep_mapping(clients[i]);
+		if (ep_idx == IPA_EP_NOT_ALLOCATED ||
+			!ipa3_ctx->ep[ep_idx].valid || !ipa3_ctx->ep[ep_idx].sys)
+			continue;
+		sys = ipa3_ctx->ep[ep_idx].sys;
+		prof = ipa3_dim_cur(&sys->dim);
+		nbytes += scnprintf(dbg_buff + nbytes,
+			IPA_MAX_MSG_LEN - nbytes,
+			"%s: profile=%u modt=%u modc=%u budget=%u hold=%u changes=%llu\n",
+			ipa_clients_strings[clients[i]], sys->dim.profile,
+			prof->int_modt, prof->int_modc, prof->budget,
+			prof->poll_hold, sys->dim.changes);
+	}
+
+	return simple_read_from_buffer(buf, count, ppos, dbg_buff, nbytes);
+}
+
+static ssize_t ipa3_write_dim(struct file *file,
+	const char __user *buf, size_t count, loff_t *ppos)
+{
+	int ret;
+	bool enable;
+
+	if (count >= sizeof(dbg_buff))
+		return -EFAULT;
+
+	ret = kstrtobool_from_user(buf, count, &enable);
+	if (ret)
+		return ret;
+
+	ipa3_ctx->ipa_dim_enable = enable;
+
+	IPADBG("adaptive moderation = %d", ipa3_ctx->ipa_dim_enable);
+
+	return count;
+}
+
+static ssize_t ipa3_read_lan_rx_zero_copy(struct file *file,
+	char __user *buf, size_t count, loff_t *ppos)
+{
+	int nbytes;
+
+	nbytes = scnprintf(dbg_buff, IPA_MAX_MSG_LEN,
+		"lan rx zero copy = %d\n", ipa3_ctx->lan_rx_zero_copy);
+	return simple_read_from_buffer(buf, count, ppos, dbg_buff, nbytes);
+}
+
+static ssize_t ipa3_write_lan_rx_zero_copy(struct file *file,
+	const char __user *buf, size_t count, loff_t *ppos)
+{
+	int ret;
+	bool enable;
+
+	if (count >= sizeof(dbg_buff))
+		return -EFAULT;
+
+	ret = kstrtobool_from_user(buf, count, &enable);
+	if (ret)
+		return ret;
+
+	ipa3_ctx->lan_rx_zero_copy = enable;
+
+	IPADBG("lan rx zero copy = %d", ipa3_ctx->lan_rx_zero_copy);
+
+	return count;
+}
+
 static ssize_t ipa3_read_page_wq_reschd_time(struct file *file,
 	char __user *buf, size_t count, loff_t *ppos) {
 
@@ -3443,6 +3543,16 @@ static const struct ipa3_debugfs_file debugfs_files[] = {
 			.read = ipa3_read_page_poll_threshold,
 			.write = ipa3_write_page_poll_threshold,
 		}
+	}, {
+		"dim", IPA_READ_WRITE_MODE, NULL, {
+			.read = ipa3_read_dim,
+			.write = ipa3_write_dim,
+		}
+	}, {
+		"lan_rx_zero_copy", IPA_READ_WRITE_MODE, NULL, {
+			.read = ipa3_read_lan_rx_zero_copy,
+			.write = ipa3_write_lan_rx_zero_copy,
+		}
 	}, {
 		"move_nat_table_to_ddr", IPA_WRITE_ONLY_MODE, NULL,{
 			.write = ipa3_write_nat_table_move,
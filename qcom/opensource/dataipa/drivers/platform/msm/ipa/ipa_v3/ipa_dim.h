@@ -0,0 +1,140 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (c) 2022 Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+
+#ifndef _IPA3_DIM_H_
+#define _IPA3_DIM_H_
+
+/*
+ * Dynamic interrupt moderation for IPA RX system pipes.
+ *
+ * Every NAPI poll reports how many frames it pulled and the budget it
+ * was given. Samples are accumulated into windows; at the end of a
+ * window the average batch is compared against that budget. A pipe that
+ * keeps filling its budget moves to a profile with heavier event ring
+ * moderation and a larger budget, a pipe that keeps returning small
+ * batches moves towards low latency. A step needs the same verdict for
+ * IPA_DIM_STEADY_WINDOWS windows in a row.
+ *
+ * ipa3_dim_sample() only touches the state it is given, so recorded
+ * traces can be replayed through it outside the driver.
+ */
+
+#define IPA_DIM_WINDOW_NS (1000 * 1000)
+#define IPA_DIM_WINDOW_POLLS 64
+#define IPA_DIM_STEADY_WINDOWS 2
+
+/**
+ * struct ipa3_dim_profile - one moderation level
+ * @int_modt: event ring moderation timer, 32KHz cycles
+ * @int_modc: event ring moderation packet counter
+ * @budget: NAPI budget in aggregated frames
+ * @poll_hold: polls that left budget unused to stay in polling mode for
+ */
+struct ipa3_dim_profile {
+	u16 int_modt;
+	u8 int_modc;
+	u16 budget;
+	u16 poll_hold;
+};
+
+enum ipa3_dim_profile_idx {
+	IPA_DIM_PROFILE_LOW_LAT,
+	IPA_DIM_PROFILE_MID,
+	IPA_DIM_PROFILE_BULK,
+	IPA_DIM_PROFILE_MAX
+};
+
+static const struct ipa3_dim_profile ipa3_dim_profiles[IPA_DIM_PROFILE_MAX] = {
+	[IPA_DIM_PROFILE_LOW_LAT] = { 0, 1, 16, 0 },
+	[IPA_DIM_PROFILE_MID] = { 8, 8, 32, 1 },
+	[IPA_DIM_PROFILE_BULK] = { 16, 20, 64, 2 },
+};
+
+/**
+ * struct ipa3_dim - per pipe moderation state
+ * @profile: current profile index
+ * @win_start_ns: start of the current window
+ * @win_polls: polls seen in the current window
+ * @win_pkts: packets seen in the current window
+ * @steady_dir: direction of the last verdicts, -1 down, 1 up
+ * @steady_cnt: consecutive windows with the same verdict
+ * @idle_polls: consecutive polls that left budget unused
+ * @changes: number of profile changes
+ */
+struct ipa3_dim {
+	u32 profile;
+	u64 win_start_ns;
+	u32 win_polls;
+	u32 win_pkts;
+	int steady_dir;
+	u32 steady_cnt;
+	u32 idle_polls;
+	u64 changes;
+};
+
+static inline void ipa3_dim_init(struct ipa3_dim *dim, u32 profile)
+{
+	memset(dim, 0, sizeof(*dim));
+	dim->profile = profile;
+}
+
+static inline const struct ipa3_dim_profile *ipa3_dim_cur(
+	const struct ipa3_dim *dim)
+{
+	return &ipa3_dim_profiles[dim->profile];
+}
+
+/**
+ * ipa3_dim_sample() - account one NAPI poll
+ * @dim: moderation state
+ * @pkts: frames pulled by the poll
+ * @budget: frames the poll was allowed to pull
+ * @now_ns: monotonic time of the poll
+ *
+ * Return: true if the profile changed and must be applied
+ */
+static inline bool ipa3_dim_sample(struct ipa3_dim *dim, u32 pkts,
+	u32 budget, u64 now_ns)
+{
+	int dir = 0;
+
+	if (!dim->win_polls)
+		dim->win_start_ns = now_ns;
+	dim->win_polls++;
+	dim->win_pkts += pkts;
+	dim->idle_polls = (pkts >= budget) ? 0 : dim->idle_polls + 1;
+
+	if (dim->win_polls < IPA_DIM_WINDOW_POLLS &&
+		now_ns - dim->win_start_ns < IPA_DIM_WINDOW_NS)
+		return false;
+
+	/* average batch of at least 3/4 budget up, below 1/4 down */
+	if (dim->win_pkts * 4 >= dim->win_polls * budget * 3)
+		dir = 1;
+	else if (dim->win_pkts * 4 < dim->win_polls * budget)
+		dir = -1;
+	dim->win_polls = 0;
+	dim->win_pkts = 0;
+
+	if (!dir || (dir > 0 && dim->profile == IPA_DIM_PROFILE_MAX - 1) ||
+		(dir < 0 && dim->profile == 0)) {
+		dim->steady_cnt = 0;
+		return false;
+	}
+
+	if (dir != dim->steady_dir) {
+		dim->steady_dir = dir;
+		dim->steady_cnt = 0;
+	}
+	if (++dim->steady_cnt < IPA_DIM_STEADY_WINDOWS)
+		return false;
+
+	dim->profile += dir;
+	dim->steady_cnt = 0;
+	dim->changes++;
+	return true;
+}
+
+#endif /* _IPA3_DIM_H_ */
@@ -63,6 +63,9 @@
 
 #define IPA_RX_BUFF_CLIENT_HEADROOM 256
 
+/* LAN RX packets below this size are copied even in zero copy mode */
+#define IPA_LAN_RX_COPYBREAK 256
+
 #define IPA_WLAN_RX_POOL_SZ 100
 #define IPA_WLAN_RX_POOL_SZ_LOW_WM 5
 #define IPA_WLAN_RX_BUFF_SZ 2048
@@ -588,6 +591,19 @@ static void ipa3_send_nop_desc(struct work_struct *work)
 }
 
 
+/* descriptors the TLV FIFO of a producer pipe can take in one transaction */
+static unsigned int ipa3_gsi_ep_max_desc(
+	const struct ipa_gsi_ep_config *gsi_ep_cfg)
+{
+	unsigned int max_desc = gsi_ep_cfg->ipa_if_tlv;
+
+	if (gsi_ep_cfg->prefetch_mode == GSI_SMART_PRE_FETCH ||
+		gsi_ep_cfg->prefetch_mode == GSI_FREE_PRE_FETCH)
+		max_desc -= gsi_ep_cfg->prefetch_threshold;
+
+	return max_desc;
+}
+
 /**
  * ipa3_send() - Send multiple descriptors in one HW transaction
  * @sys: system pipe context
@@ -638,11 +654,7 @@ int ipa3_send(struct ipa3_sys_context *sys,
 		return -EPERM;
 	}
 
-	max_desc = gsi_ep_cfg->ipa_if_tlv;
-	if (gsi_ep_cfg->prefetch_mode == GSI_SMART_PRE_FETCH ||
-		gsi_ep_cfg->prefetch_mode == GSI_FREE_PRE_FETCH)
-		max_desc -= gsi_ep_cfg->prefetch_threshold;
-
+	max_desc = ipa3_gsi_ep_max_desc(gsi_ep_cfg);
 	if (unlikely(num_desc > max_desc)) {
 		IPAERR("Too many chained descriptors need=%d max=%d\n",
 			num_desc, max_desc);
@@ -971,6 +983,25 @@ bail:
 		return result;
 }
 
+/**
+ * ipa3_send_cmd_max_desc() - max immediate commands in one ipa3_send_cmd()
+ *
+ * Callers with more commands than this must split them over several
+ * ipa3_send_cmd() calls.
+ *
+ * Return: number of descriptors, 0 if the command pipe is not configured
+ */
+u32 ipa3_send_cmd_max_desc(void)
+{
+	const struct ipa_gsi_ep_config *gsi_ep_cfg;
+
+	gsi_ep_cfg = ipa3_get_gsi_ep_info(IPA_CLIENT_APPS_CMD_PROD);
+	if (!gsi_ep_cfg)
+		return 0;
+
+	return min_t(u32, IPA_SEND_MAX_DESC, ipa3_gsi_ep_max_desc(gsi_ep_cfg));
+}
+
 /**
  * ipa3_send_cmd_timeout - send immediate commands with limited time
  *	waiting for ACK from IPA HW
@@ -1352,6 +1383,58 @@ fail_setup:
 	return result;
 }
 
+static u32 ipa3_page_recycle_stats_idx(struct ipa3_sys_context *sys)
+{
+	switch (sys->ep->client) {
+	case IPA_CLIENT_APPS_WAN_CONS:
+		return 1;
+	case IPA_CLIENT_APPS_WAN_LOW_LAT_DATA_CONS:
+		return 2;
+	default:
+		return 0;
+	}
+}
+
+/**
+ * ipa3_reap_inflight_pages() - move released pages to the free list
+ * @sys: sys context owning the page pool
+ * @budget: number of in-flight pages to examine
+ * @stats_i: page_recycle_stats index to account to
+ *
+ * Pages are handed to the stack roughly in order and released in
+ * about the same order, so only the oldest in-flight page is checked.
+ * A page still held by the stack is rotated to the tail so that it
+ * does not block the pages behind it.
+ *
+ * Must be called with common_sys->spinlock held.
+ *
+ * Return: number of pages moved to the free list
+ */
+static int ipa3_reap_inflight_pages(struct ipa3_sys_context *sys,
+	int budget, u32 stats_i)
+{
+	struct ipa3_page_repl_ctx *repl = sys->page_recycle_repl;
+	struct ipa3_rx_pkt_wrapper *rx_pkt;
+	int reaped = 0;
+
+	while (budget-- > 0 && !list_empty(&repl->page_repl_head)) {
+		rx_pkt = list_first_entry(&repl->page_repl_head,
+			struct ipa3_rx_pkt_wrapper, link);
+		if (page_ref_count(rx_pkt->page_data.page) == 1) {
+			list_move_tail(&rx_pkt->link, &repl->page_free_head);
+			reaped++;
+		} else {
+			list_move_tail(&rx_pkt->link, &repl->page_repl_head);
+			ipa3_ctx->stats.page_recycle_stats[stats_i].reap_busy++;
+		}
+	}
+	ipa3_ctx->stats.page_recycle_stats[stats_i].page_reaped += reaped;
+	if (reaped)
+		atomic_set(&sys->common_sys->page_avilable, 1);
+
+	return reaped;
+}
+
 static void ipa3_schd_freepage_work(struct work_struct *work)
 {
 	struct delayed_work *dwork;
@@ -1368,29 +1451,22 @@ static void ipa3_schd_freepage_work(struct work_struct *work)
 static void ipa3_tasklet_find_freepage(unsigned long data)
 {
 	struct ipa3_sys_context *sys;
-	struct ipa3_rx_pkt_wrapper *rx_pkt = NULL;
-	struct ipa3_rx_pkt_wrapper *tmp = NULL;
-	struct page *cur_page;
 	int found_free_page = 0;
-	struct list_head temp_head;
 
 	sys = (struct ipa3_sys_context *)data;
 
 	if(sys->page_recycle_repl == NULL)
 		return;
-	INIT_LIST_HEAD(&temp_head);
 	spin_lock_bh(&sys->common_sys->spinlock);
-	list_for_each_entry_safe(rx_pkt, tmp,
-		&sys->page_recycle_repl->page_repl_head, link) {
-		cur_page = rx_pkt->page_data.page;
-		if (page_ref_count(cur_page) == 1) {
-			/* Found a free page. */
-			list_del_init(&rx_pkt->link);
-			list_add(&rx_pkt->link, &temp_head);
-			found_free_page++;
-		}
-	}
-	if (!found_free_page) {
+	/*
+	 * Completions normally keep the free list topped up, this is only
+	 * the fallback pass over the pages still held by the stack.
+	 */
+	found_free_page = ipa3_reap_inflight_pages(sys,
+		sys->page_recycle_repl->capacity,
+		ipa3_page_recycle_stats_idx(sys));
+	if (!found_free_page &&
+		list_empty(&sys->page_recycle_repl->page_free_head)) {
 		/*Not found free page rescheduling tasklet after 2msec*/
 		IPADBG_LOW("Scheduling WQ not found free pages\n");
 		++ipa3_ctx->stats.num_of_times_wq_reschd;
@@ -1399,7 +1475,6 @@ static void ipa3_tasklet_find_freepage(unsigned long data)
 				msecs_to_jiffies(ipa3_ctx->page_wq_reschd_time));
 	} else {
 		/*Allow to use pre-allocated buffers*/
-		list_splice(&temp_head, &sys->page_recycle_repl->page_repl_head);
 		ipa3_ctx->stats.page_recycle_cnt_in_tasklet += found_free_page;
 		IPADBG_LOW("found free pages count = %d\n", found_free_page);
 		atomic_set(&sys->common_sys->page_avilable, 1);
@@ -1610,6 +1685,8 @@ int ipa3_setup_sys_pipe(struct ipa_sys_connect_params *sys_in, u32 *clnt_hdl)
 	ep->sys->ext_ioctl_v2 = sys_in->ext_ioctl_v2;
 	ep->sys->int_modt = sys_in->int_modt;
 	ep->sys->int_modc = sys_in->int_modc;
+	/* NAPI event rings start with the bulk moderation values */
+	ipa3_dim_init(&ep->sys->dim, IPA_DIM_PROFILE_BULK);
 	ep->sys->buff_size = sys_in->buff_size;
 	ep->sys->page_order = (sys_in->ext_ioctl_v2) ?
 			get_order(sys_in->buff_size) : IPA_WAN_PAGE_ORDER;
@@ -1713,6 +1790,7 @@ int ipa3_setup_sys_pipe(struct ipa_sys_connect_params *sys_in, u32 *clnt_hdl)
 				IPADBG("Page repl capacity for client:%d, value:%d\n",
 						   sys_in->client, ep->sys->page_recycle_repl->capacity);
 				INIT_LIST_HEAD(&ep->sys->page_recycle_repl->page_repl_head);
+				INIT_LIST_HEAD(&ep->sys->page_recycle_repl->page_free_head);
 				INIT_DELAYED_WORK(&ep->sys->freepage_work, ipa3_schd_freepage_work);
 				tasklet_init(&ep->sys->tasklet_find_freepage,
 					ipa3_tasklet_find_freepage, (unsigned long) ep->sys);
@@ -2638,7 +2716,7 @@ static void ipa3_replenish_rx_page_cache(struct ipa3_sys_context *sys)
 		INIT_LIST_HEAD(&rx_pkt->link);
 		rx_pkt->sys = sys;
 		list_add_tail(&rx_pkt->link,
-			&sys->page_recycle_repl->page_repl_head);
+			&sys->page_recycle_repl->page_free_head);
 	}
 	atomic_set(&sys->common_sys->page_avilable, 1);
 
@@ -2715,29 +2793,29 @@ static struct ipa3_rx_pkt_wrapper * ipa3_get_free_page
 	u32 stats_i
 )
 {
+	struct ipa3_page_repl_ctx *repl = sys->page_recycle_repl;
 	struct ipa3_rx_pkt_wrapper *rx_pkt = NULL;
-	struct ipa3_rx_pkt_wrapper *tmp = NULL;
-	struct page *cur_page;
 	int i = 0;
 	u8 LOOP_THRESHOLD = ipa3_ctx->page_poll_threshold;
 
 	spin_lock_bh(&sys->common_sys->spinlock);
-	list_for_each_entry_safe(rx_pkt, tmp,
-		&sys->page_recycle_repl->page_repl_head, link) {
-		if (i == LOOP_THRESHOLD)
-			break;
-		cur_page = rx_pkt->page_data.page;
-		if (page_ref_count(cur_page) == 1) {
-			/* Found a free page. */
-			page_ref_inc(cur_page);
-			list_del_init(&rx_pkt->link);
-			++ipa3_ctx->stats.page_recycle_cnt[stats_i][i];
-			sys->common_sys->napi_sort_page_thrshld_cnt = 0;
-			spin_unlock_bh(&sys->common_sys->spinlock);
-			return rx_pkt;
-		}
+	/* Free list empty, look at the oldest pages still with the stack. */
+	while (list_empty(&repl->page_free_head) && i < LOOP_THRESHOLD &&
+		!list_empty(&repl->page_repl_head)) {
+		ipa3_reap_inflight_pages(sys, 1, stats_i);
 		i++;
 	}
+	if (!list_empty(&repl->page_free_head)) {
+		rx_pkt = list_first_entry(&repl->page_free_head,
+			struct ipa3_rx_pkt_wrapper, link);
+		page_ref_inc(rx_pkt->page_data.page);
+		list_del_init(&rx_pkt->link);
+		++ipa3_ctx->stats.page_recycle_cnt[stats_i]
+			[min_t(int, i, IPA_PAGE_POLL_THRESHOLD_MAX - 1)];
+		sys->common_sys->napi_sort_page_thrshld_cnt = 0;
+		spin_unlock_bh(&sys->common_sys->spinlock);
+		return rx_pkt;
+	}
 	spin_unlock_bh(&sys->common_sys->spinlock);
 	IPADBG_LOW("napi_sort_page_thrshld_cnt = %d ipa_max_napi_sort_page_thrshld = %d\n",
 			sys->common_sys->napi_sort_page_thrshld_cnt,
@@ -3395,6 +3473,27 @@ static void ipa3_replenish_rx_cache_recycle(struct ipa3_sys_context *sys)
 				struct ipa3_rx_pkt_wrapper, link);
 			list_del_init(&rx_pkt->link);
 			spin_unlock_bh(&sys->spinlock);
+			/*
+			 * a buffer handed out to zero copy LAN RX clones is
+			 * never reset by the payload handler, so its cloned
+			 * bit stays set even after the clones are gone. Post
+			 * a new one and drop our reference to the old data.
+			 */
+			if (unlikely(rx_pkt->data.skb->cloned)) {
+				struct sk_buff *skb;
+
+				skb = sys->get_skb(sys->rx_buff_sz, flag);
+				if (!skb) {
+					IPAERR_RL("failed to alloc skb\n");
+					spin_lock_bh(&sys->spinlock);
+					list_add(&rx_pkt->link,
+						&sys->rcycl_list);
+					spin_unlock_bh(&sys->spinlock);
+					goto fail_kmem_cache_alloc;
+				}
+				sys->free_skb(rx_pkt->data.skb);
+				rx_pkt->data.skb = skb;
+			}
 			ptr = skb_put(rx_pkt->data.skb, sys->rx_buff_sz);
 			rx_pkt->data.dma_addr = dma_map_single(ipa3_ctx->pdev,
 				ptr, sys->rx_buff_sz, DMA_FROM_DEVICE);
@@ -3597,9 +3696,9 @@ static void free_rx_page(void *chan_user_data, void *xfer_user_data)
 		list_del_init(&rx_pkt->link);
 		page_ref_dec(rx_pkt->page_data.page);
 		spin_lock_bh(&rx_pkt->sys->common_sys->spinlock);
-		/* Add the element to head. */
+		/* Page is back with the pool only, it is free. */
 		list_add(&rx_pkt->link,
-			&rx_pkt->sys->page_recycle_repl->page_repl_head);
+			&rx_pkt->sys->page_recycle_repl->page_free_head);
 		spin_unlock_bh(&rx_pkt->sys->common_sys->spinlock);
 	} else {
 		dma_unmap_page(ipa3_ctx->pdev, rx_pkt->page_data.dma_addr,
@@ -3698,6 +3797,26 @@ static struct sk_buff *ipa3_skb_copy_for_client(struct sk_buff *skb, int len)
 	return skb2;
 }
 
+/*
+ * Zero copy variant of ipa3_skb_copy_for_client(): the returned skb shares
+ * the aggregated buffer and ipa3_replenish_rx_cache_recycle() does not
+ * repost the buffer while such clones exist.
+ */
+static struct sk_buff *ipa3_skb_clone_for_client(struct sk_buff *skb, int len)
+{
+	struct sk_buff *skb2;
+
+	if (!ipa3_ctx->lan_rx_napi_enable)
+		skb2 = skb_clone(skb, GFP_KERNEL);
+	else
+		skb2 = skb_clone(skb, GFP_ATOMIC);
+
+	if (likely(skb2))
+		skb_trim(skb2, len);
+
+	return skb2;
+}
+
 static int ipa3_lan_rx_pyld_hdlr(struct sk_buff *skb,
 		struct ipa3_sys_context *sys)
 {
@@ -3713,6 +3832,7 @@ static int ipa3_lan_rx_pyld_hdlr(struct sk_buff *skb,
 	unsigned long unused = IPA_GENERIC_RX_BUFF_BASE_SZ - used;
 	struct ipa3_tx_pkt_wrapper *tx_pkt = NULL;
 	unsigned long ptr;
+	bool zero_copy;
 
 	IPA_DUMP_BUFF(skb->data, 0, skb->len);
 
@@ -3924,8 +4044,22 @@ begin:
 				sys->drop_packet = true;
 			}
 
-			skb2 = ipa3_skb_copy_for_client(skb,
-				min(status.pkt_len + pkt_status_sz, skb->len));
+			/*
+			 * Packets fully inside this buffer are handed out as
+			 * clones, tiny ones and ones spanning into the next
+			 * buffer are still copied.
+			 */
+			zero_copy = ipa3_ctx->lan_rx_zero_copy &&
+				status.pkt_len >= IPA_LAN_RX_COPYBREAK &&
+				skb->len >= len + pkt_status_sz &&
+				!skb_has_frag_list(skb);
+			if (zero_copy)
+				skb2 = ipa3_skb_clone_for_client(skb,
+					status.pkt_len + pkt_status_sz);
+			else
+				skb2 = ipa3_skb_copy_for_client(skb,
+					min(status.pkt_len + pkt_status_sz,
+					skb->len));
 			if (likely(skb2)) {
 				if (skb->len < len + pkt_status_sz) {
 					IPADBG_LOW("SPL skb len %d len %d\n",
@@ -3955,11 +4089,20 @@ begin:
 						sys->drop_packet = true;
 						dev_kfree_skb_any(skb2);
 					} else {
-						skb2->truesize = skb2->len +
-						sizeof(struct sk_buff) +
-						(ALIGN(len +
-						pkt_status_sz, 32) *
-						unused / used_align);
+						/* clones pin their share of the buffer */
+						if (zero_copy)
+							skb2->truesize =
+							sizeof(struct sk_buff) +
+							(ALIGN(len +
+							pkt_status_sz, 32) *
+							IPA_GENERIC_RX_BUFF_BASE_SZ /
+							used_align);
+						else
+							skb2->truesize = skb2->len +
+							sizeof(struct sk_buff) +
+							(ALIGN(len +
+							pkt_status_sz, 32) *
+							unused / used_align);
 						sys->ep->client_notify(
 							sys->ep->priv,
 							IPA_RECEIVE,
@@ -3996,7 +4139,12 @@ begin:
 	}
 
 out:
-	ipa3_skb_recycle(skb);
+	/*
+	 * a buffer shared with clones must not be reset under them, keep
+	 * the cloned bit so replenish replaces it instead of reposting it
+	 */
+	if (!skb->cloned)
+		ipa3_skb_recycle(skb);
 	return 0;
 }
 
@@ -4557,9 +4705,9 @@ static struct sk_buff *handle_page_completion(struct gsi_chan_xfer_notify
 		if (!rx_page.is_tmp_alloc) {
 			init_page_count(rx_page.page);
 			spin_lock_bh(&rx_pkt->sys->common_sys->spinlock);
-			/* Add the element to head. */
+			/* Page was never handed to the stack, it is free. */
 			list_add(&rx_pkt->link,
-				&rx_pkt->sys->page_recycle_repl->page_repl_head);
+				&rx_pkt->sys->page_recycle_repl->page_free_head);
 			spin_unlock_bh(&rx_pkt->sys->common_sys->spinlock);
 		} else {
 			dma_unmap_page(ipa3_ctx->pdev, rx_page.dma_addr,
@@ -4589,9 +4737,9 @@ static struct sk_buff *handle_page_completion(struct gsi_chan_xfer_notify
 				if (!rx_page.is_tmp_alloc) {
 					init_page_count(rx_page.page);
 					spin_lock_bh(&rx_pkt->sys->common_sys->spinlock);
-					/* Add the element to head. */
+					/* Page was never handed to the stack, it is free. */
 					list_add(&rx_pkt->link,
-						&rx_pkt->sys->page_recycle_repl->page_repl_head);
+						&rx_pkt->sys->page_recycle_repl->page_free_head);
 					spin_unlock_bh(&rx_pkt->sys->common_sys->spinlock);
 				} else {
 					dma_unmap_page(ipa3_ctx->pdev, rx_page.dma_addr,
@@ -4616,6 +4764,14 @@ static struct sk_buff *handle_page_completion(struct gsi_chan_xfer_notify
 				/* Add the element back to tail. */
 				list_add_tail(&rx_pkt->link,
 					&rx_pkt->sys->page_recycle_repl->page_repl_head);
+				/*
+				 * Pick up pages the stack released since the
+				 * last completion so the replenish path finds
+				 * them without scanning the pool.
+				 */
+				ipa3_reap_inflight_pages(rx_pkt->sys,
+					IPA_PAGE_REAP_BUDGET,
+					ipa3_page_recycle_stats_idx(sys));
 				spin_unlock_bh(&rx_pkt->sys->common_sys->spinlock);
 				dma_sync_single_for_cpu(ipa3_ctx->pdev,
 					rx_page.dma_addr,
@@ -5941,6 +6097,11 @@ static int ipa_gsi_setup_event_ring(struct ipa3_ep_context *ep,
 		gsi_evt_ring_props.int_modt = ep->sys->int_modt;
 		gsi_evt_ring_props.int_modc = ep->sys->int_modc;
 	}
+	if (ep->sys) {
+		/* remembered for restoring after adaptive moderation */
+		ep->sys->int_modt = gsi_evt_ring_props.int_modt;
+		ep->sys->int_modc = gsi_evt_ring_props.int_modc;
+	}
 
 	IPADBG("client=%d moderation threshold cycles=%u cnt=%u\n",
 		ep->client,
@@ -6323,6 +6484,28 @@ start_poll:
 	return cnt;
 }
 
+static void ipa3_dim_apply(struct ipa3_sys_context *sys)
+{
+	const struct ipa3_dim_profile *prof = ipa3_dim_cur(&sys->dim);
+	int ret;
+
+	ret = gsi_set_evt_ring_int_mod(sys->ep->gsi_evt_ring_hdl,
+		prof->int_modt, prof->int_modc);
+	if (ret != GSI_STATUS_SUCCESS)
+		IPAERR_RL("client %d moderation update failed %d\n",
+			sys->ep->client, ret);
+	trace_ipa3_dim_profile(sys->ep->client, sys->dim.profile,
+		prof->int_modt, prof->int_modc, prof->budget);
+}
+
+/* account one ipa3_rx_poll() call, retries after a pending irq included */
+static void ipa3_dim_account_poll(struct ipa3_sys_context *sys, u32 pkts,
+	u32 budget)
+{
+	if (ipa3_dim_sample(&sys->dim, pkts, budget, ktime_get_ns()))
+		ipa3_dim_apply(sys);
+}
+
 /**
  * ipa3_rx_poll() - Poll the WAN rx packets from IPA HW. This
  * function is exectued in the softirq context
@@ -6340,6 +6523,8 @@ int ipa3_rx_poll(u32 clnt_hdl, int weight)
 	int cnt = 0;
 	int num = 0;
 	int remain_aggr_weight;
+	int aggr_budget;
+	bool dim_enable = ipa3_ctx->ipa_dim_enable;
 	int ipa_ep_idx;
 	struct ipa_active_client_logging_info log;
 	static struct gsi_chan_xfer_notify notify[IPA_WAN_NAPI_MAX_FRAMES];
@@ -6372,6 +6557,17 @@ int ipa3_rx_poll(u32 clnt_hdl, int weight)
 		return -EINVAL;
 	}
 
+	if (dim_enable) {
+		remain_aggr_weight = min_t(int, remain_aggr_weight,
+			ipa3_dim_cur(&ep->sys->dim)->budget);
+	} else if (ep->sys->dim.changes) {
+		/* moderation was turned off, restore the event ring setup */
+		gsi_set_evt_ring_int_mod(ep->gsi_evt_ring_hdl,
+			ep->sys->int_modt, ep->sys->int_modc);
+		ipa3_dim_init(&ep->sys->dim, IPA_DIM_PROFILE_BULK);
+	}
+	aggr_budget = remain_aggr_weight;
+
 	ep->sys->common_sys->napi_sort_page_thrshld_cnt++;
 start_poll:
 	/*
@@ -6404,6 +6600,17 @@ start_poll:
 		}
 	}
 	cnt += weight - remain_aggr_weight * ipa3_ctx->ipa_wan_aggr_pkt_cnt;
+	/*
+	 * The budget may be below the NAPI weight, a poll that used all of
+	 * it or sits in the hold window of the profile is reported as busy
+	 * so that NAPI keeps polling. The poll is sampled only once the
+	 * call is done, after any pending irq retry, so idle_polls does not
+	 * count it yet: with budget left over it would become one more.
+	 */
+	if (dim_enable && (remain_aggr_weight <= 0 ||
+		ep->sys->dim.idle_polls <
+		ipa3_dim_cur(&ep->sys->dim)->poll_hold))
+		cnt = weight;
 	/* call repl_hdlr before napi_reschedule / napi_complete */
 	ep->sys->repl_hdlr(ep->sys);
 	wan_def_sys->repl_hdlr(wan_def_sys);
@@ -6421,11 +6628,18 @@ start_poll:
 		if (ret == -GSI_STATUS_PENDING_IRQ &&
 				napi_reschedule(ep->sys->napi_obj))
 			goto start_poll;
+		/* still holding the clocks for the moderation update */
+		if (dim_enable)
+			ipa3_dim_account_poll(ep->sys,
+				aggr_budget - remain_aggr_weight, aggr_budget);
 		IPA_ACTIVE_CLIENTS_DEC_EP_NO_BLOCK(ep->client);
 	} else {
 		cnt = weight;
 		IPADBG_LOW("Client = %d not replenished free descripotrs\n",
 				ep->client);
+		if (dim_enable)
+			ipa3_dim_account_poll(ep->sys,
+				aggr_budget - remain_aggr_weight, aggr_budget);
 	}
 	trace_ipa3_napi_poll_exit(ep->client);
 	return cnt;
@@ -74,6 +74,15 @@ static int ipa3_generate_flt_hw_rule(enum ipa_ip_type ip,
 	gen_params.id = entry->rule_id;
 	gen_params.rule = (const struct ipa_flt_rule_i *)&entry->rule;
 	gen_params.cnt_idx = entry->cnt_idx;
+	gen_params.bdy_cache = &entry->bdy_cache;
+
+	/* account once per rule per commit, on the sizing pass */
+	if (!buf) {
+		if (entry->bdy_cache.bdy)
+			ipa3_ctx->stats.fltrt_bdy_cache_hit++;
+		else
+			ipa3_ctx->stats.fltrt_bdy_cache_miss++;
+	}
 
 	res = ipahal_flt_generate_hw_rule(&gen_params, &entry->hw_len, buf);
 	if (res) {
@@ -84,6 +93,64 @@ static int ipa3_generate_flt_hw_rule(enum ipa_ip_type ip,
 	return 0;
 }
 
+#ifdef CONFIG_IPA_DEBUG
+/**
+ * ipa_flt_sys_tbl_img_match() - check that the current body of a sys
+ *  table is what a full rebuild would generate
+ * @ip: the ip address family type
+ * @tbl: the flt tbl to check
+ * @rlt: the type of the rules to check (hashable or non-hashable)
+ *
+ * Returns: true if the current body matches, false otherwise
+ *
+ * caller needs to hold any needed locks to ensure integrity
+ */
+static bool ipa_flt_sys_tbl_img_match(enum ipa_ip_type ip,
+	struct ipa3_flt_tbl *tbl, enum ipa_rule_type rlt)
+{
+	struct ipa3_flt_entry *entry;
+	u32 size = tbl->curr_mem[rlt].size;
+	u32 ofst = 0;
+	bool match = false;
+	u8 *buf;
+
+	if (!tbl->curr_mem[rlt].phys_base) {
+		IPAERR("flt tbl ip %d rlt %d has no sys body\n", ip, rlt);
+		return false;
+	}
+
+	buf = kzalloc(size, GFP_KERNEL);
+	if (!buf)
+		return false;
+
+	list_for_each_entry(entry, &tbl->head_flt_rule_list, link) {
+		if (IPA_FLT_GET_RULE_TYPE(entry) != rlt)
+			continue;
+		if (ipa3_generate_flt_hw_rule(ip, entry, NULL) ||
+			ofst + entry->hw_len > size ||
+			ipa3_generate_flt_hw_rule(ip, entry, buf + ofst))
+			goto bail;
+		ofst += entry->hw_len;
+	}
+
+	match = ofst == tbl->sz[rlt] - ipahal_get_hw_tbl_hdr_width() &&
+		!memcmp(buf, tbl->curr_mem[rlt].base, size);
+	if (!match)
+		IPAERR("flt tbl ip %d rlt %d differs from full rebuild\n",
+			ip, rlt);
+
+bail:
+	kfree(buf);
+	return match;
+}
+#else
+static inline bool ipa_flt_sys_tbl_img_match(enum ipa_ip_type ip,
+	struct ipa3_flt_tbl *tbl, enum ipa_rule_type rlt)
+{
+	return true;
+}
+#endif
+
 static void __ipa_reap_sys_flt_tbls(enum ipa_ip_type ip, enum ipa_rule_type rlt)
 {
 	struct ipa3_flt_tbl *tbl;
@@ -187,10 +254,17 @@ static int ipa_prep_flt_tbl_for_cmt(enum ipa_ip_type ip,
  *  (rules and tables) to HW format and fill it in the given buffers
  * @ip: the ip address family type
  * @rlt: the type of the rules to translate (hashable or non-hashable)
- * @base: the rules body buffer to be filled
+ * @base: the rules body buffer to be filled, NULL if the local bodies
+ *  are unchanged and only their offsets are needed for the header
  * @hdr: the rules header (addresses/offsets) buffer to be filled
  * @body_ofst: the offset of the rules body from the rules header at
  *  ipa sram
+ * @verify: check the current sys bodies instead of replacing them
+ *
+ * Sys tables that were not changed since the last commit keep their
+ * current body, only their address is written to the header. With
+ * @verify, every sys table keeps it, after its body was checked
+ * against a freshly generated one.
  *
  * Returns: 0 on success, negative on failure
  *
@@ -198,7 +272,7 @@ static int ipa_prep_flt_tbl_for_cmt(enum ipa_ip_type ip,
  *
  */
 static int ipa_translate_flt_tbl_to_hw_fmt(enum ipa_ip_type ip,
-	enum ipa_rule_type rlt, u8 *base, u8 *hdr, u32 body_ofst)
+	enum ipa_rule_type rlt, u8 *base, u8 *hdr, u32 body_ofst, bool verify)
 {
 	u64 offset;
 	u8 *body_i;
@@ -209,8 +283,8 @@ static int ipa_translate_flt_tbl_to_hw_fmt(enum ipa_ip_type ip,
 	struct ipa3_flt_tbl *tbl;
 	int i;
 	int hdr_idx = 0;
+	u32 lcl_ofst = 0;
 
-	body_i = base;
 	for (i = 0; i < ipa3_ctx->ipa_num_pipes; i++) {
 		if (!ipa_is_ep_support_flt(i))
 			continue;
@@ -219,7 +293,18 @@ static int ipa_translate_flt_tbl_to_hw_fmt(enum ipa_ip_type ip,
 			hdr_idx++;
 			continue;
 		}
-		if (tbl->in_sys[rlt] || tbl->force_sys[rlt]) {
+		if ((tbl->in_sys[rlt] || tbl->force_sys[rlt]) &&
+			(verify || (!tbl->dirty &&
+			tbl->curr_mem[rlt].phys_base))) {
+			if (verify && !ipa_flt_sys_tbl_img_match(ip, tbl, rlt))
+				goto err;
+			if (ipahal_fltrt_write_addr_to_hdr(
+				tbl->curr_mem[rlt].phys_base,
+				hdr, hdr_idx, true)) {
+				IPAERR("fail to wrt sys tbl addr to hdr\n");
+				goto err;
+			}
+		} else if (tbl->in_sys[rlt] || tbl->force_sys[rlt]) {
 			/* only body (no header) */
 			tbl_mem.size = tbl->sz[rlt] -
 				ipahal_get_hw_tbl_hdr_width();
@@ -260,7 +345,7 @@ static int ipa_translate_flt_tbl_to_hw_fmt(enum ipa_ip_type ip,
 			}
 			tbl->curr_mem[rlt] = tbl_mem;
 		} else {
-			offset = body_i - base + body_ofst;
+			offset = lcl_ofst + body_ofst;
 
 			/* update the hdr at the right index */
 			if (ipahal_fltrt_write_addr_to_hdr(offset, hdr,
@@ -269,27 +354,35 @@ static int ipa_translate_flt_tbl_to_hw_fmt(enum ipa_ip_type ip,
 				goto hdr_update_fail;
 			}
 
-			/* generate the rule-set */
-			list_for_each_entry(entry, &tbl->head_flt_rule_list,
-				link) {
-				if (IPA_FLT_GET_RULE_TYPE(entry) != rlt)
-					continue;
-				res = ipa3_generate_flt_hw_rule(
-					ip, entry, body_i);
-				if (res) {
-					IPAERR("failed to gen HW FLT rule\n");
-					goto err;
+			if (!base) {
+				/* body is already in sram, skip over it */
+				lcl_ofst += tbl->sz[rlt] -
+					ipahal_get_hw_tbl_hdr_width();
+			} else {
+				/* generate the rule-set */
+				body_i = base + lcl_ofst;
+				list_for_each_entry(entry,
+					&tbl->head_flt_rule_list, link) {
+					if (IPA_FLT_GET_RULE_TYPE(entry) != rlt)
+						continue;
+					res = ipa3_generate_flt_hw_rule(
+						ip, entry, body_i);
+					if (res) {
+						IPAERR(
+						"failed to gen HW FLT rule\n");
+						goto err;
+					}
+					body_i += entry->hw_len;
 				}
-				body_i += entry->hw_len;
+				lcl_ofst = body_i - base;
 			}
 
 			/**
-			 * advance body_i to next table alignment as local
-			 * tables are order back-to-back
+			 * advance to next table alignment as local tables
+			 * are order back-to-back
 			 */
-			body_i += ipahal_get_lcl_tbl_addr_alignment();
-			body_i = (u8 *)((long)body_i &
-				~ipahal_get_lcl_tbl_addr_alignment());
+			lcl_ofst += ipahal_get_lcl_tbl_addr_alignment();
+			lcl_ofst &= ~ipahal_get_lcl_tbl_addr_alignment();
 		}
 		hdr_idx++;
 	}
@@ -309,11 +402,12 @@ err:
  * @ip: the ip address family type
  * @alloc_params: In and Out parameters for the allocations of the buffers
  *  4 buffers: hdr and bdy, each hashable and non-hashable
+ * @verify: check the current sys bodies instead of replacing them
  *
  * Return: 0 on success, negative on failure
  */
 static int ipa_generate_flt_hw_tbl_img(enum ipa_ip_type ip,
-	struct ipahal_fltrt_alloc_imgs_params *alloc_params)
+	struct ipahal_fltrt_alloc_imgs_params *alloc_params, bool verify)
 {
 	u32 hash_bdy_start_ofst, nhash_bdy_start_ofst;
 	int rc = 0;
@@ -338,14 +432,14 @@ static int ipa_generate_flt_hw_tbl_img(enum ipa_ip_type ip,
 
 	if (ipa_translate_flt_tbl_to_hw_fmt(ip, IPA_RULE_HASHABLE,
 		alloc_params->hash_bdy.base, alloc_params->hash_hdr.base,
-		hash_bdy_start_ofst)) {
+		hash_bdy_start_ofst, verify)) {
 		IPAERR_RL("fail to translate hashable flt tbls to hw format\n");
 		rc = -EPERM;
 		goto translate_fail;
 	}
 	if (ipa_translate_flt_tbl_to_hw_fmt(ip, IPA_RULE_NON_HASHABLE,
 		alloc_params->nhash_bdy.base, alloc_params->nhash_hdr.base,
-		nhash_bdy_start_ofst)) {
+		nhash_bdy_start_ofst, verify)) {
 		IPAERR_RL("fail to translate non-hash flt tbls to hw format\n");
 		rc = -EPERM;
 		goto translate_fail;
@@ -470,6 +564,249 @@ static bool ipa_flt_skip_pipe_config(int pipe)
 	return false;
 }
 
+#ifdef CONFIG_IPA_DEBUG
+/* copy of the apps flt header entries the commits wrote to sram */
+struct ipa_flt_hdr_shadow {
+	u8 *base;
+	u32 size;
+	DECLARE_BITMAP(written, IPA5_MAX_NUM_PIPES);
+};
+
+/* copy of an apps flt body as last written to sram */
+struct ipa_flt_bdy_shadow {
+	u8 *base;
+	u32 size;
+	bool valid;
+};
+
+static struct ipa_flt_hdr_shadow ipa_flt_hdr_shadow[IPA_IP_MAX][IPA_RULE_TYPE_MAX];
+static struct ipa_flt_bdy_shadow ipa_flt_bdy_shadow[IPA_IP_MAX][IPA_RULE_TYPE_MAX];
+
+static void ipa_flt_shadow_reset(void)
+{
+	enum ipa_ip_type ip;
+	int rlt;
+
+	for (ip = IPA_IP_v4; ip < IPA_IP_MAX; ip++) {
+		for (rlt = 0; rlt < IPA_RULE_TYPE_MAX; rlt++) {
+			bitmap_zero(ipa_flt_hdr_shadow[ip][rlt].written,
+				IPA5_MAX_NUM_PIPES);
+			ipa_flt_bdy_shadow[ip][rlt].valid = false;
+		}
+	}
+}
+
+static void ipa_flt_hdr_shadow_set(struct ipa_flt_hdr_shadow *shadow,
+	struct ipa_mem_buffer *img, int hdr_idx)
+{
+	u32 tbl_hdr_width = ipahal_get_hw_tbl_hdr_width();
+
+	if (shadow->size != img->size) {
+		kfree(shadow->base);
+		shadow->base = kzalloc(img->size, GFP_KERNEL);
+		shadow->size = shadow->base ? img->size : 0;
+		bitmap_zero(shadow->written, IPA5_MAX_NUM_PIPES);
+	}
+
+	if ((hdr_idx + 1) * tbl_hdr_width > shadow->size)
+		return;
+
+	memcpy(shadow->base + hdr_idx * tbl_hdr_width,
+		img->base + hdr_idx * tbl_hdr_width, tbl_hdr_width);
+	set_bit(hdr_idx, shadow->written);
+}
+
+static bool ipa_flt_hdr_shadow_match(struct ipa_flt_hdr_shadow *shadow,
+	struct ipa_mem_buffer *img)
+{
+	u32 tbl_hdr_width = ipahal_get_hw_tbl_hdr_width();
+	int hdr_idx;
+
+	for_each_set_bit(hdr_idx, shadow->written, IPA5_MAX_NUM_PIPES) {
+		if ((hdr_idx + 1) * tbl_hdr_width > img->size ||
+			memcmp(shadow->base + hdr_idx * tbl_hdr_width,
+			img->base + hdr_idx * tbl_hdr_width, tbl_hdr_width))
+			return false;
+	}
+
+	return true;
+}
+
+static void ipa_flt_bdy_shadow_set(struct ipa_flt_bdy_shadow *shadow,
+	struct ipa_mem_buffer *img)
+{
+	kfree(shadow->base);
+	shadow->base = NULL;
+	shadow->size = img->size;
+	if (img->size)
+		shadow->base = kmemdup(img->base, img->size, GFP_KERNEL);
+	shadow->valid = !img->size || shadow->base;
+}
+
+static bool ipa_flt_bdy_shadow_match(struct ipa_flt_bdy_shadow *shadow,
+	struct ipa_mem_buffer *img)
+{
+	/* nothing known about what sram holds */
+	if (!shadow->valid)
+		return true;
+
+	return shadow->size == img->size &&
+		(!img->size || !memcmp(shadow->base, img->base, img->size));
+}
+
+/**
+ * ipa_flt_shadow_commit() - record the images a commit wrote to sram
+ * @ip: the ip address family type
+ * @params: the images of the commit
+ * @bdy_written: per rule type, whether the local body was written
+ *
+ * Must be called before the dirty flags of the tables are cleared, they
+ * tell which header entries were written.
+ */
+static void ipa_flt_shadow_commit(enum ipa_ip_type ip,
+	struct ipahal_fltrt_alloc_imgs_params *params, bool *bdy_written)
+{
+	struct ipa3_flt_tbl *tbl;
+	int hdr_idx = 0;
+	int i;
+
+	for (i = 0; i < ipa3_ctx->ipa_num_pipes; i++) {
+		if (!ipa_is_ep_support_flt(i))
+			continue;
+		tbl = &ipa3_ctx->flt_tbl[i][ip];
+		if (!ipa_flt_skip_pipe_config(i) && (tbl->dirty ||
+			bdy_written[IPA_RULE_HASHABLE] ||
+			bdy_written[IPA_RULE_NON_HASHABLE])) {
+			ipa_flt_hdr_shadow_set(
+				&ipa_flt_hdr_shadow[ip][IPA_RULE_NON_HASHABLE],
+				&params->nhash_hdr, hdr_idx);
+			if (!ipa3_ctx->ipa_fltrt_not_hashable)
+				ipa_flt_hdr_shadow_set(
+				&ipa_flt_hdr_shadow[ip][IPA_RULE_HASHABLE],
+				&params->hash_hdr, hdr_idx);
+		}
+		hdr_idx++;
+	}
+
+	if (bdy_written[IPA_RULE_NON_HASHABLE])
+		ipa_flt_bdy_shadow_set(
+			&ipa_flt_bdy_shadow[ip][IPA_RULE_NON_HASHABLE],
+			&params->nhash_bdy);
+	if (bdy_written[IPA_RULE_HASHABLE])
+		ipa_flt_bdy_shadow_set(
+			&ipa_flt_bdy_shadow[ip][IPA_RULE_HASHABLE],
+			&params->hash_bdy);
+}
+
+/**
+ * ipa_flt_check_commit() - check a commit against a full rebuild
+ * @ip: the ip address family type
+ *
+ * All the tables are prepared and generated again as if all were dirty,
+ * keeping the sram/ddr placement of the last commit. The header entries
+ * and local bodies are compared with what the commits left in sram, the
+ * sys bodies with the ones the header points to. On a mismatch all the
+ * tables are marked dirty, so the next commit rewrites everything.
+ *
+ * caller needs to hold any needed locks to ensure integrity
+ */
+static void ipa_flt_check_commit(enum ipa_ip_type ip)
+{
+	struct ipahal_fltrt_alloc_imgs_params full;
+	struct ipa3_flt_tbl *tbl;
+	u32 tbl_hdr_width = ipahal_get_hw_tbl_hdr_width();
+	u32 sz[IPA_RULE_TYPE_MAX];
+	bool match = true;
+	int i;
+
+	memset(&full, 0, sizeof(full));
+	full.ipt = ip;
+	full.tbls_num = ipa3_ctx->ep_flt_num;
+
+	for (i = 0; i < ipa3_ctx->ipa_num_pipes; i++) {
+		if (!ipa_is_ep_support_flt(i))
+			continue;
+		tbl = &ipa3_ctx->flt_tbl[i][ip];
+		memcpy(sz, tbl->sz, sizeof(sz));
+		if (ipa_prep_flt_tbl_for_cmt(ip, tbl, i)) {
+			match = false;
+			goto report;
+		}
+		if (memcmp(sz, tbl->sz, sizeof(sz))) {
+			IPAERR("flt tbl pipe %d ip %d size differs from full rebuild\n",
+				i, ip);
+			match = false;
+		}
+		if (!tbl->in_sys[IPA_RULE_HASHABLE] &&
+			!tbl->force_sys[IPA_RULE_HASHABLE] &&
+			tbl->sz[IPA_RULE_HASHABLE]) {
+			full.num_lcl_hash_tbls++;
+			full.total_sz_lcl_hash_tbls +=
+				tbl->sz[IPA_RULE_HASHABLE] - tbl_hdr_width;
+		}
+		if (!tbl->in_sys[IPA_RULE_NON_HASHABLE] &&
+			!tbl->force_sys[IPA_RULE_NON_HASHABLE] &&
+			tbl->sz[IPA_RULE_NON_HASHABLE]) {
+			full.num_lcl_nhash_tbls++;
+			full.total_sz_lcl_nhash_tbls +=
+				tbl->sz[IPA_RULE_NON_HASHABLE] - tbl_hdr_width;
+		}
+	}
+
+	/* frees the images itself on failure */
+	if (ipa_generate_flt_hw_tbl_img(ip, &full, true)) {
+		match = false;
+		goto report;
+	}
+
+	if (!ipa_flt_hdr_shadow_match(
+		&ipa_flt_hdr_shadow[ip][IPA_RULE_NON_HASHABLE],
+		&full.nhash_hdr) ||
+		!ipa_flt_hdr_shadow_match(
+		&ipa_flt_hdr_shadow[ip][IPA_RULE_HASHABLE], &full.hash_hdr)) {
+		IPAERR("flt ip %d sram header differs from full rebuild\n", ip);
+		match = false;
+	}
+
+	if (!ipa_flt_bdy_shadow_match(
+		&ipa_flt_bdy_shadow[ip][IPA_RULE_NON_HASHABLE],
+		&full.nhash_bdy) ||
+		!ipa_flt_bdy_shadow_match(
+		&ipa_flt_bdy_shadow[ip][IPA_RULE_HASHABLE], &full.hash_bdy)) {
+		IPAERR("flt ip %d sram body differs from full rebuild\n", ip);
+		match = false;
+	}
+
+	if (full.hash_hdr.size)
+		ipahal_free_dma_mem(&full.hash_hdr);
+	ipahal_free_dma_mem(&full.nhash_hdr);
+	if (full.hash_bdy.size)
+		ipahal_free_dma_mem(&full.hash_bdy);
+	if (full.nhash_bdy.size)
+		ipahal_free_dma_mem(&full.nhash_bdy);
+
+report:
+	if (!match) {
+		IPAERR("flt ip %d commit differs from full rebuild\n", ip);
+		WARN_ON_RATELIMIT_IPA(1);
+		ipa3_flt_set_tbls_dirty();
+	}
+}
+#else
+static inline void ipa_flt_shadow_reset(void)
+{
+}
+
+static inline void ipa_flt_shadow_commit(enum ipa_ip_type ip,
+	struct ipahal_fltrt_alloc_imgs_params *params, bool *bdy_written)
+{
+}
+
+static inline void ipa_flt_check_commit(enum ipa_ip_type ip)
+{
+}
+#endif
+
 /**
  * __ipa_commit_flt_v3() - commit flt tables to the hw
  *  commit the headers and the bodies if are local with internal cache flushing.
@@ -499,6 +836,8 @@ int __ipa_commit_flt_v3(enum ipa_ip_type ip)
 	struct ipa3_flt_tbl_nhash_lcl *lcl_tbl;
 	u16 entries;
 	struct ipahal_imm_cmd_register_write reg_write_coal_close;
+	DECLARE_BITMAP(was_force_sys, IPA5_MAX_NUM_PIPES);
+	bool lcl_bdy_dirty[IPA_RULE_TYPE_MAX] = { false, false };
 
 	tbl_hdr_width = ipahal_get_hw_tbl_hdr_width();
 	memset(&alloc_params, 0, sizeof(alloc_params));
@@ -533,16 +872,20 @@ int __ipa_commit_flt_v3(enum ipa_ip_type ip)
 		lcl_nhash = ipa3_ctx->flt_tbl_nhash_lcl[IPA_IP_v6];
 	}
 
+	bitmap_zero(was_force_sys, IPA5_MAX_NUM_PIPES);
 	for (i = 0; i < ipa3_ctx->ipa_num_pipes; i++) {
 		if (!ipa_is_ep_support_flt(i))
 			continue;
 		tbl = &ipa3_ctx->flt_tbl[i][ip];
-		if (ipa_prep_flt_tbl_for_cmt(ip, tbl, i)) {
+		/* only tables changed since the last commit are prepared */
+		if (tbl->dirty && ipa_prep_flt_tbl_for_cmt(ip, tbl, i)) {
 			rc = -EPERM;
 			goto prep_failed;
 		}
 
 		/* First try fitting tables in lcl memory if allowed */
+		if (tbl->force_sys[IPA_RULE_NON_HASHABLE])
+			set_bit(i, was_force_sys);
 		tbl->force_sys[IPA_RULE_NON_HASHABLE] = false;
 
 		if (!tbl->in_sys[IPA_RULE_HASHABLE] &&
@@ -595,7 +938,36 @@ int __ipa_commit_flt_v3(enum ipa_ip_type ip)
 
 	}
 
-	if (ipa_generate_flt_hw_tbl_img(ip, &alloc_params)) {
+	/*
+	 * A table moved between sram and ddr needs its body regenerated.
+	 * The local bodies are packed back to back, so they are rewritten
+	 * only if one of the local tables changed.
+	 */
+	for (i = 0; i < ipa3_ctx->ipa_num_pipes; i++) {
+		if (!ipa_is_ep_support_flt(i))
+			continue;
+		tbl = &ipa3_ctx->flt_tbl[i][ip];
+		if (tbl->force_sys[IPA_RULE_NON_HASHABLE] !=
+			test_bit(i, was_force_sys))
+			tbl->dirty = true;
+		if (!tbl->dirty)
+			continue;
+		if (!tbl->in_sys[IPA_RULE_HASHABLE])
+			lcl_bdy_dirty[IPA_RULE_HASHABLE] = true;
+		if (!tbl->in_sys[IPA_RULE_NON_HASHABLE])
+			lcl_bdy_dirty[IPA_RULE_NON_HASHABLE] = true;
+	}
+
+	if (!lcl_bdy_dirty[IPA_RULE_HASHABLE]) {
+		alloc_params.num_lcl_hash_tbls = 0;
+		alloc_params.total_sz_lcl_hash_tbls = 0;
+	}
+	if (!lcl_bdy_dirty[IPA_RULE_NON_HASHABLE]) {
+		alloc_params.num_lcl_nhash_tbls = 0;
+		alloc_params.total_sz_lcl_nhash_tbls = 0;
+	}
+
+	if (ipa_generate_flt_hw_tbl_img(ip, &alloc_params, false)) {
 		IPAERR_RL("fail to generate FLT HW TBL image. IP %d\n", ip);
 		rc = -EFAULT;
 		goto prep_failed;
@@ -698,6 +1070,14 @@ int __ipa_commit_flt_v3(enum ipa_ip_type ip)
 			continue;
 		}
 
+		/* sram already holds the header entry of unchanged tables */
+		tbl = &ipa3_ctx->flt_tbl[i][ip];
+		if (!tbl->dirty && !lcl_bdy_dirty[IPA_RULE_HASHABLE] &&
+			!lcl_bdy_dirty[IPA_RULE_NON_HASHABLE]) {
+			hdr_idx++;
+			continue;
+		}
+
 		if (num_cmd + 1 >= entries) {
 			IPAERR("number of commands is out of range: IP = %d\n",
 				ip);
@@ -757,7 +1137,8 @@ int __ipa_commit_flt_v3(enum ipa_ip_type ip)
 		++hdr_idx;
 	}
 
-	if (lcl_nhash && alloc_params.num_lcl_nhash_tbls > 0) {
+	if (lcl_nhash && lcl_bdy_dirty[IPA_RULE_NON_HASHABLE] &&
+		alloc_params.num_lcl_nhash_tbls > 0) {
 		if (num_cmd >= entries) {
 			IPAERR("number of commands is out of range: IP = %d\n",
 				ip);
@@ -782,7 +1163,7 @@ int __ipa_commit_flt_v3(enum ipa_ip_type ip)
 		ipa3_init_imm_cmd_desc(&desc[num_cmd], cmd_pyld[num_cmd]);
 		++num_cmd;
 	}
-	if (lcl_hash) {
+	if (lcl_hash && lcl_bdy_dirty[IPA_RULE_HASHABLE]) {
 		if (num_cmd >= entries) {
 			IPAERR("number of commands is out of range: IP = %d\n",
 				ip);
@@ -829,6 +1210,17 @@ int __ipa_commit_flt_v3(enum ipa_ip_type ip)
 		desc_to_send += num_cmd_to_send;
 	}
 
+	lcl_bdy_dirty[IPA_RULE_HASHABLE] &= lcl_hash;
+	lcl_bdy_dirty[IPA_RULE_NON_HASHABLE] &= lcl_nhash;
+	ipa_flt_shadow_commit(ip, &alloc_params, lcl_bdy_dirty);
+
+	/* tables of skipped pipes stay dirty until their header is written */
+	for (i = 0; i < ipa3_ctx->ipa_num_pipes; i++) {
+		if (!ipa_is_ep_support_flt(i) || ipa_flt_skip_pipe_config(i))
+			continue;
+		ipa3_ctx->flt_tbl[i][ip].dirty = false;
+	}
+
 	IPADBG_LOW("Hashable HEAD\n");
 	IPA_DUMP_BUFF(alloc_params.hash_hdr.base,
 		alloc_params.hash_hdr.phys_base, alloc_params.hash_hdr.size);
@@ -854,6 +1246,8 @@ int __ipa_commit_flt_v3(enum ipa_ip_type ip)
 	__ipa_reap_sys_flt_tbls(ip, IPA_RULE_HASHABLE);
 	__ipa_reap_sys_flt_tbls(ip, IPA_RULE_NON_HASHABLE);
 
+	ipa_flt_check_commit(ip);
+
 fail_imm_cmd_construct:
 	for (i = 0 ; i < num_cmd ; i++)
 		ipahal_destroy_imm_cmd(cmd_pyld[i]);
@@ -1023,6 +1417,7 @@ static int __ipa_finish_flt_rule_add(struct ipa3_flt_tbl *tbl,
 	}
 	*rule_hdl = id;
 	entry->id = id;
+	tbl->dirty = true;
 	IPADBG_LOW("add flt rule rule_cnt=%d\n", tbl->rule_cnt);
 
 	return 0;
@@ -1140,6 +1535,7 @@ static int __ipa_del_flt_rule(u32 rule_hdl)
 
 	list_del(&entry->link);
 	entry->tbl->rule_cnt--;
+	entry->tbl->dirty = true;
 	if (entry->rt_tbl && !ipa3_check_idr_if_freed(entry->rt_tbl))
 		entry->rt_tbl->ref_cnt--;
 	IPADBG("del flt rule rule_cnt=%d rule_id=%d\n",
@@ -1150,6 +1546,7 @@ static int __ipa_del_flt_rule(u32 rule_hdl)
 		(entry->rule_id >= ipahal_get_low_rule_id()))
 		idr_remove(entry->tbl->rule_ids, entry->rule_id);
 
+	ipahal_fltrt_rule_bdy_cache_clear(&entry->bdy_cache);
 	kmem_cache_free(ipa3_ctx->flt_rule_cache, entry);
 
 	/* remove the handle from the database */
@@ -1187,10 +1584,12 @@ static int __ipa_mdfy_flt_rule(struct ipa_flt_rule_mdfy_i *frule,
 		entry->rt_tbl->ref_cnt++;
 	entry->hw_len = 0;
 	entry->prio = 0;
+	ipahal_fltrt_rule_bdy_cache_clear(&entry->bdy_cache);
 	if (frule->rule.enable_stats)
 		entry->cnt_idx = frule->rule.cnt_idx;
 	else
 		entry->cnt_idx = 0;
+	entry->tbl->dirty = true;
 
 	return 0;
 
@@ -1919,6 +2318,7 @@ int ipa3_reset_flt(enum ipa_ip_type ip, bool user_only)
 					entry->ipacm_installed) {
 				list_del(&entry->link);
 				entry->tbl->rule_cnt--;
+				entry->tbl->dirty = true;
 				if (entry->rt_tbl &&
 					(!ipa3_check_idr_if_freed(
 						entry->rt_tbl)))
@@ -1931,6 +2331,8 @@ int ipa3_reset_flt(enum ipa_ip_type ip, bool user_only)
 					idr_remove(entry->tbl->rule_ids,
 						rule_id);
 				entry->cookie = 0;
+				ipahal_fltrt_rule_bdy_cache_clear(
+					&entry->bdy_cache);
 				kmem_cache_free(ipa3_ctx->flt_rule_cache,
 								entry);
 
@@ -1952,6 +2354,30 @@ int ipa3_reset_flt(enum ipa_ip_type ip, bool user_only)
 	return 0;
 }
 
+/**
+ * ipa3_flt_set_tbls_dirty() - have the next commits regenerate all the
+ *  filtering tables
+ *
+ * Used when a routing table the rules point to went away under them, or
+ * the sram was reinitialized
+ *
+ * caller needs to hold any needed locks to ensure integrity
+ */
+void ipa3_flt_set_tbls_dirty(void)
+{
+	enum ipa_ip_type ip;
+	int i;
+
+	for (i = 0; i < ipa3_ctx->ipa_num_pipes; i++) {
+		if (!ipa_is_ep_support_flt(i))
+			continue;
+		for (ip = IPA_IP_v4; ip < IPA_IP_MAX; ip++)
+			ipa3_ctx->flt_tbl[i][ip].dirty = true;
+	}
+
+	ipa_flt_shadow_reset();
+}
+
 void ipa3_install_dflt_flt_rules(u32 ipa_ep_idx)
 {
 	struct ipa3_flt_tbl *tbl;
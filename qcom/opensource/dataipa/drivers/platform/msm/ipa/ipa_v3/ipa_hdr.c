@@ -1367,6 +1367,9 @@ int ipa3_reset_hdr(bool user_only)
 		}
 	}
 
+	/* routing rules may still point to the removed headers */
+	ipa3_rt_set_tbls_dirty();
+
 	IPADBG("reset hdr proc ctx\n");
 	list_for_each_entry_safe(
 		ctx_entry,
@@ -45,6 +45,9 @@ int ipa_hw_stats_init(void)
 
 	/* initialize stats here */
 	ipa3_ctx->hw_stats->enabled = true;
+	mutex_init(&ipa3_ctx->hw_stats->cache.lock);
+	seqcount_mutex_init(&ipa3_ctx->hw_stats->cache.seq,
+		&ipa3_ctx->hw_stats->cache.lock);
 
 	/* for IPA_HW_v5_0, reserved teth_stats sram for flt-tbls */
 	if (ipa3_ctx->ipa_hw_type == IPA_HW_v5_0)
@@ -674,46 +677,70 @@ destroy_init_pyld:
 	return ret;
 }
 
-int ipa_get_quota_stats(struct ipa_quota_stats_all *out)
+/**
+ * ipa_hw_stats_refresh() - pull quota and drop counters from hardware
+ *
+ * Both counter blocks are read and cleared by one immediate command batch
+ * and folded into the driver totals, which then become a new cache
+ * generation. Caller must hold the cache lock.
+ *
+ * Return: 0 on success, negative on failure
+ */
+static int ipa_hw_stats_refresh(void)
 {
-	int i;
-	int ret;
-	struct ipahal_stats_get_offset_quota get_offset = { { 0 } };
-	struct ipahal_stats_offset offset = { 0 };
+	struct ipa_hw_stats *hw_stats = ipa3_ctx->hw_stats;
+	struct ipa_hw_stats_cache *cache = &hw_stats->cache;
+	struct ipahal_stats_get_offset_quota quota_get = { { 0 } };
+	struct ipahal_stats_get_offset_drop drop_get = { { 0 } };
+	struct ipahal_stats_offset quota_ofst = { 0 };
+	struct ipahal_stats_offset drop_ofst = { 0 };
 	struct ipahal_imm_cmd_dma_shared_mem cmd = { 0 };
-	struct ipahal_imm_cmd_pyld *cmd_pyld[2];
+	struct ipahal_imm_cmd_pyld *cmd_pyld[3];
 	struct ipa_mem_buffer mem;
-	struct ipa3_desc desc[2];
-	struct ipahal_stats_quota_all *stats;
+	struct ipa3_desc desc[3];
+	struct ipahal_stats_quota_all *quota = NULL;
+	struct ipahal_stats_drop_all *drop = NULL;
+	struct ipa_hw_stats_snap *snap;
 	int num_cmd = 0;
+	int i;
+	int ret;
 
-	if (!(ipa3_ctx->hw_stats && ipa3_ctx->hw_stats->enabled))
-		return 0;
+	lockdep_assert_held(&cache->lock);
 
 	memset(desc, 0, sizeof(desc));
 	memset(cmd_pyld, 0, sizeof(cmd_pyld));
 
-	get_offset.init = ipa3_ctx->hw_stats->quota.init;
-	ret = ipahal_stats_get_offset(IPAHAL_HW_STATS_QUOTA, &get_offset,
-		&offset);
+	quota_get.init = hw_stats->quota.init;
+	ret = ipahal_stats_get_offset(IPAHAL_HW_STATS_QUOTA, &quota_get,
+		&quota_ofst);
 	if (ret) {
-		IPAERR("failed to get offset from hal %d\n", ret);
+		IPAERR("failed to get quota offset from hal %d\n", ret);
 		return ret;
 	}
 
-	IPADBG_LOW("offset = %d size = %d\n", offset.offset, offset.size);
+	drop_get.init = hw_stats->drop.init;
+	ret = ipahal_stats_get_offset(IPAHAL_HW_STATS_DROP, &drop_get,
+		&drop_ofst);
+	if (ret) {
+		IPAERR("failed to get drop offset from hal %d\n", ret);
+		return ret;
+	}
 
-	if (offset.size == 0)
+	IPADBG_LOW("quota offset = %d size = %d drop offset = %d size = %d\n",
+		quota_ofst.offset, quota_ofst.size,
+		drop_ofst.offset, drop_ofst.size);
+
+	mem.size = quota_ofst.size + drop_ofst.size;
+	if (mem.size == 0)
 		return 0;
 
-	mem.size = offset.size;
 	mem.base = dma_alloc_coherent(ipa3_ctx->pdev,
 		mem.size,
 		&mem.phys_base,
 		GFP_KERNEL);
 	if (!mem.base) {
-		IPAERR("fail to alloc DMA memory");
-		return ret;
+		IPAERR("fail to alloc DMA memory\n");
+		return -ENOMEM;
 	}
 
 	/* IC to close the coal frame before HPS Clear if coal is enabled */
@@ -733,19 +760,39 @@ int ipa_get_quota_stats(struct ipa_quota_stats_all *out)
 	cmd.clear_after_read = true;
 	cmd.skip_pipeline_clear = false;
 	cmd.pipeline_clear_options = IPAHAL_HPS_CLEAR;
-	cmd.size = mem.size;
-	cmd.system_addr = mem.phys_base;
-	cmd.local_addr = ipa3_ctx->smem_restricted_bytes +
-		IPA_MEM_PART(stats_quota_ap_ofst) + offset.offset;
-	cmd_pyld[num_cmd] = ipahal_construct_imm_cmd(
-		IPA_IMM_CMD_DMA_SHARED_MEM, &cmd, false);
-	if (!cmd_pyld[num_cmd]) {
-		IPAERR("failed to construct dma_shared_mem imm cmd\n");
-		ret = -ENOMEM;
-		goto free_dma_mem;
+
+	/* quota counters land first in the buffer, drop counters after */
+	if (quota_ofst.size) {
+		cmd.size = quota_ofst.size;
+		cmd.system_addr = mem.phys_base;
+		cmd.local_addr = ipa3_ctx->smem_restricted_bytes +
+			IPA_MEM_PART(stats_quota_ap_ofst) + quota_ofst.offset;
+		cmd_pyld[num_cmd] = ipahal_construct_imm_cmd(
+			IPA_IMM_CMD_DMA_SHARED_MEM, &cmd, false);
+		if (!cmd_pyld[num_cmd]) {
+			IPAERR("failed to construct dma_shared_mem imm cmd\n");
+			ret = -ENOMEM;
+			goto destroy_imm;
+		}
+		ipa3_init_imm_cmd_desc(&desc[num_cmd], cmd_pyld[num_cmd]);
+		++num_cmd;
+	}
+
+	if (drop_ofst.size) {
+		cmd.size = drop_ofst.size;
+		cmd.system_addr = mem.phys_base + quota_ofst.size;
+		cmd.local_addr = ipa3_ctx->smem_restricted_bytes +
+			IPA_MEM_PART(stats_drop_ofst) + drop_ofst.offset;
+		cmd_pyld[num_cmd] = ipahal_construct_imm_cmd(
+			IPA_IMM_CMD_DMA_SHARED_MEM, &cmd, false);
+		if (!cmd_pyld[num_cmd]) {
+			IPAERR("failed to construct dma_shared_mem imm cmd\n");
+			ret = -ENOMEM;
+			goto destroy_imm;
+		}
+		ipa3_init_imm_cmd_desc(&desc[num_cmd], cmd_pyld[num_cmd]);
+		++num_cmd;
 	}
-	ipa3_init_imm_cmd_desc(&desc[num_cmd], cmd_pyld[num_cmd]);
-	++num_cmd;
 
 	ret = ipa3_send_cmd(num_cmd, desc);
 	if (ret) {
@@ -753,17 +800,29 @@ int ipa_get_quota_stats(struct ipa_quota_stats_all *out)
 		goto destroy_imm;
 	}
 
-	stats = kzalloc(sizeof(*stats), GFP_KERNEL);
-	if (!stats) {
+	quota = kzalloc(sizeof(*quota), GFP_KERNEL);
+	drop = kzalloc(sizeof(*drop), GFP_KERNEL);
+	if (!quota || !drop) {
 		ret = -ENOMEM;
-		goto destroy_imm;
+		goto free_stats;
 	}
 
-	ret = ipahal_parse_stats(IPAHAL_HW_STATS_QUOTA,
-		&ipa3_ctx->hw_stats->quota.init, mem.base, stats);
-	if (ret) {
-		IPAERR("failed to parse stats (error %d)\n", ret);
-		goto free_stats;
+	if (quota_ofst.size) {
+		ret = ipahal_parse_stats(IPAHAL_HW_STATS_QUOTA,
+			&hw_stats->quota.init, mem.base, quota);
+		if (ret) {
+			IPAERR("failed to parse quota stats (error %d)\n", ret);
+			goto free_stats;
+		}
+	}
+
+	if (drop_ofst.size) {
+		ret = ipahal_parse_stats(IPAHAL_HW_STATS_DROP,
+			&hw_stats->drop.init, mem.base + quota_ofst.size, drop);
+		if (ret) {
+			IPAERR("failed to parse drop stats (error %d)\n", ret);
+			goto free_stats;
+		}
 	}
 
 	/*
@@ -771,6 +830,7 @@ int ipa_get_quota_stats(struct ipa_quota_stats_all *out)
 	 * the stats were read from hardware with clear_after_read meaning
 	 * hardware stats are 0 now
 	 */
+	write_seqcount_begin(&cache->seq);
 	for (i = 0; i < IPA_CLIENT_MAX; i++) {
 		int ep_idx = ipa3_get_ep_mapping(i);
 
@@ -780,34 +840,147 @@ int ipa_get_quota_stats(struct ipa_quota_stats_all *out)
 		if (ipa3_ctx->ep[ep_idx].client != i)
 			continue;
 
-		ipa3_ctx->hw_stats->quota.stats.client[i].num_ipv4_bytes +=
-			stats->stats[ep_idx].num_ipv4_bytes;
-		ipa3_ctx->hw_stats->quota.stats.client[i].num_ipv4_pkts +=
-			stats->stats[ep_idx].num_ipv4_pkts;
-		ipa3_ctx->hw_stats->quota.stats.client[i].num_ipv6_bytes +=
-			stats->stats[ep_idx].num_ipv6_bytes;
-		ipa3_ctx->hw_stats->quota.stats.client[i].num_ipv6_pkts +=
-			stats->stats[ep_idx].num_ipv6_pkts;
-	}
+		hw_stats->quota.stats.client[i].num_ipv4_bytes +=
+			quota->stats[ep_idx].num_ipv4_bytes;
+		hw_stats->quota.stats.client[i].num_ipv4_pkts +=
+			quota->stats[ep_idx].num_ipv4_pkts;
+		hw_stats->quota.stats.client[i].num_ipv6_bytes +=
+			quota->stats[ep_idx].num_ipv6_bytes;
+		hw_stats->quota.stats.client[i].num_ipv6_pkts +=
+			quota->stats[ep_idx].num_ipv6_pkts;
+
+		hw_stats->drop.stats.client[i].drop_byte_cnt +=
+			drop->stats[ep_idx].drop_byte_cnt;
+		hw_stats->drop.stats.client[i].drop_packet_cnt +=
+			drop->stats[ep_idx].drop_packet_cnt;
+	}
+
+	cache->gen++;
+	cache->stamp = jiffies;
+	snap = &cache->snap[cache->gen % IPA_HW_STATS_SNAP_NUM];
+	snap->gen = cache->gen;
+	snap->quota = hw_stats->quota.stats;
+	snap->drop = hw_stats->drop.stats;
+	write_seqcount_end(&cache->seq);
 
-	/* copy results to out parameter */
-	if (out)
-		*out = ipa3_ctx->hw_stats->quota.stats;
 	ret = 0;
 free_stats:
-	kfree(stats);
+	kfree(drop);
+	kfree(quota);
 destroy_imm:
 	for (i = 0; i < num_cmd; i++)
 		ipahal_destroy_imm_cmd(cmd_pyld[i]);
 free_dma_mem:
 	dma_free_coherent(ipa3_ctx->pdev, mem.size, mem.base, mem.phys_base);
 	return ret;
+}
+
+static bool ipa_hw_stats_cache_fresh(struct ipa_hw_stats_cache *cache)
+{
+	u32 fresh_ms = READ_ONCE(cache->fresh_ms);
+	unsigned int seq;
+	bool fresh;
 
+	if (!fresh_ms)
+		return false;
+
+	do {
+		seq = read_seqcount_begin(&cache->seq);
+		fresh = cache->gen && time_before(jiffies,
+			cache->stamp + msecs_to_jiffies(fresh_ms));
+	} while (read_seqcount_retry(&cache->seq, seq));
+
+	return fresh;
 }
 
-int ipa_reset_quota_stats(enum ipa_client_type client)
+/**
+ * ipa_hw_stats_cache_update() - make sure the cached totals are usable
+ *
+ * Totals younger than the freshness window are served as is. Otherwise
+ * one caller refreshes them from hardware while the others wait for the
+ * result instead of issuing their own reads.
+ *
+ * Return: 0 on success, negative on failure
+ */
+static int ipa_hw_stats_cache_update(void)
+{
+	struct ipa_hw_stats_cache *cache = &ipa3_ctx->hw_stats->cache;
+	unsigned int seq;
+	int ret = 0;
+
+	if (ipa_hw_stats_cache_fresh(cache))
+		return 0;
+
+	seq = raw_read_seqcount(&cache->seq);
+	mutex_lock(&cache->lock);
+	/* a refresh that completed while we waited is as good as our own */
+	if (raw_read_seqcount(&cache->seq) == seq)
+		ret = ipa_hw_stats_refresh();
+	mutex_unlock(&cache->lock);
+
+	return ret;
+}
+
+/**
+ * ipa_hw_stats_cache_reset() - clear part of the cached totals
+ * @stats: totals to clear, inside hw_stats->quota or hw_stats->drop
+ * @size: size of @stats
+ *
+ * Hardware is read first so counts accumulated before the reset are not
+ * attributed to the period after it. Past snapshots are dropped since
+ * deltas across a reset are meaningless.
+ *
+ * Return: 0 on success, negative on failure
+ */
+static int ipa_hw_stats_cache_reset(void *stats, size_t size)
 {
+	struct ipa_hw_stats_cache *cache = &ipa3_ctx->hw_stats->cache;
+	int i;
 	int ret;
+
+	mutex_lock(&cache->lock);
+	/* reading stats will reset them in hardware */
+	ret = ipa_hw_stats_refresh();
+	if (ret) {
+		IPAERR("ipa_hw_stats_refresh failed %d\n", ret);
+		goto unlock;
+	}
+
+	write_seqcount_begin(&cache->seq);
+	memset(stats, 0, size);
+	for (i = 0; i < IPA_HW_STATS_SNAP_NUM; i++)
+		cache->snap[i].gen = 0;
+	write_seqcount_end(&cache->seq);
+unlock:
+	mutex_unlock(&cache->lock);
+	return ret;
+}
+
+int ipa_get_quota_stats(struct ipa_quota_stats_all *out)
+{
+	struct ipa_hw_stats_cache *cache;
+	unsigned int seq;
+	int ret;
+
+	if (!(ipa3_ctx->hw_stats && ipa3_ctx->hw_stats->enabled))
+		return 0;
+
+	ret = ipa_hw_stats_cache_update();
+	if (ret || !out)
+		return ret;
+
+	/* copy results to out parameter */
+	cache = &ipa3_ctx->hw_stats->cache;
+	do {
+		seq = read_seqcount_begin(&cache->seq);
+		*out = ipa3_ctx->hw_stats->quota.stats;
+	} while (read_seqcount_retry(&cache->seq, seq));
+
+	return 0;
+}
+
+int ipa_reset_quota_stats(enum ipa_client_type client)
+{
 	struct ipa_quota_stats *stats;
 
 	if (!(ipa3_ctx->hw_stats && ipa3_ctx->hw_stats->enabled))
@@ -818,38 +991,21 @@ int ipa_reset_quota_stats(enum ipa_client_type client)
 		return -EINVAL;
 	}
 
-	/* reading stats will reset them in hardware */
-	ret = ipa_get_quota_stats(NULL);
-	if (ret) {
-		IPAERR("ipa_get_quota_stats failed %d\n", ret);
-		return ret;
-	}
-
 	/* reset driver's cache */
 	stats = &ipa3_ctx->hw_stats->quota.stats.client[client];
-	memset(stats, 0, sizeof(*stats));
-	return 0;
+	return ipa_hw_stats_cache_reset(stats, sizeof(*stats));
 }
 
 int ipa_reset_all_quota_stats(void)
 {
-	int ret;
 	struct ipa_quota_stats_all *stats;
 
 	if (!(ipa3_ctx->hw_stats && ipa3_ctx->hw_stats->enabled))
 		return 0;
 
-	/* reading stats will reset them in hardware */
-	ret = ipa_get_quota_stats(NULL);
-	if (ret) {
-		IPAERR("ipa_get_quota_stats failed %d\n", ret);
-		return ret;
-	}
-
 	/* reset driver's cache */
 	stats = &ipa3_ctx->hw_stats->quota.stats;
-	memset(stats, 0, sizeof(*stats));
-	return 0;
+	return ipa_hw_stats_cache_reset(stats, sizeof(*stats));
 }
 
 int ipa_init_teth_stats(struct ipa_teth_stats_endpoints *in)
@@ -2086,140 +2242,98 @@ fail_free_desc:
 
 int ipa_get_drop_stats(struct ipa_drop_stats_all *out)
 {
-	int i;
+	struct ipa_hw_stats_cache *cache;
+	unsigned int seq;
 	int ret;
-	struct ipahal_stats_get_offset_drop get_offset = { { 0 } };
-	struct ipahal_stats_offset offset = { 0 };
-	struct ipahal_imm_cmd_dma_shared_mem cmd = { 0 };
-	struct ipahal_imm_cmd_pyld *cmd_pyld[2];
-	struct ipa_mem_buffer mem;
-	struct ipa3_desc desc[2];
-	struct ipahal_stats_drop_all *stats;
-	int num_cmd = 0;
 
 	if (!(ipa3_ctx->hw_stats && ipa3_ctx->hw_stats->enabled))
 		return 0;
 
-	memset(desc, 0, sizeof(desc));
-	memset(cmd_pyld, 0, sizeof(cmd_pyld));
-
-	get_offset.init = ipa3_ctx->hw_stats->drop.init;
-	ret = ipahal_stats_get_offset(IPAHAL_HW_STATS_DROP, &get_offset,
-		&offset);
-	if (ret) {
-		IPAERR("failed to get offset from hal %d\n", ret);
+	ret = ipa_hw_stats_cache_update();
+	if (ret || !out)
 		return ret;
-	}
 
-	IPADBG_LOW("offset = %d size = %d\n", offset.offset, offset.size);
+	/* copy results to out parameter */
+	cache = &ipa3_ctx->hw_stats->cache;
+	do {
+		seq = read_seqcount_begin(&cache->seq);
+		*out = ipa3_ctx->hw_stats->drop.stats;
+	} while (read_seqcount_retry(&cache->seq, seq));
 
-	if (offset.size == 0)
-		return 0;
+	return 0;
+}
 
-	mem.size = offset.size;
-	mem.base = dma_alloc_coherent(ipa3_ctx->pdev,
-		mem.size,
-		&mem.phys_base,
-		GFP_KERNEL);
-	if (!mem.base) {
-		IPAERR("fail to alloc DMA memory\n");
-		return ret;
-	}
+int ipa_get_hw_stats_delta(u64 *gen, struct ipa_quota_stats_all *quota,
+	struct ipa_drop_stats_all *drop)
+{
+	struct ipa_hw_stats_cache *cache;
+	struct ipa_hw_stats_snap *base;
+	unsigned int seq;
+	u64 since, cur;
+	bool found;
+	int i;
+	int ret;
 
-	/* IC to close the coal frame before HPS Clear if coal is enabled */
-	if (ipa3_get_ep_mapping(IPA_CLIENT_APPS_WAN_COAL_CONS) !=
-		IPA_EP_NOT_ALLOCATED && !ipa3_ctx->ulso_wa) {
-		ipa_close_coal_frame(&cmd_pyld[num_cmd]);
-		if (!cmd_pyld[num_cmd]) {
-			IPAERR("failed to construct coal close IC\n");
-			ret = -ENOMEM;
-			goto free_dma_mem;
-		}
-		ipa3_init_imm_cmd_desc(&desc[num_cmd], cmd_pyld[num_cmd]);
-		++num_cmd;
-	}
+	if (!gen)
+		return -EINVAL;
 
-	cmd.is_read = true;
-	cmd.clear_after_read = true;
-	cmd.skip_pipeline_clear = false;
-	cmd.pipeline_clear_options = IPAHAL_HPS_CLEAR;
-	cmd.size = mem.size;
-	cmd.system_addr = mem.phys_base;
-	cmd.local_addr = ipa3_ctx->smem_restricted_bytes +
-		IPA_MEM_PART(stats_drop_ofst) + offset.offset;
-	cmd_pyld[num_cmd] = ipahal_construct_imm_cmd(
-		IPA_IMM_CMD_DMA_SHARED_MEM, &cmd, false);
-	if (!cmd_pyld[num_cmd]) {
-		IPAERR("failed to construct dma_shared_mem imm cmd\n");
-		ret = -ENOMEM;
-		goto destroy_imm;
-	}
-	ipa3_init_imm_cmd_desc(&desc[num_cmd], cmd_pyld[num_cmd]);
-	++num_cmd;
+	if (!(ipa3_ctx->hw_stats && ipa3_ctx->hw_stats->enabled))
+		return 0;
 
-	ret = ipa3_send_cmd(num_cmd, desc);
-	if (ret) {
-		IPAERR("failed to send immediate command (error %d)\n", ret);
-		goto destroy_imm;
-	}
+	ret = ipa_hw_stats_cache_update();
+	if (ret)
+		return ret;
 
-	stats = kzalloc(sizeof(*stats), GFP_KERNEL);
-	if (!stats) {
-		ret = -ENOMEM;
-		goto destroy_imm;
-	}
+	base = kzalloc(sizeof(*base), GFP_KERNEL);
+	if (!base)
+		return -ENOMEM;
 
-	ret = ipahal_parse_stats(IPAHAL_HW_STATS_DROP,
-		&ipa3_ctx->hw_stats->drop.init, mem.base, stats);
-	if (ret) {
-		IPAERR("failed to parse stats (error %d)\n", ret);
-		goto free_stats;
+	cache = &ipa3_ctx->hw_stats->cache;
+	since = *gen;
+	do {
+		seq = read_seqcount_begin(&cache->seq);
+		cur = cache->gen;
+		found = since &&
+			cache->snap[since % IPA_HW_STATS_SNAP_NUM].gen == since;
+		if (found)
+			*base = cache->snap[since % IPA_HW_STATS_SNAP_NUM];
+		if (quota)
+			*quota = ipa3_ctx->hw_stats->quota.stats;
+		if (drop)
+			*drop = ipa3_ctx->hw_stats->drop.stats;
+	} while (read_seqcount_retry(&cache->seq, seq));
+
+	*gen = cur;
+	if (!found) {
+		kfree(base);
+		return 1;
 	}
 
-	/*
-	 * update driver cache.
-	 * the stats were read from hardware with clear_after_read meaning
-	 * hardware stats are 0 now
-	 */
 	for (i = 0; i < IPA_CLIENT_MAX; i++) {
-		int ep_idx = ipa3_get_ep_mapping(i);
-
-		if (ep_idx == -1 || ep_idx >= ipa3_get_max_num_pipes())
-			continue;
-
-		if (ipa3_ctx->ep[ep_idx].client != i)
-			continue;
-
-		ipa3_ctx->hw_stats->drop.stats.client[i].drop_byte_cnt +=
-			stats->stats[ep_idx].drop_byte_cnt;
-		ipa3_ctx->hw_stats->drop.stats.client[i].drop_packet_cnt +=
-			stats->stats[ep_idx].drop_packet_cnt;
-	}
-
-
-	if (!out) {
-		ret = 0;
-		goto free_stats;
+		if (quota) {
+			quota->client[i].num_ipv4_bytes -=
+				base->quota.client[i].num_ipv4_bytes;
+			quota->client[i].num_ipv4_pkts -=
+				base->quota.client[i].num_ipv4_pkts;
+			quota->client[i].num_ipv6_bytes -=
+				base->quota.client[i].num_ipv6_bytes;
+			quota->client[i].num_ipv6_pkts -=
+				base->quota.client[i].num_ipv6_pkts;
+		}
+		if (drop) {
+			drop->client[i].drop_byte_cnt -=
+				base->drop.client[i].drop_byte_cnt;
+			drop->client[i].drop_packet_cnt -=
+				base->drop.client[i].drop_packet_cnt;
+		}
 	}
 
-	/* copy results to out parameter */
-	*out = ipa3_ctx->hw_stats->drop.stats;
-
-	ret = 0;
-free_stats:
-	kfree(stats);
-destroy_imm:
-	for (i = 0; i < num_cmd; i++)
-		ipahal_destroy_imm_cmd(cmd_pyld[i]);
-free_dma_mem:
-	dma_free_coherent(ipa3_ctx->pdev, mem.size, mem.base, mem.phys_base);
-	return ret;
-
+	kfree(base);
+	return 0;
 }
 
 int ipa_reset_drop_stats(enum ipa_client_type client)
 {
-	int ret;
 	struct ipa_drop_stats *stats;
 
 	if (!(ipa3_ctx->hw_stats && ipa3_ctx->hw_stats->enabled))
@@ -2230,38 +2344,21 @@ int ipa_reset_drop_stats(enum ipa_client_type client)
 		return -EINVAL;
 	}
 
-	/* reading stats will reset them in hardware */
-	ret = ipa_get_drop_stats(NULL);
-	if (ret) {
-		IPAERR("ipa_get_drop_stats failed %d\n", ret);
-		return ret;
-	}
-
 	/* reset driver's cache */
 	stats = &ipa3_ctx->hw_stats->drop.stats.client[client];
-	memset(stats, 0, sizeof(*stats));
-	return 0;
+	return ipa_hw_stats_cache_reset(stats, sizeof(*stats));
 }
 
 int ipa_reset_all_drop_stats(void)
 {
-	int ret;
 	struct ipa_drop_stats_all *stats;
 
 	if (!(ipa3_ctx->hw_stats && ipa3_ctx->hw_stats->enabled))
 		return 0;
 
-	/* reading stats will reset them in hardware */
-	ret = ipa_get_drop_stats(NULL);
-	if (ret) {
-		IPAERR("ipa_get_drop_stats failed %d\n", ret);
-		return ret;
-	}
-
 	/* reset driver's cache */
 	stats = &ipa3_ctx->hw_stats->drop.stats;
-	memset(stats, 0, sizeof(*stats));
-	return 0;
+	return ipa_hw_stats_cache_reset(stats, sizeof(*stats));
 }
 
 
@@ -2793,6 +2890,102 @@ bail:
 	return ret;
 }
 
+/* generation the next read of the delta file reports counters since */
+static u64 dbg_delta_gen;
+
+static ssize_t ipa_debugfs_set_delta_gen(struct file *file,
+	const char __user *ubuf, size_t count, loff_t *ppos)
+{
+	u64 gen;
+	int ret;
+
+	ret = kstrtou64_from_user(ubuf, count, 0, &gen);
+	if (ret)
+		return ret;
+
+	mutex_lock(&ipa3_ctx->lock);
+	dbg_delta_gen = gen;
+	mutex_unlock(&ipa3_ctx->lock);
+
+	return count;
+}
+
+static ssize_t ipa_debugfs_print_delta_stats(struct file *file,
+	char __user *ubuf, size_t count, loff_t *ppos)
+{
+	struct ipa_quota_stats_all *quota;
+	struct ipa_drop_stats_all *drop;
+	int nbytes = 0;
+	int i, ep_idx, reg_idx;
+	u64 gen;
+	int res;
+
+	if (!(ipa3_ctx->hw_stats && ipa3_ctx->hw_stats->enabled))
+		return 0;
+
+	/* the whole report is built on the first read of an open file */
+	if (*ppos)
+		return 0;
+
+	quota = kzalloc(sizeof(*quota), GFP_KERNEL);
+	drop = kzalloc(sizeof(*drop), GFP_KERNEL);
+	if (!quota || !drop) {
+		res = -ENOMEM;
+		goto free;
+	}
+
+	mutex_lock(&ipa3_ctx->lock);
+	gen = dbg_delta_gen;
+	res = ipa_get_hw_stats_delta(&gen, quota, drop);
+	if (res < 0) {
+		mutex_unlock(&ipa3_ctx->lock);
+		goto free;
+	}
+
+	nbytes += scnprintf(dbg_buff + nbytes, IPA_MAX_MSG_LEN - nbytes,
+		"gen=%llu since=%llu %s\n\n", gen, res ? 0 : dbg_delta_gen,
+		res ? "totals" : "delta");
+	/* next read reports what happened after this one */
+	dbg_delta_gen = gen;
+
+	for (i = 0; i < IPA_CLIENT_MAX; i++) {
+		ep_idx = ipa3_get_ep_mapping(i);
+		if (ep_idx == -1)
+			continue;
+
+		if (IPA_CLIENT_IS_TEST(i))
+			continue;
+
+		reg_idx = ipahal_get_ep_reg_idx(ep_idx);
+		if (ipa3_ctx->hw_stats->quota.init.enabled_bitmask[reg_idx] &
+			ipahal_get_ep_bit(ep_idx))
+			nbytes += scnprintf(dbg_buff + nbytes,
+				IPA_MAX_MSG_LEN - nbytes,
+				"%s: ipv4_bytes=%llu ipv6_bytes=%llu ipv4_pkts=%u ipv6_pkts=%u\n",
+				ipa_clients_strings[i],
+				quota->client[i].num_ipv4_bytes,
+				quota->client[i].num_ipv6_bytes,
+				quota->client[i].num_ipv4_pkts,
+				quota->client[i].num_ipv6_pkts);
+
+		if (IPA_CLIENT_IS_CONS(i) &&
+			(ipa3_ctx->hw_stats->drop.init.enabled_bitmask[reg_idx] &
+			ipahal_get_ep_bit(ep_idx)))
+			nbytes += scnprintf(dbg_buff + nbytes,
+				IPA_MAX_MSG_LEN - nbytes,
+				"%s: drop_byte_cnt=%u drop_packet_cnt=%u\n",
+				ipa_clients_strings[i],
+				drop->client[i].drop_byte_cnt,
+				drop->client[i].drop_packet_cnt);
+	}
+	res = simple_read_from_buffer(ubuf, count, ppos, dbg_buff, nbytes);
+	mutex_unlock(&ipa3_ctx->lock);
+free:
+	kfree(drop);
+	kfree(quota);
+	return res;
+}
+
 static const struct file_operations ipa3_quota_ops = {
 	.read = ipa_debugfs_print_quota_stats,
 	.write = ipa_debugfs_reset_quota_stats,
@@ -2817,6 +3010,11 @@ static const struct file_operations ipa3_enable_drop_ops = {
 	.write = ipa_debugfs_enable_disable_drop_stats,
 };
 
+static const struct file_operations ipa3_delta_ops = {
+	.read = ipa_debugfs_print_delta_stats,
+	.write = ipa_debugfs_set_delta_gen,
+};
+
 int ipa_debugfs_init_stats(struct dentry *parent)
 {
 	const mode_t read_write_mode = 0664;
@@ -2868,6 +3066,16 @@ int ipa_debugfs_init_stats(struct dentry *parent)
 		goto fail;
 	}
 
+	file = debugfs_create_file("delta", read_write_mode, dent, NULL,
+		&ipa3_delta_ops);
+	if (IS_ERR_OR_NULL(file)) {
+		IPAERR("fail to create file %s\n", "delta");
+		goto fail;
+	}
+
+	debugfs_create_u32("cache_fresh_ms", read_write_mode, dent,
+		&ipa3_ctx->hw_stats->cache.fresh_ms);
+
 	return 0;
 fail:
 	debugfs_remove_recursive(dent);
@@ -36,6 +36,7 @@
 #include "ipa_common_i.h"
 #include "ipa_uc_offload_i.h"
 #include "ipa_pm.h"
+#include "ipa_dim.h"
 #include "ipa_defs.h"
 #include <linux/mailbox_client.h>
 #include <linux/mailbox/qmp.h>
@@ -131,6 +132,7 @@ enum {
 
 #define IPA_PAGE_POLL_DEFAULT_THRESHOLD 15
 #define IPA_PAGE_POLL_THRESHOLD_MAX 30
+#define IPA_PAGE_REAP_BUDGET 2
 
 #define NTN3_CLIENTS_NUM 2
 
@@ -770,6 +772,7 @@ struct ipa_rt_rule_add_ext_i {
  * @rule_id: rule 10bit ID to be returned in packet status
  * @cnt_idx: stats counter index
  * @ipacm_installed: indicate if installed by ipacm
+ * @bdy_cache: H/W rule body generated on the last commit
  */
 struct ipa3_flt_entry {
 	struct list_head link;
@@ -783,6 +786,7 @@ struct ipa3_flt_entry {
 	u16 rule_id;
 	u8 cnt_idx;
 	bool ipacm_installed;
+	struct ipahal_fltrt_rule_bdy_cache bdy_cache;
 };
 
 /**
@@ -801,6 +805,7 @@ struct ipa3_flt_entry {
  * @prev_mem: previous routing table block in sys memory
  * @id: routing table id
  * @rule_ids: common idr structure that holds the rule_id for each rule
+ * @dirty: rules were changed since the table was last committed
  */
 struct ipa3_rt_tbl {
 	struct list_head link;
@@ -817,6 +822,7 @@ struct ipa3_rt_tbl {
 	struct ipa_mem_buffer prev_mem[IPA_RULE_TYPE_MAX];
 	int id;
 	struct idr *rule_ids;
+	bool dirty;
 };
 
 /**
@@ -945,6 +951,7 @@ struct ipa3_hdr_proc_ctx_tbl {
  * @rule_ids: common idr structure that holds the rule_id for each rule
  * @force_sys: flag indicating if filter table is forced to be
 			located in system memory
+ * @dirty: rules were changed since the table was last committed
  */
 struct ipa3_flt_tbl {
 	struct list_head head_flt_rule_list;
@@ -956,6 +963,7 @@ struct ipa3_flt_tbl {
 	bool sticky_rear;
 	struct idr *rule_ids;
 	bool force_sys[IPA_RULE_TYPE_MAX];
+	bool dirty;
 };
 
 struct ipa3_flt_tbl_nhash_lcl {
@@ -979,6 +987,7 @@ struct ipa3_flt_tbl_nhash_lcl {
  * @rule_id_valid: indicate if rule_id_valid valid or not?
  * @cnt_idx: stats counter index
  * @ipacm_installed: indicate if installed by ipacm
+ * @bdy_cache: H/W rule body generated on the last commit
  */
 struct ipa3_rt_entry {
 	struct list_head link;
@@ -994,6 +1003,7 @@ struct ipa3_rt_entry {
 	u16 rule_id_valid;
 	u8 cnt_idx;
 	bool ipacm_installed;
+	struct ipahal_fltrt_rule_bdy_cache bdy_cache;
 };
 
 /**
@@ -1001,11 +1011,13 @@ struct ipa3_rt_entry {
  * @head_rt_tbl_list: collection of routing tables
  * @tbl_cnt: number of routing tables
  * @rule_ids: idr structure that holds the rule_id for each rule
+ * @dirty: the local bodies need rewriting, e.g. a table was removed
  */
 struct ipa3_rt_tbl_set {
 	struct list_head head_rt_tbl_list;
 	u32 tbl_cnt;
 	struct idr rule_ids;
+	bool dirty;
 };
 
 /**
@@ -1175,8 +1187,16 @@ struct ipa3_repl_ctx {
 	atomic_t pending;
 };
 
+/**
+ * struct ipa3_page_repl_ctx - page recycling pool
+ * @page_repl_head: pages handed to the stack, oldest first
+ * @page_free_head: pages known to be released by the stack
+ * @capacity: number of pages owned by the pool
+ * @pending: replenish pending flag
+ */
 struct ipa3_page_repl_ctx {
 	struct list_head page_repl_head;
+	struct list_head page_free_head;
 	u32 capacity;
 	atomic_t pending;
 };
@@ -1198,6 +1218,7 @@ struct ipa3_page_repl_ctx {
  * @buff_size: rx packet length
  * @page_order: page order of the rx pipe based on the ioctl version
  * @ext_ioctl_v2: specifies if it's new version of ingress/egress ioctl
+ * @dim: adaptive interrupt moderation state of the NAPI rx path
  *
  * IPA context specific to the GPI pipes a.k.a LAN IN/OUT and WAN
  */
@@ -1246,6 +1267,7 @@ struct ipa3_sys_context {
 	struct ipa3_sys_context *common_sys;
 	atomic_t page_avilable;
 	u32 napi_sort_page_thrshld_cnt;
+	struct ipa3_dim dim;
 
 	/* ordering is important - mutable fields go above */
 	struct ipa3_ep_context *ep;
@@ -1579,6 +1601,8 @@ struct ipa3_page_recycle_stats {
 	u64 total_replenished;
 	u64 page_recycled;
 	u64 tmp_alloc;
+	u64 page_reaped;
+	u64 reap_busy;
 };
 
 struct ipa3_stats {
@@ -1618,6 +1642,8 @@ struct ipa3_stats {
 	u64 num_sort_tasklet_sched[3];
 	u64 num_of_times_wq_reschd;
 	u64 page_recycle_cnt_in_tasklet;
+	u64 fltrt_bdy_cache_hit;
+	u64 fltrt_bdy_cache_miss;
 };
 
 /* offset for each stats */
@@ -1948,12 +1974,45 @@ struct ipa_hw_stats_drop {
 	struct ipa_drop_stats_all stats;
 };
 
+#define IPA_HW_STATS_SNAP_NUM 4
+
+/**
+ * struct ipa_hw_stats_snap - quota and drop totals of one cache generation
+ * @gen: generation the totals belong to, 0 if the slot is unused
+ * @quota: quota totals
+ * @drop: drop totals
+ */
+struct ipa_hw_stats_snap {
+	u64 gen;
+	struct ipa_quota_stats_all quota;
+	struct ipa_drop_stats_all drop;
+};
+
+/**
+ * struct ipa_hw_stats_cache - cached quota and drop totals
+ * @lock: serializes hardware reads and resets
+ * @seq: lets readers copy the totals without taking @lock
+ * @gen: generation of the current totals, bumped on every hardware read
+ * @stamp: jiffies of the last hardware read
+ * @fresh_ms: totals younger than this are served without a hardware read
+ * @snap: totals of the last generations, used for delta queries
+ */
+struct ipa_hw_stats_cache {
+	struct mutex lock;
+	seqcount_mutex_t seq;
+	u64 gen;
+	unsigned long stamp;
+	u32 fresh_ms;
+	struct ipa_hw_stats_snap snap[IPA_HW_STATS_SNAP_NUM];
+};
+
 struct ipa_hw_stats {
 	bool enabled;
 	struct ipa_hw_stats_quota quota;
 	struct ipa_hw_stats_teth teth;
 	struct ipa_hw_stats_flt_rt flt_rt;
 	struct ipa_hw_stats_drop drop;
+	struct ipa_hw_stats_cache cache;
 	bool teth_stats_enabled;
 };
 
@@ -2551,6 +2610,8 @@ struct ipa3_context {
 	void *per_stats_smem_va;
 	u32 ipa_max_napi_sort_page_thrshld;
 	u32 page_wq_reschd_time;
+	bool ipa_dim_enable;
+	bool lan_rx_zero_copy;
 	struct list_head minidump_list_head;
 	bool is_dual_pine_config;
 	struct workqueue_struct *collect_recycle_stats_wq;
@@ -3031,6 +3092,8 @@ int ipa3_put_rt_tbl(u32 rt_tbl_hdl);
 
 int ipa3_query_rt_index(struct ipa_ioc_get_rt_tbl_indx *in);
 
+void ipa3_rt_set_tbls_dirty(void);
+
 int ipa3_mdfy_rt_rule(struct ipa_ioc_mdfy_rt_rule *rules);
 
 int ipa3_mdfy_rt_rule_v2(struct ipa_ioc_mdfy_rt_rule_v2 *rules);
@@ -3061,6 +3124,8 @@ int ipa3_commit_flt(enum ipa_ip_type ip);
 
 int ipa3_reset_flt(enum ipa_ip_type ip, bool user_only);
 
+void ipa3_flt_set_tbls_dirty(void);
+
 int ipa_flt_sram_set_client_prio_high(enum ipa_client_type client);
 
 /*
@@ -3331,6 +3396,7 @@ int ipa3_controller_static_bind(struct ipa3_controller *controller,
 int ipa3_cfg_route(struct ipahal_reg_route *route);
 int ipa3_send_cmd_timeout(u16 num_desc, struct ipa3_desc *descr, u32 timeout);
 int ipa3_send_cmd(u16 num_desc, struct ipa3_desc *descr);
+u32 ipa3_send_cmd_max_desc(void);
 int ipa3_cfg_filter(u32 disable);
 int ipa3_straddle_boundary(u32 start, u32 end, u32 boundary);
 struct ipa3_context *ipa3_get_ctx(void);
@@ -3510,6 +3576,19 @@ int ipa_reset_drop_stats(enum ipa_client_type client);
 
 int ipa_reset_all_drop_stats(void);
 
+/**
+ * ipa_get_hw_stats_delta() - quota and drop counters since a generation
+ * @gen: in: generation returned by a previous call, 0 for none;
+ *	out: generation of the returned counters
+ * @quota: filled with the quota counters, may be NULL
+ * @drop: filled with the drop counters, may be NULL
+ *
+ * Return: 0 if deltas since @gen were returned, 1 if @gen is too old or
+ *	unknown and the totals were returned instead, negative on failure
+ */
+int ipa_get_hw_stats_delta(u64 *gen, struct ipa_quota_stats_all *quota,
+	struct ipa_drop_stats_all *drop);
+
 int ipa_init_teth_stats(struct ipa_teth_stats_endpoints *in);
 
 int ipa_get_teth_stats(void);
@@ -38,7 +38,12 @@
 
 #define IPA_NAT_MAX_NUM_OF_INIT_CMD_DESC 4
 #define IPA_IPV6CT_MAX_NUM_OF_INIT_CMD_DESC 3
-#define IPA_MAX_NUM_OF_TABLE_DMA_CMD_DESC 5
+/*
+ * Max DMA entries in one table DMA command, so a batch of rule
+ * adds/deletes can be posted by user space at once. Commands longer
+ * than one HW transaction are sent in chunks.
+ */
+#define IPA_MAX_NUM_OF_TABLE_DMA_CMD_ENTRIES 60
 
 /*
  * The base table max entries is limited by index into table 13 bits number.
@@ -1944,16 +1949,17 @@ int ipa3_table_dma_cmd(
 	enum ipahal_imm_cmd_name cmd_name = IPA_IMM_CMD_NAT_DMA;
 
 	struct ipahal_imm_cmd_table_dma cmd;
-	struct ipahal_imm_cmd_pyld *cmd_pyld[IPA_MAX_NUM_OF_TABLE_DMA_CMD_DESC];
-	struct ipa3_desc desc[IPA_MAX_NUM_OF_TABLE_DMA_CMD_DESC];
+	struct ipahal_imm_cmd_pyld **cmd_pyld;
+	struct ipa3_desc *desc;
 
-	uint8_t cnt, num_cmd = 0;
+	uint8_t cnt, first, last, num_cmd = 0;
 
 	int result = 0;
 	int i;
 	struct ipahal_reg_valmask valmask;
 	struct ipahal_imm_cmd_register_write reg_write_coal_close;
-	int max_dma_table_cmds = IPA_MAX_NUM_OF_TABLE_DMA_CMD_DESC;
+	bool coal_close;
+	u32 max_desc, num_prefix;
 
 	IPADBG("In\n");
 
@@ -1976,19 +1982,9 @@ int ipa3_table_dma_cmd(
 	IPADBG("nmi(%s)\n", ipa3_nat_mem_in_as_str(dma->mem_type));
 
 	memset(&cmd, 0, sizeof(cmd));
-	memset(cmd_pyld, 0, sizeof(cmd_pyld));
-	memset(desc, 0, sizeof(desc));
-
-	/**
-	 * We use a descriptor for closing coalsceing endpoint
-	 * by immediate command. So, DMA entries should be less than
-	 * IPA_MAX_NUM_OF_TABLE_DMA_CMD_DESC - 1 to overcome
-	 * buffer overflow of ipa3_desc array.
-	 */
-	if (ipa3_get_ep_mapping(IPA_CLIENT_APPS_WAN_COAL_CONS) != -1)
-		max_dma_table_cmds -= 1;
 
-	if (!dma->entries || dma->entries > (max_dma_table_cmds - 1)) {
+	if (!dma->entries ||
+		dma->entries > IPA_MAX_NUM_OF_TABLE_DMA_CMD_ENTRIES) {
 		IPAERR_RL("Invalid number of entries %d\n",
 			dma->entries);
 		result = -EPERM;
@@ -2007,51 +2003,32 @@ int ipa3_table_dma_cmd(
 		}
 	}
 
-	/* IC to close the coal frame before HPS Clear if coal is enabled */
-	if (ipa3_get_ep_mapping(IPA_CLIENT_APPS_WAN_COAL_CONS) != -1
-		&& !ipa3_ctx->ulso_wa) {
-		u32 offset = 0;
-
-		i = ipa3_get_ep_mapping(IPA_CLIENT_APPS_WAN_COAL_CONS);
-		reg_write_coal_close.skip_pipeline_clear = false;
-		reg_write_coal_close.pipeline_clear_options = IPAHAL_HPS_CLEAR;
-		if (ipa3_ctx->ipa_hw_type < IPA_HW_v5_0)
-			offset = ipahal_get_reg_ofst(
-				IPA_AGGR_FORCE_CLOSE);
-		else
-			offset = ipahal_get_ep_reg_offset(
-				IPA_AGGR_FORCE_CLOSE_n, i);
-		reg_write_coal_close.offset = offset;
-		ipahal_get_aggr_force_close_valmask(i, &valmask);
-		reg_write_coal_close.value = valmask.val;
-		reg_write_coal_close.value_mask = valmask.mask;
-		cmd_pyld[num_cmd] = ipahal_construct_imm_cmd(
-			IPA_IMM_CMD_REGISTER_WRITE,
-			&reg_write_coal_close, false);
-		if (!cmd_pyld[num_cmd]) {
-			IPAERR("failed to construct coal close IC\n");
-			result = -ENOMEM;
-			goto destroy_imm_cmd;
-		}
-		ipa3_init_imm_cmd_desc(&desc[num_cmd], cmd_pyld[num_cmd]);
-		++num_cmd;
-	}
-
 	/*
-	 * NO-OP IC for ensuring that IPA pipeline is empty
+	 * Every transaction starts with the NOP and, if coal is enabled,
+	 * the coal close descriptor. The DMA entries fill the rest of
+	 * what one ipa3_send_cmd() can take.
 	 */
-	cmd_pyld[num_cmd] =
-		ipahal_construct_nop_imm_cmd(false, IPAHAL_HPS_CLEAR, false);
-
-	if (!cmd_pyld[num_cmd]) {
-		IPAERR("Failed to construct NOP imm cmd\n");
-		result = -ENOMEM;
-		goto destroy_imm_cmd;
+	coal_close = ipa3_get_ep_mapping(IPA_CLIENT_APPS_WAN_COAL_CONS) != -1
+		&& !ipa3_ctx->ulso_wa;
+	num_prefix = coal_close ? 2 : 1;
+	max_desc = min_t(u32, ipa3_send_cmd_max_desc(),
+		num_prefix + dma->entries);
+
+	if (max_desc <= num_prefix) {
+		IPAERR("No room for table_dma commands, max desc %u\n",
+			max_desc);
+		result = -EPERM;
+		goto bail;
 	}
 
-	ipa3_init_imm_cmd_desc(&desc[num_cmd], cmd_pyld[num_cmd]);
+	cmd_pyld = kcalloc(max_desc, sizeof(*cmd_pyld), GFP_KERNEL);
+	desc = kcalloc(max_desc, sizeof(*desc), GFP_KERNEL);
 
-	++num_cmd;
+	if (!cmd_pyld || !desc) {
+		IPAERR("Failed to allocate table_dma descriptors\n");
+		result = -ENOMEM;
+		goto free_desc;
+	}
 
 	/*
 	 * NAT_DMA was renamed to TABLE_DMA starting from IPAv4
@@ -2059,18 +2036,55 @@ int ipa3_table_dma_cmd(
 	if (ipa3_ctx->ipa_hw_type >= IPA_HW_v4_0)
 		cmd_name = IPA_IMM_CMD_TABLE_DMA;
 
-	for (cnt = 0; cnt < dma->entries; ++cnt) {
-
-		cmd.table_index = dma->dma[cnt].table_index;
-		cmd.base_addr   = dma->dma[cnt].base_addr;
-		cmd.offset      = dma->dma[cnt].offset;
-		cmd.data        = dma->dma[cnt].data;
+	/*
+	 * The chunks are sent in order and each one waits for its ACK, so
+	 * the entries land in the order user space gave them
+	 */
+	for (first = 0; first < dma->entries; first = last) {
+		last = min_t(u32, dma->entries,
+			first + max_desc - num_prefix);
+		num_cmd = 0;
+		memset(desc, 0, max_desc * sizeof(*desc));
+
+		/* IC to close the coal frame before HPS Clear */
+		if (coal_close) {
+			u32 offset = 0;
+
+			i = ipa3_get_ep_mapping(IPA_CLIENT_APPS_WAN_COAL_CONS);
+			reg_write_coal_close.skip_pipeline_clear = false;
+			reg_write_coal_close.pipeline_clear_options =
+				IPAHAL_HPS_CLEAR;
+			if (ipa3_ctx->ipa_hw_type < IPA_HW_v5_0)
+				offset = ipahal_get_reg_ofst(
+					IPA_AGGR_FORCE_CLOSE);
+			else
+				offset = ipahal_get_ep_reg_offset(
+					IPA_AGGR_FORCE_CLOSE_n, i);
+			reg_write_coal_close.offset = offset;
+			ipahal_get_aggr_force_close_valmask(i, &valmask);
+			reg_write_coal_close.value = valmask.val;
+			reg_write_coal_close.value_mask = valmask.mask;
+			cmd_pyld[num_cmd] = ipahal_construct_imm_cmd(
+				IPA_IMM_CMD_REGISTER_WRITE,
+				&reg_write_coal_close, false);
+			if (!cmd_pyld[num_cmd]) {
+				IPAERR("failed to construct coal close IC\n");
+				result = -ENOMEM;
+				goto destroy_imm_cmd;
+			}
+			ipa3_init_imm_cmd_desc(&desc[num_cmd],
+				cmd_pyld[num_cmd]);
+			++num_cmd;
+		}
 
-		cmd_pyld[num_cmd] =
-			ipahal_construct_imm_cmd(cmd_name, &cmd, false);
+		/*
+		 * NO-OP IC for ensuring that IPA pipeline is empty
+		 */
+		cmd_pyld[num_cmd] = ipahal_construct_nop_imm_cmd(
+			false, IPAHAL_HPS_CLEAR, false);
 
 		if (!cmd_pyld[num_cmd]) {
-			IPAERR_RL("Fail to construct table_dma imm cmd\n");
+			IPAERR("Failed to construct NOP imm cmd\n");
 			result = -ENOMEM;
 			goto destroy_imm_cmd;
 		}
@@ -2078,17 +2092,50 @@ int ipa3_table_dma_cmd(
 		ipa3_init_imm_cmd_desc(&desc[num_cmd], cmd_pyld[num_cmd]);
 
 		++num_cmd;
-	}
 
-	result = ipa3_send_cmd(num_cmd, desc);
+		for (cnt = first; cnt < last; ++cnt) {
 
-	if (result)
-		IPAERR("Fail to send table_dma immediate command\n");
+			cmd.table_index = dma->dma[cnt].table_index;
+			cmd.base_addr   = dma->dma[cnt].base_addr;
+			cmd.offset      = dma->dma[cnt].offset;
+			cmd.data        = dma->dma[cnt].data;
+
+			cmd_pyld[num_cmd] =
+				ipahal_construct_imm_cmd(cmd_name, &cmd, false);
+
+			if (!cmd_pyld[num_cmd]) {
+				IPAERR_RL("Fail to construct table_dma imm cmd\n");
+				result = -ENOMEM;
+				goto destroy_imm_cmd;
+			}
+
+			ipa3_init_imm_cmd_desc(&desc[num_cmd],
+				cmd_pyld[num_cmd]);
+
+			++num_cmd;
+		}
+
+		result = ipa3_send_cmd(num_cmd, desc);
+
+		if (result) {
+			IPAERR("Fail to send table_dma immediate command\n");
+			goto destroy_imm_cmd;
+		}
+
+		for (cnt = 0; cnt < num_cmd; ++cnt)
+			ipahal_destroy_imm_cmd(cmd_pyld[cnt]);
+	}
+
+	num_cmd = 0;
 
 destroy_imm_cmd:
 	for (cnt = 0; cnt < num_cmd; ++cnt)
 		ipahal_destroy_imm_cmd(cmd_pyld[cnt]);
 
+free_desc:
+	kfree(desc);
+	kfree(cmd_pyld);
+
 bail:
 	IPADBG("Out\n");
 
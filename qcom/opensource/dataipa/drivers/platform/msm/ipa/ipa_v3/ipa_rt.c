@@ -124,6 +124,15 @@ static int ipa_generate_rt_hw_rule(enum ipa_ip_type ip,
 	gen_params.id = entry->rule_id;
 	gen_params.rule = (const struct ipa_rt_rule_i *)&entry->rule;
 	gen_params.cnt_idx = entry->cnt_idx;
+	gen_params.bdy_cache = &entry->bdy_cache;
+
+	/* account once per rule per commit, on the sizing pass */
+	if (!buf) {
+		if (entry->bdy_cache.bdy)
+			ipa3_ctx->stats.fltrt_bdy_cache_hit++;
+		else
+			ipa3_ctx->stats.fltrt_bdy_cache_miss++;
+	}
 
 	res = ipahal_rt_generate_hw_rule(&gen_params, &entry->hw_len, buf);
 	if (res)
@@ -132,16 +141,82 @@ static int ipa_generate_rt_hw_rule(enum ipa_ip_type ip,
 	return res;
 }
 
+#ifdef CONFIG_IPA_DEBUG
+/**
+ * ipa_rt_sys_tbl_img_match() - check that the current body of a sys
+ *  table is what a full rebuild would generate
+ * @ip: the ip address family type
+ * @tbl: the rt tbl to check
+ * @rlt: the type of the rules to check (hashable or non-hashable)
+ *
+ * Returns: true if the current body matches, false otherwise
+ *
+ * caller needs to hold any needed locks to ensure integrity
+ */
+static bool ipa_rt_sys_tbl_img_match(enum ipa_ip_type ip,
+	struct ipa3_rt_tbl *tbl, enum ipa_rule_type rlt)
+{
+	struct ipa3_rt_entry *entry;
+	u32 size = tbl->curr_mem[rlt].size;
+	u32 ofst = 0;
+	bool match = false;
+	u8 *buf;
+
+	if (!tbl->curr_mem[rlt].phys_base) {
+		IPAERR("rt tbl %s ip %d rlt %d has no sys body\n",
+			tbl->name, ip, rlt);
+		return false;
+	}
+
+	buf = kzalloc(size, GFP_KERNEL);
+	if (!buf)
+		return false;
+
+	list_for_each_entry(entry, &tbl->head_rt_rule_list, link) {
+		if (IPA_RT_GET_RULE_TYPE(entry) != rlt)
+			continue;
+		if (ipa_generate_rt_hw_rule(ip, entry, NULL) ||
+			ofst + entry->hw_len > size ||
+			ipa_generate_rt_hw_rule(ip, entry, buf + ofst))
+			goto bail;
+		ofst += entry->hw_len;
+	}
+
+	match = ofst == tbl->sz[rlt] - ipahal_get_hw_tbl_hdr_width() &&
+		!memcmp(buf, tbl->curr_mem[rlt].base, size);
+	if (!match)
+		IPAERR("rt tbl %s ip %d rlt %d differs from full rebuild\n",
+			tbl->name, ip, rlt);
+
+bail:
+	kfree(buf);
+	return match;
+}
+#else
+static inline bool ipa_rt_sys_tbl_img_match(enum ipa_ip_type ip,
+	struct ipa3_rt_tbl *tbl, enum ipa_rule_type rlt)
+{
+	return true;
+}
+#endif
+
 /**
  * ipa_translate_rt_tbl_to_hw_fmt() - translate the routing driver structures
  *  (rules and tables) to HW format and fill it in the given buffers
  * @ip: the ip address family type
  * @rlt: the type of the rules to translate (hashable or non-hashable)
- * @base: the rules body buffer to be filled
+ * @base: the rules body buffer to be filled, NULL if the local bodies
+ *  are unchanged and only their offsets are needed for the header
  * @hdr: the rules header (addresses/offsets) buffer to be filled
  * @body_ofst: the offset of the rules body from the rules header at
  *  ipa sram (for local body usage)
  * @apps_start_idx: the first rt table index of apps tables
+ * @verify: check the current sys bodies instead of replacing them
+ *
+ * Sys tables that were not changed since the last commit keep their
+ * current body, only their address is written to the header. With
+ * @verify, every sys table keeps it, after its body was checked
+ * against a freshly generated one.
  *
  * Returns: 0 on success, negative on failure
  *
@@ -150,7 +225,7 @@ static int ipa_generate_rt_hw_rule(enum ipa_ip_type ip,
  */
 static int ipa_translate_rt_tbl_to_hw_fmt(enum ipa_ip_type ip,
 	enum ipa_rule_type rlt, u8 *base, u8 *hdr,
-	u32 body_ofst, u32 apps_start_idx)
+	u32 body_ofst, u32 apps_start_idx, bool verify)
 {
 	struct ipa3_rt_tbl_set *set;
 	struct ipa3_rt_tbl *tbl;
@@ -160,13 +235,23 @@ static int ipa_translate_rt_tbl_to_hw_fmt(enum ipa_ip_type ip,
 	int res;
 	u64 offset;
 	u8 *body_i;
+	u32 lcl_ofst = 0;
 
 	set = &ipa3_ctx->rt_tbl_set[ip];
-	body_i = base;
 	list_for_each_entry(tbl, &set->head_rt_tbl_list, link) {
 		if (tbl->sz[rlt] == 0)
 			continue;
-		if (tbl->in_sys[rlt]) {
+		if (tbl->in_sys[rlt] && (verify || (!tbl->dirty &&
+			tbl->curr_mem[rlt].phys_base))) {
+			if (verify && !ipa_rt_sys_tbl_img_match(ip, tbl, rlt))
+				goto err;
+			if (ipahal_fltrt_write_addr_to_hdr(
+				tbl->curr_mem[rlt].phys_base,
+				hdr, tbl->idx - apps_start_idx, true)) {
+				IPAERR_RL("fail to wrt sys tbl addr to hdr\n");
+				goto err;
+			}
+		} else if (tbl->in_sys[rlt]) {
 			/* only body (no header) */
 			tbl_mem.size = tbl->sz[rlt] -
 				ipahal_get_hw_tbl_hdr_width();
@@ -207,7 +292,7 @@ static int ipa_translate_rt_tbl_to_hw_fmt(enum ipa_ip_type ip,
 			}
 			tbl->curr_mem[rlt] = tbl_mem;
 		} else {
-			offset = body_i - base + body_ofst;
+			offset = lcl_ofst + body_ofst;
 
 			/* update the hdr at the right index */
 			if (ipahal_fltrt_write_addr_to_hdr(offset, hdr,
@@ -216,28 +301,35 @@ static int ipa_translate_rt_tbl_to_hw_fmt(enum ipa_ip_type ip,
 				goto hdr_update_fail;
 			}
 
-			/* generate the rule-set */
-			list_for_each_entry(entry, &tbl->head_rt_rule_list,
-					link) {
-				if (IPA_RT_GET_RULE_TYPE(entry) != rlt)
-					continue;
-				res = ipa_generate_rt_hw_rule(ip, entry,
-					body_i);
-				if (res) {
-					IPAERR_RL("failed to gen HW RT rule\n");
-					goto err;
+			if (!base) {
+				/* body is already in sram, skip over it */
+				lcl_ofst += tbl->sz[rlt] -
+					ipahal_get_hw_tbl_hdr_width();
+			} else {
+				/* generate the rule-set */
+				body_i = base + lcl_ofst;
+				list_for_each_entry(entry,
+					&tbl->head_rt_rule_list, link) {
+					if (IPA_RT_GET_RULE_TYPE(entry) != rlt)
+						continue;
+					res = ipa_generate_rt_hw_rule(ip, entry,
+						body_i);
+					if (res) {
+						IPAERR_RL(
+						"failed to gen HW RT rule\n");
+						goto err;
+					}
+					body_i += entry->hw_len;
 				}
-				body_i += entry->hw_len;
+				lcl_ofst = body_i - base;
 			}
 
 			/**
-			 * advance body_i to next table alignment as local
-			 * tables
+			 * advance to next table alignment as local tables
 			 * are order back-to-back
 			 */
-			body_i += ipahal_get_lcl_tbl_addr_alignment();
-			body_i = (u8 *)((long)body_i &
-				~ipahal_get_lcl_tbl_addr_alignment());
+			lcl_ofst += ipahal_get_lcl_tbl_addr_alignment();
+			lcl_ofst &= ~ipahal_get_lcl_tbl_addr_alignment();
 		}
 	}
 
@@ -364,11 +456,12 @@ static int ipa_prep_rt_tbl_for_cmt(enum ipa_ip_type ip,
  * @alloc_params: IN/OUT parameters to hold info regard the tables headers
  *  and bodies on DDR (DMA buffers), and needed info for the allocation
  *  that the HAL needs
+ * @verify: check the current sys bodies instead of replacing them
  *
  * Return: 0 on success, negative on failure
  */
 static int ipa_generate_rt_hw_tbl_img(enum ipa_ip_type ip,
-	struct ipahal_fltrt_alloc_imgs_params *alloc_params)
+	struct ipahal_fltrt_alloc_imgs_params *alloc_params, bool verify)
 {
 	u32 hash_bdy_start_ofst, nhash_bdy_start_ofst;
 	u32 apps_start_idx;
@@ -396,14 +489,14 @@ static int ipa_generate_rt_hw_tbl_img(enum ipa_ip_type ip,
 
 	if (ipa_translate_rt_tbl_to_hw_fmt(ip, IPA_RULE_HASHABLE,
 		alloc_params->hash_bdy.base, alloc_params->hash_hdr.base,
-		hash_bdy_start_ofst, apps_start_idx)) {
+		hash_bdy_start_ofst, apps_start_idx, verify)) {
 		IPAERR("fail to translate hashable rt tbls to hw format\n");
 		rc = -EPERM;
 		goto translate_fail;
 	}
 	if (ipa_translate_rt_tbl_to_hw_fmt(ip, IPA_RULE_NON_HASHABLE,
 		alloc_params->nhash_bdy.base, alloc_params->nhash_hdr.base,
-		nhash_bdy_start_ofst, apps_start_idx)) {
+		nhash_bdy_start_ofst, apps_start_idx, verify)) {
 		IPAERR("fail to translate non-hashable rt tbls to hw format\n");
 		rc = -EPERM;
 		goto translate_fail;
@@ -423,6 +516,186 @@ allocate_fail:
 	return rc;
 }
 
+#ifdef CONFIG_IPA_DEBUG
+/* copy of an apps rt image as last written to sram */
+struct ipa_rt_img_shadow {
+	u8 *base;
+	u32 size;
+	bool valid;
+};
+
+static struct ipa_rt_img_shadow ipa_rt_hdr_shadow[IPA_IP_MAX][IPA_RULE_TYPE_MAX];
+static struct ipa_rt_img_shadow ipa_rt_bdy_shadow[IPA_IP_MAX][IPA_RULE_TYPE_MAX];
+
+static void ipa_rt_img_shadow_set(struct ipa_rt_img_shadow *shadow,
+	struct ipa_mem_buffer *img)
+{
+	kfree(shadow->base);
+	shadow->base = NULL;
+	shadow->size = img->size;
+	if (img->size)
+		shadow->base = kmemdup(img->base, img->size, GFP_KERNEL);
+	shadow->valid = !img->size || shadow->base;
+}
+
+static bool ipa_rt_img_shadow_match(struct ipa_rt_img_shadow *shadow,
+	struct ipa_mem_buffer *img)
+{
+	/* nothing known about what sram holds */
+	if (!shadow->valid)
+		return true;
+
+	return shadow->size == img->size &&
+		(!img->size || !memcmp(shadow->base, img->base, img->size));
+}
+
+static void ipa_rt_shadow_reset(void)
+{
+	enum ipa_ip_type ip;
+	int rlt;
+
+	for (ip = IPA_IP_v4; ip < IPA_IP_MAX; ip++) {
+		for (rlt = 0; rlt < IPA_RULE_TYPE_MAX; rlt++) {
+			ipa_rt_hdr_shadow[ip][rlt].valid = false;
+			ipa_rt_bdy_shadow[ip][rlt].valid = false;
+		}
+	}
+}
+
+/**
+ * ipa_rt_shadow_commit() - record the images a commit wrote to sram
+ * @ip: the ip address family type
+ * @params: the images of the commit
+ * @bdy_written: per rule type, whether the local body was written
+ */
+static void ipa_rt_shadow_commit(enum ipa_ip_type ip,
+	struct ipahal_fltrt_alloc_imgs_params *params, bool *bdy_written)
+{
+	ipa_rt_img_shadow_set(&ipa_rt_hdr_shadow[ip][IPA_RULE_NON_HASHABLE],
+		&params->nhash_hdr);
+	if (!ipa3_ctx->ipa_fltrt_not_hashable)
+		ipa_rt_img_shadow_set(
+			&ipa_rt_hdr_shadow[ip][IPA_RULE_HASHABLE],
+			&params->hash_hdr);
+	if (bdy_written[IPA_RULE_NON_HASHABLE])
+		ipa_rt_img_shadow_set(
+			&ipa_rt_bdy_shadow[ip][IPA_RULE_NON_HASHABLE],
+			&params->nhash_bdy);
+	if (bdy_written[IPA_RULE_HASHABLE])
+		ipa_rt_img_shadow_set(
+			&ipa_rt_bdy_shadow[ip][IPA_RULE_HASHABLE],
+			&params->hash_bdy);
+}
+
+/**
+ * ipa_rt_check_commit() - check a commit against a full rebuild
+ * @ip: the ip address family type
+ * @tbls_num: number of apps rt tables in the header
+ *
+ * All the tables are prepared and generated again as if all were dirty.
+ * The headers and local bodies are compared with what the commits left
+ * in sram, the sys bodies with the ones the header points to. On a
+ * mismatch all the tables are marked dirty, so the next commit
+ * rewrites everything.
+ *
+ * caller needs to hold any needed locks to ensure integrity
+ */
+static void ipa_rt_check_commit(enum ipa_ip_type ip, u32 tbls_num)
+{
+	struct ipahal_fltrt_alloc_imgs_params full;
+	struct ipa3_rt_tbl_set *set;
+	struct ipa3_rt_tbl *tbl;
+	u32 tbl_hdr_width = ipahal_get_hw_tbl_hdr_width();
+	u32 sz[IPA_RULE_TYPE_MAX];
+	bool match = true;
+
+	memset(&full, 0, sizeof(full));
+	full.ipt = ip;
+	full.tbls_num = tbls_num;
+
+	set = &ipa3_ctx->rt_tbl_set[ip];
+	list_for_each_entry(tbl, &set->head_rt_tbl_list, link) {
+		memcpy(sz, tbl->sz, sizeof(sz));
+		if (ipa_prep_rt_tbl_for_cmt(ip, tbl)) {
+			match = false;
+			goto report;
+		}
+		if (memcmp(sz, tbl->sz, sizeof(sz))) {
+			IPAERR("rt tbl %s ip %d size differs from full rebuild\n",
+				tbl->name, ip);
+			match = false;
+		}
+		if (!tbl->in_sys[IPA_RULE_HASHABLE] &&
+			tbl->sz[IPA_RULE_HASHABLE]) {
+			full.num_lcl_hash_tbls++;
+			full.total_sz_lcl_hash_tbls +=
+				tbl->sz[IPA_RULE_HASHABLE] - tbl_hdr_width;
+		}
+		if (!tbl->in_sys[IPA_RULE_NON_HASHABLE] &&
+			tbl->sz[IPA_RULE_NON_HASHABLE]) {
+			full.num_lcl_nhash_tbls++;
+			full.total_sz_lcl_nhash_tbls +=
+				tbl->sz[IPA_RULE_NON_HASHABLE] - tbl_hdr_width;
+		}
+	}
+
+	/* frees the images itself on failure */
+	if (ipa_generate_rt_hw_tbl_img(ip, &full, true)) {
+		match = false;
+		goto report;
+	}
+
+	if (!ipa_rt_img_shadow_match(
+		&ipa_rt_hdr_shadow[ip][IPA_RULE_NON_HASHABLE],
+		&full.nhash_hdr) ||
+		!ipa_rt_img_shadow_match(
+		&ipa_rt_hdr_shadow[ip][IPA_RULE_HASHABLE], &full.hash_hdr)) {
+		IPAERR("rt ip %d sram header differs from full rebuild\n", ip);
+		match = false;
+	}
+
+	if ((ipa3_ctx->rt_tbl_nhash_lcl[ip] &&
+		!ipa_rt_img_shadow_match(
+		&ipa_rt_bdy_shadow[ip][IPA_RULE_NON_HASHABLE],
+		&full.nhash_bdy)) ||
+		(ipa3_ctx->rt_tbl_hash_lcl[ip] &&
+		!ipa_rt_img_shadow_match(
+		&ipa_rt_bdy_shadow[ip][IPA_RULE_HASHABLE],
+		&full.hash_bdy))) {
+		IPAERR("rt ip %d sram body differs from full rebuild\n", ip);
+		match = false;
+	}
+
+	if (full.hash_hdr.size)
+		ipahal_free_dma_mem(&full.hash_hdr);
+	ipahal_free_dma_mem(&full.nhash_hdr);
+	if (full.hash_bdy.size)
+		ipahal_free_dma_mem(&full.hash_bdy);
+	if (full.nhash_bdy.size)
+		ipahal_free_dma_mem(&full.nhash_bdy);
+
+report:
+	if (!match) {
+		IPAERR("rt ip %d commit differs from full rebuild\n", ip);
+		WARN_ON_RATELIMIT_IPA(1);
+		ipa3_rt_set_tbls_dirty();
+	}
+}
+#else
+static inline void ipa_rt_shadow_reset(void)
+{
+}
+
+static inline void ipa_rt_shadow_commit(enum ipa_ip_type ip,
+	struct ipahal_fltrt_alloc_imgs_params *params, bool *bdy_written)
+{
+}
+
+static inline void ipa_rt_check_commit(enum ipa_ip_type ip, u32 tbls_num)
+{
+}
+#endif
+
 /**
  * ipa_rt_valid_lcl_tbl_size() - validate if the space allocated for rt tbl
  *  bodies at the sram is enough for the commit
@@ -480,6 +753,7 @@ int __ipa_commit_rt_v3(enum ipa_ip_type ip)
 	struct ipa3_rt_tbl *tbl;
 	u32 tbl_hdr_width;
 	struct ipahal_imm_cmd_register_write reg_write_coal_close;
+	bool lcl_bdy_dirty[IPA_RULE_TYPE_MAX];
 
 	tbl_hdr_width = ipahal_get_hw_tbl_hdr_width();
 	memset(desc, 0, sizeof(desc));
@@ -531,20 +805,38 @@ int __ipa_commit_rt_v3(enum ipa_ip_type ip)
 		goto no_rt_tbls;
 	}
 
+	/*
+	 * Only tables changed since the last commit are prepared and
+	 * regenerated. The local bodies are rewritten only if one of the
+	 * local tables changed, or a table left the set and the ones
+	 * after it moved.
+	 */
 	set = &ipa3_ctx->rt_tbl_set[ip];
+	lcl_bdy_dirty[IPA_RULE_HASHABLE] = set->dirty;
+	lcl_bdy_dirty[IPA_RULE_NON_HASHABLE] = set->dirty;
 	list_for_each_entry(tbl, &set->head_rt_tbl_list, link) {
+		if (!tbl->dirty)
+			continue;
 		if (ipa_prep_rt_tbl_for_cmt(ip, tbl)) {
 			rc = -EPERM;
 			goto no_rt_tbls;
 		}
-		if (!tbl->in_sys[IPA_RULE_HASHABLE] &&
+		for (i = 0; i < IPA_RULE_TYPE_MAX; i++)
+			if (!tbl->in_sys[i])
+				lcl_bdy_dirty[i] = true;
+	}
+
+	list_for_each_entry(tbl, &set->head_rt_tbl_list, link) {
+		if (lcl_bdy_dirty[IPA_RULE_HASHABLE] &&
+			!tbl->in_sys[IPA_RULE_HASHABLE] &&
 			tbl->sz[IPA_RULE_HASHABLE]) {
 			alloc_params.num_lcl_hash_tbls++;
 			alloc_params.total_sz_lcl_hash_tbls +=
 				tbl->sz[IPA_RULE_HASHABLE];
 			alloc_params.total_sz_lcl_hash_tbls -= tbl_hdr_width;
 		}
-		if (!tbl->in_sys[IPA_RULE_NON_HASHABLE] &&
+		if (lcl_bdy_dirty[IPA_RULE_NON_HASHABLE] &&
+			!tbl->in_sys[IPA_RULE_NON_HASHABLE] &&
 			tbl->sz[IPA_RULE_NON_HASHABLE]) {
 			alloc_params.num_lcl_nhash_tbls++;
 			alloc_params.total_sz_lcl_nhash_tbls +=
@@ -553,7 +845,7 @@ int __ipa_commit_rt_v3(enum ipa_ip_type ip)
 		}
 	}
 
-	if (ipa_generate_rt_hw_tbl_img(ip, &alloc_params)) {
+	if (ipa_generate_rt_hw_tbl_img(ip, &alloc_params, false)) {
 		IPAERR("fail to generate RT HW TBL images. IP %d\n", ip);
 		rc = -EFAULT;
 		goto no_rt_tbls;
@@ -680,7 +972,7 @@ int __ipa_commit_rt_v3(enum ipa_ip_type ip)
 		num_cmd++;
 	}
 
-	if (lcl_nhash) {
+	if (lcl_nhash && lcl_bdy_dirty[IPA_RULE_NON_HASHABLE]) {
 		if (num_cmd >= IPA_RT_MAX_NUM_OF_COMMIT_TABLES_CMD_DESC) {
 			IPAERR("number of commands is out of range: IP = %d\n",
 				ip);
@@ -704,7 +996,7 @@ int __ipa_commit_rt_v3(enum ipa_ip_type ip)
 		ipa3_init_imm_cmd_desc(&desc[num_cmd], cmd_pyld[num_cmd]);
 		num_cmd++;
 	}
-	if (lcl_hash) {
+	if (lcl_hash && lcl_bdy_dirty[IPA_RULE_HASHABLE]) {
 		if (num_cmd >= IPA_RT_MAX_NUM_OF_COMMIT_TABLES_CMD_DESC) {
 			IPAERR("number of commands is out of range: IP = %d\n",
 				ip);
@@ -735,6 +1027,14 @@ int __ipa_commit_rt_v3(enum ipa_ip_type ip)
 		goto fail_imm_cmd_construct;
 	}
 
+	list_for_each_entry(tbl, &set->head_rt_tbl_list, link)
+		tbl->dirty = false;
+	set->dirty = false;
+
+	lcl_bdy_dirty[IPA_RULE_HASHABLE] &= lcl_hash;
+	lcl_bdy_dirty[IPA_RULE_NON_HASHABLE] &= lcl_nhash;
+	ipa_rt_shadow_commit(ip, &alloc_params, lcl_bdy_dirty);
+
 	IPADBG_LOW("Hashable HEAD\n");
 	IPA_DUMP_BUFF(alloc_params.hash_hdr.base,
 		alloc_params.hash_hdr.phys_base, alloc_params.hash_hdr.size);
@@ -759,6 +1059,8 @@ int __ipa_commit_rt_v3(enum ipa_ip_type ip)
 
 	__ipa_reap_sys_rt_tbls(ip);
 
+	ipa_rt_check_commit(ip, alloc_params.tbls_num);
+
 fail_imm_cmd_construct:
 	for (i = 0 ; i < num_cmd ; i++)
 		ipahal_destroy_imm_cmd(cmd_pyld[i]);
@@ -775,6 +1077,31 @@ no_rt_tbls:
 	return rc;
 }
 
+/**
+ * ipa3_rt_set_tbls_dirty() - have the next commits regenerate all the
+ *  routing tables
+ *
+ * Used when something the tables point to went away under them, or the
+ * sram was reinitialized
+ *
+ * caller needs to hold any needed locks to ensure integrity
+ */
+void ipa3_rt_set_tbls_dirty(void)
+{
+	struct ipa3_rt_tbl_set *set;
+	struct ipa3_rt_tbl *tbl;
+	enum ipa_ip_type ip;
+
+	for (ip = IPA_IP_v4; ip < IPA_IP_MAX; ip++) {
+		set = &ipa3_ctx->rt_tbl_set[ip];
+		list_for_each_entry(tbl, &set->head_rt_tbl_list, link)
+			tbl->dirty = true;
+		set->dirty = true;
+	}
+
+	ipa_rt_shadow_reset();
+}
+
 /**
  * __ipa3_find_rt_tbl() - find the routing table
  *			which name is given as parameter
@@ -893,6 +1220,7 @@ static struct ipa3_rt_tbl *__ipa_add_rt_tbl(enum ipa_ip_type ip,
 		entry->cookie = IPA_RT_TBL_COOKIE;
 		entry->in_sys[IPA_RULE_HASHABLE] = !ipa3_ctx->rt_tbl_hash_lcl[ip];
 		entry->in_sys[IPA_RULE_NON_HASHABLE] = !ipa3_ctx->rt_tbl_nhash_lcl[ip];
+		entry->dirty = true;
 		set->tbl_cnt++;
 		entry->rule_ids = &set->rule_ids;
 		list_add(&entry->link, &set->head_rt_tbl_list);
@@ -949,6 +1277,7 @@ static int __ipa_del_rt_tbl(struct ipa3_rt_tbl *entry)
 	rset = &ipa3_ctx->reap_rt_tbl_set[ip];
 
 	entry->rule_ids = NULL;
+	entry->set->dirty = true;
 	if (entry->in_sys[IPA_RULE_HASHABLE] ||
 		entry->in_sys[IPA_RULE_NON_HASHABLE]) {
 		list_move(&entry->link, &rset->head_rt_tbl_list);
@@ -1115,6 +1444,7 @@ static int __ipa_finish_rt_rule_add(struct ipa3_rt_entry *entry, u32 *rule_hdl,
 		tbl->idx, tbl->rule_cnt, entry->rule_id);
 	*rule_hdl = id;
 	entry->id = id;
+	tbl->dirty = true;
 
 	return 0;
 
@@ -1805,6 +2135,7 @@ int __ipa3_del_rt_rule(u32 rule_hdl)
 		__ipa3_release_hdr_proc_ctx(entry->proc_ctx->id);
 	list_del(&entry->link);
 	entry->tbl->rule_cnt--;
+	entry->tbl->dirty = true;
 	IPADBG("del rt rule tbl_idx=%d rule_cnt=%d rule_id=%d\n ref_cnt=%u",
 		entry->tbl->idx, entry->tbl->rule_cnt,
 		entry->rule_id, entry->tbl->ref_cnt);
@@ -1817,6 +2148,7 @@ int __ipa3_del_rt_rule(u32 rule_hdl)
 	}
 	entry->cookie = 0;
 	id = entry->id;
+	ipahal_fltrt_rule_bdy_cache_clear(&entry->bdy_cache);
 	kmem_cache_free(ipa3_ctx->rt_rule_cache, entry);
 
 	/* remove the handle from the database */
@@ -1997,6 +2329,7 @@ int ipa3_reset_rt(enum ipa_ip_type ip, bool user_only)
 					}
 				}
 				tbl->rule_cnt--;
+				tbl->dirty = true;
 				list_del(&rule->link);
 				if (rule->hdr &&
 					(!ipa3_check_idr_if_freed(
@@ -2012,6 +2345,8 @@ int ipa3_reset_rt(enum ipa_ip_type ip, bool user_only)
 					idr_remove(tbl->rule_ids,
 						rule->rule_id);
 				id = rule->id;
+				ipahal_fltrt_rule_bdy_cache_clear(
+					&rule->bdy_cache);
 				kmem_cache_free(ipa3_ctx->rt_rule_cache, rule);
 
 				/* remove the handle from the database */
@@ -2030,6 +2365,7 @@ int ipa3_reset_rt(enum ipa_ip_type ip, bool user_only)
 		if (tbl->idx != apps_start_idx) {
 			if (!user_only || tbl_user) {
 				tbl->rule_ids = NULL;
+				set->dirty = true;
 				if (tbl->in_sys[IPA_RULE_HASHABLE] ||
 					tbl->in_sys[IPA_RULE_NON_HASHABLE]) {
 					list_move(&tbl->link,
@@ -2055,6 +2391,10 @@ int ipa3_reset_rt(enum ipa_ip_type ip, bool user_only)
 		}
 	}
 
+	/* filtering rules may still point to the removed routing tables */
+	if (set->dirty)
+		ipa3_flt_set_tbls_dirty();
+
 	/* commit the change to IPA-HW */
 	if (ipa3_ctx->ctrl->ipa3_commit_rt(IPA_IP_v4) ||
 		ipa3_ctx->ctrl->ipa3_commit_rt(IPA_IP_v6)) {
@@ -2234,10 +2574,12 @@ static int __ipa_mdfy_rt_rule(struct ipa_rt_rule_mdfy_i *rtrule)
 
 	entry->hw_len = 0;
 	entry->prio = 0;
+	ipahal_fltrt_rule_bdy_cache_clear(&entry->bdy_cache);
 	if (rtrule->rule.enable_stats)
 		entry->cnt_idx = rtrule->rule.cnt_idx;
 	else
 		entry->cnt_idx = 0;
+	entry->tbl->dirty = true;
 	return 0;
 
 error:
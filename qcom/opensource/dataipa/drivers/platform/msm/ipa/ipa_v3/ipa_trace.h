@@ -298,6 +298,35 @@ TRACE_EVENT(
 	TP_printk("client=%lu", __entry->client)
 );
 
+TRACE_EVENT(
+	ipa3_dim_profile,
+
+	TP_PROTO(unsigned long client, u32 profile, u16 int_modt, u8 int_modc,
+		u16 budget),
+
+	TP_ARGS(client, profile, int_modt, int_modc, budget),
+
+	TP_STRUCT__entry(
+		__field(unsigned long,	client)
+		__field(u32,		profile)
+		__field(u16,		int_modt)
+		__field(u8,		int_modc)
+		__field(u16,		budget)
+	),
+
+	TP_fast_assign(
+		__entry->client = client;
+		__entry->profile = profile;
+		__entry->int_modt = int_modt;
+		__entry->int_modc = int_modc;
+		__entry->budget = budget;
+	),
+
+	TP_printk("client=%lu profile=%u modt=%u modc=%u budget=%u",
+		__entry->client, __entry->profile, __entry->int_modt,
+		__entry->int_modc, __entry->budget)
+);
+
 TRACE_EVENT(
 	ipa3_replenish_rx_page_recycle,
 
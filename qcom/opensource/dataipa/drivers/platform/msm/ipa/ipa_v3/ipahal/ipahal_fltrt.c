@@ -99,6 +99,10 @@ static int ipa_fltrt_generate_hw_rule_bdy(enum ipa_ip_type ipt,
 	const struct ipa_rule_attrib *attrib, u8 **buf, u16 *en_rule);
 static int ipa_fltrt_generate_hw_rule_bdy_from_eq(
 		const struct ipa_ipfltri_rule_eq *attrib, u8 **buf);
+static int ipa_fltrt_gen_hw_rule_bdy_cached(enum ipa_ip_type ipt,
+	const struct ipa_rule_attrib *attrib,
+	const struct ipa_ipfltri_rule_eq *eq_attrib,
+	struct ipahal_fltrt_rule_bdy_cache *cache, u8 **buf, u16 *en_rule);
 static int ipa_flt_generate_eq_ip4(enum ipa_ip_type ip,
 		const struct ipa_rule_attrib *attrib,
 		struct ipa_ipfltri_rule_eq *eq_atrb);
@@ -210,7 +214,8 @@ static int ipa_rt_gen_hw_rule(struct ipahal_rt_rule_gen_params *params,
 
 	buf += sizeof(struct ipa3_0_rt_rule_hw_hdr);
 
-	if (ipa_fltrt_generate_hw_rule_bdy(params->ipt, &params->rule->attrib,
+	if (ipa_fltrt_gen_hw_rule_bdy_cached(params->ipt,
+		&params->rule->attrib, NULL, params->bdy_cache,
 		&buf, &en_rule)) {
 		IPAHAL_ERR("fail to generate hw rule\n");
 		return -EPERM;
@@ -278,7 +283,8 @@ static int ipa_rt_gen_hw_rule_ipav4_5(struct ipahal_rt_rule_gen_params *params,
 
 	buf += sizeof(struct ipa4_5_rt_rule_hw_hdr);
 
-	if (ipa_fltrt_generate_hw_rule_bdy(params->ipt, &params->rule->attrib,
+	if (ipa_fltrt_gen_hw_rule_bdy_cached(params->ipt,
+		&params->rule->attrib, NULL, params->bdy_cache,
 		&buf, &en_rule)) {
 		IPAHAL_ERR("fail to generate hw rule\n");
 		return -EPERM;
@@ -347,7 +353,8 @@ static int ipa_rt_gen_hw_rule_ipav5_0(struct ipahal_rt_rule_gen_params *params,
 
 	buf += sizeof(struct ipa5_0_rt_rule_hw_hdr);
 
-	if (ipa_fltrt_generate_hw_rule_bdy(params->ipt, &params->rule->attrib,
+	if (ipa_fltrt_gen_hw_rule_bdy_cached(params->ipt,
+		&params->rule->attrib, NULL, params->bdy_cache,
 		&buf, &en_rule)) {
 		IPAHAL_ERR("fail to generate hw rule\n");
 		return -EPERM;
@@ -411,19 +418,13 @@ static int ipa_flt_gen_hw_rule(struct ipahal_flt_rule_gen_params *params,
 
 	buf += sizeof(struct ipa3_0_flt_rule_hw_hdr);
 
-	if (params->rule->eq_attrib_type) {
-		if (ipa_fltrt_generate_hw_rule_bdy_from_eq(
-			&params->rule->eq_attrib, &buf)) {
-			IPAHAL_ERR_RL("fail to generate hw rule from eq\n");
-			return -EPERM;
-		}
-		en_rule = params->rule->eq_attrib.rule_eq_bitmap;
-	} else {
-		if (ipa_fltrt_generate_hw_rule_bdy(params->ipt,
-			&params->rule->attrib, &buf, &en_rule)) {
-			IPAHAL_ERR_RL("fail to generate hw rule\n");
-			return -EPERM;
-		}
+	if (ipa_fltrt_gen_hw_rule_bdy_cached(params->ipt,
+		&params->rule->attrib,
+		params->rule->eq_attrib_type ?
+			&params->rule->eq_attrib : NULL,
+		params->bdy_cache, &buf, &en_rule)) {
+		IPAHAL_ERR_RL("fail to generate hw rule\n");
+		return -EPERM;
 	}
 	rule_hdr->u.hdr.en_rule = en_rule;
 
@@ -496,19 +497,13 @@ static int ipa_flt_gen_hw_rule_ipav4(struct ipahal_flt_rule_gen_params *params,
 
 	buf += sizeof(struct ipa4_0_flt_rule_hw_hdr);
 
-	if (params->rule->eq_attrib_type) {
-		if (ipa_fltrt_generate_hw_rule_bdy_from_eq(
-			&params->rule->eq_attrib, &buf)) {
-			IPAHAL_ERR("fail to generate hw rule from eq\n");
-			return -EPERM;
-		}
-		en_rule = params->rule->eq_attrib.rule_eq_bitmap;
-	} else {
-		if (ipa_fltrt_generate_hw_rule_bdy(params->ipt,
-			&params->rule->attrib, &buf, &en_rule)) {
-			IPAHAL_ERR("fail to generate hw rule\n");
-			return -EPERM;
-		}
+	if (ipa_fltrt_gen_hw_rule_bdy_cached(params->ipt,
+		&params->rule->attrib,
+		params->rule->eq_attrib_type ?
+			&params->rule->eq_attrib : NULL,
+		params->bdy_cache, &buf, &en_rule)) {
+		IPAHAL_ERR("fail to generate hw rule\n");
+		return -EPERM;
 	}
 	rule_hdr->u.hdr.en_rule = en_rule;
 
@@ -585,19 +580,13 @@ static int ipa_flt_gen_hw_rule_ipav4_5(
 
 	buf += sizeof(struct ipa4_5_flt_rule_hw_hdr);
 
-	if (params->rule->eq_attrib_type) {
-		if (ipa_fltrt_generate_hw_rule_bdy_from_eq(
-			&params->rule->eq_attrib, &buf)) {
-			IPAHAL_ERR("fail to generate hw rule from eq\n");
-			return -EPERM;
-		}
-		en_rule = params->rule->eq_attrib.rule_eq_bitmap;
-	} else {
-		if (ipa_fltrt_generate_hw_rule_bdy(params->ipt,
-			&params->rule->attrib, &buf, &en_rule)) {
-			IPAHAL_ERR("fail to generate hw rule\n");
-			return -EPERM;
-		}
+	if (ipa_fltrt_gen_hw_rule_bdy_cached(params->ipt,
+		&params->rule->attrib,
+		params->rule->eq_attrib_type ?
+			&params->rule->eq_attrib : NULL,
+		params->bdy_cache, &buf, &en_rule)) {
+		IPAHAL_ERR("fail to generate hw rule\n");
+		return -EPERM;
 	}
 	rule_hdr->u.hdr.en_rule = en_rule;
 
@@ -693,19 +682,13 @@ static int ipa_flt_gen_hw_rule_ipav5_0(
 
 	buf += sizeof(struct ipa5_0_flt_rule_hw_hdr);
 
-	if (params->rule->eq_attrib_type) {
-		if (ipa_fltrt_generate_hw_rule_bdy_from_eq(
-			&params->rule->eq_attrib, &buf)) {
-			IPAHAL_ERR("fail to generate hw rule from eq\n");
-			return -EPERM;
-		}
-		en_rule = params->rule->eq_attrib.rule_eq_bitmap;
-	} else {
-		if (ipa_fltrt_generate_hw_rule_bdy(params->ipt,
-			&params->rule->attrib, &buf, &en_rule)) {
-			IPAHAL_ERR("fail to generate hw rule\n");
-			return -EPERM;
-		}
+	if (ipa_fltrt_gen_hw_rule_bdy_cached(params->ipt,
+		&params->rule->attrib,
+		params->rule->eq_attrib_type ?
+			&params->rule->eq_attrib : NULL,
+		params->bdy_cache, &buf, &en_rule)) {
+		IPAHAL_ERR("fail to generate hw rule\n");
+		return -EPERM;
 	}
 	rule_hdr->u.hdr.en_rule = en_rule;
 
@@ -2250,6 +2233,58 @@ fail_extra_alloc:
 }
 
 
+/*
+ * ipa_fltrt_gen_hw_rule_bdy_cached() - generate HW rule body (w/o header),
+ *  reusing the body kept from a previous generation of the same rule
+ * @ipt: IP address type
+ * @attrib: IPA rule attribute
+ * @eq_attrib: rule in equation form. If not NULL the body is built from it
+ *  instead of @attrib
+ * @cache: body cache of the rule, may be NULL. Filled on a miss
+ * @buf: output buffer. Advance it after building the rule
+ * @en_rule: enable rule
+ *
+ * The body depends only on the IP type and the rule attributes, so it is
+ * valid until the rule is modified. A failure to keep a copy is not an
+ * error, the body is just generated again the next time.
+ *
+ * Return codes:
+ * 0: success
+ * -EPERM: wrong input
+ */
+static int ipa_fltrt_gen_hw_rule_bdy_cached(enum ipa_ip_type ipt,
+	const struct ipa_rule_attrib *attrib,
+	const struct ipa_ipfltri_rule_eq *eq_attrib,
+	struct ipahal_fltrt_rule_bdy_cache *cache, u8 **buf, u16 *en_rule)
+{
+	u8 *bdy = *buf;
+
+	if (cache && cache->bdy) {
+		memcpy(*buf, cache->bdy, cache->len);
+		*buf += cache->len;
+		*en_rule = cache->en_rule;
+		return 0;
+	}
+
+	if (eq_attrib) {
+		if (ipa_fltrt_generate_hw_rule_bdy_from_eq(eq_attrib, buf))
+			return -EPERM;
+		*en_rule = eq_attrib->rule_eq_bitmap;
+	} else if (ipa_fltrt_generate_hw_rule_bdy(ipt, attrib, buf, en_rule)) {
+		return -EPERM;
+	}
+
+	if (cache) {
+		cache->bdy = kmemdup(bdy, *buf - bdy, GFP_KERNEL);
+		if (cache->bdy) {
+			cache->len = *buf - bdy;
+			cache->en_rule = *en_rule;
+		}
+	}
+
+	return 0;
+}
+
 /**
  * ipa_fltrt_calc_extra_wrd_bytes()- Calculate the number of extra words for eq
  * @attrib: equation attribute
@@ -5087,6 +5122,23 @@ int ipahal_flt_generate_hw_rule(struct ipahal_flt_rule_gen_params *params,
 
 }
 
+/*
+ * ipahal_fltrt_rule_bdy_cache_clear() - drop a cached rule body
+ * @cache: the cache to clear. Must be called when the rule attributes
+ *  change and before the owning rule is freed
+ */
+void ipahal_fltrt_rule_bdy_cache_clear(
+	struct ipahal_fltrt_rule_bdy_cache *cache)
+{
+	if (!cache)
+		return;
+
+	kfree(cache->bdy);
+	cache->bdy = NULL;
+	cache->len = 0;
+	cache->en_rule = 0;
+}
+
 /*
  * ipahal_flt_generate_equation() - generate flt rule in equation form
  *  Will build equation form flt rule from given info.
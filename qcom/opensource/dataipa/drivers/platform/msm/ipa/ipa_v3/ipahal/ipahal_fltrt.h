@@ -47,6 +47,18 @@ enum ipahal_rt_rule_hdr_type {
 	IPAHAL_RT_RULE_HDR_PROC_CTX,
 };
 
+/*
+ * struct ipahal_fltrt_rule_bdy_cache - Rule body kept from last generation
+ * @bdy: The rule body as written after the H/W rule header, NULL if empty
+ * @len: Size of the body in bytes
+ * @en_rule: Enabled equations bitmap for the H/W rule header
+ */
+struct ipahal_fltrt_rule_bdy_cache {
+	u8 *bdy;
+	u32 len;
+	u16 en_rule;
+};
+
 /*
  * struct ipahal_rt_rule_gen_params - Params for generating rt rule
  * @ipt: IP family version
@@ -58,6 +70,7 @@ enum ipahal_rt_rule_hdr_type {
  * @id: Rule ID
  * @cnt_idx: Stats counter index
  * @rule: Rule info
+ * @bdy_cache: Optional cache of the rule body, filled if empty
  */
 struct ipahal_rt_rule_gen_params {
 	enum ipa_ip_type ipt;
@@ -69,6 +82,7 @@ struct ipahal_rt_rule_gen_params {
 	u32 id;
 	u8 cnt_idx;
 	const struct ipa_rt_rule_i *rule;
+	struct ipahal_fltrt_rule_bdy_cache *bdy_cache;
 };
 
 /*
@@ -108,6 +122,7 @@ struct ipahal_rt_rule_entry {
  * @id: Rule ID
  * @cnt_idx: Stats counter index
  * @rule: Rule info
+ * @bdy_cache: Optional cache of the rule body, filled if empty
  */
 struct ipahal_flt_rule_gen_params {
 	enum ipa_ip_type ipt;
@@ -116,6 +131,7 @@ struct ipahal_flt_rule_gen_params {
 	u32 id;
 	u8 cnt_idx;
 	const struct ipa_flt_rule_i *rule;
+	struct ipahal_fltrt_rule_bdy_cache *bdy_cache;
 };
 
 /*
@@ -279,6 +295,14 @@ int ipahal_rt_generate_hw_rule(struct ipahal_rt_rule_gen_params *params,
 int ipahal_flt_generate_hw_rule(struct ipahal_flt_rule_gen_params *params,
 	u32 *hw_len, u8 *buf);
 
+/*
+ * ipahal_fltrt_rule_bdy_cache_clear() - drop a cached rule body
+ * @cache: the cache to clear. Must be called when the rule attributes
+ *  change and before the owning rule is freed
+ */
+void ipahal_fltrt_rule_bdy_cache_clear(
+	struct ipahal_fltrt_rule_bdy_cache *cache);
+
 /*
  * ipahal_flt_generate_equation() - generate flt rule in equation form
  *  Will build equation form flt rule from given info.
@@ -0,0 +1,135 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Copyright (c) 2022 Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+
+#include <linux/string.h>
+#include "ipa_ut_framework.h"
+#include "ipa_dim.h"
+
+/**
+ * RX interrupt moderation unit-test suite
+ * Replays a recorded NAPI poll trace through ipa3_dim_sample() the way
+ * ipa3_rx_poll() feeds it: one sample per poll, frames capped at the
+ * budget of the current profile. No pipe or HW is involved.
+ */
+
+#define IPA_TEST_DIM_START_NS	(1000ULL * 1000 * 1000)
+
+/**
+ * struct ipa_test_dim_seg - polls of the trace with the same load
+ * @polls: number of polls in the segment
+ * @pkts: frames available to each poll, capped at the budget
+ * @gap_us: time between two polls
+ * @profile: expected profile at the end of the segment
+ * @changes: expected profile changes since the start of the trace
+ */
+struct ipa_test_dim_seg {
+	u32 polls;
+	u32 pkts;
+	u32 gap_us;
+	u32 profile;
+	u64 changes;
+};
+
+/*
+ * Budgets are 16/32/64 for LOW_LAT/MID/BULK. Polls 10us apart close a
+ * window every IPA_DIM_WINDOW_POLLS polls, polls 600us apart close one
+ * every 3 polls on time. Every profile change lands on the last poll of
+ * its segment.
+ */
+static const struct ipa_test_dim_seg ipa_test_dim_trace[] = {
+	/* light load, one down verdict is not enough */
+	{ 64, 4, 10, IPA_DIM_PROFILE_BULK, 0 },
+	{ 64, 4, 10, IPA_DIM_PROFILE_MID, 1 },
+	{ 128, 4, 10, IPA_DIM_PROFILE_LOW_LAT, 2 },
+	/* clamped at LOW_LAT */
+	{ 128, 1, 10, IPA_DIM_PROFILE_LOW_LAT, 2 },
+	/* up, neutral, up: the neutral window restarts the count */
+	{ 64, 16, 10, IPA_DIM_PROFILE_LOW_LAT, 2 },
+	{ 64, 8, 10, IPA_DIM_PROFILE_LOW_LAT, 2 },
+	{ 64, 16, 10, IPA_DIM_PROFILE_LOW_LAT, 2 },
+	/* a down verdict at LOW_LAT restarts it too */
+	{ 64, 2, 10, IPA_DIM_PROFILE_LOW_LAT, 2 },
+	{ 64, 16, 10, IPA_DIM_PROFILE_LOW_LAT, 2 },
+	{ 64, 16, 10, IPA_DIM_PROFILE_MID, 3 },
+	/* full budget all the way up, then clamped at BULK */
+	{ 128, 64, 10, IPA_DIM_PROFILE_BULK, 4 },
+	{ 128, 64, 10, IPA_DIM_PROFILE_BULK, 4 },
+	/* idle polls far apart, windows closed on time */
+	{ 6, 0, 600, IPA_DIM_PROFILE_MID, 5 },
+	/* up and down windows alternating never step */
+	{ 64, 32, 10, IPA_DIM_PROFILE_MID, 5 },
+	{ 64, 2, 10, IPA_DIM_PROFILE_MID, 5 },
+	{ 64, 32, 10, IPA_DIM_PROFILE_MID, 5 },
+	{ 64, 2, 10, IPA_DIM_PROFILE_MID, 5 },
+};
+
+/**
+ * Replay the trace starting at BULK, as the pipe is set up.
+ * Pass when:
+ * 1- the profile and the number of changes match the trace at the end
+ *	of every segment
+ * 2- a change is reported only on the last poll of a segment, so it
+ *	took IPA_DIM_STEADY_WINDOWS full windows
+ * 3- ipa3_dim_sample() reports a change exactly when the profile moved
+ */
+static int ipa_test_dim_trace_replay(void *priv)
+{
+	const struct ipa_test_dim_seg *seg;
+	struct ipa3_dim dim;
+	u64 now = IPA_TEST_DIM_START_NS;
+	u32 prev, budget, pkts;
+	bool changed;
+	int i;
+	u32 j;
+
+	ipa3_dim_init(&dim, IPA_DIM_PROFILE_BULK);
+
+	for (i = 0; i < ARRAY_SIZE(ipa_test_dim_trace); i++) {
+		seg = &ipa_test_dim_trace[i];
+		for (j = 0; j < seg->polls; j++) {
+			now += seg->gap_us * 1000ULL;
+			prev = dim.profile;
+			budget = ipa3_dim_cur(&dim)->budget;
+			pkts = min_t(u32, seg->pkts, budget);
+
+			changed = ipa3_dim_sample(&dim, pkts, budget, now);
+			if (changed != (dim.profile != prev)) {
+				IPA_UT_ERR("seg %d poll %u changed %d %u->%u\n",
+					i, j, changed, prev, dim.profile);
+				IPA_UT_TEST_FAIL_REPORT(
+					"change not reported as such");
+				return -EFAULT;
+			}
+			if (changed && j != seg->polls - 1) {
+				IPA_UT_ERR("seg %d stepped at poll %u of %u\n",
+					i, j, seg->polls);
+				IPA_UT_TEST_FAIL_REPORT(
+					"step before steady windows");
+				return -EFAULT;
+			}
+		}
+
+		IPA_UT_LOG("seg %d profile %u changes %llu\n",
+			i, dim.profile, dim.changes);
+		if (dim.profile != seg->profile ||
+			dim.changes != seg->changes) {
+			IPA_UT_ERR("seg %d expected profile %u changes %llu\n",
+				i, seg->profile, seg->changes);
+			IPA_UT_TEST_FAIL_REPORT("trace diverged");
+			return -EFAULT;
+		}
+	}
+
+	return 0;
+}
+
+/* Suite definition block */
+IPA_UT_DEFINE_SUITE_START(dim, "RX interrupt moderation suite",
+	NULL, NULL)
+{
+	IPA_UT_ADD_TEST(trace_replay,
+		"Replay a poll trace through the moderation state",
+		ipa_test_dim_trace_replay, false, IPA_HW_v3_0, IPA_HW_MAX),
+} IPA_UT_DEFINE_SUITE_END(dim);
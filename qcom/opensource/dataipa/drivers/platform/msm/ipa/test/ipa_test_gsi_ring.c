@@ -0,0 +1,244 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Copyright (c) 2021, The Linux Foundation. All rights reserved.
+ */
+
+#include <linux/delay.h>
+#include "gsi.h"
+#include "ipa_ut_framework.h"
+
+/**
+ * GSI ring producer unit-test suite
+ * Runs the reserve -> fill -> publish -> ring-if-last protocol of
+ * gsi_queue_xfer() with several producers on a model ring in memory,
+ * no channel or HW is involved. The doorbell of the model checks that
+ * every slot it hands to the "HW" has been filled, then consumes them.
+ */
+
+#define IPA_TEST_GSI_RING_NUM_ELEM	256
+#define IPA_TEST_GSI_RING_ELEM_SZ	16
+#define IPA_TEST_GSI_RING_BASE		0x100000
+#define IPA_TEST_GSI_RING_NUM_PROD	8
+#define IPA_TEST_GSI_RING_MAX_BATCH	8
+#define IPA_TEST_GSI_RING_ITERS		20000
+#define IPA_TEST_GSI_RING_WQ_NAME_BUFF_SZ	64
+
+struct ipa_test_gsi_ring_prod {
+	struct work_struct work;
+	u32 id;
+	u64 queued;
+};
+
+struct ipa_test_gsi_ring_ctx {
+	struct gsi_ring_ctx ring;
+	u32 slot[IPA_TEST_GSI_RING_NUM_ELEM];
+	u64 consumed;
+	u64 doorbells;
+	atomic_t errors;
+	struct ipa_test_gsi_ring_prod prod[IPA_TEST_GSI_RING_NUM_PROD];
+};
+
+static struct ipa_test_gsi_ring_ctx *ring_ctx;
+
+static u16 ipa_test_gsi_ring_used(struct gsi_ring_ctx *ring)
+{
+	return ((ring->wp_local - ring->rp + ring->len) % ring->len) /
+		ring->elem_sz;
+}
+
+/* called with the ring lock held, stands in for gsi_ring_chan_doorbell */
+static void ipa_test_gsi_ring_doorbell(struct ipa_test_gsi_ring_ctx *rctx)
+{
+	struct gsi_ring_ctx *ring = &rctx->ring;
+	u16 idx;
+
+	rctx->doorbells++;
+
+	while (ring->rp != ring->wp_local) {
+		idx = gsi_find_idx_from_addr(ring, ring->rp);
+		if (!READ_ONCE(rctx->slot[idx])) {
+			IPA_UT_ERR("doorbell exposed empty slot %u\n", idx);
+			atomic_inc(&rctx->errors);
+		}
+		WRITE_ONCE(rctx->slot[idx], 0);
+		rctx->consumed++;
+
+		ring->rp += ring->elem_sz;
+		if (ring->rp == ring->end)
+			ring->rp = ring->base;
+	}
+
+	ring->wp = ring->wp_local;
+}
+
+static void ipa_test_gsi_ring_fill(struct ipa_test_gsi_ring_ctx *rctx,
+	u16 idx, u16 num, u32 cookie)
+{
+	u16 i;
+
+	for (i = 0; i < num; i++) {
+		if (READ_ONCE(rctx->slot[idx])) {
+			IPA_UT_ERR("slot %u reserved twice\n", idx);
+			atomic_inc(&rctx->errors);
+		}
+		WRITE_ONCE(rctx->slot[idx], cookie);
+		if (++idx > rctx->ring.max_num_elem)
+			idx = 0;
+	}
+}
+
+static void ipa_test_gsi_ring_producer(struct work_struct *work)
+{
+	struct ipa_test_gsi_ring_prod *prod = container_of(work,
+		struct ipa_test_gsi_ring_prod, work);
+	struct ipa_test_gsi_ring_ctx *rctx = ring_ctx;
+	struct gsi_ring_ctx *ring = &rctx->ring;
+	unsigned long flags;
+	bool ring_db;
+	u16 num, idx;
+	u32 it = 0;
+
+	while (it < IPA_TEST_GSI_RING_ITERS) {
+		num = 1 + (it * 7 + prod->id) % IPA_TEST_GSI_RING_MAX_BATCH;
+		/* the last batch always asks for the doorbell */
+		ring_db = (it % 4) != 3 || it == IPA_TEST_GSI_RING_ITERS - 1;
+
+		spin_lock_irqsave(&ring->slock, flags);
+		if (ipa_test_gsi_ring_used(ring) + num > ring->max_num_elem) {
+			/* flush unrung slots the way gsi_start_xfer() does */
+			if (ring->wp != ring->wp_local &&
+				gsi_ring_publish(ring, false, true))
+				ipa_test_gsi_ring_doorbell(rctx);
+			spin_unlock_irqrestore(&ring->slock, flags);
+			cond_resched();
+			continue;
+		}
+
+		idx = gsi_ring_resv(ring, num);
+
+		if (it % 2) {
+			/* no window between reserve and publish */
+			ipa_test_gsi_ring_fill(rctx, idx, num, prod->id + 1);
+		} else {
+			spin_unlock_irqrestore(&ring->slock, flags);
+			ipa_test_gsi_ring_fill(rctx, idx, num, prod->id + 1);
+			/* widen the window for the other producers */
+			if (!(it % 16))
+				udelay(1);
+			spin_lock_irqsave(&ring->slock, flags);
+		}
+
+		if (gsi_ring_publish(ring, true, ring_db))
+			ipa_test_gsi_ring_doorbell(rctx);
+		spin_unlock_irqrestore(&ring->slock, flags);
+
+		prod->queued += num;
+		it++;
+	}
+}
+
+static int ipa_test_gsi_ring_suite_setup(void **ppriv)
+{
+	IPA_UT_DBG("Start Setup\n");
+
+	ring_ctx = kzalloc(sizeof(*ring_ctx), GFP_KERNEL);
+	if (!ring_ctx)
+		return -ENOMEM;
+
+	*ppriv = ring_ctx;
+
+	return 0;
+}
+
+static int ipa_test_gsi_ring_suite_teardown(void *priv)
+{
+	IPA_UT_DBG("Start Teardown\n");
+
+	kfree(ring_ctx);
+	ring_ctx = NULL;
+
+	return 0;
+}
+
+/**
+ * Several producers queue batches of random size on one model ring.
+ * Pass when:
+ * 1- no doorbell exposes a slot that was reserved but not yet filled
+ * 2- no slot is handed out twice before being consumed
+ * 3- once all producers are done, nothing is left reserved, no doorbell
+ *	is pending and everything queued was seen by the "HW"
+ */
+static int ipa_test_gsi_ring_mt_producers(void *priv)
+{
+	static struct workqueue_struct *wq[IPA_TEST_GSI_RING_NUM_PROD];
+	struct ipa_test_gsi_ring_ctx *rctx = priv;
+	struct gsi_ring_ctx *ring = &rctx->ring;
+	char buff[IPA_TEST_GSI_RING_WQ_NAME_BUFF_SZ];
+	u64 queued = 0;
+	int rc = 0;
+	int i;
+
+	memset(rctx, 0, sizeof(*rctx));
+	spin_lock_init(&ring->slock);
+	ring->elem_sz = IPA_TEST_GSI_RING_ELEM_SZ;
+	ring->len = IPA_TEST_GSI_RING_NUM_ELEM * IPA_TEST_GSI_RING_ELEM_SZ;
+	ring->max_num_elem = IPA_TEST_GSI_RING_NUM_ELEM - 1;
+	ring->base = IPA_TEST_GSI_RING_BASE;
+	ring->end = ring->base + ring->len;
+	ring->wp = ring->wp_local = ring->rp = ring->rp_local = ring->base;
+	atomic_set(&rctx->errors, 0);
+
+	for (i = 0; i < IPA_TEST_GSI_RING_NUM_PROD; i++) {
+		snprintf(buff, sizeof(buff), "ipa_test_gsi_ring_wq%d", i);
+		wq[i] = create_singlethread_workqueue(buff);
+		if (!wq[i]) {
+			IPA_UT_ERR("failed to create wq %d\n", i);
+			IPA_UT_TEST_FAIL_REPORT("wq creation failed");
+			rc = -ENOMEM;
+			goto destroy_wq;
+		}
+		rctx->prod[i].id = i;
+		INIT_WORK(&rctx->prod[i].work, ipa_test_gsi_ring_producer);
+	}
+
+	for (i = 0; i < IPA_TEST_GSI_RING_NUM_PROD; i++)
+		queue_work(wq[i], &rctx->prod[i].work);
+
+	for (i = 0; i < IPA_TEST_GSI_RING_NUM_PROD; i++) {
+		flush_workqueue(wq[i]);
+		queued += rctx->prod[i].queued;
+	}
+
+	IPA_UT_LOG("queued %llu consumed %llu doorbells %llu errors %d\n",
+		queued, rctx->consumed, rctx->doorbells,
+		atomic_read(&rctx->errors));
+
+	if (atomic_read(&rctx->errors)) {
+		IPA_UT_TEST_FAIL_REPORT("empty or double booked slots");
+		rc = -EFAULT;
+	} else if (ring->resv_inflight || ring->db_pending) {
+		IPA_UT_ERR("resv_inflight %u db_pending %d\n",
+			ring->resv_inflight, ring->db_pending);
+		IPA_UT_TEST_FAIL_REPORT("ring left with work in flight");
+		rc = -EFAULT;
+	} else if (ring->wp != ring->wp_local || queued != rctx->consumed) {
+		IPA_UT_TEST_FAIL_REPORT("queued slots never rung");
+		rc = -EFAULT;
+	}
+
+	i = IPA_TEST_GSI_RING_NUM_PROD;
+destroy_wq:
+	while (i--)
+		destroy_workqueue(wq[i]);
+
+	return rc;
+}
+
+/* Suite definition block */
+IPA_UT_DEFINE_SUITE_START(gsi_ring, "GSI ring producers suite",
+	ipa_test_gsi_ring_suite_setup, ipa_test_gsi_ring_suite_teardown)
+{
+	IPA_UT_ADD_TEST(mt_producers,
+		"Several producers reserving, filling and publishing slots",
+		ipa_test_gsi_ring_mt_producers, false, IPA_HW_v3_0, IPA_HW_MAX),
+} IPA_UT_DEFINE_SUITE_END(gsi_ring);
@@ -941,6 +941,137 @@ static int ipa_test_hw_stats_reset_all_quota_stats(void *priv)
        return ret;
 }
 
+/**
+ * Delta queries against the cached quota and drop totals.
+ * The freshness window is closed for the test so that every query reads
+ * hardware and starts a new generation.
+ * Pass when:
+ * 1- gen 0 returns the totals and a non zero generation
+ * 2- a known generation returns deltas no bigger than the totals
+ * 3- a generation older than IPA_HW_STATS_SNAP_NUM reads returns totals
+ * 4- a generation from before a reset returns totals, the generation
+ *	returned after the reset works again
+ */
+static int ipa_test_hw_stats_query_delta_stats(void *priv)
+{
+	struct ipa_hw_stats_cache *cache;
+	struct ipa_quota_stats_all *delta;
+	struct ipa_quota_stats_all *total;
+	u64 gen, known;
+	u32 fresh_ms;
+	int i;
+	int ret;
+
+	if (!(ipa3_ctx->hw_stats && ipa3_ctx->hw_stats->enabled)) {
+		IPA_UT_INFO("hw stats disabled, nothing to test\n");
+		return 0;
+	}
+
+	delta = kzalloc(sizeof(*delta), GFP_KERNEL);
+	total = kzalloc(sizeof(*total), GFP_KERNEL);
+	if (!delta || !total) {
+		ret = -ENOMEM;
+		goto free;
+	}
+
+	cache = &ipa3_ctx->hw_stats->cache;
+	fresh_ms = READ_ONCE(cache->fresh_ms);
+	WRITE_ONCE(cache->fresh_ms, 0);
+
+	IPA_UT_INFO("========query delta stats since gen 0========\n");
+	gen = 0;
+	ret = ipa_get_hw_stats_delta(&gen, delta, NULL);
+	if (ret != 1 || !gen) {
+		IPA_UT_ERR("gen 0 returned %d gen %llu\n", ret, gen);
+		IPA_UT_TEST_FAIL_REPORT("gen 0 did not return totals");
+		ret = -EFAULT;
+		goto restore;
+	}
+
+	IPA_UT_INFO("========query delta stats since gen %llu========\n",
+		gen);
+	known = gen;
+	ret = ipa_get_hw_stats_delta(&gen, delta, NULL);
+	if (ret || gen <= known) {
+		IPA_UT_ERR("gen %llu returned %d gen %llu\n", known, ret, gen);
+		IPA_UT_TEST_FAIL_REPORT("known gen did not return deltas");
+		ret = -EFAULT;
+		goto restore;
+	}
+
+	/* totals only grow without a reset, a delta can't exceed them */
+	ret = ipa_get_quota_stats(total);
+	if (ret) {
+		IPA_UT_ERR("ipa_get_quota_stats failed %d\n", ret);
+		goto restore;
+	}
+	for (i = 0; i < IPA_CLIENT_MAX; i++) {
+		if (delta->client[i].num_ipv4_bytes >
+			total->client[i].num_ipv4_bytes ||
+			delta->client[i].num_ipv6_bytes >
+			total->client[i].num_ipv6_bytes ||
+			delta->client[i].num_ipv4_pkts >
+			total->client[i].num_ipv4_pkts ||
+			delta->client[i].num_ipv6_pkts >
+			total->client[i].num_ipv6_pkts) {
+			IPA_UT_ERR("client %d delta above total\n", i);
+			IPA_UT_TEST_FAIL_REPORT("delta above total");
+			ret = -EFAULT;
+			goto restore;
+		}
+	}
+
+	IPA_UT_INFO("========query delta stats since evicted gen========\n");
+	known = gen;
+	for (i = 0; i < IPA_HW_STATS_SNAP_NUM; i++) {
+		ret = ipa_get_quota_stats(NULL);
+		if (ret) {
+			IPA_UT_ERR("ipa_get_quota_stats failed %d\n", ret);
+			goto restore;
+		}
+	}
+	ret = ipa_get_hw_stats_delta(&gen, delta, NULL);
+	if (ret != 1) {
+		IPA_UT_ERR("evicted gen %llu returned %d\n", known, ret);
+		IPA_UT_TEST_FAIL_REPORT("evicted gen did not return totals");
+		ret = -EFAULT;
+		goto restore;
+	}
+
+	IPA_UT_INFO("========query delta stats across reset========\n");
+	known = gen;
+	ret = ipa_reset_all_quota_stats();
+	if (ret) {
+		IPA_UT_ERR("ipa_reset_all_quota_stats failed %d\n", ret);
+		goto restore;
+	}
+	ret = ipa_get_hw_stats_delta(&gen, delta, NULL);
+	if (ret != 1 || gen <= known) {
+		IPA_UT_ERR("gen %llu before reset returned %d gen %llu\n",
+			known, ret, gen);
+		IPA_UT_TEST_FAIL_REPORT("query across reset returned deltas");
+		ret = -EFAULT;
+		goto restore;
+	}
+	known = gen;
+	ret = ipa_get_hw_stats_delta(&gen, delta, NULL);
+	if (ret) {
+		IPA_UT_ERR("gen %llu after reset returned %d\n", known, ret);
+		IPA_UT_TEST_FAIL_REPORT("gen after reset did not return deltas");
+		ret = -EFAULT;
+		goto restore;
+	}
+
+	IPA_UT_INFO("================ done ============\n");
+
+restore:
+	WRITE_ONCE(cache->fresh_ms, fresh_ms);
+free:
+	kfree(total);
+	kfree(delta);
+	return ret;
+}
+
 static int ipa_test_hw_stats_set_uc_event_ring(void *priv)
 {
 	struct ipa_ioc_flt_rt_counter_alloc *counter = NULL;
@@ -1182,6 +1313,10 @@ IPA_UT_DEFINE_SUITE_START(hw_stats, "HW stats test",
 		ipa_test_hw_stats_reset_all_quota_stats, false,
 		IPA_HW_v4_5, IPA_HW_MAX),
 
+	IPA_UT_ADD_TEST(query_delta_stats, "Query delta stats",
+		ipa_test_hw_stats_query_delta_stats, false,
+		IPA_HW_v4_5, IPA_HW_MAX),
+
 	IPA_UT_ADD_TEST(set_uc_evtring, "Set uc event ring",
 		ipa_test_hw_stats_set_uc_event_ring, false,
 		IPA_HW_v4_5, IPA_HW_MAX),
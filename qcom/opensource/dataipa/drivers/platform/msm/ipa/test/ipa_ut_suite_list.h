@@ -21,6 +21,8 @@ IPA_UT_DECLARE_SUITE(hw_stats);
 IPA_UT_DECLARE_SUITE(wdi3);
 IPA_UT_DECLARE_SUITE(ntn);
 IPA_UT_DECLARE_SUITE(wdi3m);
+IPA_UT_DECLARE_SUITE(gsi_ring);
+IPA_UT_DECLARE_SUITE(dim);
 
 
 
@@ -38,6 +40,8 @@ IPA_UT_DEFINE_ALL_SUITES_START
 	IPA_UT_REGISTER_SUITE(wdi3),
 	IPA_UT_REGISTER_SUITE(ntn),
 	IPA_UT_REGISTER_SUITE(wdi3m),
+	IPA_UT_REGISTER_SUITE(gsi_ring),
+	IPA_UT_REGISTER_SUITE(dim),
 } IPA_UT_DEFINE_ALL_SUITES_END;
 
 #endif /* _IPA_UT_SUITE_LIST_H_ */
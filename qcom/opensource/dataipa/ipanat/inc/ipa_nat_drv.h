@@ -150,7 +150,8 @@ int ipa_nat_del_ipv4_tbl(uint32_t table_handle);
  *
  * To insert new ipv4 nat rule into ipv4 nat table
  *
- * Returns:	0  On Success, negative on failure
+ * Returns:	0  On Success, -ENOSPC when the table is full (and
+ *		couldn't be grown), other negative on failure
  */
 int ipa_nat_add_ipv4_rule(uint32_t table_handle,
 				const ipa_nat_ipv4_rule * rule,
@@ -168,6 +169,45 @@ int ipa_nat_add_ipv4_rule(uint32_t table_handle,
 int ipa_nat_del_ipv4_rule(uint32_t table_handle,
 				uint32_t rule_handle);
 
+/**
+ * ipa_nat_add_ipv4_rules() - to insert a batch of new ipv4 rules
+ * @table_handle: [in] handle of ipv4 nat table
+ * @rules: [in] Array of new rules
+ * @num_rules: [in] Number of rules in the array
+ * @rule_handles: [out] Handles of the rules added, in order
+ * @num_added: [out] Number of rules added
+ *
+ * To insert many ipv4 nat rules with as few DMA commands to the
+ * hardware as possible. On failure, the first num_added rules are
+ * in the table and their handles are valid.
+ *
+ * Returns:	0  On Success, -ENOSPC when the table is full (and
+ *		couldn't be grown), other negative on failure
+ */
+int ipa_nat_add_ipv4_rules(uint32_t table_handle,
+				const ipa_nat_ipv4_rule *rules,
+				uint32_t num_rules,
+				uint32_t *rule_handles,
+				uint32_t *num_added);
+
+/**
+ * ipa_nat_del_ipv4_rules() - to delete a batch of ipv4 nat rules
+ * @table_handle: [in] handle of ipv4 nat table
+ * @rule_handles: [in] Array of ipv4 nat rule handles
+ * @num_rules: [in] Number of handles in the array
+ * @num_deleted: [out] Number of rules deleted
+ *
+ * To delete many ipv4 nat rules with as few DMA commands to the
+ * hardware as possible. On failure, the first num_deleted rules
+ * have been deleted.
+ *
+ * Returns:	0  On Success, negative on failure
+ */
+int ipa_nat_del_ipv4_rules(uint32_t table_handle,
+				const uint32_t *rule_handles,
+				uint32_t num_rules,
+				uint32_t *num_deleted);
+
 
 /**
  * ipa_nat_query_timestamp() - to query timestamp
@@ -284,5 +324,27 @@ int ipa_nat_switch_to(
 	enum ipa3_nat_mem_in nmi,
 	bool                 hold_state );
 
+/**
+ * ipa_nat_set_ddr_tbl_growth() - Controls how the DDR table, while in
+ * focus, grows.
+ * @when_full: Grow the table, and retry, when a rule add finds it
+ *             full (the default)
+ * @when_crowded: Also grow the table ahead of time, when its chains
+ *                get long or its expansion table gets crowded (off by
+ *                default)
+ * @max_ents: Never grow the table past this many entries (zero means
+ *            the most a table can have)
+ *
+ * Growing the table recreates it, so for a short while the IPA can't
+ * find its connections and hands their packets up to the apps.
+ * Handles given out before a grow stay valid after it.
+ *
+ * Returns:	0  On Success, negative on failure
+ */
+int ipa_nat_set_ddr_tbl_growth(
+	bool     when_full,
+	bool     when_crowded,
+	uint32_t max_ents );
+
 #endif
 
@@ -265,6 +265,7 @@ struct ipa_nat_indx_tbl_meta_info {
 
 struct ipa_nat_ip4_table_cache {
 	uint32_t public_addr;
+	uint16_t number_of_entries;
 	ipa_mem_descriptor mem_desc;
 	ipa_table table;
 	ipa_table index_table;
@@ -309,6 +310,17 @@ int ipa_nati_add_ipv4_rule(uint32_t tbl_hdl,
 int ipa_nati_del_ipv4_rule(uint32_t tbl_hdl,
 				uint32_t rule_hdl);
 
+int ipa_nati_add_ipv4_rules(uint32_t tbl_hdl,
+				const ipa_nat_ipv4_rule *clnt_rules,
+				uint32_t num_rules,
+				uint32_t *rule_hdls,
+				uint32_t *num_added);
+
+int ipa_nati_del_ipv4_rules(uint32_t tbl_hdl,
+				const uint32_t *rule_hdls,
+				uint32_t num_rules,
+				uint32_t *num_deleted);
+
 int ipa_nati_get_sram_size(
 	uint32_t* size_ptr);
 
@@ -343,6 +355,7 @@ int ipa_nati_walk_ipv4_tbl(
 typedef struct
 {
 	enum ipa3_nat_mem_in nmi;
+	uint32_t req_ents; /* number_of_entries the table was created with */
 	uint32_t tot_ents;
 	uint32_t tot_base_ents;
 	uint32_t tot_base_ents_filled;
@@ -371,6 +384,10 @@ int ipa_NATI_add_ipv4_tbl(
 int ipa_NATI_del_ipv4_table(
 	uint32_t tbl_hdl);
 
+int ipa_NATI_resize_ipv4_tbl(
+	uint32_t tbl_hdl,
+	uint16_t number_of_entries);
+
 int ipa_NATI_clear_ipv4_tbl(
 	uint32_t tbl_hdl );
 
@@ -400,6 +417,19 @@ int ipa_NATI_del_ipv4_rule(
 	uint32_t tbl_hdl,
 	uint32_t rule_hdl);
 
+int ipa_NATI_add_ipv4_rules(
+	uint32_t                 tbl_hdl,
+	const ipa_nat_ipv4_rule* clnt_rules,
+	uint32_t                 num_rules,
+	uint32_t*                rule_hdls,
+	uint32_t*                num_added);
+
+int ipa_NATI_del_ipv4_rules(
+	uint32_t        tbl_hdl,
+	const uint32_t* rule_hdls,
+	uint32_t        num_rules,
+	uint32_t*       num_deleted);
+
 int ipa_NATI_post_ipv4_init_cmd(
 	uint32_t tbl_hdl );
 
@@ -58,7 +58,7 @@ typedef enum
 } ipa_which_map;
 
 #define VALID_IPA_USE_MAP(w) \
-	( (w) >= MAP_NUM_00 || (w) < MAP_NUM_MAX )
+	( (w) >= MAP_NUM_00 && (w) < MAP_NUM_MAX )
 
 /* KEEP THE FOLLOWING IN SYNC WITH ABOVE. */
 static inline const char* ipa_which_map_as_str(
@@ -79,6 +79,14 @@ static inline const char* ipa_which_map_as_str(
 	return "???";
 }
 
+/*
+ * Presize a map to hold num_ents entries, so that adds up to that
+ * count never allocate.
+ */
+int ipa_nat_map_reserve(
+	ipa_which_map which,
+	uint32_t      num_ents );
+
 int ipa_nat_map_add(
 	ipa_which_map which,
 	uint32_t      key,
@@ -89,6 +97,14 @@ int ipa_nat_map_find(
 	uint32_t      key,
 	uint32_t*     val_ptr );
 
+/*
+ * Non-zero when key is in the map.  Unlike ipa_nat_map_find(), a
+ * missing key is not reported as an error.
+ */
+int ipa_nat_map_has(
+	ipa_which_map which,
+	uint32_t      key );
+
 int ipa_nat_map_del(
 	ipa_which_map which,
 	uint32_t      key,
@@ -102,6 +102,9 @@ typedef enum {
 	NATI_TRIG_GOTO_DDR   =  9,
 	NATI_TRIG_GOTO_SRAM  = 10,
 	NATI_TRIG_GET_TSTAMP = 11,
+	NATI_TRIG_ADD_RULES  = 12,
+	NATI_TRIG_DEL_RULES  = 13,
+	NATI_TRIG_TBL_RESIZE = 14,
 
 	NATI_TRIG_LAST
 } ipa_nati_trigger;
@@ -159,6 +162,19 @@ typedef struct
 	 * sw_stats[1] for sram
 	 */
 	nati_switch_stats sw_stats[2];
+	/*
+	 * For growing the DDR table when it fills up or, if asked for,
+	 * when it gets crowded (see ipa_nat_set_ddr_tbl_growth())
+	 */
+	bool              grow_when_full;
+	bool              grow_when_crowded;
+	uint32_t          grow_max_ents;
+	uint32_t          adds_since_resize_chk;
+	nati_switch_stats resize_stats;
+	/*
+	 * Next made up original rule handle (see gen_orig_rule_hdl())
+	 */
+	uint32_t          next_alias_hdl;
 } ipa_nati_obj;
 
 /*
@@ -201,6 +217,11 @@ typedef struct
 	( nati_obj.curr_state == NATI_STATE_SRAM_ONLY || \
 	  nati_obj.curr_state == NATI_STATE_HYBRID )
 
+#undef  DDR_CURRENTLY_ACTIVE
+#define DDR_CURRENTLY_ACTIVE() \
+	( nati_obj.curr_state == NATI_STATE_DDR_ONLY || \
+	  nati_obj.curr_state == NATI_STATE_HYBRID_DDR )
+
 #define SRAM_TO_BE_ACCESSED(t) \
 	( SRAM_CURRENTLY_ACTIVE() || \
 	  (t) == NATI_TRIG_GOTO_SRAM || \
@@ -46,6 +46,13 @@
 #define MAX_DMA_ENTRIES_FOR_ADD 4
 #define MAX_DMA_ENTRIES_FOR_DEL 3
 
+/*
+ * Upper bound on the DMA entries coalesced into one
+ * IPA_IOC_TABLE_DMA_CMD by the batched rule add/delete API. Must not
+ * exceed IPA_MAX_NUM_OF_TABLE_DMA_CMD_ENTRIES of the kernel driver.
+ */
+#define MAX_DMA_ENTRIES_FOR_BATCH 60
+
 #if !defined(MSM_IPA_TESTS) && !defined(FEATURE_IPA_ANDROID)
 #ifdef USE_GLIB
 #include <glib.h>
@@ -170,6 +170,14 @@ typedef struct
 	uint16_t                   cur_tbl_cnt;
 	uint16_t                   cur_expn_tbl_cnt;
 
+	/*
+	 * Stack of the free expansion table slots (absolute indexes).
+	 * When present, it makes finding an open expansion slot O(1)
+	 * rather than a walk of the expansion table.
+	 */
+	uint16_t*                  expn_free_list;
+	uint16_t                   expn_free_cnt;
+
 	ipa_table_entry_interface* entry_interface;
 
 	ipa_table_dma_cmd_helper*  dma_help[HELP_UPDATE_MAX];
@@ -215,6 +223,12 @@ uint8_t* ipa_table_calculate_addresses(
 void ipa_table_reset(
 	ipa_table* table);
 
+int ipa_table_alloc_expn_free_list(
+	ipa_table* table);
+
+void ipa_table_free_expn_free_list(
+	ipa_table* table);
+
 int ipa_table_add_entry(
 	ipa_table*                  table,
 	void*                       user_data,
@@ -279,6 +293,10 @@ int ipa_table_iterator_end(
 int ipa_table_iterator_is_head_with_tail(
 	ipa_table_iterator* iterator);
 
+uint16_t ipa_table_get_chain_head(
+	ipa_table* table,
+	uint16_t   rec_index);
+
 int ipa_calc_num_sram_table_entries(
 	uint32_t  sram_size,
 	uint32_t  table1_ent_size,
@@ -672,6 +672,13 @@ static int ipa_ipv6ct_create_table(ipa_ipv6ct_table* ipv6ct_table, uint16_t numb
 		return ret;
 	}
 
+	ret = ipa_table_alloc_expn_free_list(&ipv6ct_table->table);
+	if (ret)
+	{
+		IPAERR("unable to allocate ipv6ct expansion free list\n");
+		goto bail;
+	}
+
 	size = ipa_table_calculate_size(&ipv6ct_table->table);
 	IPADBG("IPv6CT table size: %d\n", size);
 
@@ -704,6 +711,7 @@ static int ipa_ipv6ct_create_table(ipa_ipv6ct_table* ipv6ct_table, uint16_t numb
 	return 0;
 
 bail:
+	ipa_table_free_expn_free_list(&ipv6ct_table->table);
 	memset(ipv6ct_table, 0, sizeof(*ipv6ct_table));
 	return ret;
 }
@@ -718,6 +726,8 @@ static int ipa_ipv6ct_destroy_table(ipa_ipv6ct_table* ipv6ct_table)
 	if (ret)
 		IPAERR("unable to delete IPV6CT descriptor\n");
 
+	ipa_table_free_expn_free_list(&ipv6ct_table->table);
+
 	memset(ipv6ct_table, 0, sizeof(*ipv6ct_table));
 
 	IPADBG("return\n");
@@ -705,7 +705,8 @@ static int ipa_nati_create_table(
 
 	IPADBG("In\n");
 
-	nat_table->public_addr = public_ip_addr;
+	nat_table->public_addr       = public_ip_addr;
+	nat_table->number_of_entries = number_of_entries;
 
 	ipa_table_init(
 		&nat_table->table,
@@ -763,6 +764,20 @@ static int ipa_nati_create_table(
 	nat_table->index_table.tot_tbl_ents =
 		nat_table->table.tot_tbl_ents;
 
+	ret = ipa_table_alloc_expn_free_list(&nat_table->table);
+
+	if (ret) {
+		IPAERR("unable to allocate nat expansion free list\n");
+		goto bail_meta;
+	}
+
+	ret = ipa_table_alloc_expn_free_list(&nat_table->index_table);
+
+	if (ret) {
+		IPAERR("unable to allocate nat index expansion free list\n");
+		goto bail_meta;
+	}
+
 	size  = ipa_table_calculate_size(&nat_table->table);
 	size += ipa_table_calculate_size(&nat_table->index_table);
 
@@ -817,6 +832,8 @@ bail_mem_desc:
 #endif
 
 bail_meta:
+	ipa_table_free_expn_free_list(&nat_table->table);
+	ipa_table_free_expn_free_list(&nat_table->index_table);
 	free(nat_table->index_expn_table_meta);
 	memset(nat_table, 0, sizeof(*nat_table));
 
@@ -840,6 +857,9 @@ static int ipa_nati_destroy_table(
 	if (ret)
 		IPAERR("unable to delete NAT descriptor\n");
 
+	ipa_table_free_expn_free_list(&nat_table->table);
+	ipa_table_free_expn_free_list(&nat_table->index_table);
+
 	free(nat_table->index_expn_table_meta);
 
 	memset(nat_table, 0, sizeof(*nat_table));
@@ -1106,6 +1126,92 @@ bail:
 	return ret;
 }
 
+/*
+ * Whether the kernel takes coalesced DMA commands (older kernels
+ * have a small per ioctl entry limit). Found out by
+ * ipa_nati_probe_batch_dma() below.
+ */
+typedef enum
+{
+	BATCH_DMA_UNKNOWN     = 0,
+	BATCH_DMA_SUPPORTED   = 1,
+	BATCH_DMA_UNSUPPORTED = 2,
+} ipa_nati_batch_dma;
+
+static ipa_nati_batch_dma batch_dma = BATCH_DMA_UNKNOWN;
+
+/*
+ * Called with a freshly created, hence empty, table. Posts a full
+ * size coalesced command that writes zero over the already zero
+ * next_index of base records, so it leaves the table as it is. The
+ * kernel's error doesn't say why a command was refused, hence if
+ * this one is, a single rule's worth of the same entries is posted.
+ * Only when that goes through is batching deemed unsupported.
+ */
+static void ipa_nati_probe_batch_dma(
+	struct ipa_nat_cache*           nat_cache_ptr,
+	struct ipa_nat_ip4_table_cache* nat_table)
+{
+	uint32_t cmd_sz =
+		sizeof(struct ipa_ioc_nat_dma_cmd) +
+		(MAX_DMA_ENTRIES_FOR_BATCH * sizeof(struct ipa_ioc_nat_dma_one));
+	char cmd_buf[cmd_sz];
+	struct ipa_ioc_nat_dma_cmd* cmd =
+		(struct ipa_ioc_nat_dma_cmd*) cmd_buf;
+
+	uint16_t rec_index;
+	uint32_t i;
+
+	IPADBG("In\n");
+
+	if ( batch_dma != BATCH_DMA_UNKNOWN )
+	{
+		goto bail;
+	}
+
+	memset(cmd_buf, 0, sizeof(cmd_buf));
+
+	/*
+	 * Record zero is never used (see dst_hash())
+	 */
+	for ( i = 0; i < MAX_DMA_ENTRIES_FOR_BATCH; i++ )
+	{
+		rec_index = 1 + (i % (nat_table->table.table_entries - 1));
+
+		ipa_table_add_dma_cmd(
+			&nat_table->table,
+			HELP_UPDATE_ENTRY,
+			GOTO_REC(&nat_table->table, rec_index),
+			rec_index,
+			0,
+			cmd);
+	}
+
+	if ( ipa_nati_post_ipv4_dma_cmd(nat_cache_ptr, cmd) == 0 )
+	{
+		batch_dma = BATCH_DMA_SUPPORTED;
+		goto bail;
+	}
+
+	cmd->entries = MAX_DMA_ENTRIES_FOR_ADD;
+
+	if ( ipa_nati_post_ipv4_dma_cmd(nat_cache_ptr, cmd) == 0 )
+	{
+		IPAERR("Coalesced DMA commands of %u entries refused; "
+			   "posting rule by rule\n",
+			   MAX_DMA_ENTRIES_FOR_BATCH);
+
+		batch_dma = BATCH_DMA_UNSUPPORTED;
+	}
+	else
+	{
+		IPAERR("Unable to tell whether coalesced DMA commands are supported\n");
+	}
+
+bail:
+	IPADBG("Out\n");
+}
+
 /*
  * ----------------------------------------------------------------------------
  * API functions exposed to the upper layers
@@ -1449,6 +1555,8 @@ int ipa_NATI_add_ipv4_tbl(
 		goto failed_post_init_cmd;
 	}
 
+	ipa_nati_probe_batch_dma(nat_cache_ptr, nat_table);
+
 	active_nat_cache_ptr = nat_cache_ptr;
 
 	/*
@@ -1552,6 +1660,157 @@ bail:
 	return ret;
 }
 
+/**
+ * ipa_NATI_resize_ipv4_tbl() - Recreates an IPv4 NAT table at a new size
+ * @tbl_hdl: [in] handle of the table to recreate
+ * @number_of_entries: [in] number of NAT entries for the new table
+ *
+ * The kernel maps only one NAT table per memory type, so the table
+ * is deleted and then created again, empty, with the same public IP
+ * address and handle.  Deleting the table also drops the PDN table in
+ * the kernel, hence the cached PDN entries are posted again.  Putting
+ * the rules back is up to the caller.
+ *
+ * On failure, the table may be gone.  The caller can tell by asking
+ * ipa_NATI_ipv4_tbl_stats() about tbl_hdl.
+ *
+ * Returns:	0  On Success, negative on failure
+ */
+int ipa_NATI_resize_ipv4_tbl(
+	uint32_t tbl_hdl,
+	uint16_t number_of_entries )
+{
+	enum ipa3_nat_mem_in            nmi;
+	uint32_t                        broken_tbl_hdl, new_tbl_hdl;
+	struct ipa_nat_ip4_table_cache* nat_table;
+	struct ipa_ioc_nat_pdn_entry    pdn_data;
+	ipa_table                       size_check;
+
+	ipa_nat_pdn_entry               saved_pdns[IPA_MAX_PDN_NUM];
+	ipa_nat_pdn_entry               zero_test;
+	uint32_t                        public_ip_addr;
+	int                             saved_num_pdns, i;
+
+	int ret;
+
+	IPADBG("In\n");
+
+	BREAK_TBL_HDL(tbl_hdl, nmi, broken_tbl_hdl);
+
+	if ( ! IPA_VALID_NAT_MEM_IN(nmi) || ! VALID_TBL_HDL(tbl_hdl) ) {
+		IPAERR("Bad table handle 0x%08X\n", tbl_hdl);
+		ret = -EINVAL;
+		goto bail;
+	}
+
+	IPADBG("nmi(%s) number_of_entries(%u)\n",
+		   ipa3_nat_mem_in_as_str(nmi), number_of_entries);
+
+	nat_table = &ipv4_nat_cache[nmi].ip4_tbl[broken_tbl_hdl - 1];
+
+	if (pthread_mutex_lock(&nat_mutex)) {
+		IPAERR("unable to lock the nat mutex\n");
+		ret = -EINVAL;
+		goto bail;
+	}
+
+	if (! nat_table->mem_desc.valid) {
+		IPAERR("invalid table handle 0x%08X\n", tbl_hdl);
+		ret = -EINVAL;
+		goto unlock;
+	}
+
+	/*
+	 * Make sure a table of the new size can be had before the
+	 * current one is thrown away...
+	 */
+	size_check = nat_table->table;
+
+	ret = ipa_table_calculate_entries_num(&size_check, number_of_entries, nmi);
+
+	if (ret) {
+		IPAERR("NAT table can't be recreated with %u entries\n",
+			   number_of_entries);
+		goto unlock;
+	}
+
+	public_ip_addr = nat_table->public_addr;
+
+	memcpy(saved_pdns, pdns, sizeof(saved_pdns));
+	saved_num_pdns = num_pdns;
+
+	ret = ipa_NATI_del_ipv4_table(tbl_hdl);
+
+	if (ret) {
+		IPAERR("unable to delete NAT table with handle 0x%08X\n", tbl_hdl);
+		goto unlock;
+	}
+
+	ret = ipa_NATI_add_ipv4_tbl(
+		nmi, public_ip_addr, number_of_entries, &new_tbl_hdl);
+
+	if (ret) {
+		IPAERR("unable to recreate NAT table with %u entries\n",
+			   number_of_entries);
+		goto unlock;
+	}
+
+	/*
+	 * The caller's rule handle maps are keyed by table handle, so
+	 * the table must come back in the same slot...
+	 */
+	if (new_tbl_hdl != tbl_hdl) {
+		IPAERR("NAT table recreated as 0x%08X, not as 0x%08X\n",
+			   new_tbl_hdl, tbl_hdl);
+		ipa_NATI_del_ipv4_table(new_tbl_hdl);
+		ret = -EIO;
+		goto unlock;
+	}
+
+	/*
+	 * Table creation above reposted PDN zero with the table's public
+	 * address only, so anything else needs to be put back...
+	 */
+	memset(&zero_test, 0, sizeof(zero_test));
+
+	for (i = 0; i < (IPA_MAX_PDN_NUM - 1); i++) {
+
+		if (! memcmp(&saved_pdns[i], &zero_test, sizeof(zero_test)))
+			continue;
+
+		if (i == 0 && ! memcmp(&saved_pdns[i], &pdns[i], sizeof(zero_test)))
+			continue;
+
+		pdn_data.pdn_index    = i;
+		pdn_data.public_ip    = saved_pdns[i].public_ip;
+		pdn_data.src_metadata = saved_pdns[i].src_metadata;
+		pdn_data.dst_metadata = saved_pdns[i].dst_metadata;
+
+		ret = ipa_nati_modify_pdn(&pdn_data);
+
+		if (ret) {
+			IPAERR("unable to restore PDN %d\n", i);
+			goto unlock;
+		}
+	}
+
+	num_pdns = saved_num_pdns;
+
+	IPADBG("tbl_hdl(0x%08X) recreated with %u entries\n",
+		   new_tbl_hdl, number_of_entries);
+
+unlock:
+	if (pthread_mutex_unlock(&nat_mutex)) {
+		IPAERR("unable to unlock the nat mutex\n");
+		ret = (ret) ? ret : -EPERM;
+	}
+
+bail:
+	IPADBG("Out\n");
+
+	return ret;
+}
+
 int ipa_NATI_query_timestamp_redirect(
 	uint32_t  tbl_hdl,
 	uint32_t  rule_hdl,
@@ -1626,69 +1885,33 @@ bail:
 	return ret;
 }
 
-int ipa_NATI_add_ipv4_rule(
-	uint32_t                 tbl_hdl,
-	const ipa_nat_ipv4_rule* clnt_rule,
-	uint32_t*                rule_hdl)
+/*
+ * Per rule state kept by the batched add/delete paths between
+ * building a rule's DMA entries and posting them.
+ */
+typedef struct
 {
-	uint32_t cmd_sz =
-		sizeof(struct ipa_ioc_nat_dma_cmd) +
-		(MAX_DMA_ENTRIES_FOR_ADD * sizeof(struct ipa_ioc_nat_dma_one));
-	char cmd_buf[cmd_sz];
-	struct ipa_ioc_nat_dma_cmd* cmd =
-		(struct ipa_ioc_nat_dma_cmd*) cmd_buf;
-
-	enum ipa3_nat_mem_in            nmi;
-	struct ipa_nat_cache*           nat_cache_ptr;
-	struct ipa_nat_ip4_table_cache* nat_table;
-	struct ipa_nat_rule*            rule;
-
-	uint16_t new_entry_index;
-	uint16_t new_index_tbl_entry_index;
-	uint32_t new_entry_handle;
-	char     buf[1024];
-
-	int ret = 0;
-
-	IPADBG("In\n");
-
-	memset(cmd_buf, 0, sizeof(cmd_buf));
-
-	if ( ! VALID_TBL_HDL(tbl_hdl) ||
-		 ! clnt_rule ||
-		 ! rule_hdl )
-	{
-		IPAERR("Bad arg: tbl_hdl(0x%08X) and/or clnt_rule(%p) and/or rule_hdl(%p)\n",
-			   tbl_hdl, clnt_rule, rule_hdl);
-		ret = -EINVAL;
-		goto done;
-	}
-
-	*rule_hdl = 0;
-
-	IPADBG("tbl_hdl(0x%08X)\n", tbl_hdl);
-
-	BREAK_TBL_HDL(tbl_hdl, nmi, tbl_hdl);
+	uint16_t           tbl_head;
+	uint16_t           index_tbl_head;
+	uint8_t            num_dma_ents;
 
-	if ( ! IPA_VALID_NAT_MEM_IN(nmi) ) {
-		IPAERR("Bad cache type argument passed\n");
-		ret = -EINVAL;
-		goto done;
-	}
-
-	IPADBG("tbl_hdl(0x%08X) nmi(%s) %s\n",
-		   tbl_hdl,
-		   ipa3_nat_mem_in_as_str(nmi),
-		   prep_nat_ipv4_rule_4print(clnt_rule, buf, sizeof(buf)));
+	uint16_t           new_entry_index;
+	uint16_t           new_index_tbl_entry_index;
+	uint32_t           rule_hdl;
 
-	nat_cache_ptr = &ipv4_nat_cache[nmi];
+	ipa_table_iterator table_iterator;
+	ipa_table_iterator index_table_iterator;
+} ipa_nati_batch_op;
 
-	nat_table = &nat_cache_ptr->ip4_tbl[tbl_hdl - 1];
+#undef  IPA_NATI_MAX_BATCH_OPS
+#define IPA_NATI_MAX_BATCH_OPS (MAX_DMA_ENTRIES_FOR_BATCH / 2)
 
+static int ipa_nati_validate_ipv4_rule(
+	const ipa_nat_ipv4_rule* clnt_rule)
+{
 	if (clnt_rule->protocol == IPAHAL_NAT_INVALID_PROTOCOL) {
 		IPAERR("invalid parameter protocol=%d\n", clnt_rule->protocol);
-		ret = -EINVAL;
-		goto done;
+		return -EINVAL;
 	}
 
 	/*
@@ -1698,25 +1921,22 @@ int ipa_NATI_add_ipv4_rule(
 		pdns[clnt_rule->pdn_index].public_ip == 0) {
 		IPAERR("invalid parameters, pdn index %d, public ip = 0x%X\n",
 			   clnt_rule->pdn_index, pdns[clnt_rule->pdn_index].public_ip);
-		ret = -EINVAL;
-		goto done;
-	}
-
-	if (pthread_mutex_lock(&nat_mutex)) {
-		IPAERR("unable to lock the nat mutex\n");
-		ret = -EINVAL;
-		goto done;
+		return -EINVAL;
 	}
 
-	if (! nat_table->mem_desc.valid) {
-		IPAERR("invalid table handle %d\n", tbl_hdl);
-		ret = -EINVAL;
-		goto unlock;
-	}
+	return 0;
+}
 
+static void ipa_nati_calc_ipv4_rule_hashes(
+	struct ipa_nat_cache*           nat_cache_ptr,
+	struct ipa_nat_ip4_table_cache* nat_table,
+	const ipa_nat_ipv4_rule*        clnt_rule,
+	uint16_t*                       new_entry_index,
+	uint16_t*                       new_index_tbl_entry_index)
+{
 	/* src_only */
 	if (clnt_rule->src_only) {
-		new_entry_index = dst_hash(
+		*new_entry_index = dst_hash(
 			nat_cache_ptr,
 			pdns[clnt_rule->pdn_index].public_ip,
 			clnt_rule->target_ip,
@@ -1724,13 +1944,13 @@ int ipa_NATI_add_ipv4_rule(
 			clnt_rule->public_port,
 			clnt_rule->protocol,
 			nat_table->table.table_entries - 1) + Hash_token;
-		new_entry_index = (new_entry_index & (nat_table->table.table_entries - 1));
-		if (new_entry_index == 0) {
-			new_entry_index = nat_table->table.table_entries - 1;
+		*new_entry_index = (*new_entry_index & (nat_table->table.table_entries - 1));
+		if (*new_entry_index == 0) {
+			*new_entry_index = nat_table->table.table_entries - 1;
 		}
 		Hash_token++;
 	} else {
-	new_entry_index = dst_hash(
+	*new_entry_index = dst_hash(
 		nat_cache_ptr,
 		pdns[clnt_rule->pdn_index].public_ip,
 		clnt_rule->target_ip,
@@ -1740,34 +1960,22 @@ int ipa_NATI_add_ipv4_rule(
 		nat_table->table.table_entries - 1);
 	}
 
-	ret = ipa_table_add_entry(
-		&nat_table->table,
-		(void*) clnt_rule,
-		&new_entry_index,
-		&new_entry_handle,
-		cmd);
-
-	if (ret) {
-		IPAERR("Failed to add a new NAT entry\n");
-		goto unlock;
-	}
-
 	/* dst_only */
 	if (clnt_rule->dst_only) {
-		new_index_tbl_entry_index =
+		*new_index_tbl_entry_index =
 			src_hash(clnt_rule->private_ip,
 				 clnt_rule->private_port,
 				 clnt_rule->target_ip,
 				 clnt_rule->target_port,
 				 clnt_rule->protocol,
 				 nat_table->table.table_entries - 1) + Hash_token;
-		new_index_tbl_entry_index = (new_index_tbl_entry_index & (nat_table->table.table_entries - 1));
-		if (new_index_tbl_entry_index == 0) {
-			new_index_tbl_entry_index = nat_table->table.table_entries - 1;
+		*new_index_tbl_entry_index = (*new_index_tbl_entry_index & (nat_table->table.table_entries - 1));
+		if (*new_index_tbl_entry_index == 0) {
+			*new_index_tbl_entry_index = nat_table->table.table_entries - 1;
 		}
 		Hash_token++;
 	} else {
-	new_index_tbl_entry_index =
+	*new_index_tbl_entry_index =
 		src_hash(clnt_rule->private_ip,
 				 clnt_rule->private_port,
 				 clnt_rule->target_ip,
@@ -1775,41 +1983,522 @@ int ipa_NATI_add_ipv4_rule(
 				 clnt_rule->protocol,
 				 nat_table->table.table_entries - 1);
 	}
+}
+
+/*
+ * Adds the rule to the local NAT and index tables and appends the
+ * DMA entries that make it visible to IPA onto cmd. On entry, the
+ * indexes are the hash results; on success, they are where the
+ * records landed. On failure, nothing is left in the local tables.
+ */
+static int ipa_nati_insert_ipv4_rule(
+	struct ipa_nat_ip4_table_cache* nat_table,
+	const ipa_nat_ipv4_rule*        clnt_rule,
+	uint16_t*                       new_entry_index,
+	uint16_t*                       new_index_tbl_entry_index,
+	uint32_t*                       new_entry_handle,
+	struct ipa_ioc_nat_dma_cmd*     cmd)
+{
+	struct ipa_nat_rule* rule;
+	int                  ret;
+
 	ret = ipa_table_add_entry(
-		&nat_table->index_table,
-		(void*) &new_entry_index,
-		&new_index_tbl_entry_index,
-		NULL,
+		&nat_table->table,
+		(void*) clnt_rule,
+		new_entry_index,
+		new_entry_handle,
 		cmd);
 
 	if (ret) {
-		IPAERR("failed to add a new NAT index entry\n");
-		goto fail_add_index_entry;
+		IPAERR("Failed to add a new NAT entry\n");
+		goto done;
 	}
 
-	rule = ipa_table_get_entry_by_index(
+	ret = ipa_table_add_entry(
+		&nat_table->index_table,
+		(void*) new_entry_index,
+		new_index_tbl_entry_index,
+		NULL,
+		cmd);
+
+	if (ret) {
+		IPAERR("failed to add a new NAT index entry\n");
+		goto fail_add_index_entry;
+	}
+
+	rule = ipa_table_get_entry_by_index(
 		&nat_table->table,
-		new_entry_index);
+		*new_entry_index);
 
 	if (rule == NULL) {
-		IPAERR("Failed to retrieve the entry in index %d for NAT table with handle=%d\n",
-			   new_entry_index, tbl_hdl);
+		IPAERR("Failed to retrieve the entry in index %d for NAT table\n",
+			   *new_entry_index);
 		ret = -EPERM;
 		goto bail;
 	}
 
-	rule->indx_tbl_entry = new_index_tbl_entry_index;
-
-	rule->redirect   = clnt_rule->redirect;
-	rule->enable     = clnt_rule->enable;
-	rule->time_stamp = clnt_rule->time_stamp;
+	rule->indx_tbl_entry = *new_index_tbl_entry_index;
+
+	rule->redirect   = clnt_rule->redirect;
+	rule->enable     = clnt_rule->enable;
+	rule->time_stamp = clnt_rule->time_stamp;
+
+	IPADBG("new entry:%d, new index entry: %d, rule_hdl(0x%08X)\n",
+		   *new_entry_index, *new_index_tbl_entry_index,
+		   *new_entry_handle);
+
+	goto done;
+
+bail:
+	ipa_table_erase_entry(&nat_table->index_table, *new_index_tbl_entry_index);
+
+fail_add_index_entry:
+	ipa_table_erase_entry(&nat_table->table, *new_entry_index);
+
+done:
+	return ret;
+}
+
+/*
+ * Finds the rule's record and the base table indexes of the NAT
+ * and index table chains it sits on.
+ */
+static int ipa_nati_get_ipv4_rule_chain_heads(
+	struct ipa_nat_ip4_table_cache* nat_table,
+	uint32_t                        rule_hdl,
+	uint16_t*                       tbl_head,
+	uint16_t*                       index_tbl_head)
+{
+	struct ipa_nat_rule* table_rule;
+	uint16_t             index;
+	int                  ret;
+
+	ret = ipa_table_get_entry(
+		&nat_table->table,
+		rule_hdl,
+		(void**) &table_rule,
+		&index);
+
+	if (ret) {
+		IPAERR("Unable to retrive the entry with rule_hdl=%u\n", rule_hdl);
+		return ret;
+	}
+
+	*tbl_head =
+		ipa_table_get_chain_head(&nat_table->table, index);
+
+	*index_tbl_head =
+		ipa_table_get_chain_head(&nat_table->index_table, table_rule->indx_tbl_entry);
+
+	return 0;
+}
+
+/*
+ * Builds the DMA entries that remove the rule from IPA's view of
+ * the tables. The local tables are left alone until the command has
+ * been posted; see ipa_nati_finish_del_ipv4_rule().
+ */
+static int ipa_nati_prep_del_ipv4_rule(
+	struct ipa_nat_ip4_table_cache* nat_table,
+	uint32_t                        tbl_hdl,
+	uint32_t                        rule_hdl,
+	ipa_table_iterator*             table_iterator,
+	ipa_table_iterator*             index_table_iterator,
+	struct ipa_ioc_nat_dma_cmd*     cmd)
+{
+	struct ipa_nat_rule*          table_rule;
+	struct ipa_nat_indx_tbl_rule* index_table_rule;
+
+	uint16_t index;
+	char     buf[1024];
+	int      ret;
+
+	ret = ipa_table_get_entry(
+		&nat_table->table,
+		rule_hdl,
+		(void**) &table_rule,
+		&index);
+
+	if (ret) {
+		IPAERR("Unable to retrive the entry with rule_hdl=%u\n", rule_hdl);
+		goto done;
+	}
+
+	IPADBG("rule_hdl(0x%08X) -> %s\n",
+		   rule_hdl,
+		   prep_nat_rule_4print(table_rule, buf, sizeof(buf)));
+
+	ret = ipa_table_iterator_init(
+		table_iterator,
+		&nat_table->table,
+		table_rule,
+		index);
+
+	if (ret) {
+		IPAERR("Unable to create iterator which points to the "
+			   "entry %u in NAT table with handle=0x%08X\n",
+			   index, tbl_hdl);
+		goto done;
+	}
+
+	index = table_rule->indx_tbl_entry;
+
+	index_table_rule = (struct ipa_nat_indx_tbl_rule*)
+		ipa_table_get_entry_by_index(&nat_table->index_table, index);
+
+	if (index_table_rule == NULL) {
+		IPAERR("Unable to retrieve the entry in index %u "
+			   "in NAT index table with handle=0x%08X\n",
+			   index, tbl_hdl);
+		ret = -EPERM;
+		goto done;
+	}
+
+	ret = ipa_table_iterator_init(
+		index_table_iterator,
+		&nat_table->index_table,
+		index_table_rule,
+		index);
+
+	if (ret) {
+		IPAERR("Unable to create iterator which points to the "
+			   "entry %u in NAT index table with handle=0x%08X\n",
+			   index, tbl_hdl);
+		goto done;
+	}
+
+	ipa_table_create_delete_command(
+		&nat_table->index_table,
+		cmd,
+		index_table_iterator);
+
+	if (ipa_table_iterator_is_head_with_tail(index_table_iterator)) {
+
+		ipa_nati_copy_second_index_entry_to_head(
+			nat_table, index_table_iterator, cmd);
+		/*
+		 * Iterate to the next entry which should be deleted
+		 */
+		ret = ipa_table_iterator_next(
+			index_table_iterator, &nat_table->index_table);
+
+		if (ret) {
+			IPAERR("Unable to move the iterator to the next entry "
+				   "(points to the entry %u in NAT index table)\n",
+				   index);
+			goto done;
+		}
+	}
+
+	ipa_table_create_delete_command(
+		&nat_table->table,
+		cmd,
+		table_iterator);
+
+done:
+	return ret;
+}
+
+static void ipa_nati_finish_del_ipv4_rule(
+	struct ipa_nat_ip4_table_cache* nat_table,
+	ipa_table_iterator*             table_iterator,
+	ipa_table_iterator*             index_table_iterator)
+{
+	if (! ipa_table_iterator_is_head_with_tail(table_iterator)) {
+		/* The entry can be deleted */
+		uint8_t is_prev_empty =
+			(table_iterator->prev_entry != NULL &&
+			 ((struct ipa_nat_rule*)table_iterator->prev_entry)->protocol ==
+			 IPAHAL_NAT_INVALID_PROTOCOL);
+
+		ipa_table_delete_entry(
+			&nat_table->table, table_iterator, is_prev_empty);
+	}
+
+	ipa_table_delete_entry(
+		&nat_table->index_table,
+		index_table_iterator,
+		FALSE);
+
+	if (index_table_iterator->curr_index >= nat_table->index_table.table_entries)
+		nat_table->index_expn_table_meta[
+			index_table_iterator->curr_index - nat_table->index_table.table_entries].
+			prev_index = IPA_TABLE_INVALID_ENTRY;
+}
+
+/*
+ * A batch may only carry one operation per chain. Until the posted
+ * command lands, the local view of a touched chain is stale (the
+ * head enable bits and the next links are only written by DMA), so a
+ * second operation on the same chain must wait for a flush.
+ */
+static bool ipa_nati_batch_conflicts(
+	const ipa_nati_batch_op* ops,
+	uint32_t                 num_ops,
+	uint16_t                 tbl_head,
+	uint16_t                 index_tbl_head)
+{
+	uint32_t i;
+
+	for ( i = 0; i < num_ops; i++ )
+	{
+		if ( ops[i].tbl_head       == tbl_head ||
+			 ops[i].index_tbl_head == index_tbl_head )
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*
+ * Posts the coalesced command, unless the kernel is known not to
+ * take them. Should the kernel refuse it, this batch's entries are
+ * re-posted rule by rule, which is safe since the DMA writes are
+ * idempotent. On return, num_posted holds how many of the ops (in
+ * order) are known to have reached IPA.
+ */
+static int ipa_nati_post_ipv4_dma_cmd_batch(
+	struct ipa_nat_cache*       nat_cache_ptr,
+	struct ipa_ioc_nat_dma_cmd* cmd,
+	const ipa_nati_batch_op*    ops,
+	uint32_t                    num_ops,
+	uint32_t*                   num_posted)
+{
+	uint32_t one_sz =
+		sizeof(struct ipa_ioc_nat_dma_cmd) +
+		(MAX_DMA_ENTRIES_FOR_ADD * sizeof(struct ipa_ioc_nat_dma_one));
+	char one_buf[one_sz];
+	struct ipa_ioc_nat_dma_cmd* one_cmd =
+		(struct ipa_ioc_nat_dma_cmd*) one_buf;
+
+	uint32_t i, first = 0;
+	int      ret = 0;
+
+	IPADBG("In\n");
+
+	*num_posted = 0;
+
+	if ( num_ops == 0 )
+	{
+		goto bail;
+	}
+
+	if ( num_ops == 1 || batch_dma != BATCH_DMA_UNSUPPORTED )
+	{
+		ret = ipa_nati_post_ipv4_dma_cmd(nat_cache_ptr, cmd);
+
+		if ( ret == 0 )
+		{
+			*num_posted = num_ops;
+			goto bail;
+		}
+
+		if ( num_ops == 1 )
+		{
+			goto bail;
+		}
+
+		IPAERR("Coalesced DMA command of %u entries refused; "
+			   "posting its %u rules one by one\n",
+			   cmd->entries, num_ops);
+	}
+
+	for ( i = 0; i < num_ops; i++ )
+	{
+		memset(one_buf, 0, sizeof(one_buf));
+
+		one_cmd->entries = ops[i].num_dma_ents;
+
+		memcpy(one_cmd->dma,
+			   &cmd->dma[first],
+			   ops[i].num_dma_ents * sizeof(struct ipa_ioc_nat_dma_one));
+
+		first += ops[i].num_dma_ents;
+
+		ret = ipa_nati_post_ipv4_dma_cmd(nat_cache_ptr, one_cmd);
+
+		if ( ret )
+		{
+			break;
+		}
+
+		(*num_posted)++;
+	}
+
+bail:
+	IPADBG("Out\n");
+
+	return ret;
+}
+
+static int ipa_nati_flush_ipv4_rule_adds(
+	struct ipa_nat_cache*           nat_cache_ptr,
+	struct ipa_nat_ip4_table_cache* nat_table,
+	struct ipa_ioc_nat_dma_cmd*     cmd,
+	ipa_nati_batch_op*              ops,
+	uint32_t*                       num_ops,
+	uint32_t*                       rule_hdls,
+	uint32_t*                       num_added)
+{
+	uint32_t num_posted, i;
+	int      ret;
+
+	ret = ipa_nati_post_ipv4_dma_cmd_batch(
+		nat_cache_ptr, cmd, ops, *num_ops, &num_posted);
+
+	if (ret) {
+		IPAERR("unable to post dma command\n");
+	}
+
+	for ( i = 0; i < num_posted; i++ )
+	{
+		rule_hdls[(*num_added)++] = ops[i].rule_hdl;
+	}
+
+	/*
+	 * Undo, newest first, the rules IPA never saw
+	 */
+	for ( i = *num_ops; i > num_posted; i-- )
+	{
+		ipa_table_erase_entry(
+			&nat_table->index_table, ops[i-1].new_index_tbl_entry_index);
+		ipa_table_erase_entry(
+			&nat_table->table, ops[i-1].new_entry_index);
+	}
+
+	*num_ops     = 0;
+	cmd->entries = 0;
+
+	return ret;
+}
+
+static int ipa_nati_flush_ipv4_rule_dels(
+	struct ipa_nat_cache*           nat_cache_ptr,
+	struct ipa_nat_ip4_table_cache* nat_table,
+	struct ipa_ioc_nat_dma_cmd*     cmd,
+	ipa_nati_batch_op*              ops,
+	uint32_t*                       num_ops,
+	uint32_t*                       num_deleted)
+{
+	uint32_t num_posted, i;
+	int      ret;
+
+	ret = ipa_nati_post_ipv4_dma_cmd_batch(
+		nat_cache_ptr, cmd, ops, *num_ops, &num_posted);
+
+	if (ret) {
+		IPAERR("Unable to post dma command\n");
+	}
+
+	for ( i = 0; i < num_posted; i++ )
+	{
+		ipa_nati_finish_del_ipv4_rule(
+			nat_table, &ops[i].table_iterator, &ops[i].index_table_iterator);
+	}
+
+	*num_deleted += num_posted;
+	*num_ops      = 0;
+	cmd->entries  = 0;
+
+	return ret;
+}
+
+int ipa_NATI_add_ipv4_rule(
+	uint32_t                 tbl_hdl,
+	const ipa_nat_ipv4_rule* clnt_rule,
+	uint32_t*                rule_hdl)
+{
+	uint32_t cmd_sz =
+		sizeof(struct ipa_ioc_nat_dma_cmd) +
+		(MAX_DMA_ENTRIES_FOR_ADD * sizeof(struct ipa_ioc_nat_dma_one));
+	char cmd_buf[cmd_sz];
+	struct ipa_ioc_nat_dma_cmd* cmd =
+		(struct ipa_ioc_nat_dma_cmd*) cmd_buf;
+
+	enum ipa3_nat_mem_in            nmi;
+	struct ipa_nat_cache*           nat_cache_ptr;
+	struct ipa_nat_ip4_table_cache* nat_table;
+
+	uint16_t new_entry_index;
+	uint16_t new_index_tbl_entry_index;
+	uint32_t new_entry_handle;
+	char     buf[1024];
+
+	int ret = 0;
+
+	IPADBG("In\n");
+
+	memset(cmd_buf, 0, sizeof(cmd_buf));
+
+	if ( ! VALID_TBL_HDL(tbl_hdl) ||
+		 ! clnt_rule ||
+		 ! rule_hdl )
+	{
+		IPAERR("Bad arg: tbl_hdl(0x%08X) and/or clnt_rule(%p) and/or rule_hdl(%p)\n",
+			   tbl_hdl, clnt_rule, rule_hdl);
+		ret = -EINVAL;
+		goto done;
+	}
+
+	*rule_hdl = 0;
+
+	IPADBG("tbl_hdl(0x%08X)\n", tbl_hdl);
+
+	BREAK_TBL_HDL(tbl_hdl, nmi, tbl_hdl);
+
+	if ( ! IPA_VALID_NAT_MEM_IN(nmi) ) {
+		IPAERR("Bad cache type argument passed\n");
+		ret = -EINVAL;
+		goto done;
+	}
+
+	IPADBG("tbl_hdl(0x%08X) nmi(%s) %s\n",
+		   tbl_hdl,
+		   ipa3_nat_mem_in_as_str(nmi),
+		   prep_nat_ipv4_rule_4print(clnt_rule, buf, sizeof(buf)));
+
+	nat_cache_ptr = &ipv4_nat_cache[nmi];
+
+	nat_table = &nat_cache_ptr->ip4_tbl[tbl_hdl - 1];
+
+	ret = ipa_nati_validate_ipv4_rule(clnt_rule);
+
+	if (ret) {
+		goto done;
+	}
+
+	if (pthread_mutex_lock(&nat_mutex)) {
+		IPAERR("unable to lock the nat mutex\n");
+		ret = -EINVAL;
+		goto done;
+	}
+
+	if (! nat_table->mem_desc.valid) {
+		IPAERR("invalid table handle %d\n", tbl_hdl);
+		ret = -EINVAL;
+		goto unlock;
+	}
+
+	ipa_nati_calc_ipv4_rule_hashes(
+		nat_cache_ptr,
+		nat_table,
+		clnt_rule,
+		&new_entry_index,
+		&new_index_tbl_entry_index);
 
-	IPADBG("new entry:%d, new index entry: %d\n",
-		   new_entry_index, new_index_tbl_entry_index);
+	ret = ipa_nati_insert_ipv4_rule(
+		nat_table,
+		clnt_rule,
+		&new_entry_index,
+		&new_index_tbl_entry_index,
+		&new_entry_handle,
+		cmd);
 
-	IPADBG("rule_hdl(0x%08X) -> %s\n",
-		   new_entry_handle,
-		   prep_nat_rule_4print(rule, buf, sizeof(buf)));
+	if (ret) {
+		goto unlock;
+	}
 
 	ret = ipa_nati_post_ipv4_dma_cmd(nat_cache_ptr, cmd);
 
@@ -1832,8 +2521,6 @@ int ipa_NATI_add_ipv4_rule(
 
 bail:
 	ipa_table_erase_entry(&nat_table->index_table, new_index_tbl_entry_index);
-
-fail_add_index_entry:
 	ipa_table_erase_entry(&nat_table->table, new_entry_index);
 
 unlock:
@@ -1859,14 +2546,10 @@ int ipa_NATI_del_ipv4_rule(
 	enum ipa3_nat_mem_in            nmi;
 	struct ipa_nat_cache*           nat_cache_ptr;
 	struct ipa_nat_ip4_table_cache* nat_table;
-	struct ipa_nat_rule*            table_rule;
-	struct ipa_nat_indx_tbl_rule*   index_table_rule;
 
 	ipa_table_iterator table_iterator;
 	ipa_table_iterator index_table_iterator;
 
-	uint16_t index;
-	char     buf[1024];
 	int      ret = 0;
 
 	IPADBG("In\n");
@@ -1901,115 +2584,314 @@ int ipa_NATI_del_ipv4_rule(
 		goto unlock;
 	}
 
-	ret = ipa_table_get_entry(
-		&nat_table->table,
+	ret = ipa_nati_prep_del_ipv4_rule(
+		nat_table,
+		tbl_hdl,
 		rule_hdl,
-		(void**) &table_rule,
-		&index);
+		&table_iterator,
+		&index_table_iterator,
+		cmd);
 
 	if (ret) {
-		IPAERR("Unable to retrive the entry with rule_hdl=%u\n", rule_hdl);
 		goto unlock;
 	}
 
-	IPADBG("rule_hdl(0x%08X) -> %s\n",
-		   rule_hdl,
-		   prep_nat_rule_4print(table_rule, buf, sizeof(buf)));
-
-	ret = ipa_table_iterator_init(
-		&table_iterator,
-		&nat_table->table,
-		table_rule,
-		index);
+	ret = ipa_nati_post_ipv4_dma_cmd(nat_cache_ptr, cmd);
 
 	if (ret) {
-		IPAERR("Unable to create iterator which points to the "
-			   "entry %u in NAT table with handle=0x%08X\n",
-			   index, tbl_hdl);
+		IPAERR("Unable to post dma command\n");
 		goto unlock;
 	}
 
-	index = table_rule->indx_tbl_entry;
+	ipa_nati_finish_del_ipv4_rule(
+		nat_table, &table_iterator, &index_table_iterator);
 
-	index_table_rule = (struct ipa_nat_indx_tbl_rule*)
-		ipa_table_get_entry_by_index(&nat_table->index_table, index);
+unlock:
+	if (pthread_mutex_unlock(&nat_mutex)) {
+		IPAERR("Unable to unlock the nat mutex\n");
+		ret = (ret) ? ret : -EPERM;
+	}
 
-	if (index_table_rule == NULL) {
-		IPAERR("Unable to retrieve the entry in index %u "
-			   "in NAT index table with handle=0x%08X\n",
-			   index, tbl_hdl);
-		ret = -EPERM;
-		goto unlock;
+done:
+	IPADBG("Out\n");
+
+	return ret;
+}
+
+int ipa_NATI_add_ipv4_rules(
+	uint32_t                 tbl_hdl,
+	const ipa_nat_ipv4_rule* clnt_rules,
+	uint32_t                 num_rules,
+	uint32_t*                rule_hdls,
+	uint32_t*                num_added)
+{
+	uint32_t cmd_sz =
+		sizeof(struct ipa_ioc_nat_dma_cmd) +
+		(MAX_DMA_ENTRIES_FOR_BATCH * sizeof(struct ipa_ioc_nat_dma_one));
+	char cmd_buf[cmd_sz];
+	struct ipa_ioc_nat_dma_cmd* cmd =
+		(struct ipa_ioc_nat_dma_cmd*) cmd_buf;
+
+	ipa_nati_batch_op ops[IPA_NATI_MAX_BATCH_OPS];
+	uint32_t          num_ops = 0;
+
+	enum ipa3_nat_mem_in            nmi;
+	struct ipa_nat_cache*           nat_cache_ptr;
+	struct ipa_nat_ip4_table_cache* nat_table;
+
+	uint16_t new_entry_index;
+	uint16_t new_index_tbl_entry_index;
+	uint8_t  entries_before;
+	uint32_t i;
+
+	int ret = 0, flush_ret;
+
+	IPADBG("In\n");
+
+	memset(cmd_buf, 0, sizeof(cmd_buf));
+
+	if ( ! VALID_TBL_HDL(tbl_hdl) ||
+		 ! clnt_rules ||
+		 ! rule_hdls ||
+		 ! num_added )
+	{
+		IPAERR("Bad arg: tbl_hdl(0x%08X) and/or clnt_rules(%p) "
+			   "and/or rule_hdls(%p) and/or num_added(%p)\n",
+			   tbl_hdl, clnt_rules, rule_hdls, num_added);
+		ret = -EINVAL;
+		goto done;
 	}
 
-	ret = ipa_table_iterator_init(
-		&index_table_iterator,
-		&nat_table->index_table,
-		index_table_rule,
-		index);
+	*num_added = 0;
 
-	if (ret) {
-		IPAERR("Unable to create iterator which points to the "
-			   "entry %u in NAT index table with handle=0x%08X\n",
-			   index, tbl_hdl);
+	IPADBG("tbl_hdl(0x%08X) num_rules(%u)\n", tbl_hdl, num_rules);
+
+	BREAK_TBL_HDL(tbl_hdl, nmi, tbl_hdl);
+
+	if ( ! IPA_VALID_NAT_MEM_IN(nmi) ) {
+		IPAERR("Bad cache type argument passed\n");
+		ret = -EINVAL;
+		goto done;
+	}
+
+	nat_cache_ptr = &ipv4_nat_cache[nmi];
+
+	nat_table = &nat_cache_ptr->ip4_tbl[tbl_hdl - 1];
+
+	if (pthread_mutex_lock(&nat_mutex)) {
+		IPAERR("unable to lock the nat mutex\n");
+		ret = -EINVAL;
+		goto done;
+	}
+
+	if (! nat_table->mem_desc.valid) {
+		IPAERR("invalid table handle %d\n", tbl_hdl);
+		ret = -EINVAL;
 		goto unlock;
 	}
 
-	ipa_table_create_delete_command(
-		&nat_table->index_table,
-		cmd,
-		&index_table_iterator);
+	for ( i = 0; i < num_rules; i++ )
+	{
+		ret = ipa_nati_validate_ipv4_rule(&clnt_rules[i]);
+
+		if (ret) {
+			break;
+		}
 
-	if (ipa_table_iterator_is_head_with_tail(&index_table_iterator)) {
+		ipa_nati_calc_ipv4_rule_hashes(
+			nat_cache_ptr,
+			nat_table,
+			&clnt_rules[i],
+			&new_entry_index,
+			&new_index_tbl_entry_index);
+
+		if ( num_ops == IPA_NATI_MAX_BATCH_OPS ||
+			 cmd->entries + MAX_DMA_ENTRIES_FOR_ADD > MAX_DMA_ENTRIES_FOR_BATCH ||
+			 ipa_nati_batch_conflicts(
+				 ops, num_ops, new_entry_index, new_index_tbl_entry_index) )
+		{
+			ret = ipa_nati_flush_ipv4_rule_adds(
+				nat_cache_ptr, nat_table, cmd, ops, &num_ops, rule_hdls, num_added);
 
-		ipa_nati_copy_second_index_entry_to_head(
-			nat_table, &index_table_iterator, cmd);
-		/*
-		 * Iterate to the next entry which should be deleted
-		 */
-		ret = ipa_table_iterator_next(
-			&index_table_iterator, &nat_table->index_table);
+			if (ret) {
+				break;
+			}
+		}
+
+		ops[num_ops].tbl_head       = new_entry_index;
+		ops[num_ops].index_tbl_head = new_index_tbl_entry_index;
+
+		entries_before = cmd->entries;
+
+		ret = ipa_nati_insert_ipv4_rule(
+			nat_table,
+			&clnt_rules[i],
+			&new_entry_index,
+			&new_index_tbl_entry_index,
+			&ops[num_ops].rule_hdl,
+			cmd);
 
 		if (ret) {
-			IPAERR("Unable to move the iterator to the next entry "
-				   "(points to the entry %u in NAT index table)\n",
-				   index);
-			goto unlock;
+			cmd->entries = entries_before;
+			break;
 		}
+
+		ops[num_ops].new_entry_index           = new_entry_index;
+		ops[num_ops].new_index_tbl_entry_index = new_index_tbl_entry_index;
+		ops[num_ops].num_dma_ents              = cmd->entries - entries_before;
+
+		num_ops++;
 	}
 
-	ipa_table_create_delete_command(
-		&nat_table->table,
-		cmd,
-		&table_iterator);
+	/*
+	 * Whatever was built before a failure still goes out
+	 */
+	if ( num_ops )
+	{
+		flush_ret = ipa_nati_flush_ipv4_rule_adds(
+			nat_cache_ptr, nat_table, cmd, ops, &num_ops, rule_hdls, num_added);
 
-	ret = ipa_nati_post_ipv4_dma_cmd(nat_cache_ptr, cmd);
+		ret = (ret) ? ret : flush_ret;
+	}
 
-	if (ret) {
-		IPAERR("Unable to post dma command\n");
+	IPADBG("Added %u of %u rules\n", *num_added, num_rules);
+
+unlock:
+	if (pthread_mutex_unlock(&nat_mutex)) {
+		IPAERR("unable to unlock the nat mutex\n");
+		ret = (ret) ? ret : -EPERM;
+	}
+
+done:
+	IPADBG("Out\n");
+
+	return ret;
+}
+
+int ipa_NATI_del_ipv4_rules(
+	uint32_t        tbl_hdl,
+	const uint32_t* rule_hdls,
+	uint32_t        num_rules,
+	uint32_t*       num_deleted)
+{
+	uint32_t cmd_sz =
+		sizeof(struct ipa_ioc_nat_dma_cmd) +
+		(MAX_DMA_ENTRIES_FOR_BATCH * sizeof(struct ipa_ioc_nat_dma_one));
+	char cmd_buf[cmd_sz];
+	struct ipa_ioc_nat_dma_cmd* cmd =
+		(struct ipa_ioc_nat_dma_cmd*) cmd_buf;
+
+	ipa_nati_batch_op ops[IPA_NATI_MAX_BATCH_OPS];
+	uint32_t          num_ops = 0;
+
+	enum ipa3_nat_mem_in            nmi;
+	struct ipa_nat_cache*           nat_cache_ptr;
+	struct ipa_nat_ip4_table_cache* nat_table;
+
+	uint16_t tbl_head, index_tbl_head;
+	uint8_t  entries_before;
+	uint32_t i;
+
+	int ret = 0, flush_ret;
+
+	IPADBG("In\n");
+
+	memset(cmd_buf, 0, sizeof(cmd_buf));
+
+	if ( ! VALID_TBL_HDL(tbl_hdl) ||
+		 ! rule_hdls ||
+		 ! num_deleted )
+	{
+		IPAERR("Bad arg: tbl_hdl(0x%08X) and/or rule_hdls(%p) and/or num_deleted(%p)\n",
+			   tbl_hdl, rule_hdls, num_deleted);
+		ret = -EINVAL;
+		goto done;
+	}
+
+	*num_deleted = 0;
+
+	IPADBG("tbl_hdl(0x%08X) num_rules(%u)\n", tbl_hdl, num_rules);
+
+	BREAK_TBL_HDL(tbl_hdl, nmi, tbl_hdl);
+
+	if ( ! IPA_VALID_NAT_MEM_IN(nmi) ) {
+		IPAERR("Bad cache type argument passed\n");
+		ret = -EINVAL;
+		goto done;
+	}
+
+	nat_cache_ptr = &ipv4_nat_cache[nmi];
+
+	nat_table = &nat_cache_ptr->ip4_tbl[tbl_hdl - 1];
+
+	if (pthread_mutex_lock(&nat_mutex)) {
+		IPAERR("Unable to lock the nat mutex\n");
+		ret = -EINVAL;
+		goto done;
+	}
+
+	if (! nat_table->mem_desc.valid) {
+		IPAERR("Invalid table handle 0x%08X\n", tbl_hdl);
+		ret = -EINVAL;
 		goto unlock;
 	}
 
-	if (! ipa_table_iterator_is_head_with_tail(&table_iterator)) {
-		/* The entry can be deleted */
-		uint8_t is_prev_empty =
-			(table_iterator.prev_entry != NULL &&
-			 ((struct ipa_nat_rule*)table_iterator.prev_entry)->protocol ==
-			 IPAHAL_NAT_INVALID_PROTOCOL);
+	for ( i = 0; i < num_rules; i++ )
+	{
+		ret = ipa_nati_get_ipv4_rule_chain_heads(
+			nat_table, rule_hdls[i], &tbl_head, &index_tbl_head);
 
-		ipa_table_delete_entry(
-			&nat_table->table, &table_iterator, is_prev_empty);
+		if (ret) {
+			break;
+		}
+
+		if ( num_ops == IPA_NATI_MAX_BATCH_OPS ||
+			 cmd->entries + MAX_DMA_ENTRIES_FOR_DEL > MAX_DMA_ENTRIES_FOR_BATCH ||
+			 ipa_nati_batch_conflicts(ops, num_ops, tbl_head, index_tbl_head) )
+		{
+			ret = ipa_nati_flush_ipv4_rule_dels(
+				nat_cache_ptr, nat_table, cmd, ops, &num_ops, num_deleted);
+
+			if (ret) {
+				break;
+			}
+		}
+
+		ops[num_ops].tbl_head       = tbl_head;
+		ops[num_ops].index_tbl_head = index_tbl_head;
+
+		entries_before = cmd->entries;
+
+		ret = ipa_nati_prep_del_ipv4_rule(
+			nat_table,
+			tbl_hdl,
+			rule_hdls[i],
+			&ops[num_ops].table_iterator,
+			&ops[num_ops].index_table_iterator,
+			cmd);
+
+		if (ret) {
+			cmd->entries = entries_before;
+			break;
+		}
+
+		ops[num_ops].num_dma_ents = cmd->entries - entries_before;
+
+		num_ops++;
 	}
 
-	ipa_table_delete_entry(
-		&nat_table->index_table,
-		&index_table_iterator,
-		FALSE);
+	/*
+	 * Whatever was built before a failure still goes out
+	 */
+	if ( num_ops )
+	{
+		flush_ret = ipa_nati_flush_ipv4_rule_dels(
+			nat_cache_ptr, nat_table, cmd, ops, &num_ops, num_deleted);
 
-	if (index_table_iterator.curr_index >= nat_table->index_table.table_entries)
-		nat_table->index_expn_table_meta[
-			index_table_iterator.curr_index - nat_table->index_table.table_entries].
-			prev_index = IPA_TABLE_INVALID_ENTRY;
+		ret = (ret) ? ret : flush_ret;
+	}
+
+	IPADBG("Deleted %u of %u rules\n", *num_deleted, num_rules);
 
 unlock:
 	if (pthread_mutex_unlock(&nat_mutex)) {
@@ -2565,6 +3447,13 @@ int ipa_NATI_ipv4_tbl_stats(
 
 	nat_table = &nat_cache_ptr->ip4_tbl[broken_tbl_hdl - 1];
 
+	if ( ! nat_table->mem_desc.valid )
+	{
+		IPAERR("invalid table handle 0x%08X\n", tbl_hdl);
+		ret = -EINVAL;
+		goto unlock;
+	}
+
 	/*
 	 * Gather NAT table stats...
 	 */
@@ -2572,6 +3461,7 @@ int ipa_NATI_ipv4_tbl_stats(
 
 	nat_stats_ptr->nmi                  = nmi;
 
+	nat_stats_ptr->req_ents             = nat_table->number_of_entries;
 	nat_stats_ptr->tot_base_ents        = ipa_tbl_ptr->table_entries;
 	nat_stats_ptr->tot_expn_ents        = ipa_tbl_ptr->expn_table_entries;
 	nat_stats_ptr->tot_ents             =
@@ -26,14 +26,174 @@
  * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
  * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
-#include <map>
-#include <iterator>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
 
 #include "ipa_nat_utils.h"
 
 #include "ipa_nat_map.h"
 
-static std::map<uint32_t, uint32_t> map_array[MAP_NUM_MAX];
+/*
+ * Each map is a flat, open addressed hash table using linear probing.
+ *
+ * The slot array is allocated up front (see ipa_nat_map_reserve())
+ * to at least twice the number of entries the map will hold. That
+ * keeps the load factor at or below one half, hence probe runs short,
+ * and means an add never allocates. Deletion shifts the rest of the
+ * probe run back over the hole, so there are no tombstones to age the
+ * table.
+ *
+ * Should a map be used without being reserved, or outgrow its
+ * reservation, it is doubled in place.
+ */
+#define MAP_MIN_SLOTS 256
+
+typedef struct
+{
+	uint32_t key;
+	uint32_t val;
+	uint32_t used;
+} map_slot;
+
+typedef struct
+{
+	map_slot* slots;
+	uint32_t  num_slots; /* always a power of two */
+	uint32_t  num_used;
+} flat_map;
+
+static flat_map map_array[MAP_NUM_MAX];
+
+static inline uint32_t hash_key(
+	uint32_t key )
+{
+	/*
+	 * Rule handles are small, dense integers; spread them...
+	 */
+	key *= 0x9E3779B1;
+
+	return key ^ (key >> 16);
+}
+
+static int find_slot(
+	flat_map* map_ptr,
+	uint32_t  key )
+{
+	uint32_t mask, i, probes;
+
+	if ( map_ptr->num_used == 0 )
+	{
+		return -1;
+	}
+
+	mask = map_ptr->num_slots - 1;
+
+	for ( i = hash_key(key) & mask, probes = 0;
+		  probes < map_ptr->num_slots;
+		  i = (i + 1) & mask, probes++ )
+	{
+		if ( ! map_ptr->slots[i].used )
+		{
+			break;
+		}
+
+		if ( map_ptr->slots[i].key == key )
+		{
+			return (int) i;
+		}
+	}
+
+	return -1;
+}
+
+static void put_slot(
+	map_slot* slots,
+	uint32_t  num_slots,
+	uint32_t  key,
+	uint32_t  val )
+{
+	uint32_t mask = num_slots - 1;
+	uint32_t i    = hash_key(key) & mask;
+
+	while ( slots[i].used )
+	{
+		i = (i + 1) & mask;
+	}
+
+	slots[i].key  = key;
+	slots[i].val  = val;
+	slots[i].used = 1;
+}
+
+static int resize_map(
+	flat_map* map_ptr,
+	uint32_t  num_slots )
+{
+	map_slot* slots;
+	uint32_t  i;
+
+	slots = (map_slot*) calloc(num_slots, sizeof(map_slot));
+
+	if ( slots == NULL )
+	{
+		IPAERR("Unable to allocate %u map slots\n", num_slots);
+		return -ENOMEM;
+	}
+
+	for ( i = 0; i < map_ptr->num_slots; i++ )
+	{
+		if ( map_ptr->slots[i].used )
+		{
+			put_slot(slots, num_slots, map_ptr->slots[i].key, map_ptr->slots[i].val);
+		}
+	}
+
+	free(map_ptr->slots);
+
+	map_ptr->slots     = slots;
+	map_ptr->num_slots = num_slots;
+
+	return 0;
+}
+
+/******************************************************************************/
+
+int ipa_nat_map_reserve(
+	ipa_which_map which,
+	uint32_t      num_ents )
+{
+	uint32_t num_slots = MAP_MIN_SLOTS;
+
+	int ret_val = 0;
+
+	IPADBG("In\n");
+
+	if ( ! VALID_IPA_USE_MAP(which) )
+	{
+		IPAERR("Bad arg which(%u)\n", which);
+		ret_val = -1;
+		goto bail;
+	}
+
+	while ( num_slots < num_ents * 2 )
+	{
+		num_slots <<= 1;
+	}
+
+	IPADBG("[%s] num_ents(%u) -> num_slots(%u)\n",
+		   ipa_which_map_as_str(which), num_ents, num_slots);
+
+	if ( num_slots > map_array[which].num_slots )
+	{
+		ret_val = resize_map(&map_array[which], num_slots);
+	}
+
+bail:
+	IPADBG("Out\n");
+
+	return ret_val;
+}
 
 /******************************************************************************/
 
@@ -42,9 +202,9 @@ int ipa_nat_map_add(
 	uint32_t      key,
 	uint32_t      val )
 {
-	int ret_val = 0;
+	flat_map* map_ptr;
 
-	std::pair<std::map<uint32_t, uint32_t>::iterator, bool> ret;
+	int ret_val = 0;
 
 	IPADBG("In\n");
 
@@ -58,16 +218,33 @@ int ipa_nat_map_add(
 	IPADBG("[%s] key(%u) -> val(%u)\n",
 		   ipa_which_map_as_str(which), key, val);
 
-	ret = map_array[which].insert(std::pair<uint32_t, uint32_t>(key, val));
+	map_ptr = &map_array[which];
 
-	if ( ret.second == false )
+	if ( find_slot(map_ptr, key) >= 0 )
 	{
 		IPAERR("[%s] key(%u) already exists in map\n",
 			   ipa_which_map_as_str(which),
 			   key);
 		ret_val = -1;
+		goto bail;
+	}
+
+	if ( (map_ptr->num_used + 1) * 2 > map_ptr->num_slots )
+	{
+		ret_val = resize_map(
+			map_ptr,
+			(map_ptr->num_slots) ? map_ptr->num_slots * 2 : MAP_MIN_SLOTS);
+
+		if ( ret_val )
+		{
+			goto bail;
+		}
 	}
 
+	put_slot(map_ptr->slots, map_ptr->num_slots, key, val);
+
+	map_ptr->num_used++;
+
 bail:
 	IPADBG("Out\n");
 
@@ -82,8 +259,7 @@ int ipa_nat_map_find(
 	uint32_t*     val_ptr )
 {
 	int ret_val = 0;
-
-	std::map<uint32_t, uint32_t>::iterator it;
+	int slot;
 
 	IPADBG("In\n");
 
@@ -97,9 +273,9 @@ int ipa_nat_map_find(
 	IPADBG("[%s] key(%u)\n",
 		   ipa_which_map_as_str(which), key);
 
-	it = map_array[which].find(key);
+	slot = find_slot(&map_array[which], key);
 
-	if ( it == map_array[which].end() )
+	if ( slot < 0 )
 	{
 		IPAERR("[%s] key(%u) not found in map\n",
 			   ipa_which_map_as_str(which),
@@ -110,7 +286,7 @@ int ipa_nat_map_find(
 	{
 		if ( val_ptr )
 		{
-			*val_ptr = it->second;
+			*val_ptr = map_array[which].slots[slot].val;
 			IPADBG("[%s] key(%u) -> val(%u)\n",
 				   ipa_which_map_as_str(which),
 				   key, *val_ptr);
@@ -125,14 +301,32 @@ bail:
 
 /******************************************************************************/
 
+int ipa_nat_map_has(
+	ipa_which_map which,
+	uint32_t      key )
+{
+	if ( ! VALID_IPA_USE_MAP(which) )
+	{
+		IPAERR("Bad arg which(%u)\n", which);
+		return 0;
+	}
+
+	return find_slot(&map_array[which], key) >= 0;
+}
+
+/******************************************************************************/
+
 int ipa_nat_map_del(
 	ipa_which_map which,
 	uint32_t      key,
 	uint32_t*     val_ptr )
 {
-	int ret_val = 0;
+	flat_map* map_ptr;
+	map_slot* slots;
+	uint32_t  mask, hole, i, home;
 
-	std::map<uint32_t, uint32_t>::iterator it;
+	int ret_val = 0;
+	int slot;
 
 	IPADBG("In\n");
 
@@ -146,27 +340,54 @@ int ipa_nat_map_del(
 	IPADBG("[%s] key(%u)\n",
 		   ipa_which_map_as_str(which), key);
 
-	it = map_array[which].find(key);
+	map_ptr = &map_array[which];
+
+	slot = find_slot(map_ptr, key);
 
-	if ( it == map_array[which].end() )
+	if ( slot < 0 )
 	{
 		IPAERR("[%s] key(%u) not found in map\n",
 			   ipa_which_map_as_str(which),
 			   key);
 		ret_val = -1;
+		goto bail;
 	}
-	else
+
+	slots = map_ptr->slots;
+	mask  = map_ptr->num_slots - 1;
+
+	if ( val_ptr )
 	{
-		if ( val_ptr )
+		*val_ptr = slots[slot].val;
+		IPADBG("[%s] key(%u) -> val(%u)\n",
+			   ipa_which_map_as_str(which),
+			   key, *val_ptr);
+	}
+
+	/*
+	 * Close the hole: walk the rest of the probe run and pull back
+	 * any entry whose home slot is not between the hole and itself.
+	 */
+	hole = (uint32_t) slot;
+
+	for ( i = (hole + 1) & mask; slots[i].used; i = (i + 1) & mask )
+	{
+		home = hash_key(slots[i].key) & mask;
+
+		if ( (hole <= i) ? (hole < home && home <= i) : (hole < home || home <= i) )
 		{
-			*val_ptr = it->second;
-			IPADBG("[%s] key(%u) -> val(%u)\n",
-				   ipa_which_map_as_str(which),
-				   key, *val_ptr);
+			continue;
 		}
-		map_array[which].erase(it);
+
+		slots[hole] = slots[i];
+
+		hole = i;
 	}
 
+	slots[hole].used = 0;
+
+	map_ptr->num_used--;
+
 bail:
 	IPADBG("Out\n");
 
@@ -187,7 +408,14 @@ int ipa_nat_map_clear(
 		goto bail;
 	}
 
-	map_array[which].clear();
+	if ( map_array[which].num_used )
+	{
+		memset(map_array[which].slots,
+			   0,
+			   map_array[which].num_slots * sizeof(map_slot));
+
+		map_array[which].num_used = 0;
+	}
 
 bail:
 	IPADBG("Out\n");
@@ -198,7 +426,7 @@ bail:
 int ipa_nat_map_dump(
 	ipa_which_map which )
 {
-	std::map<uint32_t, uint32_t>::iterator it;
+	uint32_t i;
 
 	int ret_val = 0;
 
@@ -213,15 +441,18 @@ int ipa_nat_map_dump(
 
 	printf("Dumping: %s\n", ipa_which_map_as_str(which));
 
-	for ( it  = map_array[which].begin();
-		  it != map_array[which].end();
-		  it++ )
+	for ( i = 0; i < map_array[which].num_slots; i++ )
 	{
+		if ( ! map_array[which].slots[i].used )
+		{
+			continue;
+		}
+
 		printf("  Key[%u|0x%08X] -> Value[%u|0x%08X]\n",
-			   it->first,
-			   it->first,
-			   it->second,
-			   it->second);
+			   map_array[which].slots[i].key,
+			   map_array[which].slots[i].key,
+			   map_array[which].slots[i].val,
+			   map_array[which].slots[i].val);
 	}
 
 bail:
@@ -28,6 +28,7 @@
  */
 #include <errno.h>
 #include <pthread.h>
+#include <stdlib.h>
 
 #include "ipa_nat_drv.h"
 #include "ipa_nat_drvi.h"
@@ -62,6 +63,34 @@
 #define CHOOSE_SW_STATS() \
 	&(nati_obj.sw_stats[CHOOSE_MEM_SUB()])
 
+/*
+ * When the DDR table is in focus and an add fails because the table is
+ * full, the table is grown and the add retried.  If asked for (see
+ * ipa_nat_set_ddr_tbl_growth()), its chains and expansion tables are
+ * also looked at every RESIZE_CHK_INTVL rule additions.  If any chain
+ * is longer than RESIZE_MAX_CHAIN_LEN, or an expansion table is more
+ * than RESIZE_EXPN_FILL_PRCNT full, the table is grown...
+ */
+#undef  GROW_DDR_WHEN_FULL
+#define GROW_DDR_WHEN_FULL(r) \
+	( (r) == -ENOSPC && DDR_CURRENTLY_ACTIVE() && nati_obj.grow_when_full )
+
+#undef  RESIZE_CHK_INTVL
+#define RESIZE_CHK_INTVL       128
+
+#undef  RESIZE_MAX_CHAIN_LEN
+#define RESIZE_MAX_CHAIN_LEN   8
+
+#undef  RESIZE_EXPN_FILL_PRCNT
+#define RESIZE_EXPN_FILL_PRCNT 75
+
+/*
+ * Table rule handles are 16 bits, so made up original handles start
+ * above them...
+ */
+#undef  ALIAS_HDL_BASE
+#define ALIAS_HDL_BASE 0x00010000
+
 /*
  * BACKROUND INFORMATION
  *
@@ -136,6 +165,12 @@ static ipa_nati_obj nati_obj = {
 	 *   sw_stats[1] for sram
 	 */
 	.sw_stats = { {0, 0}, {0, 0} },
+	.grow_when_full        = true,
+	.grow_when_crowded     = false,
+	.grow_max_ents         = IPA_TABLE_MAX_ENTRIES,
+	.adds_since_resize_chk = 0,
+	.resize_stats = {0, 0},
+	.next_alias_hdl = ALIAS_HDL_BASE,
 };
 
 /*
@@ -400,6 +435,62 @@ int ipa_nati_del_ipv4_rule(
 	return ret;
 }
 
+int ipa_nati_add_ipv4_rules(
+	uint32_t                 tbl_hdl,
+	const ipa_nat_ipv4_rule* clnt_rules,
+	uint32_t                 num_rules,
+	uint32_t*                rule_hdls,
+	uint32_t*                num_added )
+{
+	arb_t* args[] = {
+		(arb_t*) tbl_hdl,
+		(arb_t*) clnt_rules,
+		(arb_t*) num_rules,
+		(arb_t*) rule_hdls,
+		(arb_t*) num_added,
+	};
+
+	int ret;
+
+	IPADBG("In\n");
+
+	*num_added = 0;
+
+	ret = ipa_nati_statemach(&nati_obj, NATI_TRIG_ADD_RULES, args);
+
+	IPADBG("Added %u of %u rules\n", *num_added, num_rules);
+
+	IPADBG("Out\n");
+
+	return ret;
+}
+
+int ipa_nati_del_ipv4_rules(
+	uint32_t        tbl_hdl,
+	const uint32_t* rule_hdls,
+	uint32_t        num_rules,
+	uint32_t*       num_deleted )
+{
+	arb_t* args[] = {
+		(arb_t*) tbl_hdl,
+		(arb_t*) rule_hdls,
+		(arb_t*) num_rules,
+		(arb_t*) num_deleted,
+	};
+
+	int ret;
+
+	IPADBG("In\n");
+
+	*num_deleted = 0;
+
+	ret = ipa_nati_statemach(&nati_obj, NATI_TRIG_DEL_RULES, args);
+
+	IPADBG("Out\n");
+
+	return ret;
+}
+
 int ipa_nati_query_timestamp_redirect(
 	uint32_t  tbl_hdl,
 	uint32_t  rule_hdl,
@@ -572,11 +663,149 @@ bail:
 	return ret;
 }
 
+int ipa_nat_set_ddr_tbl_growth(
+	bool     when_full,
+	bool     when_crowded,
+	uint32_t max_ents )
+{
+	int ret;
+
+	IPADBG("In\n");
+
+	if ( max_ents > IPA_TABLE_MAX_ENTRIES )
+	{
+		IPAERR("Bad max_ents(%u), no more than (%u) allowed\n",
+			   max_ents, IPA_TABLE_MAX_ENTRIES);
+
+		ret = -EINVAL;
+
+		goto bail;
+	}
+
+	ret = take_mutex();
+
+	if ( ret != 0 )
+	{
+		goto bail;
+	}
+
+	nati_obj.grow_when_full        = when_full;
+	nati_obj.grow_when_crowded     = when_crowded;
+	nati_obj.grow_max_ents         = (max_ents) ? max_ents : IPA_TABLE_MAX_ENTRIES;
+	nati_obj.adds_since_resize_chk = 0;
+
+	IPADBG("DDR table growth: when_full(%s) when_crowded(%s) max_ents(%u)\n",
+		   (when_full) ? "yes" : "no",
+		   (when_crowded) ? "yes" : "no",
+		   nati_obj.grow_max_ents);
+
+	ret = give_mutex();
+
+bail:
+	IPADBG("Out\n");
+
+	return ret;
+}
+
 bool ipa_nat_is_sram_supported(void)
 {
 	return VALID_TBL_HDL(nati_obj.sram_tbl_hdl);
 }
 
+/******************************************************************************/
+/*
+ * FUNCTION: reserve_maps
+ *
+ * PARAMS:
+ *
+ *   nati_obj_ptr (IN) A pointer to an initialized nati object
+ *
+ *   sub          (IN) DDR_SUB or SRAM_SUB
+ *
+ *   tbl_hdl      (IN) The handle of that memory type's table
+ *
+ * DESCRIPTION:
+ *
+ *   Presize a memory type's handle maps to the number of rules its
+ *   table can hold, so that rule adds and migrations never cause the
+ *   maps to allocate.
+ *
+ * RETURNS:
+ *
+ *   zero on success, otherwise non-zero
+ */
+static int reserve_maps(
+	ipa_nati_obj* nati_obj_ptr,
+	uint32_t      sub,
+	uint32_t      tbl_hdl )
+{
+	ipa_nati_tbl_stats nat_stats, idx_stats;
+
+	int ret;
+
+	IPADBG("In\n");
+
+	ret = ipa_NATI_ipv4_tbl_stats(tbl_hdl, &nat_stats, &idx_stats);
+
+	if ( ret == 0 )
+	{
+		ret = ipa_nat_map_reserve(
+			nati_obj_ptr->map_pairs[sub].orig2new_map, nat_stats.tot_ents);
+	}
+
+	if ( ret == 0 )
+	{
+		ret = ipa_nat_map_reserve(
+			nati_obj_ptr->map_pairs[sub].new2orig_map, nat_stats.tot_ents);
+	}
+
+	IPADBG("Out\n");
+
+	return ret;
+}
+
+/******************************************************************************/
+/*
+ * FUNCTION: nat_rule_to_v4_rule
+ *
+ * PARAMS:
+ *
+ *   nat_rule_ptr (IN)  A nat rule record from a table
+ *
+ *   v4_rule_ptr  (OUT) The rule in the form needed to add it to a table
+ *
+ * DESCRIPTION:
+ *
+ *   Turns a table's nat rule record back into the rule that created
+ *   it, so that it can be added to another table.
+ *
+ * RETURNS:
+ *
+ *   Nothing
+ */
+static void nat_rule_to_v4_rule(
+	const struct ipa_nat_rule* nat_rule_ptr,
+	ipa_nat_ipv4_rule*         v4_rule_ptr )
+{
+	memset(v4_rule_ptr, 0, sizeof(ipa_nat_ipv4_rule));
+
+	v4_rule_ptr->private_ip   = nat_rule_ptr->private_ip;
+	v4_rule_ptr->private_port = nat_rule_ptr->private_port;
+	v4_rule_ptr->protocol     = nat_rule_ptr->protocol;
+	v4_rule_ptr->public_port  = nat_rule_ptr->public_port;
+	v4_rule_ptr->target_ip    = nat_rule_ptr->target_ip;
+	v4_rule_ptr->target_port  = nat_rule_ptr->target_port;
+	v4_rule_ptr->pdn_index    = nat_rule_ptr->pdn_index;
+	v4_rule_ptr->redirect     = nat_rule_ptr->redirect;
+	v4_rule_ptr->enable       = nat_rule_ptr->enable;
+	v4_rule_ptr->time_stamp   = nat_rule_ptr->time_stamp;
+	v4_rule_ptr->uc_activation_index = nat_rule_ptr->uc_activation_index;
+	v4_rule_ptr->s = nat_rule_ptr->s;
+	v4_rule_ptr->ucp = nat_rule_ptr->ucp;
+	v4_rule_ptr->dst_only = nat_rule_ptr->dst_only;
+	v4_rule_ptr->src_only = nat_rule_ptr->src_only;
+}
+
 /******************************************************************************/
 /*
  * FUNCTION: migrate_rule
@@ -713,23 +942,7 @@ static int migrate_rule(
 		goto bail;
 	}
 
-	memset(&v4_rule, 0, sizeof(v4_rule));
-
-	v4_rule.private_ip   = nat_rule_ptr->private_ip;
-	v4_rule.private_port = nat_rule_ptr->private_port;
-	v4_rule.protocol     = nat_rule_ptr->protocol;
-	v4_rule.public_port  = nat_rule_ptr->public_port;
-	v4_rule.target_ip    = nat_rule_ptr->target_ip;
-	v4_rule.target_port  = nat_rule_ptr->target_port;
-	v4_rule.pdn_index    = nat_rule_ptr->pdn_index;
-	v4_rule.redirect     = nat_rule_ptr->redirect;
-	v4_rule.enable       = nat_rule_ptr->enable;
-	v4_rule.time_stamp   = nat_rule_ptr->time_stamp;
-	v4_rule.uc_activation_index = nat_rule_ptr->uc_activation_index;
-	v4_rule.s = nat_rule_ptr->s;
-	v4_rule.ucp = nat_rule_ptr->ucp;
-	v4_rule.dst_only = nat_rule_ptr->dst_only;
-	v4_rule.src_only = nat_rule_ptr->src_only;
+	nat_rule_to_v4_rule(nat_rule_ptr, &v4_rule);
 
 	ret = ipa_NATI_add_ipv4_rule(dst_tbl_hdl, &v4_rule, &new_rule_hdl);
 
@@ -773,146 +986,531 @@ bail:
 	return ret;
 }
 
+/******************************************************************************/
 /*
- * ****************************************************************************
+ * FUNCTION: gen_orig_rule_hdl
  *
- * STATE MACHINE CODE BEGINS HERE
+ * PARAMS:
  *
- * ****************************************************************************
+ *   orig2new_map (IN) The orig to new map the rule is going into
+ *
+ *   new_rule_hdl (IN) The handle the table gave the rule
+ *
+ * DESCRIPTION:
+ *
+ *   A newly added rule's original handle is normally the handle the
+ *   table gave it.  Once rules have moved between tables, or their
+ *   table has been grown, that handle may already be the original
+ *   handle of some other rule.  When that happens, an unused handle
+ *   is made up instead.
+ *
+ * RETURNS:
+ *
+ *   The original handle to give the application
  */
-static int _smUndef(
-	ipa_nati_obj*    nati_obj_ptr,
-	ipa_nati_trigger trigger,
-	arb_t*           arb_data_ptr ); /* forward declaration */
+static uint32_t gen_orig_rule_hdl(
+	uint32_t orig2new_map,
+	uint32_t new_rule_hdl )
+{
+	uint32_t orig_rule_hdl = new_rule_hdl;
+
+	while ( ipa_nat_map_has(orig2new_map, orig_rule_hdl) )
+	{
+		orig_rule_hdl = nati_obj.next_alias_hdl++;
+
+		if ( nati_obj.next_alias_hdl < ALIAS_HDL_BASE )
+		{
+			nati_obj.next_alias_hdl = ALIAS_HDL_BASE;
+		}
+	}
+
+	if ( orig_rule_hdl != new_rule_hdl )
+	{
+		IPADBG("new_rule_hdl(0x%08X) already in use, orig_rule_hdl(0x%08X)\n",
+			   new_rule_hdl, orig_rule_hdl);
+	}
+
+	return orig_rule_hdl;
+}
 
 /******************************************************************************/
 /*
- * FUNCTION: _smDelTbl
+ * The following is used to hold a copy of the DDR table's rules while
+ * the table is being recreated at a larger size.
+ */
+typedef struct
+{
+	ipa_nat_ipv4_rule* rules;
+	uint32_t*          orig_rule_hdls;
+	uint32_t           num_rules;
+	uint32_t           max_rules;
+} rule_snapshot;
+
+/******************************************************************************/
+/*
+ * FUNCTION: snapshot_rule
  *
  * PARAMS:
  *
- *   nati_obj_ptr (IN) A pointer to an initialized nati object
- *
- *   trigger      (IN) The trigger to run through the state machine
- *
- *   arb_data_ptr (IN) Whatever you like
+ *   As for migrate_rule() above, except arb_data_ptr is the
+ *   rule_snapshot to fill
  *
  * DESCRIPTION:
  *
- *   The following will cause the destruction of the DDR based NAT
- *   table.
+ *   The ipa_table_walk() compatible counterpart of migrate_rule()
+ *   used when growing the DDR table.  Rather than adding the rule to
+ *   another table, it saves the rule and its original handle, since
+ *   the table it comes from is about to be recreated.
  *
  * RETURNS:
  *
- *   zero on success, otherwise non-zero
+ *   Returns 0 on success, non-zero on failure
  */
-static int _smDelTbl(
-	ipa_nati_obj*    nati_obj_ptr,
-	ipa_nati_trigger trigger,
-	arb_t*           arb_data_ptr )
+static int snapshot_rule(
+	ipa_table*      table_ptr,
+	uint32_t        tbl_rule_hdl,
+	void*           record_ptr,
+	uint16_t        record_index,
+	void*           meta_record_ptr,
+	uint16_t        meta_record_index,
+	void*           arb_data_ptr )
 {
-	arb_t**  args = arb_data_ptr;
-
-	uint32_t tbl_hdl = (uint32_t) args[0];
+	struct ipa_nat_rule* nat_rule_ptr = (struct ipa_nat_rule*) record_ptr;
+	rule_snapshot*       snap_ptr     = (rule_snapshot*) arb_data_ptr;
 
-	int ret;
+	int                  ret = 0;
 
-	IPADBG("In\n");
+	if ( nat_rule_ptr->protocol == IPA_NAT_INVALID_PROTO_FIELD_VALUE_IN_RULE )
+	{
+		IPADBG("Special \"first rule in list\" case. "
+			   "Rule's enabled bit on, but protocol implies deleted\n");
+		goto bail;
+	}
 
-	IPADBG("tbl_hdl(0x%08X)\n", tbl_hdl);
+	if ( snap_ptr->num_rules >= snap_ptr->max_rules )
+	{
+		IPAERR("More rules in table than counted (%u)\n", snap_ptr->max_rules);
+		ret = -1;
+		goto bail;
+	}
 
-	ret = ipa_NATI_del_ipv4_table(tbl_hdl);
+	ret = ipa_nat_map_find(
+		nati_obj.map_pairs[DDR_SUB].new2orig_map,
+		tbl_rule_hdl,
+		&snap_ptr->orig_rule_hdls[snap_ptr->num_rules]);
 
-	if ( ret == 0 && ! IN_HYBRID_STATE() )
+	if ( ret != 0 )
 	{
-		/*
-		 * The following will create the preferred "initial state" for
-		 * restart...
-		 */
-		BACK2_UNSTARTED_STATE();
+		IPAERR("ipa_nat_map_find(new2orig_map) fail for rule_hdl(0x%08X)\n",
+			   tbl_rule_hdl);
+		goto bail;
 	}
 
-	IPADBG("Out\n");
+	nat_rule_to_v4_rule(nat_rule_ptr, &snap_ptr->rules[snap_ptr->num_rules]);
 
+	snap_ptr->num_rules++;
+
+bail:
 	return ret;
 }
 
 /******************************************************************************/
 /*
- * FUNCTION: _smFirstTbl
+ * FUNCTION: ddr_tbl_crowded
  *
  * PARAMS:
  *
  *   nati_obj_ptr (IN) A pointer to an initialized nati object
  *
- *   trigger      (IN) The trigger to run through the state machine
- *
- *   arb_data_ptr (IN) Whatever you like
- *
  * DESCRIPTION:
  *
- *   The following will cause the creation of the very first NAT table(s)
- *   before any others have ever been created...
+ *   Uses the table's chain stats to decide whether the DDR table has
+ *   become crowded enough to be worth growing.
  *
  * RETURNS:
  *
- *   zero on success, otherwise non-zero
+ *   true when crowded and there is room to grow, otherwise false
  */
-static int _smFirstTbl(
-	ipa_nati_obj*    nati_obj_ptr,
-	ipa_nati_trigger trigger,
-	arb_t*           arb_data_ptr )
+static bool ddr_tbl_crowded(
+	ipa_nati_obj* nati_obj_ptr )
 {
-	arb_t**   args = arb_data_ptr;
-
-	uint32_t    public_ip_addr    = (uint32_t)    args[0];
-	uint16_t    number_of_entries = (uint16_t)    args[1];
-	uint32_t*   tbl_hdl_ptr       = (uint32_t*)   args[2];
-	const char* mem_type_ptr      = (const char*) args[3];
-
-	int ret;
+	ipa_nati_tbl_stats nat_stats, idx_stats;
 
-	IPADBG("In\n");
+	uint32_t           max_chain_len;
+	bool               crowded = false;
 
-	/*
-	 * This is the first time in here.  Let the ipacm's XML config (or
-	 * state_to_hold) drive initial state...
-	 */
-	SET_NATIOBJ_STATE(
-		nati_obj_ptr,
-		(nati_obj_ptr->hold_state && nati_obj_ptr->state_to_hold) ?
-		nati_obj_ptr->state_to_hold                               :
-		mem_type_str_to_ipa_nati_state(mem_type_ptr));
+	if ( ipa_NATI_ipv4_tbl_stats(
+			 nati_obj_ptr->ddr_tbl_hdl, &nat_stats, &idx_stats) != 0 )
+	{
+		goto bail;
+	}
 
-	ret = ipa_nati_statemach(nati_obj_ptr, NATI_TRIG_ADD_TABLE, args);
+	if ( nat_stats.req_ents >= nati_obj_ptr->grow_max_ents )
+	{
+		goto bail;
+	}
 
-	IPADBG("Out\n");
+	max_chain_len =
+		(nat_stats.max_chain_len > idx_stats.max_chain_len) ?
+		nat_stats.max_chain_len :
+		idx_stats.max_chain_len;
+
+	if ( max_chain_len > RESIZE_MAX_CHAIN_LEN
+		 ||
+		 nat_stats.tot_expn_ents_filled * 100 >=
+		 nat_stats.tot_expn_ents * RESIZE_EXPN_FILL_PRCNT
+		 ||
+		 idx_stats.tot_expn_ents_filled * 100 >=
+		 idx_stats.tot_expn_ents * RESIZE_EXPN_FILL_PRCNT )
+	{
+		IPAINFO("DDR table crowded: max_chain_len(%u) "
+				"NAT EXPN(%u of %u) IDX EXPN(%u of %u)\n",
+				max_chain_len,
+				nat_stats.tot_expn_ents_filled,
+				nat_stats.tot_expn_ents,
+				idx_stats.tot_expn_ents_filled,
+				idx_stats.tot_expn_ents);
+
+		crowded = true;
+	}
 
-	return ret;
+bail:
+	return crowded;
 }
 
 /******************************************************************************/
 /*
- * FUNCTION: _smAddDdrTbl
+ * FUNCTION: check_ddr_tbl_crowding
  *
  * PARAMS:
  *
  *   nati_obj_ptr (IN) A pointer to an initialized nati object
  *
- *   trigger      (IN) The trigger to run through the state machine
- *
- *   arb_data_ptr (IN) Whatever you like
+ *   num_added    (IN) The number of rules just added
  *
  * DESCRIPTION:
  *
- *   The following will cause the creation of a NAT table in DDR.
+ *   Called after rules have been added.  When the DDR table is in
+ *   focus, and growing it ahead of time has been asked for, every
+ *   RESIZE_CHK_INTVL additions it is checked for crowding, and grown
+ *   if need be.
  *
  * RETURNS:
  *
- *   zero on success, otherwise non-zero
+ *   Nothing.  A failure to grow leaves the table as it was.
  */
-static int _smAddDdrTbl(
-	ipa_nati_obj*    nati_obj_ptr,
+static void check_ddr_tbl_crowding(
+	ipa_nati_obj* nati_obj_ptr,
+	uint32_t      num_added )
+{
+	if ( ! DDR_CURRENTLY_ACTIVE() || ! nati_obj_ptr->grow_when_crowded )
+	{
+		return;
+	}
+
+	nati_obj_ptr->adds_since_resize_chk += num_added;
+
+	if ( nati_obj_ptr->adds_since_resize_chk < RESIZE_CHK_INTVL )
+	{
+		return;
+	}
+
+	nati_obj_ptr->adds_since_resize_chk = 0;
+
+	if ( ddr_tbl_crowded(nati_obj_ptr) )
+	{
+		ipa_nati_statemach(nati_obj_ptr, NATI_TRIG_TBL_RESIZE, 0);
+	}
+}
+
+/******************************************************************************/
+/*
+ * FUNCTION: rebuild_ddr_tbl
+ *
+ * PARAMS:
+ *
+ *   nati_obj_ptr  (IN)  A pointer to an initialized nati object
+ *
+ *   num_ents      (IN)  The number of entries to recreate the table with
+ *
+ *   snap_ptr      (IN)  The rules to put back into the table
+ *
+ *   new_rule_hdls (OUT) The handles the rules got, in snapshot order
+ *
+ *   added_ptr     (OUT) How many of the rules were put back
+ *
+ * DESCRIPTION:
+ *
+ *   Recreates the DDR table with num_ents entries and puts the
+ *   snapshot's rules back into it.  Rules are put back in snapshot
+ *   order, hence the first *added_ptr of them are in the table.
+ *
+ * RETURNS:
+ *
+ *   zero when the table was recreated and every rule put back,
+ *   otherwise non-zero
+ */
+static int rebuild_ddr_tbl(
+	ipa_nati_obj*        nati_obj_ptr,
+	uint32_t             num_ents,
+	const rule_snapshot* snap_ptr,
+	uint32_t*            new_rule_hdls,
+	uint32_t*            added_ptr )
+{
+	int ret;
+
+	IPADBG("In\n");
+
+	*added_ptr = 0;
+
+	ret = ipa_NATI_resize_ipv4_tbl(nati_obj_ptr->ddr_tbl_hdl, num_ents);
+
+	if ( ret != 0 )
+	{
+		IPAERR("Unable to recreate DDR table with (%u) entries\n", num_ents);
+		goto bail;
+	}
+
+	if ( snap_ptr->num_rules )
+	{
+		ret = ipa_NATI_add_ipv4_rules(
+			nati_obj_ptr->ddr_tbl_hdl,
+			snap_ptr->rules,
+			snap_ptr->num_rules,
+			new_rule_hdls,
+			added_ptr);
+	}
+
+	if ( ret == 0 && *added_ptr != snap_ptr->num_rules )
+	{
+		ret = -1;
+	}
+
+	if ( ret != 0 )
+	{
+		IPAERR("Only (%u) of (%u) rules put back into DDR table with (%u) entries\n",
+			   *added_ptr, snap_ptr->num_rules, num_ents);
+	}
+
+bail:
+	IPADBG("Out\n");
+
+	return ret;
+}
+
+/******************************************************************************/
+/*
+ * FUNCTION: remap_ddr_rules
+ *
+ * PARAMS:
+ *
+ *   nati_obj_ptr  (IN) A pointer to an initialized nati object
+ *
+ *   snap_ptr      (IN) The rules that were put back into the table
+ *
+ *   new_rule_hdls (IN) The handles the rules got, in snapshot order
+ *
+ *   num_rules     (IN) How many of the snapshot's rules are in the table
+ *
+ * DESCRIPTION:
+ *
+ *   Makes the DDR maps, and rule count, agree with a table that has
+ *   just been rebuilt.  The original handles held by the application
+ *   are made to point to the rules' new handles.  Rules that didn't
+ *   make it into the table are dropped from the maps, so that their
+ *   handles can't find some other rule.
+ *
+ *   The maps keep their room when cleared, and held every one of the
+ *   snapshot's rules before, hence this can't run out of room.
+ *
+ * RETURNS:
+ *
+ *   zero on success, otherwise non-zero
+ */
+static int remap_ddr_rules(
+	ipa_nati_obj*        nati_obj_ptr,
+	const rule_snapshot* snap_ptr,
+	const uint32_t*      new_rule_hdls,
+	uint32_t             num_rules )
+{
+	uint32_t orig2new_map = nati_obj_ptr->map_pairs[DDR_SUB].orig2new_map;
+	uint32_t new2orig_map = nati_obj_ptr->map_pairs[DDR_SUB].new2orig_map;
+	uint32_t i;
+
+	int      ret = 0;
+
+	IPADBG("In\n");
+
+	ipa_nat_map_clear(orig2new_map);
+	ipa_nat_map_clear(new2orig_map);
+
+	nati_obj_ptr->tot_rules_in_table[DDR_SUB] = num_rules;
+
+	for ( i = 0; i < num_rules; i++ )
+	{
+		ret = ipa_nat_map_add(
+			orig2new_map, snap_ptr->orig_rule_hdls[i], new_rule_hdls[i]);
+
+		if ( ret == 0 )
+		{
+			ret = ipa_nat_map_add(
+				new2orig_map, new_rule_hdls[i], snap_ptr->orig_rule_hdls[i]);
+		}
+
+		if ( ret != 0 )
+		{
+			IPAERR("Unable to map orig_rule_hdl(0x%08X) -> new_rule_hdl(0x%08X)\n",
+				   snap_ptr->orig_rule_hdls[i], new_rule_hdls[i]);
+			break;
+		}
+	}
+
+	IPADBG("Out\n");
+
+	return ret;
+}
+
+/*
+ * ****************************************************************************
+ *
+ * STATE MACHINE CODE BEGINS HERE
+ *
+ * ****************************************************************************
+ */
+static int _smUndef(
+	ipa_nati_obj*    nati_obj_ptr,
+	ipa_nati_trigger trigger,
+	arb_t*           arb_data_ptr ); /* forward declaration */
+
+/******************************************************************************/
+/*
+ * FUNCTION: _smDelTbl
+ *
+ * PARAMS:
+ *
+ *   nati_obj_ptr (IN) A pointer to an initialized nati object
+ *
+ *   trigger      (IN) The trigger to run through the state machine
+ *
+ *   arb_data_ptr (IN) Whatever you like
+ *
+ * DESCRIPTION:
+ *
+ *   The following will cause the destruction of the DDR based NAT
+ *   table.
+ *
+ * RETURNS:
+ *
+ *   zero on success, otherwise non-zero
+ */
+static int _smDelTbl(
+	ipa_nati_obj*    nati_obj_ptr,
+	ipa_nati_trigger trigger,
+	arb_t*           arb_data_ptr )
+{
+	arb_t**  args = arb_data_ptr;
+
+	uint32_t tbl_hdl = (uint32_t) args[0];
+
+	int ret;
+
+	IPADBG("In\n");
+
+	IPADBG("tbl_hdl(0x%08X)\n", tbl_hdl);
+
+	ret = ipa_NATI_del_ipv4_table(tbl_hdl);
+
+	if ( ret == 0 && ! IN_HYBRID_STATE() )
+	{
+		/*
+		 * The following will create the preferred "initial state" for
+		 * restart...
+		 */
+		BACK2_UNSTARTED_STATE();
+	}
+
+	IPADBG("Out\n");
+
+	return ret;
+}
+
+/******************************************************************************/
+/*
+ * FUNCTION: _smFirstTbl
+ *
+ * PARAMS:
+ *
+ *   nati_obj_ptr (IN) A pointer to an initialized nati object
+ *
+ *   trigger      (IN) The trigger to run through the state machine
+ *
+ *   arb_data_ptr (IN) Whatever you like
+ *
+ * DESCRIPTION:
+ *
+ *   The following will cause the creation of the very first NAT table(s)
+ *   before any others have ever been created...
+ *
+ * RETURNS:
+ *
+ *   zero on success, otherwise non-zero
+ */
+static int _smFirstTbl(
+	ipa_nati_obj*    nati_obj_ptr,
+	ipa_nati_trigger trigger,
+	arb_t*           arb_data_ptr )
+{
+	arb_t**   args = arb_data_ptr;
+
+	uint32_t    public_ip_addr    = (uint32_t)    args[0];
+	uint16_t    number_of_entries = (uint16_t)    args[1];
+	uint32_t*   tbl_hdl_ptr       = (uint32_t*)   args[2];
+	const char* mem_type_ptr      = (const char*) args[3];
+
+	int ret;
+
+	IPADBG("In\n");
+
+	/*
+	 * This is the first time in here.  Let the ipacm's XML config (or
+	 * state_to_hold) drive initial state...
+	 */
+	SET_NATIOBJ_STATE(
+		nati_obj_ptr,
+		(nati_obj_ptr->hold_state && nati_obj_ptr->state_to_hold) ?
+		nati_obj_ptr->state_to_hold                               :
+		mem_type_str_to_ipa_nati_state(mem_type_ptr));
+
+	ret = ipa_nati_statemach(nati_obj_ptr, NATI_TRIG_ADD_TABLE, args);
+
+	IPADBG("Out\n");
+
+	return ret;
+}
+
+/******************************************************************************/
+/*
+ * FUNCTION: _smAddDdrTbl
+ *
+ * PARAMS:
+ *
+ *   nati_obj_ptr (IN) A pointer to an initialized nati object
+ *
+ *   trigger      (IN) The trigger to run through the state machine
+ *
+ *   arb_data_ptr (IN) Whatever you like
+ *
+ * DESCRIPTION:
+ *
+ *   The following will cause the creation of a NAT table in DDR.  The
+ *   DDR handle maps are emptied and sized for the new table.
+ *
+ * RETURNS:
+ *
+ *   zero on success, otherwise non-zero
+ */
+static int _smAddDdrTbl(
+	ipa_nati_obj*    nati_obj_ptr,
 	ipa_nati_trigger trigger,
 	arb_t*           arb_data_ptr )
 {
@@ -929,12 +1527,23 @@ static int _smAddDdrTbl(
 	IPADBG("public_ip_addr(0x%08X) number_of_entries(%u) tbl_hdl_ptr(%p)\n",
 		   public_ip_addr, number_of_entries, tbl_hdl_ptr);
 
+	nati_obj_ptr->tot_rules_in_table[DDR_SUB] = 0;
+	nati_obj_ptr->adds_since_resize_chk       = 0;
+
+	ipa_nat_map_clear(nati_obj_ptr->map_pairs[DDR_SUB].orig2new_map);
+	ipa_nat_map_clear(nati_obj_ptr->map_pairs[DDR_SUB].new2orig_map);
+
 	ret = ipa_NATI_add_ipv4_tbl(
 		IPA_NAT_MEM_IN_DDR,
 		public_ip_addr,
 		number_of_entries,
 		&nati_obj_ptr->ddr_tbl_hdl);
 
+	if ( ret == 0 )
+	{
+		ret = reserve_maps(nati_obj_ptr, DDR_SUB, nati_obj_ptr->ddr_tbl_hdl);
+	}
+
 	if ( ret == 0 )
 	{
 		*tbl_hdl_ptr = nati_obj_ptr->ddr_tbl_hdl;
@@ -1117,6 +1726,11 @@ static int _smAddSramAndDdrTbl(
 
 			ret = _smAddDdrTbl(nati_obj_ptr, trigger, new_args);
 
+			if ( ret == 0 )
+			{
+				ret = reserve_maps(nati_obj_ptr, SRAM_SUB, nati_obj_ptr->sram_tbl_hdl);
+			}
+
 			if ( ret == 0 )
 			{
 				/*
@@ -1669,6 +2283,7 @@ static int _smAddRuleHybrid(
 	};
 
 	uint32_t orig2new_map, new2orig_map;
+	uint32_t new_rule_hdl;
 
 	int ret;
 
@@ -1701,17 +2316,39 @@ static int _smAddRuleHybrid(
 		 */
 		CHOOSE_MAPS(orig2new_map, new2orig_map);
 
-		ret = ipa_nat_map_add(orig2new_map, *rule_hdl, *rule_hdl);
+		new_rule_hdl = *rule_hdl;
+		*rule_hdl    = gen_orig_rule_hdl(orig2new_map, new_rule_hdl);
+
+		ret = ipa_nat_map_add(orig2new_map, *rule_hdl, new_rule_hdl);
+
+		if ( ret == 0 )
+		{
+			ret = ipa_nat_map_add(new2orig_map, new_rule_hdl, *rule_hdl);
+		}
 
 		if ( ret == 0 )
 		{
-			ret = ipa_nat_map_add(new2orig_map, *rule_hdl, *rule_hdl);
+			check_ddr_tbl_crowding(nati_obj_ptr, 1);
 		}
 	}
 	else
 	{
-		if ( nati_obj_ptr->curr_state == NATI_STATE_HYBRID
-			 &&
+		if ( GROW_DDR_WHEN_FULL(ret) )
+		{
+			/*
+			 * The DDR table has no room left for the rule, so grow
+			 * it and try again.  If it can't be grown, the add
+			 * fails as it would have...
+			 */
+			IPAINFO("Add of rule failed...attempting table resize\n");
+
+			if ( ipa_nati_statemach(nati_obj_ptr, NATI_TRIG_TBL_RESIZE, 0) == 0 )
+			{
+				ret = ipa_nati_statemach(nati_obj_ptr, trigger, arb_data_ptr);
+			}
+		}
+		else if ( nati_obj_ptr->curr_state == NATI_STATE_HYBRID
+			 &&
 			 ! nati_obj_ptr->hold_state )
 		{
 			/*
@@ -1880,6 +2517,400 @@ static int _smDelRuleHybrid(
 	return ret;
 }
 
+/******************************************************************************/
+/*
+ * FUNCTION: _smAddRulesToTbl
+ *
+ * PARAMS:
+ *
+ *   nati_obj_ptr (IN) A pointer to an initialized nati object
+ *
+ *   trigger      (IN) The trigger to run through the state machine
+ *
+ *   arb_data_ptr (IN) Whatever you like
+ *
+ * DESCRIPTION:
+ *
+ *   The following will cause the addtion of a batch of NAT rules
+ *   into the currently focused table.
+ *
+ * RETURNS:
+ *
+ *   zero on success, otherwise non-zero
+ */
+static int _smAddRulesToTbl(
+	ipa_nati_obj*    nati_obj_ptr,
+	ipa_nati_trigger trigger,
+	arb_t*           arb_data_ptr )
+{
+	arb_t** args = arb_data_ptr;
+
+	uint32_t           tbl_hdl    = (uint32_t)           args[0];
+	ipa_nat_ipv4_rule* clnt_rules = (ipa_nat_ipv4_rule*) args[1];
+	uint32_t           num_rules  = (uint32_t)           args[2];
+	uint32_t*          rule_hdls  = (uint32_t*)          args[3];
+	uint32_t*          num_added  = (uint32_t*)          args[4];
+
+	uint32_t* cnt_ptr;
+	uint32_t  i;
+
+	int ret;
+
+	IPADBG("In\n");
+
+	IPADBG("tbl_hdl(0x%08X) clnt_rules_ptr(%p) num_rules(%u) rule_hdls_ptr(%p)\n",
+		   tbl_hdl, clnt_rules, num_rules, rule_hdls);
+
+	for ( i = 0; i < num_rules; i++ )
+	{
+		clnt_rules[i].redirect = clnt_rules[i].enable = clnt_rules[i].time_stamp = 0;
+	}
+
+	ret = ipa_NATI_add_ipv4_rules(tbl_hdl, clnt_rules, num_rules, rule_hdls, num_added);
+
+	cnt_ptr = CHOOSE_CNTR();
+
+	(*cnt_ptr) += *num_added;
+
+	IPADBG("Added %u of %u rules\n", *num_added, num_rules);
+
+	IPADBG("Out\n");
+
+	return ret;
+}
+
+/******************************************************************************/
+/*
+ * FUNCTION: _smDelRulesFromTbl
+ *
+ * PARAMS:
+ *
+ *   nati_obj_ptr (IN) A pointer to an initialized nati object
+ *
+ *   trigger      (IN) The trigger to run through the state machine
+ *
+ *   arb_data_ptr (IN) Whatever you like
+ *
+ * DESCRIPTION:
+ *
+ *   The following will cause the deletion of a batch of NAT rules
+ *   from the currently focused table.
+ *
+ * RETURNS:
+ *
+ *   zero on success, otherwise non-zero
+ */
+static int _smDelRulesFromTbl(
+	ipa_nati_obj*    nati_obj_ptr,
+	ipa_nati_trigger trigger,
+	arb_t*           arb_data_ptr )
+{
+	arb_t**   args = arb_data_ptr;
+
+	uint32_t  tbl_hdl     = (uint32_t)  args[0];
+	uint32_t* rule_hdls   = (uint32_t*) args[1];
+	uint32_t  num_rules   = (uint32_t)  args[2];
+	uint32_t* num_deleted = (uint32_t*) args[3];
+
+	uint32_t* cnt_ptr;
+
+	int ret;
+
+	IPADBG("In\n");
+
+	IPADBG("tbl_hdl(0x%08X) rule_hdls_ptr(%p) num_rules(%u)\n",
+		   tbl_hdl, rule_hdls, num_rules);
+
+	ret = ipa_NATI_del_ipv4_rules(tbl_hdl, rule_hdls, num_rules, num_deleted);
+
+	cnt_ptr = CHOOSE_CNTR();
+
+	(*cnt_ptr) -= *num_deleted;
+
+	IPADBG("Deleted %u of %u rules\n", *num_deleted, num_rules);
+
+	IPADBG("Out\n");
+
+	return ret;
+}
+
+/******************************************************************************/
+/*
+ * FUNCTION: _smAddRulesHybrid
+ *
+ * PARAMS:
+ *
+ *   nati_obj_ptr (IN) A pointer to an initialized nati object
+ *
+ *   trigger      (IN) The trigger to run through the state machine
+ *
+ *   arb_data_ptr (IN) Whatever you like
+ *
+ * DESCRIPTION:
+ *
+ *   The batch version of _smAddRuleHybrid. Rules are added to
+ *   whichever table is in focus and mapped as described there. If
+ *   SRAM fills part way through the batch, the table switch to DDR
+ *   happens and the remaining rules go there.
+ *
+ * RETURNS:
+ *
+ *   zero on success, otherwise non-zero
+ */
+static int _smAddRulesHybrid(
+	ipa_nati_obj*    nati_obj_ptr,
+	ipa_nati_trigger trigger,
+	arb_t*           arb_data_ptr )
+{
+	arb_t** args = arb_data_ptr;
+
+	uint32_t           tbl_hdl    = (uint32_t)           args[0];
+	ipa_nat_ipv4_rule* clnt_rules = (ipa_nat_ipv4_rule*) args[1];
+	uint32_t           num_rules  = (uint32_t)           args[2];
+	uint32_t*          rule_hdls  = (uint32_t*)          args[3];
+	uint32_t*          num_added  = (uint32_t*)          args[4];
+
+	uint32_t           added = 0, more_added = 0;
+
+	arb_t*             new_args[] = {
+		(arb_t*) (nati_obj_ptr->curr_state == NATI_STATE_HYBRID) ?
+		         tbl_hdl :
+		         nati_obj_ptr->ddr_tbl_hdl,
+		(arb_t*) clnt_rules,
+		(arb_t*) num_rules,
+		(arb_t*) rule_hdls,
+		(arb_t*) &added,
+	};
+
+	uint32_t orig2new_map, new2orig_map;
+	uint32_t new_rule_hdl;
+	uint32_t i;
+
+	int ret, map_ret = 0;
+
+	IPADBG("In\n");
+
+	ret = _smAddRulesToTbl(nati_obj_ptr, trigger, new_args);
+
+	/*
+	 * See _smAddRuleHybrid() for why the maps are needed...
+	 */
+	CHOOSE_MAPS(orig2new_map, new2orig_map);
+
+	for ( i = 0; i < added && map_ret == 0; i++ )
+	{
+		new_rule_hdl = rule_hdls[i];
+		rule_hdls[i] = gen_orig_rule_hdl(orig2new_map, new_rule_hdl);
+
+		map_ret = ipa_nat_map_add(orig2new_map, rule_hdls[i], new_rule_hdl);
+
+		if ( map_ret == 0 )
+		{
+			map_ret = ipa_nat_map_add(new2orig_map, new_rule_hdl, rule_hdls[i]);
+		}
+	}
+
+	*num_added = added;
+
+	if ( map_ret )
+	{
+		ret = map_ret;
+	}
+	else if ( ret == 0 )
+	{
+		check_ddr_tbl_crowding(nati_obj_ptr, added);
+	}
+	else if ( GROW_DDR_WHEN_FULL(ret) )
+	{
+		/*
+		 * The DDR table filled part way through the batch, so grow
+		 * it and carry on with the rules that did not fit...
+		 */
+		IPAINFO("Add of rule %u of %u failed...attempting table resize\n",
+				added + 1, num_rules);
+
+		if ( ipa_nati_statemach(nati_obj_ptr, NATI_TRIG_TBL_RESIZE, 0) == 0 )
+		{
+			arb_t* more_args[] = {
+				(arb_t*) tbl_hdl,
+				(arb_t*) &clnt_rules[added],
+				(arb_t*) (num_rules - added),
+				(arb_t*) &rule_hdls[added],
+				(arb_t*) &more_added,
+			};
+
+			ret = ipa_nati_statemach(nati_obj_ptr, trigger, more_args);
+
+			*num_added += more_added;
+		}
+	}
+	else if ( ret
+			  &&
+			  nati_obj_ptr->curr_state == NATI_STATE_HYBRID
+			  &&
+			  ! nati_obj_ptr->hold_state )
+	{
+		/*
+		 * SRAM is full, so jump to DDR and carry on there with the
+		 * rules that did not fit...
+		 */
+		IPAINFO("Add of rule %u of %u failed...attempting table switch\n",
+				added + 1, num_rules);
+
+		ret = ipa_nati_statemach(nati_obj_ptr, NATI_TRIG_TBL_SWITCH, 0);
+
+		if ( ret == 0 )
+		{
+			arb_t* more_args[] = {
+				(arb_t*) tbl_hdl,
+				(arb_t*) &clnt_rules[added],
+				(arb_t*) (num_rules - added),
+				(arb_t*) &rule_hdls[added],
+				(arb_t*) &more_added,
+			};
+
+			SET_NATIOBJ_STATE(nati_obj_ptr, NATI_STATE_HYBRID_DDR);
+
+			ret = ipa_nati_statemach(nati_obj_ptr, trigger, more_args);
+
+			*num_added += more_added;
+		}
+	}
+
+	IPADBG("Out\n");
+
+	return ret;
+}
+
+/******************************************************************************/
+/*
+ * FUNCTION: _smDelRulesHybrid
+ *
+ * PARAMS:
+ *
+ *   nati_obj_ptr (IN) A pointer to an initialized nati object
+ *
+ *   trigger      (IN) The trigger to run through the state machine
+ *
+ *   arb_data_ptr (IN) Whatever you like
+ *
+ * DESCRIPTION:
+ *
+ *   The batch version of _smDelRuleHybrid. The original handles are
+ *   mapped to the current ones a chunk at a time, and the check for
+ *   going back to SRAM is made once, after the whole batch.
+ *
+ * RETURNS:
+ *
+ *   zero on success, otherwise non-zero
+ */
+static int _smDelRulesHybrid(
+	ipa_nati_obj*    nati_obj_ptr,
+	ipa_nati_trigger trigger,
+	arb_t*           arb_data_ptr )
+{
+	arb_t**   args = arb_data_ptr;
+
+	uint32_t  tbl_hdl        = (uint32_t)  args[0];
+	uint32_t* orig_rule_hdls = (uint32_t*) args[1];
+	uint32_t  num_rules      = (uint32_t)  args[2];
+	uint32_t* num_deleted    = (uint32_t*) args[3];
+
+	uint32_t  new_rule_hdls[64];
+	uint32_t  chunk, found, deleted, i;
+
+	uint32_t  orig2new_map,  new2orig_map;
+
+	int       ret = 0, del_ret;
+
+	IPADBG("In\n");
+
+	*num_deleted = 0;
+
+	CHOOSE_MAPS(orig2new_map, new2orig_map);
+
+	while ( ret == 0 && *num_deleted < num_rules )
+	{
+		chunk = num_rules - *num_deleted;
+
+		if ( chunk > (sizeof(new_rule_hdls) / sizeof(new_rule_hdls[0])) )
+		{
+			chunk = (sizeof(new_rule_hdls) / sizeof(new_rule_hdls[0]));
+		}
+
+		for ( found = 0; found < chunk; found++ )
+		{
+			ret = ipa_nat_map_find(
+				orig2new_map,
+				orig_rule_hdls[*num_deleted + found],
+				&new_rule_hdls[found]);
+
+			if ( ret )
+			{
+				break;
+			}
+		}
+
+		if ( found == 0 )
+		{
+			break;
+		}
+
+		{
+			arb_t* new_args[]  = {
+				(arb_t*) (nati_obj_ptr->curr_state == NATI_STATE_HYBRID) ?
+				        tbl_hdl :
+				        nati_obj_ptr->ddr_tbl_hdl,
+				(arb_t*) new_rule_hdls,
+				(arb_t*) found,
+				(arb_t*) &deleted,
+			};
+
+			deleted = 0;
+
+			del_ret = _smDelRulesFromTbl(nati_obj_ptr, trigger, new_args);
+
+			for ( i = 0; i < deleted; i++ )
+			{
+				ipa_nat_map_del(orig2new_map, orig_rule_hdls[*num_deleted + i], NULL);
+				ipa_nat_map_del(new2orig_map, new_rule_hdls[i], NULL);
+			}
+
+			*num_deleted += deleted;
+
+			ret = (ret) ? ret : del_ret;
+		}
+	}
+
+	if ( *num_deleted && nati_obj_ptr->curr_state == NATI_STATE_HYBRID_DDR )
+	{
+		/*
+		 * See _smDelRuleHybrid() for the how and why of going back
+		 * to SRAM...
+		 */
+		uint32_t* cnt_ptr = CHOOSE_CNTR();
+
+		if ( *cnt_ptr <= nati_obj_ptr->back_to_sram_thresh
+			 &&
+			 ! nati_obj_ptr->hold_state )
+		{
+			IPAINFO("Switch back to SRAM threshold has been reached -> "
+					"Total rules in DDR(%u) <= SRAM THRESH(%u)\n",
+					*cnt_ptr,
+					nati_obj_ptr->back_to_sram_thresh);
+
+			if ( ipa_nati_statemach(nati_obj_ptr, NATI_TRIG_TBL_SWITCH, 0) == 0 )
+			{
+				SET_NATIOBJ_STATE(nati_obj_ptr, NATI_STATE_HYBRID);
+			}
+		}
+	}
+
+	IPADBG("Out\n");
+
+	return ret;
+}
+
 /******************************************************************************/
 /*
  * FUNCTION: _smGoToDdr
@@ -2304,6 +3335,199 @@ static int _smSwitchFromSramToDdr(
 	return ret;
 }
 
+/******************************************************************************/
+/*
+ * FUNCTION: _smResizeDdrTbl
+ *
+ * PARAMS:
+ *
+ *   nati_obj_ptr (IN) A pointer to an initialized nati object
+ *
+ *   trigger      (IN) The trigger to run through the state machine
+ *
+ *   arb_data_ptr (IN) Whatever you like
+ *
+ * DESCRIPTION:
+ *
+ *   The following will grow the DDR table, that's currently in focus,
+ *   to twice its size (or nati_obj's grow_max_ents) and rehash all of
+ *   its rules into the bigger table.
+ *
+ *   Only one DDR table can exist at a time, so the bigger table can't
+ *   be built before the old one is gone.  Instead, the rules are saved
+ *   off (see snapshot_rule()), the table is recreated, and the rules
+ *   are put back.  While this happens, the IPA will not find the
+ *   table's connections and will hand their packets up to the apps.
+ *
+ *   Much like a switch between SRAM and DDR, every rule gets a new
+ *   handle.  The DDR maps are rebuilt so that the original handles,
+ *   held by the application, point to the new ones.
+ *
+ *   If the bigger table can't be had, or the rules don't all fit in
+ *   it, the table is recreated at its old size and the rules put back
+ *   there, which they should fit.  The grow fails, but every handle
+ *   held by the application still works.  Only if that too fails are
+ *   rules lost.  Their handles are then dropped from the maps.
+ *
+ * RETURNS:
+ *
+ *   zero when the table was grown, otherwise non-zero
+ */
+static int _smResizeDdrTbl(
+	ipa_nati_obj*    nati_obj_ptr,
+	ipa_nati_trigger trigger,
+	arb_t*           arb_data_ptr )
+{
+	ipa_nati_tbl_stats nat_stats, idx_stats;
+
+	rule_snapshot      snap;
+	uint32_t*          new_rule_hdls = NULL;
+	uint32_t           old_ents, new_ents, added = 0;
+
+	uint64_t           start, stop;
+
+	int                ret;
+
+	IPADBG("In\n");
+
+	memset(&snap, 0, sizeof(snap));
+
+	ret = ipa_NATI_ipv4_tbl_stats(
+		nati_obj_ptr->ddr_tbl_hdl, &nat_stats, &idx_stats);
+
+	if ( ret != 0 )
+	{
+		goto bail;
+	}
+
+	old_ents = nat_stats.req_ents;
+
+	new_ents = (old_ents * 2 < nati_obj_ptr->grow_max_ents) ?
+		old_ents * 2 :
+		nati_obj_ptr->grow_max_ents;
+
+	if ( new_ents <= old_ents )
+	{
+		IPAERR("DDR table of size (%u) can't be grown any further\n", old_ents);
+		ret = -1;
+		goto bail;
+	}
+
+	currTimeAs(TimeAsNanSecs, &start);
+
+	/*
+	 * Save the rules, along with the handles the application knows
+	 * them by...
+	 */
+	snap.max_rules      = nati_obj_ptr->tot_rules_in_table[DDR_SUB];
+	snap.rules          = calloc(snap.max_rules + 1, sizeof(ipa_nat_ipv4_rule));
+	snap.orig_rule_hdls = calloc(snap.max_rules + 1, sizeof(uint32_t));
+	new_rule_hdls       = calloc(snap.max_rules + 1, sizeof(uint32_t));
+
+	if ( ! snap.rules || ! snap.orig_rule_hdls || ! new_rule_hdls )
+	{
+		IPAERR("Unable to allocate room for (%u) rules\n", snap.max_rules);
+		ret = -ENOMEM;
+		goto free_snap;
+	}
+
+	ret = ipa_NATI_walk_ipv4_tbl(
+		nati_obj_ptr->ddr_tbl_hdl, USE_NAT_TABLE, snapshot_rule, &snap);
+
+	if ( ret != 0 )
+	{
+		IPAERR("Unable to save DDR table's rules\n");
+		goto free_snap;
+	}
+
+	/*
+	 * Now recreate the table, bigger, and put the rules back...
+	 */
+	ret = rebuild_ddr_tbl(nati_obj_ptr, new_ents, &snap, new_rule_hdls, &added);
+
+	if ( ret != 0 )
+	{
+		IPAERR("Unable to grow DDR table to (%u) entries\n", new_ents);
+
+		/*
+		 * When the bigger table was refused up front, the old one is
+		 * still there, untouched, and so are the maps...
+		 */
+		if ( ipa_NATI_ipv4_tbl_stats(
+				 nati_obj_ptr->ddr_tbl_hdl, &nat_stats, &idx_stats) == 0
+			 &&
+			 nat_stats.req_ents == old_ents )
+		{
+			goto free_snap;
+		}
+
+		/*
+		 * ...otherwise, get the old size back.
+		 */
+		if ( rebuild_ddr_tbl(nati_obj_ptr, old_ents, &snap, new_rule_hdls, &added) != 0 )
+		{
+			IPAERR("Unable to recreate DDR table. (%u) of (%u) rules lost\n",
+				   snap.num_rules - added, snap.num_rules);
+
+			remap_ddr_rules(nati_obj_ptr, &snap, new_rule_hdls, added);
+
+			ret = -EIO;
+
+			goto free_snap;
+		}
+
+		if ( remap_ddr_rules(nati_obj_ptr, &snap, new_rule_hdls, added) == 0 )
+		{
+			IPAINFO("DDR table put back at (%u) entries with (%u) rules\n",
+					old_ents, added);
+		}
+
+		goto free_snap;
+	}
+
+	ret = remap_ddr_rules(nati_obj_ptr, &snap, new_rule_hdls, added);
+
+	if ( ret != 0 )
+	{
+		goto free_snap;
+	}
+
+	if ( reserve_maps(nati_obj_ptr, DDR_SUB, nati_obj_ptr->ddr_tbl_hdl) != 0 )
+	{
+		IPAERR("Unable to size DDR maps for (%u) entries\n", new_ents);
+	}
+
+	currTimeAs(TimeAsNanSecs, &stop);
+
+	IPAINFO("DDR table grown from (%u) to (%u) entries with (%u) rules "
+			"in %f microseconds\n",
+			old_ents, new_ents, added,
+			(float) (stop - start) / 1000.0);
+
+free_snap:
+	if ( ret == 0 )
+	{
+		nati_obj_ptr->resize_stats.pass += 1;
+	}
+	else
+	{
+		nati_obj_ptr->resize_stats.fail += 1;
+	}
+
+	IPADBG("Resize pass/fail counts PASS: %u FAIL: %u\n",
+		   nati_obj_ptr->resize_stats.pass,
+		   nati_obj_ptr->resize_stats.fail);
+
+	free(snap.rules);
+	free(snap.orig_rule_hdls);
+	free(new_rule_hdls);
+
+bail:
+	IPADBG("Out\n");
+
+	return ret;
+}
+
 /******************************************************************************/
 /*
  * FUNCTION: _smGetTmStmp
@@ -2439,6 +3663,9 @@ _state_mach_tbl[NATI_STATE_LAST+1][NATI_TRIG_LAST+1] =
 		SM_ROW( NATI_STATE_NULL,       NATI_TRIG_GOTO_DDR,   _smUndef ),
 		SM_ROW( NATI_STATE_NULL,       NATI_TRIG_GOTO_SRAM,  _smUndef ),
 		SM_ROW( NATI_STATE_NULL,       NATI_TRIG_GET_TSTAMP, _smUndef ),
+		SM_ROW( NATI_STATE_NULL,       NATI_TRIG_ADD_RULES,  _smUndef ),
+		SM_ROW( NATI_STATE_NULL,       NATI_TRIG_DEL_RULES,  _smUndef ),
+		SM_ROW( NATI_STATE_NULL,       NATI_TRIG_TBL_RESIZE, _smUndef ),
 		SM_ROW( NATI_STATE_NULL,       NATI_TRIG_LAST,       _smUndef ),
 	},
 
@@ -2446,15 +3673,18 @@ _state_mach_tbl[NATI_STATE_LAST+1][NATI_TRIG_LAST+1] =
 		SM_ROW( NATI_STATE_DDR_ONLY,   NATI_TRIG_NULL,       _smUndef ),
 		SM_ROW( NATI_STATE_DDR_ONLY,   NATI_TRIG_ADD_TABLE,  _smAddDdrTbl ),
 		SM_ROW( NATI_STATE_DDR_ONLY,   NATI_TRIG_DEL_TABLE,  _smDelTbl ),
-		SM_ROW( NATI_STATE_DDR_ONLY,   NATI_TRIG_CLR_TABLE,  _smClrTbl ),
-		SM_ROW( NATI_STATE_DDR_ONLY,   NATI_TRIG_WLK_TABLE,  _smWalkTbl ),
-		SM_ROW( NATI_STATE_DDR_ONLY,   NATI_TRIG_TBL_STATS,  _smStatTbl ),
-		SM_ROW( NATI_STATE_DDR_ONLY,   NATI_TRIG_ADD_RULE,   _smAddRuleToTbl ),
-		SM_ROW( NATI_STATE_DDR_ONLY,   NATI_TRIG_DEL_RULE,   _smDelRuleFromTbl ),
+		SM_ROW( NATI_STATE_DDR_ONLY,   NATI_TRIG_CLR_TABLE,  _smClrTblHybrid ),
+		SM_ROW( NATI_STATE_DDR_ONLY,   NATI_TRIG_WLK_TABLE,  _smWalkTblHybrid ),
+		SM_ROW( NATI_STATE_DDR_ONLY,   NATI_TRIG_TBL_STATS,  _smStatTblHybrid ),
+		SM_ROW( NATI_STATE_DDR_ONLY,   NATI_TRIG_ADD_RULE,   _smAddRuleHybrid ),
+		SM_ROW( NATI_STATE_DDR_ONLY,   NATI_TRIG_DEL_RULE,   _smDelRuleHybrid ),
 		SM_ROW( NATI_STATE_DDR_ONLY,   NATI_TRIG_TBL_SWITCH, _smUndef ),
 		SM_ROW( NATI_STATE_DDR_ONLY,   NATI_TRIG_GOTO_DDR,   _smUndef ),
 		SM_ROW( NATI_STATE_DDR_ONLY,   NATI_TRIG_GOTO_SRAM,  _smUndef ),
-		SM_ROW( NATI_STATE_DDR_ONLY,   NATI_TRIG_GET_TSTAMP, _smGetTmStmp ),
+		SM_ROW( NATI_STATE_DDR_ONLY,   NATI_TRIG_GET_TSTAMP, _smGetTmStmpHybrid ),
+		SM_ROW( NATI_STATE_DDR_ONLY,   NATI_TRIG_ADD_RULES,  _smAddRulesHybrid ),
+		SM_ROW( NATI_STATE_DDR_ONLY,   NATI_TRIG_DEL_RULES,  _smDelRulesHybrid ),
+		SM_ROW( NATI_STATE_DDR_ONLY,   NATI_TRIG_TBL_RESIZE, _smResizeDdrTbl ),
 		SM_ROW( NATI_STATE_DDR_ONLY,   NATI_TRIG_LAST,       _smUndef ),
 	},
 
@@ -2471,6 +3701,9 @@ _state_mach_tbl[NATI_STATE_LAST+1][NATI_TRIG_LAST+1] =
 		SM_ROW( NATI_STATE_SRAM_ONLY,  NATI_TRIG_GOTO_DDR,   _smUndef ),
 		SM_ROW( NATI_STATE_SRAM_ONLY,  NATI_TRIG_GOTO_SRAM,  _smUndef ),
 		SM_ROW( NATI_STATE_SRAM_ONLY,  NATI_TRIG_GET_TSTAMP, _smGetTmStmp ),
+		SM_ROW( NATI_STATE_SRAM_ONLY,  NATI_TRIG_ADD_RULES,  _smAddRulesToTbl ),
+		SM_ROW( NATI_STATE_SRAM_ONLY,  NATI_TRIG_DEL_RULES,  _smDelRulesFromTbl ),
+		SM_ROW( NATI_STATE_SRAM_ONLY,  NATI_TRIG_TBL_RESIZE, _smUndef ),
 		SM_ROW( NATI_STATE_SRAM_ONLY,  NATI_TRIG_LAST,       _smUndef ),
 	},
 
@@ -2487,6 +3720,9 @@ _state_mach_tbl[NATI_STATE_LAST+1][NATI_TRIG_LAST+1] =
 		SM_ROW( NATI_STATE_HYBRID,     NATI_TRIG_GOTO_DDR,   _smGoToDdr ),
 		SM_ROW( NATI_STATE_HYBRID,     NATI_TRIG_GOTO_SRAM,  _smGoToSram ),
 		SM_ROW( NATI_STATE_HYBRID,     NATI_TRIG_GET_TSTAMP, _smGetTmStmpHybrid ),
+		SM_ROW( NATI_STATE_HYBRID,     NATI_TRIG_ADD_RULES,  _smAddRulesHybrid ),
+		SM_ROW( NATI_STATE_HYBRID,     NATI_TRIG_DEL_RULES,  _smDelRulesHybrid ),
+		SM_ROW( NATI_STATE_HYBRID,     NATI_TRIG_TBL_RESIZE, _smUndef ),
 		SM_ROW( NATI_STATE_HYBRID,     NATI_TRIG_LAST,       _smUndef ),
 	},
 
@@ -2503,6 +3739,9 @@ _state_mach_tbl[NATI_STATE_LAST+1][NATI_TRIG_LAST+1] =
 		SM_ROW( NATI_STATE_HYBRID_DDR, NATI_TRIG_GOTO_DDR,   _smGoToDdr ),
 		SM_ROW( NATI_STATE_HYBRID_DDR, NATI_TRIG_GOTO_SRAM,  _smGoToSram ),
 		SM_ROW( NATI_STATE_HYBRID_DDR, NATI_TRIG_GET_TSTAMP, _smGetTmStmpHybrid ),
+		SM_ROW( NATI_STATE_HYBRID_DDR, NATI_TRIG_ADD_RULES,  _smAddRulesHybrid ),
+		SM_ROW( NATI_STATE_HYBRID_DDR, NATI_TRIG_DEL_RULES,  _smDelRulesHybrid ),
+		SM_ROW( NATI_STATE_HYBRID_DDR, NATI_TRIG_TBL_RESIZE, _smResizeDdrTbl ),
 		SM_ROW( NATI_STATE_HYBRID_DDR, NATI_TRIG_LAST,       _smUndef ),
 	},
 
@@ -2519,6 +3758,9 @@ _state_mach_tbl[NATI_STATE_LAST+1][NATI_TRIG_LAST+1] =
 		SM_ROW( NATI_STATE_LAST,       NATI_TRIG_GOTO_DDR,   _smUndef ),
 		SM_ROW( NATI_STATE_LAST,       NATI_TRIG_GOTO_SRAM,  _smUndef ),
 		SM_ROW( NATI_STATE_LAST,       NATI_TRIG_GET_TSTAMP, _smUndef ),
+		SM_ROW( NATI_STATE_LAST,       NATI_TRIG_ADD_RULES,  _smUndef ),
+		SM_ROW( NATI_STATE_LAST,       NATI_TRIG_DEL_RULES,  _smUndef ),
+		SM_ROW( NATI_STATE_LAST,       NATI_TRIG_TBL_RESIZE, _smUndef ),
 		SM_ROW( NATI_STATE_LAST,       NATI_TRIG_LAST,       _smUndef ),
 	},
 };
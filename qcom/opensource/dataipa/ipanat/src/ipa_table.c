@@ -30,6 +30,7 @@
 #include "ipa_nat_utils.h"
 
 #include <errno.h>
+#include <stdlib.h>
 
 #define IPA_BASE_TABLE_PERCENTAGE       .8
 #define IPA_EXPANSION_TABLE_PERCENTAGE  .2
@@ -70,6 +71,13 @@ static int FindExpnTblFreeEntry(
 	void**     free_entry,
 	uint16_t*  entry_index );
 
+static void FillExpnFreeList(
+	ipa_table* table );
+
+static void PutExpnFreeEntry(
+	ipa_table* table,
+	uint16_t   entry_index );
+
 static int Get2PowerTightUpperBound(
 	uint16_t num);
 
@@ -217,6 +225,57 @@ void ipa_table_reset(
 	for (i = 0; i < tot; i++)
 		table->expn_table_addr[i] = '\0';
 
+	FillExpnFreeList(table);
+
+	IPADBG("Out\n");
+}
+
+/**
+ * ipa_table_alloc_expn_free_list() - allocates the expansion free slot list
+ * @table: [in] the table
+ *
+ * Must be called once the number of expansion entries is known. All
+ * expansion slots are considered free on return.
+ *
+ * Returns: 0 on success, negative on failure
+ */
+int ipa_table_alloc_expn_free_list(
+	ipa_table* table)
+{
+	int ret = 0;
+
+	IPADBG("In\n");
+
+	table->expn_free_list = (uint16_t*)
+		calloc(table->expn_table_entries, sizeof(uint16_t));
+
+	if ( table->expn_free_list == NULL )
+	{
+		IPAERR("Fail to allocate %s expansion free list with size %zu\n",
+			   table->name,
+			   table->expn_table_entries * sizeof(uint16_t));
+		ret = -ENOMEM;
+		goto bail;
+	}
+
+	FillExpnFreeList(table);
+
+bail:
+	IPADBG("Out\n");
+
+	return ret;
+}
+
+void ipa_table_free_expn_free_list(
+	ipa_table* table)
+{
+	IPADBG("In\n");
+
+	free(table->expn_free_list);
+
+	table->expn_free_list = NULL;
+	table->expn_free_cnt  = 0;
+
 	IPADBG("Out\n");
 }
 
@@ -405,6 +464,8 @@ void ipa_table_erase_entry(
 	else
 	{
 		--table->cur_expn_tbl_cnt;
+
+		PutExpnFreeEntry(table, index);
 	}
 
 	IPADBG("Out\n");
@@ -770,6 +831,41 @@ int ipa_table_iterator_is_head_with_tail(
 	return ret;
 }
 
+/*
+ * Returns the base table index of the chain that the record at
+ * rec_index belongs to, by following the prev links back out of the
+ * expansion table.
+ */
+uint16_t ipa_table_get_chain_head(
+	ipa_table* table,
+	uint16_t   rec_index )
+{
+	uint16_t prev_index;
+	int      hops = 0;
+
+	IPADBG("In\n");
+
+	while ( rec_index >= table->table_entries &&
+			rec_index <  table->tot_tbl_ents &&
+			hops++    <  table->expn_table_entries )
+	{
+		prev_index = table->entry_interface->entry_get_prev_index(
+			GOTO_REC(table, rec_index),
+			rec_index,
+			table->meta,
+			table->table_entries);
+
+		if ( ! VALID_INDEX(prev_index) )
+			break;
+
+		rec_index = prev_index;
+	}
+
+	IPADBG("Out\n");
+
+	return rec_index;
+}
+
 static int InsertHead(
 	ipa_table*                  table,
 	void*                       rec_ptr,   /* empty record in table */
@@ -877,6 +973,10 @@ static int InsertTail(
 	if (ret)
 	{
 		IPAERR("Unable to insert a new entry to the tail in %s\n", table->name);
+		/*
+		 * The slot was never linked in, hand it back...
+		 */
+		PutExpnFreeEntry(table, iterator.curr_index);
 		goto bail;
 	}
 
@@ -1015,11 +1115,22 @@ static int FindExpnTblFreeEntry(
 	*entry_index = 0;
 	*free_entry  = NULL;
 
-	/*
-	 * The following will start walk at expansion slots
-	 * (ie. just after table->table_entries)...
-	 */
-	ret = ipa_table_walk(table, table->table_entries, WHEN_SLOT_EMPTY, mt_slot, 0);
+	if ( table->expn_free_list )
+	{
+		/*
+		 * Pop the most recently freed slot...
+		 */
+		ret = (table->expn_free_cnt) ?
+			table->expn_free_list[--table->expn_free_cnt] : 0;
+	}
+	else
+	{
+		/*
+		 * No free list, hence the following will start walk at
+		 * expansion slots (ie. just after table->table_entries)...
+		 */
+		ret = ipa_table_walk(table, table->table_entries, WHEN_SLOT_EMPTY, mt_slot, 0);
+	}
 
 	if ( ret > 0 )
 	{
@@ -1040,6 +1151,8 @@ static int FindExpnTblFreeEntry(
 		{
 			IPAERR("%s: While searching table for emtpy slot\n",
 				   table->name);
+
+			ret = -1;
 		}
 		else
 		{
@@ -1050,9 +1163,13 @@ static int FindExpnTblFreeEntry(
 				   table->cur_tbl_cnt,
 				   table->expn_table_entries,
 				   table->cur_expn_tbl_cnt);
-		}
 
-		ret = -1;
+			/*
+			 * Distinct from a search failure, so that callers
+			 * can tell a full table from a broken one...
+			 */
+			ret = -ENOSPC;
+		}
 	}
 
 bail:
@@ -1061,6 +1178,52 @@ bail:
 	return ret;
 }
 
+/**
+ * FillExpnFreeList() - marks every expansion slot as free
+ * @table: [in] the table
+ *
+ * The slots are pushed from the top down, so that they are handed out
+ * in ascending order, like the table walk used to do.
+ */
+static void FillExpnFreeList(
+	ipa_table* table )
+{
+	uint16_t i;
+
+	if ( ! table->expn_free_list )
+		return;
+
+	table->expn_free_cnt = 0;
+
+	for ( i = table->expn_table_entries; i > 0; i-- )
+	{
+		table->expn_free_list[table->expn_free_cnt++] =
+			table->table_entries + i - 1;
+	}
+}
+
+/**
+ * PutExpnFreeEntry() - returns an expansion slot to the free list
+ * @table: [in] the table
+ * @entry_index: [in] absolute index of the freed expansion slot
+ */
+static void PutExpnFreeEntry(
+	ipa_table* table,
+	uint16_t   entry_index )
+{
+	if ( ! table->expn_free_list )
+		return;
+
+	if ( table->expn_free_cnt >= table->expn_table_entries )
+	{
+		IPAERR("%s: expansion free list overflow on slot (%u)\n",
+			   table->name, entry_index);
+		return;
+	}
+
+	table->expn_free_list[table->expn_free_cnt++] = entry_index;
+}
+
 /**
  * Get2PowerTightUpperBound() - Returns the tight upper bound which is a power of 2
  * @num: [in] given number
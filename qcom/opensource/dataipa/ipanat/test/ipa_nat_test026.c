@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2019 The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *  * Neither the name of The Linux Foundation nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*=========================================================================*/
+/*!
+	@file
+	ipa_nat_test026.c
+
+	@brief
+	Note: Verify the following scenario:
+	1. Add and delete rules using the batch api, for a range of
+	   batch sizes, and report rules/sec for each
+	2. Compare with one rule at a time
+*/
+/*=========================================================================*/
+
+#include "ipa_nat_test.h"
+
+static double elapsed_secs(
+	const struct timespec* start,
+	const struct timespec* end)
+{
+	return (double) (end->tv_sec - start->tv_sec) +
+		(double) (end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+int ipa_nat_test026(
+	const char* nat_mem_type,
+	u32 pub_ip_add,
+	int total_entries,
+	u32 tbl_hdl,
+	int sep,
+	void* arb_data_ptr)
+{
+	static const u32 batch_szs[] = { 1, 4, 16, 64, 256, 1024 };
+
+	static ipa_nat_ipv4_rule ipv4_rules[1024];
+	static u32               rule_hdls[1024];
+
+	struct timespec    start, end;
+	double             add_secs, del_secs;
+
+	u32                num_rules, num_done, done, this_batch;
+	u32                i, j;
+
+	int ret;
+
+	IPADBG("In\n");
+
+	if ( sep )
+	{
+		ret = ipa_nat_add_ipv4_tbl(pub_ip_add, nat_mem_type, total_entries, &tbl_hdl);
+		CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+	}
+
+	/*
+	 * Leave head room in the table, so that chains stay short and
+	 * adds do not fail for lack of space
+	 */
+	num_rules = (u32) total_entries / 2;
+
+	if ( num_rules > array_sz(ipv4_rules) )
+	{
+		num_rules = array_sz(ipv4_rules);
+	}
+
+	for ( i = 0; i < num_rules; i++ )
+	{
+		memset(&ipv4_rules[i], 0, sizeof(ipv4_rules[i]));
+
+		ipv4_rules[i].protocol     = IPPROTO_TCP;
+		ipv4_rules[i].public_port  = RAN_PORT;
+		ipv4_rules[i].target_ip    = RAN_ADDR;
+		ipv4_rules[i].target_port  = RAN_PORT;
+		ipv4_rules[i].private_ip   = RAN_ADDR;
+		ipv4_rules[i].private_port = RAN_PORT;
+	}
+
+	/*
+	 * One rule at a time, for reference
+	 */
+	ret = ipa_nati_clear_ipv4_tbl(tbl_hdl);
+	CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+	for ( i = 0; i < num_rules; i++ )
+	{
+		ret = ipa_nat_add_ipv4_rule(tbl_hdl, &ipv4_rules[i], &rule_hdls[i]);
+		CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	add_secs = elapsed_secs(&start, &end);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+	for ( i = 0; i < num_rules; i++ )
+	{
+		ret = ipa_nat_del_ipv4_rule(tbl_hdl, rule_hdls[i]);
+		CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	del_secs = elapsed_secs(&start, &end);
+
+	IPAINFO("%s single: %u rules: add %.0f rules/sec del %.0f rules/sec\n",
+			nat_mem_type, num_rules,
+			num_rules / add_secs, num_rules / del_secs);
+
+	/*
+	 * Now through the batch api
+	 */
+	for ( j = 0; j < array_sz(batch_szs); j++ )
+	{
+		ret = ipa_nati_clear_ipv4_tbl(tbl_hdl);
+		CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+
+		clock_gettime(CLOCK_MONOTONIC, &start);
+
+		for ( num_done = 0; num_done < num_rules; num_done += done )
+		{
+			this_batch = num_rules - num_done;
+
+			if ( this_batch > batch_szs[j] )
+			{
+				this_batch = batch_szs[j];
+			}
+
+			ret = ipa_nat_add_ipv4_rules(
+				tbl_hdl, &ipv4_rules[num_done], this_batch, &rule_hdls[num_done], &done);
+			CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+		}
+
+		clock_gettime(CLOCK_MONOTONIC, &end);
+
+		add_secs = elapsed_secs(&start, &end);
+
+		clock_gettime(CLOCK_MONOTONIC, &start);
+
+		for ( num_done = 0; num_done < num_rules; num_done += done )
+		{
+			this_batch = num_rules - num_done;
+
+			if ( this_batch > batch_szs[j] )
+			{
+				this_batch = batch_szs[j];
+			}
+
+			ret = ipa_nat_del_ipv4_rules(
+				tbl_hdl, &rule_hdls[num_done], this_batch, &done);
+			CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+		}
+
+		clock_gettime(CLOCK_MONOTONIC, &end);
+
+		del_secs = elapsed_secs(&start, &end);
+
+		IPAINFO("%s batch(%u): %u rules: add %.0f rules/sec del %.0f rules/sec\n",
+				nat_mem_type, batch_szs[j], num_rules,
+				num_rules / add_secs, num_rules / del_secs);
+	}
+
+	if ( sep )
+	{
+		ret = ipa_nat_del_ipv4_tbl(tbl_hdl);
+		CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+	}
+
+	IPADBG("Out\n");
+
+	return 0;
+}
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2019 The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *  * Neither the name of The Linux Foundation nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*=========================================================================*/
+/*!
+	@file
+	ipa_nat_test027.cpp
+
+	@brief
+	Note: Verify the following scenario:
+	1. Microbenchmark of the rule handle maps (ipa_nat_map_*) against
+	   the std::map they replaced, using handle shaped keys and the
+	   add/find/del mix of the hybrid state machine
+*/
+/*=========================================================================*/
+
+#include <map>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "ipa_nat_utils.h"
+#include "ipa_nat_map.h"
+
+extern "C" int ipa_nat_test027(
+	const char* nat_mem_type,
+	uint32_t pub_ip_add,
+	int total_entries,
+	uint32_t tbl_hdl,
+	int sep,
+	void* arb_data_ptr);
+
+#define NUM_KEYS 5120
+#define NUM_REPS 20
+
+static double now_nsecs(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (double) ts.tv_sec * 1e9 + (double) ts.tv_nsec;
+}
+
+int ipa_nat_test027(
+	const char* nat_mem_type,
+	uint32_t pub_ip_add,
+	int total_entries,
+	uint32_t tbl_hdl,
+	int sep,
+	void* arb_data_ptr)
+{
+	static uint32_t keys[NUM_KEYS];
+
+	std::map<uint32_t, uint32_t> std_map;
+
+	double   start, flat_nsecs = 0, std_nsecs = 0;
+	uint32_t i, rep, val, sum = 0;
+
+	IPADBG("In\n");
+
+	/*
+	 * Rule handle shaped keys: table index above a base/expansion bit
+	 */
+	for ( i = 0; i < NUM_KEYS; i++ )
+	{
+		keys[i] = ((i % 4096) << 1) | (i / 4096);
+	}
+
+	for ( i = 0; i < NUM_KEYS; i++ )
+	{
+		uint32_t j   = rand() % NUM_KEYS;
+		uint32_t tmp = keys[i];
+
+		keys[i] = keys[j];
+		keys[j] = tmp;
+	}
+
+	ipa_nat_map_reserve(MAP_NUM_99, NUM_KEYS);
+
+	for ( rep = 0; rep < NUM_REPS; rep++ )
+	{
+		ipa_nat_map_clear(MAP_NUM_99);
+
+		start = now_nsecs();
+
+		for ( i = 0; i < NUM_KEYS; i++ )
+		{
+			ipa_nat_map_add(MAP_NUM_99, keys[i], i);
+		}
+
+		for ( i = 0; i < NUM_KEYS; i++ )
+		{
+			ipa_nat_map_find(MAP_NUM_99, keys[NUM_KEYS - 1 - i], &val);
+			sum += val;
+		}
+
+		for ( i = 0; i < NUM_KEYS; i++ )
+		{
+			ipa_nat_map_del(MAP_NUM_99, keys[i], &val);
+			sum += val;
+		}
+
+		flat_nsecs += now_nsecs() - start;
+
+		std_map.clear();
+
+		start = now_nsecs();
+
+		for ( i = 0; i < NUM_KEYS; i++ )
+		{
+			std_map.insert(std::pair<uint32_t, uint32_t>(keys[i], i));
+		}
+
+		for ( i = 0; i < NUM_KEYS; i++ )
+		{
+			sum += std_map.find(keys[NUM_KEYS - 1 - i])->second;
+		}
+
+		for ( i = 0; i < NUM_KEYS; i++ )
+		{
+			std::map<uint32_t, uint32_t>::iterator it = std_map.find(keys[i]);
+
+			sum += it->second;
+
+			std_map.erase(it);
+		}
+
+		std_nsecs += now_nsecs() - start;
+	}
+
+	IPAINFO("ipa_nat_map: %.1f nsecs/op  std::map: %.1f nsecs/op  (%u keys, %u reps, chk %u)\n",
+			flat_nsecs / (3.0 * NUM_KEYS * NUM_REPS),
+			std_nsecs  / (3.0 * NUM_KEYS * NUM_REPS),
+			NUM_KEYS, NUM_REPS, sum);
+
+	IPADBG("Out\n");
+
+	return 0;
+}
@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2019 The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *  * Neither the name of The Linux Foundation nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*=========================================================================*/
+/*!
+	@file
+	ipa_nat_test028.c
+
+	@brief
+	Note: Verify the following scenario:
+	1. Add more rules than a DDR table was sized for, so that it
+	   gets grown while in use
+	2. Verify every rule can still be found by its original handle
+	3. Delete half the rules by their original handles and verify,
+	   by walking the table, that exactly those rules went away
+	4. Delete the rest
+*/
+/*=========================================================================*/
+
+#include "ipa_nat_test.h"
+
+/*
+ * Each rule gets its own private port, so that the table walk can
+ * tell which rule is which...
+ */
+#define PORT_BASE 1024
+
+typedef struct
+{
+	u8  seen[IPA_TABLE_MAX_ENTRIES];
+	u32 num_rules;
+	u32 num_seen;
+} rule_census;
+
+static int count_rule(
+	ipa_table*      table_ptr,
+	uint32_t        rule_hdl,
+	void*           record_ptr,
+	uint16_t        record_index,
+	void*           meta_record_ptr,
+	uint16_t        meta_record_index,
+	void*           arb_data_ptr )
+{
+	struct ipa_nat_rule* rule_ptr   = (struct ipa_nat_rule*) record_ptr;
+	rule_census*         census_ptr = (rule_census*) arb_data_ptr;
+	u32                  i;
+
+	if ( rule_ptr->protocol == IPA_NAT_INVALID_PROTO_FIELD_VALUE_IN_RULE )
+	{
+		return 0;
+	}
+
+	i = rule_ptr->private_port - PORT_BASE;
+
+	if ( rule_ptr->private_port < PORT_BASE || i >= census_ptr->num_rules )
+	{
+		IPAERR("Unknown rule with private_port(%u)\n", rule_ptr->private_port);
+		return -1;
+	}
+
+	census_ptr->seen[i]++;
+	census_ptr->num_seen++;
+
+	return 0;
+}
+
+int ipa_nat_test028(
+	const char* nat_mem_type,
+	u32 pub_ip_add,
+	int total_entries,
+	u32 tbl_hdl,
+	int sep,
+	void* arb_data_ptr)
+{
+	static u32         rule_hdls[IPA_TABLE_MAX_ENTRIES];
+	static rule_census census;
+
+	ipa_nat_ipv4_rule  ipv4_rule;
+	ipa_nati_tbl_stats nstats, istats;
+	u32                time_stamp;
+	u32                num_rules;
+	u32                i;
+
+	int ret;
+
+	IPADBG("In\n");
+
+	/*
+	 * Only DDR tables get grown...
+	 */
+	if ( ! strcmp(nat_mem_type, "SRAM") )
+	{
+		IPAINFO("Test not applicable to %s\n", nat_mem_type);
+		return 0;
+	}
+
+	if ( sep )
+	{
+		ret = ipa_nat_add_ipv4_tbl(pub_ip_add, nat_mem_type, total_entries, &tbl_hdl);
+		CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+	}
+
+	/*
+	 * Twice what the table was created for, but with head room left
+	 * in the largest table it can be grown to
+	 */
+	num_rules = (u32) total_entries * 2;
+
+	if ( num_rules > array_sz(rule_hdls) / 2 )
+	{
+		num_rules = array_sz(rule_hdls) / 2;
+	}
+
+	for ( i = 0; i < num_rules; i++ )
+	{
+		memset(&ipv4_rule, 0, sizeof(ipv4_rule));
+
+		ipv4_rule.protocol     = IPPROTO_TCP;
+		ipv4_rule.public_port  = RAN_PORT;
+		ipv4_rule.target_ip    = RAN_ADDR;
+		ipv4_rule.target_port  = RAN_PORT;
+		ipv4_rule.private_ip   = RAN_ADDR;
+		ipv4_rule.private_port = PORT_BASE + i;
+
+		ret = ipa_nat_add_ipv4_rule(tbl_hdl, &ipv4_rule, &rule_hdls[i]);
+		CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+	}
+
+	if ( ! strcmp(nat_mem_type, "DDR") )
+	{
+		ret = ipa_nati_ipv4_tbl_stats(tbl_hdl, &nstats, &istats);
+		CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+
+		if ( nstats.req_ents <= (u32) total_entries )
+		{
+			IPAERR("DDR table still sized for (%u) entries\n", nstats.req_ents);
+			ret = -1;
+		}
+		CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+	}
+
+	for ( i = 0; i < num_rules; i++ )
+	{
+		ret = ipa_nat_query_timestamp(tbl_hdl, rule_hdls[i], &time_stamp);
+		CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+	}
+
+	/*
+	 * Take out the even numbered rules, then make sure that only the
+	 * odd numbered ones are left...
+	 */
+	for ( i = 0; i < num_rules; i += 2 )
+	{
+		ret = ipa_nat_del_ipv4_rule(tbl_hdl, rule_hdls[i]);
+		CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+	}
+
+	memset(&census, 0, sizeof(census));
+
+	census.num_rules = num_rules;
+
+	ret = ipa_nati_walk_ipv4_tbl(tbl_hdl, USE_NAT_TABLE, count_rule, &census);
+	CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+
+	for ( i = 0; i < num_rules; i++ )
+	{
+		if ( census.seen[i] != (i & 1) )
+		{
+			IPAERR("Rule (%u) found (%u) times\n", i, census.seen[i]);
+			ret = -1;
+			break;
+		}
+	}
+	CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+
+	for ( i = 1; i < num_rules; i += 2 )
+	{
+		ret = ipa_nat_query_timestamp(tbl_hdl, rule_hdls[i], &time_stamp);
+		CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+
+		ret = ipa_nat_del_ipv4_rule(tbl_hdl, rule_hdls[i]);
+		CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+	}
+
+	if ( sep )
+	{
+		ret = ipa_nat_del_ipv4_tbl(tbl_hdl);
+		CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+	}
+
+	IPADBG("Out\n");
+
+	return 0;
+}
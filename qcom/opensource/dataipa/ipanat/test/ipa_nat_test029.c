@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2019 The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *  * Neither the name of The Linux Foundation nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*=========================================================================*/
+/*!
+	@file
+	ipa_nat_test029.c
+
+	@brief
+	Note: Verify the following scenario:
+	1. Cap how big the DDR table may be grown at its current size
+	2. Add rules until the table is full and the add fails with
+	   -ENOSPC, rather than the table being torn down and recreated
+	3. Verify every rule added before that can still be found, and
+	   deleted, by its original handle
+*/
+/*=========================================================================*/
+
+#include <errno.h>
+
+#include "ipa_nat_test.h"
+
+int ipa_nat_test029(
+	const char* nat_mem_type,
+	u32 pub_ip_add,
+	int total_entries,
+	u32 tbl_hdl,
+	int sep,
+	void* arb_data_ptr)
+{
+	static u32         rule_hdls[IPA_TABLE_MAX_ENTRIES];
+
+	ipa_nat_ipv4_rule  ipv4_rule;
+	ipa_nati_tbl_stats nstats, istats;
+	u32                req_ents;
+	u32                time_stamp;
+	u32                num_rules;
+	u32                i;
+
+	int ret, add_ret;
+
+	IPADBG("In\n");
+
+	/*
+	 * Only DDR tables get grown...
+	 */
+	if ( strcmp(nat_mem_type, "DDR") )
+	{
+		IPAINFO("Test not applicable to %s\n", nat_mem_type);
+		return 0;
+	}
+
+	if ( sep )
+	{
+		ret = ipa_nat_add_ipv4_tbl(pub_ip_add, nat_mem_type, total_entries, &tbl_hdl);
+		CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+	}
+
+	ret = ipa_nati_ipv4_tbl_stats(tbl_hdl, &nstats, &istats);
+	CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+
+	req_ents = nstats.req_ents;
+
+	ret = ipa_nat_set_ddr_tbl_growth(true, false, req_ents);
+	CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+
+	add_ret = 0;
+
+	for ( num_rules = 0; num_rules < array_sz(rule_hdls) && add_ret == 0; num_rules++ )
+	{
+		memset(&ipv4_rule, 0, sizeof(ipv4_rule));
+
+		ipv4_rule.protocol     = IPPROTO_TCP;
+		ipv4_rule.public_port  = RAN_PORT;
+		ipv4_rule.target_ip    = RAN_ADDR;
+		ipv4_rule.target_port  = RAN_PORT;
+		ipv4_rule.private_ip   = RAN_ADDR;
+		ipv4_rule.private_port = RAN_PORT;
+
+		add_ret = ipa_nat_add_ipv4_rule(tbl_hdl, &ipv4_rule, &rule_hdls[num_rules]);
+	}
+
+	/*
+	 * The failed add above was counted, so...
+	 */
+	num_rules--;
+
+	ret = ipa_nat_set_ddr_tbl_growth(true, false, 0);
+	CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+
+	if ( add_ret != -ENOSPC )
+	{
+		IPAERR("Add of rule (%u) returned (%d), not -ENOSPC\n", num_rules, add_ret);
+		ret = -1;
+	}
+	CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+
+	ret = ipa_nati_ipv4_tbl_stats(tbl_hdl, &nstats, &istats);
+	CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+
+	if ( nstats.req_ents != req_ents )
+	{
+		IPAERR("DDR table resized from (%u) to (%u) entries\n",
+			   req_ents, nstats.req_ents);
+		ret = -1;
+	}
+	CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+
+	for ( i = 0; i < num_rules; i++ )
+	{
+		ret = ipa_nat_query_timestamp(tbl_hdl, rule_hdls[i], &time_stamp);
+		CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+	}
+
+	for ( i = 0; i < num_rules; i++ )
+	{
+		ret = ipa_nat_del_ipv4_rule(tbl_hdl, rule_hdls[i]);
+		CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+	}
+
+	if ( sep )
+	{
+		ret = ipa_nat_del_ipv4_tbl(tbl_hdl);
+		CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+	}
+
+	IPADBG("Out\n");
+
+	return 0;
+}
@@ -351,6 +351,10 @@ static NatTests nt_array[] = {
 	NAT_TEST_ENTRY(ipa_nat_test023, IPA_NAT_TEST_PRE_COND_TE, 0),
 	NAT_TEST_ENTRY(ipa_nat_test024, IPA_NAT_TEST_PRE_COND_TE, 0),
 	NAT_TEST_ENTRY(ipa_nat_test025, IPA_NAT_TEST_PRE_COND_TE, 0),
+	NAT_TEST_ENTRY(ipa_nat_test026, IPA_NAT_TEST_PRE_COND_TE, 0),
+	NAT_TEST_ENTRY(ipa_nat_test027, 1, 0),
+	NAT_TEST_ENTRY(ipa_nat_test028, IPA_NAT_TEST_PRE_COND_TE, 0),
+	NAT_TEST_ENTRY(ipa_nat_test029, IPA_NAT_TEST_PRE_COND_TE, 0),
 	/*
 	 * Add new tests just above this comment. Keep the following two
 	 * at the end...
@@ -0,0 +1,272 @@
+/*
+ * Copyright (c) 2022 The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *  * Neither the name of The Linux Foundation nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include "TestsUtils.h"
+#include "RoutingDriverWrapper.h"
+#include "HeaderInsertion.h"
+#include "Filtering.h"
+#include "IPAFilteringTable.h"
+
+#define LAN_RX_ZERO_COPY_NODE "/sys/kernel/debug/ipa/lan_rx_zero_copy"
+
+using namespace IPA;
+
+/*
+ * Exception packets reach the apps over APPS_LAN_CONS and go through the
+ * LAN payload handler. With lan_rx_zero_copy set, packets above the
+ * driver's copybreak are delivered as clones of the RX buffer, so pushing
+ * more of them than the LAN ring holds makes the driver repost buffers
+ * whose data was shared with already consumed clones.
+ */
+class IPALanRxZeroCopyTestFixture: public TestBase {
+public:
+
+	IPALanRxZeroCopyTestFixture() : m_uBufferSize(0)
+	{
+		memset(m_aBuffer, 0, sizeof(m_aBuffer));
+		m_testSuiteName.push_back("LanRxZeroCopy");
+	}
+
+	bool Setup()
+	{
+		ConfigureScenario(PHASE_SEVEN_TEST_CONFIGURATION);
+
+		m_producer.Open(INTERFACE0_TO_IPA_DATA_PATH,
+				INTERFACE0_FROM_IPA_DATA_PATH);
+		m_Exceptions.Open(INTERFACE_TO_IPA_EXCEPTION_PATH,
+				INTERFACE_FROM_IPA_EXCEPTION_PATH);
+
+		if (!m_Routing.DeviceNodeIsOpened()) {
+			LOG_MSG_ERROR(
+				"Routing block is not ready for immediate commands!\n");
+			return false;
+		}
+		if (!m_Filtering.DeviceNodeIsOpened()) {
+			LOG_MSG_ERROR(
+				"Filtering block is not ready for immediate commands!\n");
+			return false;
+		}
+		if (!m_HeaderInsertion.DeviceNodeIsOpened()) {
+			LOG_MSG_ERROR(
+				"Header Insertion block is not ready for immediate commands!\n");
+			return false;
+		}
+		m_HeaderInsertion.Reset();
+
+		return true;
+	} // Setup()
+
+	bool Teardown()
+	{
+		SetZeroCopy(false);
+		m_HeaderInsertion.Reset();
+		m_producer.Close();
+		m_Exceptions.Close();
+		return true;
+	} // Teardown()
+
+	bool SetZeroCopy(bool enable)
+	{
+		int fd;
+		ssize_t ret;
+
+		fd = open(LAN_RX_ZERO_COPY_NODE, O_WRONLY);
+		if (fd < 0) {
+			LOG_MSG_ERROR("Failed opening %s. errno %d: %s\n",
+				LAN_RX_ZERO_COPY_NODE, errno, strerror(errno));
+			return false;
+		}
+		ret = write(fd, enable ? "1" : "0", 1);
+		close(fd);
+		if (ret != 1) {
+			LOG_MSG_ERROR("Failed writing %s\n", LAN_RX_ZERO_COPY_NODE);
+			return false;
+		}
+		return true;
+	}
+
+	bool AddExceptionRule()
+	{
+		const char bypass0[20] = "Bypass0";
+		IPAFilteringTable cFilterTable;
+		struct ipa_flt_rule_add sFilterRuleEntry;
+		uint32_t nRTTableHdl = 0;
+
+		if (!CreateBypassRoutingTable(&m_Routing, IPA_IP_v4, bypass0,
+				IPA_CLIENT_TEST2_CONS, 0, &nRTTableHdl)) {
+			LOG_MSG_ERROR("CreateBypassRoutingTable Failed\n");
+			return false;
+		}
+
+		cFilterTable.Init(IPA_IP_v4, IPA_CLIENT_TEST_PROD, true, 1);
+		cFilterTable.GeneratePresetRule(0, sFilterRuleEntry);
+		sFilterRuleEntry.at_rear = true;
+		sFilterRuleEntry.rule.action = IPA_PASS_TO_EXCEPTION;
+		sFilterRuleEntry.rule.rt_tbl_hdl = nRTTableHdl;
+		if (((uint8_t)-1 == cFilterTable.AddRuleToTable(sFilterRuleEntry)) ||
+			!m_Filtering.AddFilteringRule(
+				cFilterTable.GetFilteringTable())) {
+			LOG_MSG_ERROR("Adding Rule (0) to Filtering block Failed.");
+			return false;
+		}
+		return true;
+	}
+
+	/* grow the default IPv4 packet to nSize bytes of known payload */
+	bool BuildPacket(size_t nSize, uint8_t nSeed)
+	{
+		uint32_t nSum = 0;
+		size_t nHdrLen;
+		size_t i;
+
+		m_uBufferSize = BUFF_MAX_SIZE;
+		if (!LoadDefaultPacket(IPA_IP_v4, m_aBuffer, m_uBufferSize)) {
+			LOG_MSG_ERROR("Failed default Packet");
+			return false;
+		}
+		nHdrLen = (m_aBuffer[0] & 0x0F) * 4;
+		if (nSize > BUFF_MAX_SIZE || nSize < m_uBufferSize)
+			return false;
+
+		for (i = m_uBufferSize; i < nSize; i++)
+			m_aBuffer[i] = (uint8_t)(nSeed + i);
+		m_uBufferSize = nSize;
+
+		m_aBuffer[2] = (uint8_t)(nSize >> 8);
+		m_aBuffer[3] = (uint8_t)nSize;
+		m_aBuffer[10] = 0;
+		m_aBuffer[11] = 0;
+		for (i = 0; i < nHdrLen; i += 2)
+			nSum += (m_aBuffer[i] << 8) | m_aBuffer[i + 1];
+		while (nSum >> 16)
+			nSum = (nSum & 0xFFFF) + (nSum >> 16);
+		m_aBuffer[10] = (uint8_t)(~nSum >> 8);
+		m_aBuffer[11] = (uint8_t)~nSum;
+		return true;
+	}
+
+	/* the exception may carry a header, the packet must end the buffer */
+	bool SendAndReceiveException()
+	{
+		int nRead;
+
+		if (m_producer.SendData(m_aBuffer, m_uBufferSize) !=
+			(long)m_uBufferSize) {
+			LOG_MSG_ERROR("Failed sending packet of %zu bytes",
+				m_uBufferSize);
+			return false;
+		}
+
+		nRead = m_Exceptions.ReceiveData(m_aRxBuffer, sizeof(m_aRxBuffer));
+		if (nRead < (int)m_uBufferSize) {
+			LOG_MSG_ERROR("Received %d bytes, expected at least %zu",
+				nRead, m_uBufferSize);
+			return false;
+		}
+
+		if (memcmp(m_aRxBuffer + nRead - m_uBufferSize, m_aBuffer,
+			m_uBufferSize)) {
+			LOG_MSG_ERROR("Exception packet content mismatch");
+			print_buffer(m_aRxBuffer, nRead, "Received");
+			print_buffer(m_aBuffer, m_uBufferSize, "Sent");
+			return false;
+		}
+		return true;
+	}
+
+	static RoutingDriverWrapper m_Routing;
+	static Filtering m_Filtering;
+	static HeaderInsertion m_HeaderInsertion;
+	InterfaceAbstraction m_producer;
+	InterfaceAbstraction m_Exceptions;
+
+protected:
+	static const size_t BUFF_MAX_SIZE = 1500;
+	uint8_t m_aBuffer[BUFF_MAX_SIZE];
+	uint8_t m_aRxBuffer[BUFF_MAX_SIZE * 2];
+	size_t m_uBufferSize;
+};
+RoutingDriverWrapper IPALanRxZeroCopyTestFixture::m_Routing;
+Filtering IPALanRxZeroCopyTestFixture::m_Filtering;
+HeaderInsertion IPALanRxZeroCopyTestFixture::m_HeaderInsertion;
+
+//-----------------------------------------------------------------------------/
+// Test001: exception traffic with LAN RX zero copy enabled                    /
+//-----------------------------------------------------------------------------/
+class IPALanRxZeroCopyTest001: public IPALanRxZeroCopyTestFixture {
+public:
+	IPALanRxZeroCopyTest001()
+	{
+		m_name = "IPALanRxZeroCopyTest001";
+		m_description = "\
+			LAN RX zero copy test 001 - enable lan_rx_zero_copy and push \
+			NUM_OF_PKTS exception packets of mixed sizes, above and below \
+			the driver copybreak, through the LAN consumer. Every packet \
+			must arrive intact at the exception pipe, including the ones \
+			received into reposted buffers.";
+		Register(*this);
+	}
+
+	bool Run()
+	{
+		static const size_t aSizes[] = { 1400, 300, 120, 1024, 256, 64 };
+		int i;
+
+		if (!SetZeroCopy(true))
+			return false;
+
+		if (!AddExceptionRule())
+			return false;
+
+		for (i = 0; i < NUM_OF_PKTS; i++) {
+			size_t nSize = aSizes[i % (sizeof(aSizes) / sizeof(aSizes[0]))];
+
+			if (!BuildPacket(nSize, (uint8_t)i)) {
+				LOG_MSG_ERROR("Failed building packet %d", i);
+				return false;
+			}
+			if (!SendAndReceiveException()) {
+				LOG_MSG_ERROR("Packet %d of %zu bytes failed", i, nSize);
+				return false;
+			}
+		}
+		return true;
+	}
+
+private:
+	/* well above the LAN consumer ring depth so buffers get reposted */
+	static const int NUM_OF_PKTS = 1024;
+};
+
+static IPALanRxZeroCopyTest001 ipaLanRxZeroCopyTest001;
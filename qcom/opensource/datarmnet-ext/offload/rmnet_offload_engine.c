@@ -13,6 +13,7 @@
 #include <linux/log2.h>
 #include <linux/list.h>
 #include <linux/hashtable.h>
+#include <linux/ktime.h>
 #include "rmnet_descriptor.h"
 #include "rmnet_offload_state.h"
 #include "rmnet_offload_engine.h"
@@ -82,19 +83,53 @@ DATARMNET907d58c807*DATARMNETa6f73cbe10;struct DATARMNETd7c9631acd*
 DATARMNET6745427f98;LIST_HEAD(DATARMNET6f9bfa17e6);DATARMNETa6f73cbe10=&
 DATARMNETe05748b000->DATARMNETebb45c8d86;if(DATARMNETa6f73cbe10->
 DATARMNET8dfc11cccd<DATARMNET78d9393ac8){DATARMNET6745427f98=&
-DATARMNETa6f73cbe10->DATARMNET2846a01cce[DATARMNETa6f73cbe10->
-DATARMNET8dfc11cccd];DATARMNETa6f73cbe10->DATARMNET8dfc11cccd++;return 
-DATARMNET6745427f98;}DATARMNET6745427f98=&DATARMNETa6f73cbe10->
-DATARMNET2846a01cce[DATARMNETa6f73cbe10->DATARMNET57d435b225];
-DATARMNETa6f73cbe10->DATARMNET57d435b225++;DATARMNETa6f73cbe10->
-DATARMNET57d435b225%=DATARMNET78d9393ac8;hash_del(&DATARMNET6745427f98->
-DATARMNETbd5d7d96d8);if(DATARMNET6745427f98->DATARMNET1db11fa85e){
+DATARMNETa6f73cbe10->DATARMNET2846a01cce[ DATARMNETa6f73cbe10->
+DATARMNET8dfc11cccd];DATARMNETa6f73cbe10->DATARMNET8dfc11cccd++;
+DATARMNET6745427f98->DATARMNETb3a0d967c6=ktime_get_ns();list_add_tail(&
+DATARMNET6745427f98->DATARMNET8404ab9e4b,&DATARMNETa6f73cbe10->
+DATARMNET8404ab9e4b);return DATARMNET6745427f98;}DATARMNET6745427f98=
+list_first_entry(&DATARMNETa6f73cbe10->DATARMNET8404ab9e4b, struct 
+DATARMNETd7c9631acd,DATARMNET8404ab9e4b);DATARMNET6745427f98->
+DATARMNETb3a0d967c6=ktime_get_ns();list_move_tail(&DATARMNET6745427f98->
+DATARMNET8404ab9e4b,&DATARMNETa6f73cbe10->DATARMNET8404ab9e4b);hash_del(&
+DATARMNET6745427f98->DATARMNETbd5d7d96d8);if(DATARMNET6745427f98->
+DATARMNET1db11fa85e){
 DATARMNETa00cda79d0(DATARMNETf3f92fc0b9);DATARMNETa3055c21f2(DATARMNET6745427f98
 ,&DATARMNET6f9bfa17e6);}DATARMNETc70e73c8d4(&DATARMNET6f9bfa17e6);return 
-DATARMNET6745427f98;}static void DATARMNETbe30d096c6(void){LIST_HEAD(
-DATARMNET6f9bfa17e6);DATARMNET664568fcd0();if(DATARMNETae70636c90(&
-DATARMNET6f9bfa17e6))DATARMNETa00cda79d0(DATARMNET5727f095ec);
-DATARMNET6a76048590();DATARMNETc70e73c8d4(&DATARMNET6f9bfa17e6);}void 
+DATARMNET6745427f98;}static u64 DATARMNETba2883da25(void){return 
+DATARMNETf1d1b8287f(DATARMNETd33781e14c)*NSEC_PER_USEC;}static bool 
+DATARMNETd674260e24(void){return DATARMNETf1d1b8287f(DATARMNET4d2ce13a17)&&
+DATARMNETba2883da25();}static u32 DATARMNET5f84751889(struct list_head*
+DATARMNETdefe431591,bool*DATARMNET2fde79cdc3){struct DATARMNET70f3b87b5d*
+DATARMNETc9e85e0a73=DATARMNETc2a630b113();struct DATARMNETd7c9631acd*
+DATARMNET4ef20c3223;u64 DATARMNETfeab22e5ff=DATARMNETba2883da25();u64 
+DATARMNETcc64529958=ktime_get_ns();u32 DATARMNETa5520e84b4=(0xd2d+202-0xdf7);*
+DATARMNET2fde79cdc3=false;list_for_each_entry(DATARMNET4ef20c3223,&
+DATARMNETc9e85e0a73->DATARMNETebb45c8d86.DATARMNET8404ab9e4b,DATARMNET8404ab9e4b
+){if(DATARMNETcc64529958-DATARMNET4ef20c3223->DATARMNETb3a0d967c6<
+DATARMNETfeab22e5ff){*DATARMNET2fde79cdc3=true;break;}if(!DATARMNET4ef20c3223->
+DATARMNET1db11fa85e)continue;DATARMNETa5520e84b4++;DATARMNETa3055c21f2(
+DATARMNET4ef20c3223,DATARMNETdefe431591);}return DATARMNETa5520e84b4;}static 
+enum hrtimer_restart DATARMNET522b9dd653(struct hrtimer*DATARMNETe632500d44){
+LIST_HEAD(DATARMNETdefe431591);bool DATARMNET2fde79cdc3;u32 DATARMNETa5520e84b4;
+DATARMNET664568fcd0();DATARMNETa5520e84b4=DATARMNET5f84751889(&
+DATARMNETdefe431591,&DATARMNET2fde79cdc3);if(DATARMNETa5520e84b4)
+DATARMNETbad3b5165e(DATARMNETbe7cb17f45,DATARMNETa5520e84b4);DATARMNET6a76048590
+();DATARMNETc70e73c8d4(&DATARMNETdefe431591);if(!DATARMNET2fde79cdc3)return 
+HRTIMER_NORESTART;hrtimer_forward_now(DATARMNETe632500d44,ns_to_ktime(
+DATARMNETba2883da25()));return HRTIMER_RESTART;}static void DATARMNETf3e28e69ea(
+void){struct DATARMNET907d58c807*DATARMNET65dde83e4c=&DATARMNETc2a630b113()->
+DATARMNETebb45c8d86;if(hrtimer_is_queued(&DATARMNET65dde83e4c->
+DATARMNETb49f8f9aff))return;hrtimer_start(&DATARMNET65dde83e4c->
+DATARMNETb49f8f9aff,ns_to_ktime(DATARMNETba2883da25()), HRTIMER_MODE_REL_SOFT);}
+static void DATARMNETbe30d096c6(void){LIST_HEAD(DATARMNET6f9bfa17e6);
+DATARMNET664568fcd0();if(DATARMNETd674260e24()){bool DATARMNET2fde79cdc3;u32 
+DATARMNETa5520e84b4;DATARMNETa5520e84b4=DATARMNET5f84751889(&DATARMNET6f9bfa17e6
+,&DATARMNET2fde79cdc3);if(DATARMNETa5520e84b4)DATARMNETbad3b5165e(
+DATARMNETbe7cb17f45,DATARMNETa5520e84b4);if(DATARMNET2fde79cdc3)
+DATARMNETf3e28e69ea();}else if(DATARMNETae70636c90(&DATARMNET6f9bfa17e6)) 
+DATARMNETa00cda79d0(DATARMNET5727f095ec);DATARMNET6a76048590();
+DATARMNETc70e73c8d4(&DATARMNET6f9bfa17e6);}void 
 DATARMNETd4230b6bfe(void){rcu_assign_pointer(rmnet_perf_chain_end,
 DATARMNETbe30d096c6);}void DATARMNET560e127137(void){rcu_assign_pointer(
 rmnet_perf_chain_end,NULL);}int DATARMNET241493ab9a(u64 DATARMNET0470698d6c,u64 
@@ -138,10 +173,12 @@ DATARMNET4791268d67,DATARMNETaa568481cf,DATARMNETbd5d7d96d8,DATARMNET3f8cc6fc24)
 {if(DATARMNETaa568481cf->DATARMNET381f1cadc4==DATARMNET3f8cc6fc24&&
 DATARMNETaa568481cf->DATARMNET1db11fa85e)DATARMNETa3055c21f2(DATARMNETaa568481cf
 ,DATARMNET6f9bfa17e6);}}u32 DATARMNETae70636c90(struct list_head*
-DATARMNET6f9bfa17e6){struct DATARMNETd7c9631acd*DATARMNETaa568481cf;int 
-DATARMNETae0201901a;u32 DATARMNET737bbd41c3=(0xd2d+202-0xdf7);hash_for_each(
-DATARMNET4791268d67,DATARMNETae0201901a,DATARMNETaa568481cf,DATARMNETbd5d7d96d8)
-{if(DATARMNETaa568481cf->DATARMNET1db11fa85e){DATARMNET737bbd41c3++;
+DATARMNET6f9bfa17e6){struct DATARMNET70f3b87b5d*DATARMNETc9e85e0a73=
+DATARMNETc2a630b113();struct DATARMNETd7c9631acd*DATARMNETaa568481cf;u32 
+DATARMNET737bbd41c3=(0xd2d+202-0xdf7);if(!DATARMNETc9e85e0a73)return
+(0xd2d+202-0xdf7);list_for_each_entry(DATARMNETaa568481cf,&DATARMNETc9e85e0a73->
+DATARMNETebb45c8d86.DATARMNET8404ab9e4b,DATARMNET8404ab9e4b){if(
+DATARMNETaa568481cf->DATARMNET1db11fa85e){DATARMNET737bbd41c3++;
 DATARMNETa3055c21f2(DATARMNETaa568481cf,DATARMNET6f9bfa17e6);}}return 
 DATARMNET737bbd41c3;}void DATARMNET33aa5df9ef(struct DATARMNETd7c9631acd*
 DATARMNETaa568481cf,struct DATARMNETd812bcdbb5*DATARMNET5fe4c722a8){if(
@@ -156,8 +193,11 @@ DATARMNET144d119066.DATARMNET7fa8b2acbf==DATARMNETfd5c3d30e5)DATARMNETaa568481cf
 DATARMNET1ef22e4c76;list_add_tail(&DATARMNET5fe4c722a8->DATARMNET719f68fb88->
 list,&DATARMNETaa568481cf->DATARMNETb76b79d0d5);DATARMNETaa568481cf->
 DATARMNET1db11fa85e++;DATARMNETaa568481cf->DATARMNETcf28ae376b+=
-DATARMNET5fe4c722a8->DATARMNET1ef22e4c76;}bool DATARMNETfbf5798e15(struct 
-DATARMNETd812bcdbb5*DATARMNET5fe4c722a8,struct list_head*DATARMNET6f9bfa17e6){
+DATARMNET5fe4c722a8->DATARMNET1ef22e4c76;DATARMNETaa568481cf->
+DATARMNETb3a0d967c6=ktime_get_ns();list_move_tail(&DATARMNETaa568481cf->
+DATARMNET8404ab9e4b, &DATARMNETc2a630b113()->DATARMNETebb45c8d86.
+DATARMNET8404ab9e4b);}bool DATARMNETfbf5798e15(struct DATARMNETd812bcdbb5*
+DATARMNET5fe4c722a8,struct list_head*DATARMNET6f9bfa17e6){
 struct DATARMNETd7c9631acd*DATARMNETaa568481cf;bool DATARMNET885970f252=false;u8
  DATARMNET9695aa5b1d=DATARMNET5fe4c722a8->DATARMNET144d119066.
 DATARMNET7fa8b2acbf;if(!DATARMNET2013036d80(DATARMNET9695aa5b1d)){
@@ -179,11 +219,18 @@ DATARMNETc6f994577c;}return false;}void DATARMNETb98b78b8e3(void){struct
 DATARMNETd7c9631acd*DATARMNETaa568481cf;struct hlist_node*DATARMNET0386f6f82a;
 int DATARMNETae0201901a;hash_for_each_safe(DATARMNET4791268d67,
 DATARMNETae0201901a,DATARMNET0386f6f82a,DATARMNETaa568481cf,DATARMNETbd5d7d96d8)
-hash_del(&DATARMNETaa568481cf->DATARMNETbd5d7d96d8);}int DATARMNETdbcaf01255(
-void){struct DATARMNET70f3b87b5d*DATARMNETe05748b000=DATARMNETc2a630b113();u8 
-DATARMNETefc9df3df2;for(DATARMNETefc9df3df2=(0xd2d+202-0xdf7);
+hash_del(&DATARMNETaa568481cf->DATARMNETbd5d7d96d8);}void DATARMNET59c4eaf87b(
+void){struct DATARMNET70f3b87b5d*DATARMNETc9e85e0a73=DATARMNETc2a630b113();
+hrtimer_cancel(&DATARMNETc9e85e0a73->DATARMNETebb45c8d86.DATARMNETb49f8f9aff);}
+int DATARMNETdbcaf01255(void){struct DATARMNET70f3b87b5d*DATARMNETe05748b000=
+DATARMNETc2a630b113();u8 DATARMNETefc9df3df2;INIT_LIST_HEAD(&DATARMNETe05748b000
+->DATARMNETebb45c8d86.DATARMNET8404ab9e4b);hrtimer_init(&DATARMNETe05748b000->
+DATARMNETebb45c8d86.DATARMNETb49f8f9aff,CLOCK_MONOTONIC, HRTIMER_MODE_REL_SOFT);
+DATARMNETe05748b000->DATARMNETebb45c8d86.DATARMNETb49f8f9aff.function=
+DATARMNET522b9dd653;for(DATARMNETefc9df3df2=(0xd2d+202-0xdf7);
 DATARMNETefc9df3df2<DATARMNET78d9393ac8;DATARMNETefc9df3df2++){struct 
 DATARMNETd7c9631acd*DATARMNETaa568481cf;DATARMNETaa568481cf=&DATARMNETe05748b000
 ->DATARMNETebb45c8d86.DATARMNET2846a01cce[DATARMNETefc9df3df2];INIT_LIST_HEAD(&
 DATARMNETaa568481cf->DATARMNETb76b79d0d5);INIT_HLIST_NODE(&DATARMNETaa568481cf->
-DATARMNETbd5d7d96d8);}return DATARMNET0529bb9c4e;}
+DATARMNETbd5d7d96d8);INIT_LIST_HEAD(&DATARMNETaa568481cf->DATARMNET8404ab9e4b);}
+return DATARMNET0529bb9c4e;}
\ No newline at end of file
@@ -44,13 +44,23 @@ DATARMNETcd597b0a1b);struct kernel_param_ops DATARMNET9cee06cbe4;};static int
 DATARMNETf467eaf6fc(const char*DATARMNETcc6099cb14,const struct kernel_param*
 DATARMNETb3ce0fdc63,u32 DATARMNET4c4a5ce272);DATARMNET7996ea045b(
 DATARMNETdf66588a73);DATARMNET7996ea045b(DATARMNET9c85bb95a3);
-DATARMNET7996ea045b(DATARMNET6d2ed4b822);static struct DATARMNET5374f6eafa 
+DATARMNET7996ea045b(DATARMNET6d2ed4b822);DATARMNET7996ea045b(DATARMNETeca25e6800
+);DATARMNET7996ea045b(DATARMNET2356b8114e);DATARMNET7996ea045b(
+DATARMNETd33781e14c);DATARMNET7996ea045b(DATARMNETfcc9bd3f65);
+DATARMNET7996ea045b(DATARMNET4d2ce13a17);static struct DATARMNET5374f6eafa 
 DATARMNET07ae1e39fb[DATARMNET94aa767bca]={DATARMNETce9a74c748(
 DATARMNETdf66588a73,65000,(0xd2d+202-0xdf7),65000,NULL),DATARMNETce9a74c748(
 DATARMNET9c85bb95a3,65000,(0xd2d+202-0xdf7),65000,NULL),DATARMNETce9a74c748(
 DATARMNET6d2ed4b822,DATARMNET2d89680280,DATARMNETa2ddeec85f,DATARMNETaccb69cf16,
-DATARMNET241493ab9a),};static int DATARMNETf467eaf6fc(const char*
-DATARMNETcc6099cb14,const struct kernel_param*DATARMNETb3ce0fdc63,u32 
+DATARMNET241493ab9a), DATARMNETce9a74c748(DATARMNETeca25e6800,(0xfe2+433-0x1094)
+,(0xd26+209-0xdf6),(0xfe2+433-0x1094),NULL), DATARMNETce9a74c748(
+DATARMNET2356b8114e,(0xfe2+433-0x1094),(0xd26+209-0xdf6),(0xfe2+433-0x1094),NULL
+), DATARMNETce9a74c748(DATARMNETd33781e14c,(0xd2d+202-0xdf7),(0xd2d+202-0xdf7),
+100000,NULL), DATARMNETce9a74c748(DATARMNETfcc9bd3f65,(0xd2d+202-0xdf7),
+(0xd2d+202-0xdf7),65535,NULL), DATARMNETce9a74c748(DATARMNET4d2ce13a17,
+(0xd2d+202-0xdf7),(0xd2d+202-0xdf7),(0xd26+209-0xdf6),NULL),};static int 
+DATARMNETf467eaf6fc(const char*DATARMNETcc6099cb14,const struct kernel_param*
+DATARMNETb3ce0fdc63,u32 
 DATARMNET4c4a5ce272){struct DATARMNET5374f6eafa*DATARMNET0751f2024d;unsigned 
 long long DATARMNETcd597b0a1b;u64 DATARMNET7e07157b72;int DATARMNETb14e52a504;if
 (DATARMNET4c4a5ce272>=DATARMNET94aa767bca)return-EINVAL;DATARMNETb14e52a504=
@@ -68,8 +78,13 @@ DATARMNET6a76048590();return DATARMNETb14e52a504;}}*(u64*)DATARMNETb3ce0fdc63->
 arg=(u64)DATARMNETcd597b0a1b;DATARMNET6a76048590();return(0xd2d+202-0xdf7);}
 DATARMNET584f34118e(rmnet_offload_knob0,DATARMNETdf66588a73);DATARMNET584f34118e
 (rmnet_offload_knob1,DATARMNET9c85bb95a3);DATARMNET584f34118e(
-rmnet_offload_knob2,DATARMNET6d2ed4b822);u64 DATARMNETf1d1b8287f(u32 
-DATARMNET4c4a5ce272){struct DATARMNET5374f6eafa*DATARMNET0751f2024d;if(
+rmnet_offload_knob2,DATARMNET6d2ed4b822);DATARMNET584f34118e(rmnet_offload_knob3
+,DATARMNETeca25e6800);DATARMNET584f34118e(rmnet_offload_knob4,
+DATARMNET2356b8114e);DATARMNET584f34118e(rmnet_offload_knob5,DATARMNETd33781e14c
+);DATARMNET584f34118e(rmnet_offload_knob6,DATARMNETfcc9bd3f65);
+DATARMNET584f34118e(rmnet_offload_knob7,DATARMNET4d2ce13a17);u64 
+DATARMNETf1d1b8287f(u32 DATARMNET4c4a5ce272){struct DATARMNET5374f6eafa*
+DATARMNET0751f2024d;if(
 DATARMNET4c4a5ce272>=DATARMNET94aa767bca)return(u64)~(0xd2d+202-0xdf7);
 DATARMNET0751f2024d=&DATARMNET07ae1e39fb[DATARMNET4c4a5ce272];return 
 DATARMNET0751f2024d->DATARMNETd67569df12;}
@@ -14,5 +14,7 @@
 #define DATARMNET5833be0738
 #include <linux/types.h>
 enum{DATARMNETdf66588a73,DATARMNET9c85bb95a3,DATARMNET6d2ed4b822,
-DATARMNET94aa767bca,};u64 DATARMNETf1d1b8287f(u32 DATARMNET4c4a5ce272);
+DATARMNETeca25e6800,DATARMNET2356b8114e, DATARMNETd33781e14c,DATARMNETfcc9bd3f65
+,DATARMNET4d2ce13a17, DATARMNET94aa767bca,};u64 DATARMNETf1d1b8287f(u32 
+DATARMNET4c4a5ce272);
 #endif
@@ -50,12 +50,22 @@ sizeof(DATARMNET699c2c62cd->DATARMNETe31a04a369);DATARMNETefc9df3df2<
 DATARMNET3c3abe9e2c;DATARMNETefc9df3df2+=(0xd11+230-0xdf3)){if(*(u32*)(
 DATARMNET699c2c62cd->DATARMNET021aa8e68d+DATARMNETefc9df3df2)^*(u32*)(
 DATARMNET8814564ab9->DATARMNET021aa8e68d+DATARMNETefc9df3df2))return true;}
-return false;}static int DATARMNET9a13d70865(struct DATARMNETd7c9631acd*
-DATARMNETaa568481cf,struct DATARMNETd812bcdbb5*DATARMNET5fe4c722a8){u64 
+return false;}static bool DATARMNET887b45bf1b(struct DATARMNETd812bcdbb5*
+DATARMNET5fe4c722a8){struct DATARMNETd2991e8952*DATARMNET5bab3dc4f7,
+DATARMNET6a3667361e;u64 DATARMNETe7cf80f9c1=DATARMNETf1d1b8287f(
+DATARMNETfcc9bd3f65);if(!DATARMNETe7cf80f9c1)return false;DATARMNET5bab3dc4f7=
+rmnet_frag_header_ptr(DATARMNET5fe4c722a8->DATARMNET719f68fb88, 
+DATARMNET5fe4c722a8->DATARMNET144d119066.DATARMNET4ca5ac9de1,sizeof(*
+DATARMNET5bab3dc4f7),&DATARMNET6a3667361e);if(!DATARMNET5bab3dc4f7)return false;
+return ntohs(DATARMNET5bab3dc4f7->DATARMNET807cd6af6c)<DATARMNETe7cf80f9c1;}
+static int DATARMNET9a13d70865(struct DATARMNETd7c9631acd*DATARMNETaa568481cf,
+struct DATARMNETd812bcdbb5*DATARMNET5fe4c722a8){u64 
 DATARMNET7457d496cb;u32 DATARMNET95acece3fc;if(DATARMNET2818ea93ec(
 DATARMNET5fe4c722a8)){DATARMNETa00cda79d0(DATARMNETb322de38be);return 
-DATARMNET7af645849a;}if(!DATARMNETaa568481cf->DATARMNET1db11fa85e)return 
-DATARMNET0413b43080;if(DATARMNET829fcf5939(DATARMNETaa568481cf,
+DATARMNET7af645849a;}if(DATARMNET887b45bf1b(DATARMNET5fe4c722a8)){
+DATARMNETa00cda79d0(DATARMNETdaa8baa536);return DATARMNET7af645849a;}if(!
+DATARMNETaa568481cf->DATARMNET1db11fa85e)return DATARMNET0413b43080;if(
+DATARMNET829fcf5939(DATARMNETaa568481cf,
 DATARMNET5fe4c722a8)){DATARMNETa00cda79d0(DATARMNET38317c7efd);return 
 DATARMNETb0bd5db24d;}if(DATARMNET5fe4c722a8->DATARMNET144d119066.
 DATARMNETbc28a5970f^DATARMNETaa568481cf->DATARMNET78fd20ce0e.DATARMNETbc28a5970f
@@ -67,8 +77,11 @@ DATARMNET0cd1fa0d98);return DATARMNETb0bd5db24d;}DATARMNET7457d496cb=
 DATARMNETf1d1b8287f(DATARMNETdf66588a73);if(DATARMNET5fe4c722a8->
 DATARMNET1ef22e4c76+DATARMNETaa568481cf->DATARMNETcf28ae376b>=
 DATARMNET7457d496cb){DATARMNETa00cda79d0(DATARMNET1c0d243816);return 
-DATARMNETb0bd5db24d;}DATARMNET5fe4c722a8->DATARMNETf1b6b0a6cc=false;return 
-DATARMNET0413b43080;}bool DATARMNET4c7cdc25b7(struct DATARMNETd7c9631acd*
+DATARMNETb0bd5db24d;}if(DATARMNETaa568481cf->DATARMNET1db11fa85e>= 
+DATARMNETf1d1b8287f(DATARMNETeca25e6800)){DATARMNETa00cda79d0(
+DATARMNET8fad14389c);return DATARMNETb0bd5db24d;}DATARMNET5fe4c722a8->
+DATARMNETf1b6b0a6cc=false;return DATARMNET0413b43080;}bool DATARMNET4c7cdc25b7(
+struct DATARMNETd7c9631acd*
 DATARMNETaa568481cf,struct DATARMNETd812bcdbb5*DATARMNET5fe4c722a8,bool 
 DATARMNETd87669e323,struct list_head*DATARMNET6f9bfa17e6){int 
 DATARMNETb14e52a504;if(DATARMNETd87669e323){DATARMNETa00cda79d0(
@@ -25,8 +25,11 @@ DATARMNETa00cda79d0(DATARMNETbc56977b7e);return DATARMNETb0bd5db24d;}
 DATARMNET71c7d18d88=DATARMNETf1d1b8287f(DATARMNET9c85bb95a3);if(
 DATARMNET5fe4c722a8->DATARMNET1ef22e4c76+DATARMNETaa568481cf->
 DATARMNETcf28ae376b>=DATARMNET71c7d18d88){DATARMNETa00cda79d0(
-DATARMNETc9b8ef90d1);return DATARMNETb0bd5db24d;}DATARMNET5fe4c722a8->
-DATARMNETf1b6b0a6cc=false;return DATARMNET0413b43080;}bool DATARMNET8dc47eb7af(
+DATARMNETc9b8ef90d1);return DATARMNETb0bd5db24d;}if(DATARMNETaa568481cf->
+DATARMNET1db11fa85e>= DATARMNETf1d1b8287f(DATARMNET2356b8114e)){
+DATARMNETa00cda79d0(DATARMNETca3a0538da);return DATARMNETb0bd5db24d;}
+DATARMNET5fe4c722a8->DATARMNETf1b6b0a6cc=false;return DATARMNET0413b43080;}bool 
+DATARMNET8dc47eb7af(
 struct DATARMNETd7c9631acd*DATARMNETaa568481cf,struct DATARMNETd812bcdbb5*
 DATARMNET5fe4c722a8,bool DATARMNETd87669e323,struct list_head*
 DATARMNET6f9bfa17e6){int DATARMNETb14e52a504;if(DATARMNETd87669e323){
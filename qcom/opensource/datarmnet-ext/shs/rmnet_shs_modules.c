@@ -213,4 +213,24 @@ DATARMNET930a441406,
 DATARMNET68d84e7b98,ulong,NULL,(0xcb7+5769-0x221c));MODULE_PARM_DESC(
 DATARMNET68d84e7b98,
 "\x72\x6d\x6e\x65\x74\x20\x73\x68\x73\x20\x63\x72\x74\x69\x63\x61\x6c\x20\x65\x72\x72\x6f\x72\x20\x74\x79\x70\x65"
-);
+);unsigned int DATARMNET41b3e0c132 __read_mostly;module_param(
+DATARMNET41b3e0c132,uint,(0xdb7+6665-0x261c));MODULE_PARM_DESC(
+DATARMNET41b3e0c132, 
+"\x45\x6e\x61\x62\x6c\x65\x20\x63\x61\x70\x61\x63\x69\x74\x79\x20\x61\x6e\x64\x20\x6c\x6f\x61\x64\x20\x61\x77\x61\x72\x65\x20\x66\x6c\x6f\x77\x20\x73\x74\x65\x65\x72\x69\x6e\x67"
+);unsigned int DATARMNETd4f02896cf __read_mostly=(0xd1f+216-0xdf5);module_param(
+DATARMNETd4f02896cf,uint,(0xdb7+6665-0x261c));MODULE_PARM_DESC(
+DATARMNETd4f02896cf, 
+"\x4d\x61\x78\x20\x66\x6c\x6f\x77\x20\x6d\x69\x67\x72\x61\x74\x69\x6f\x6e\x73\x20\x70\x65\x72\x20\x77\x71\x20\x72\x75\x6e\x20\x69\x6e\x20\x63\x61\x70\x61\x63\x69\x74\x79\x20\x6d\x6f\x64\x65"
+);unsigned int DATARMNETa535afee57 __read_mostly=(0xbd5+917-0xf65);module_param(
+DATARMNETa535afee57,uint,(0xdb7+6665-0x261c));MODULE_PARM_DESC(
+DATARMNETa535afee57, 
+"\x57\x71\x20\x72\x75\x6e\x73\x20\x61\x20\x6d\x69\x67\x72\x61\x74\x65\x64\x20\x66\x6c\x6f\x77\x20\x73\x74\x61\x79\x73\x20\x6f\x6e\x20\x69\x74\x73\x20\x6e\x65\x77\x20\x63\x70\x75"
+);unsigned int DATARMNET60f95150ef __read_mostly=(0xe93+3258-0x1af8);
+module_param(DATARMNET60f95150ef,uint,(0xdb7+6665-0x261c));MODULE_PARM_DESC(
+DATARMNET60f95150ef, 
+"\x43\x50\x55\x20\x62\x75\x73\x79\x20\x70\x65\x72\x63\x65\x6e\x74\x20\x61\x62\x6f\x76\x65\x20\x77\x68\x69\x63\x68\x20\x66\x6c\x6f\x77\x73\x20\x61\x72\x65\x20\x73\x68\x65\x64"
+);unsigned long DATARMNETc133bd9386[DATARMNETe32ca26fa1];module_param_array(
+DATARMNETc133bd9386,ulong,NULL,(0xcb7+5769-0x221c));MODULE_PARM_DESC(
+DATARMNETc133bd9386, 
+"\x43\x61\x70\x61\x63\x69\x74\x79\x20\x6d\x6f\x64\x65\x20\x66\x6c\x6f\x77\x20\x6d\x69\x67\x72\x61\x74\x69\x6f\x6e\x73\x20\x70\x65\x72\x20\x72\x65\x61\x73\x6f\x6e"
+);
\ No newline at end of file
@@ -53,6 +53,9 @@ int DATARMNETd75e474598[DATARMNETc6782fed88];extern unsigned int
 DATARMNET25c61a512c;extern unsigned int DATARMNET1ad396a890;extern unsigned int 
 DATARMNET756bdd424a;extern unsigned int DATARMNET58b009b16b __read_mostly;extern
  unsigned long DATARMNET68d84e7b98[DATARMNETf3110711cb];extern unsigned long 
-DATARMNET930a441406[DATARMNET0d61981934];
+DATARMNET930a441406[DATARMNET0d61981934];extern unsigned int DATARMNET41b3e0c132
+;extern unsigned int DATARMNETd4f02896cf;extern unsigned int DATARMNETa535afee57
+;extern unsigned int DATARMNET60f95150ef;extern unsigned long 
+DATARMNETc133bd9386[DATARMNETe32ca26fa1];
 #endif
 
@@ -22,6 +22,8 @@
 #include "rmnet_shs_modules.h"
 #include "rmnet_shs_common.h"
 #include <linux/pm_wakeup.h>
+#include <linux/tick.h>
+#include <linux/sched/topology.h>
 MODULE_LICENSE("\x47\x50\x4c\x20\x76\x32");
 #define DATARMNET59f7cb903f (0xc07+4861-0x1e3c)
 #define DATARMNET832dcfb5f8 (0xeb7+698-0x110d)
@@ -30,6 +32,7 @@ MODULE_LICENSE("\x47\x50\x4c\x20\x76\x32");
 #define DATARMNETbe271c415b ((!DATARMNET25c61a512c) ? (0xd1f+216-0xdf5) : \
 DATARMNET25c61a512c)
 #define DATARMNET2f8c32c8eb ((0xd1f+216-0xdf5))
+#define DATARMNET6ee23875cb (0xd35+210-0xdff)
 DEFINE_SPINLOCK(DATARMNETfbdbab2ef6);DEFINE_SPINLOCK(DATARMNETec2a4f5211);static
  ktime_t DATARMNETb3a4036d6d;struct workqueue_struct*DATARMNETf141197982;static 
 struct DATARMNETa144e2bd00*DATARMNET9dc7755be5;static struct DATARMNETc8fdbf9c85
@@ -647,8 +650,105 @@ NULL,NULL);if((DATARMNET253a9fc708>DATARMNET264b01f4d5)||(((0xd26+209-0xdf6)<<
 DATARMNET42a992465f)&DATARMNETecc0627c70.DATARMNETba3f7a11ef)||!cpu_online(
 DATARMNET42a992465f)||((DATARMNET253a9fc708<DATARMNET53ce143c7e)&&(
 DATARMNETc7c10881f4<DATARMNET53ce143c7e)))DATARMNET466244e5d6(
-DATARMNET42a992465f);}}void DATARMNETe00453a3e4(struct DATARMNET9b44b71ee9*ep){
-int DATARMNET9025861a27;int DATARMNETef87f9e251;u16 DATARMNETb773055ecd;u16 
+DATARMNET42a992465f);}}static u64 DATARMNETc8a356b3ca[DATARMNETc6782fed88];
+static u64 DATARMNETfc1dd41541[DATARMNETc6782fed88];static u32 
+DATARMNET4c9dd263ab[DATARMNETc6782fed88];static u64 DATARMNETa8ad518871[
+DATARMNETc6782fed88];static struct DATARMNET531d924630 DATARMNETcbdb73255a[
+DATARMNET6ee23875cb];static u8 DATARMNET6cea790133;static void 
+DATARMNET210bba39bf(void){u64 DATARMNET15a145f781,DATARMNET8a396ea014,
+DATARMNETee44d7f4ee,DATARMNETc062b24881;u16 cpu;for(cpu=(0xd2d+202-0xdf7);cpu<
+DATARMNETc6782fed88;cpu++){DATARMNETa8ad518871[cpu]=DATARMNET6cdd58e74c.
+DATARMNET73464778dc[cpu].DATARMNET324c1a8f98;DATARMNET4c9dd263ab[cpu]=(0xd2d+202
+-0xdf7);if(!cpu_online(cpu))continue;DATARMNET15a145f781=get_cpu_idle_time_us(
+cpu,&DATARMNET8a396ea014);if(DATARMNET15a145f781==U64_MAX)continue;
+DATARMNETee44d7f4ee=DATARMNET15a145f781-DATARMNETc8a356b3ca[cpu];
+DATARMNETc062b24881=DATARMNET8a396ea014-DATARMNETfc1dd41541[cpu];if(!
+DATARMNETfc1dd41541[cpu]||!DATARMNETc062b24881||DATARMNETee44d7f4ee>
+DATARMNETc062b24881){DATARMNETc8a356b3ca[cpu]=DATARMNET15a145f781;
+DATARMNETfc1dd41541[cpu]=DATARMNET8a396ea014;continue;}DATARMNETc8a356b3ca[cpu]=
+DATARMNET15a145f781;DATARMNETfc1dd41541[cpu]=DATARMNET8a396ea014;
+DATARMNET4c9dd263ab[cpu]=div64_u64((DATARMNETc062b24881-DATARMNETee44d7f4ee)*(
+0xbdd+5872-0x2269),DATARMNETc062b24881);}}static u64 DATARMNET523fff876c(u16 cpu
+){u64 DATARMNET36dc009bfa=DATARMNET713717107f[cpu];u64 DATARMNET76f416f1a4;
+DATARMNET76f416f1a4=(DATARMNET36dc009bfa>DATARMNETa8ad518871[cpu])?
+DATARMNET36dc009bfa-DATARMNETa8ad518871[cpu]:(0xd2d+202-0xdf7);
+DATARMNET36dc009bfa=div64_u64(DATARMNET36dc009bfa*((0xbdd+5872-0x2269)-min_t(u32
+,DATARMNET4c9dd263ab[cpu],(0xbdd+5872-0x2269))),(0xbdd+5872-0x2269));return min(
+DATARMNET76f416f1a4,DATARMNET36dc009bfa);}static int DATARMNET2508b04396(u16 cpu
+){if(!cpu_online(cpu))return DATARMNETb127f6f602;if(((0xd26+209-0xdf6)<<cpu)&
+DATARMNETecc0627c70.DATARMNETba3f7a11ef)return DATARMNET28d2466444;if(
+DATARMNETa8ad518871[cpu]>DATARMNET713717107f[cpu])return DATARMNET054553cf5c;if(
+DATARMNET4c9dd263ab[cpu]>DATARMNET60f95150ef)return DATARMNET04a8120096;return 
+DATARMNETe32ca26fa1;}static struct DATARMNET6c78e47d24*DATARMNET846d6b7cb7(u16 
+cpu){struct DATARMNET6c78e47d24*DATARMNETe1122c3ec2,*DATARMNET3f07af1068=NULL;
+list_for_each_entry(DATARMNETe1122c3ec2,&DATARMNET9825511866,DATARMNET6de26f0feb
+){if(!DATARMNETe1122c3ec2->DATARMNET0dc393a345||!DATARMNETe1122c3ec2->
+DATARMNET63b1a086d5||!DATARMNETe1122c3ec2->hash)continue;if(DATARMNETe1122c3ec2
+->DATARMNET7c894c2f8f!=cpu||DATARMNETe1122c3ec2->DATARMNET6e1a4eaf09!=cpu)
+continue;if(DATARMNETe1122c3ec2->DATARMNETb84ccf39c1||!DATARMNETe1122c3ec2->
+DATARMNET324c1a8f98)continue;if(!DATARMNET3f07af1068||DATARMNETe1122c3ec2->
+DATARMNET324c1a8f98>DATARMNET3f07af1068->DATARMNET324c1a8f98)DATARMNET3f07af1068
+=DATARMNETe1122c3ec2;}return DATARMNET3f07af1068;}static int DATARMNETdec7fdd86f
+(struct DATARMNET9b44b71ee9*ep,u16 DATARMNETe2deb78cf1,u64 DATARMNET2c099b9b5f){
+u64 DATARMNET76f416f1a4,DATARMNET4c396131cf,DATARMNET3f07af1068=(0xd2d+202-0xdf7
+);int DATARMNETfd61d3a4aa=-(0xd26+209-0xdf6);u16 cpu;for(cpu=(0xd2d+202-0xdf7);
+cpu<DATARMNETc6782fed88;cpu++){if(cpu==DATARMNETe2deb78cf1||!cpu_online(cpu))
+continue;if(!(((0xd26+209-0xdf6)<<cpu)&ep->DATARMNET9fb369ce5f&~
+DATARMNETecc0627c70.DATARMNETba3f7a11ef)) continue;DATARMNET76f416f1a4=
+DATARMNET523fff876c(cpu);if(DATARMNET76f416f1a4<=DATARMNET2c099b9b5f)continue;
+DATARMNET4c396131cf=((DATARMNET76f416f1a4-DATARMNET2c099b9b5f)*
+arch_scale_cpu_capacity(cpu))>>SCHED_CAPACITY_SHIFT;if(DATARMNET4c396131cf>
+DATARMNET3f07af1068){DATARMNET3f07af1068=DATARMNET4c396131cf;DATARMNETfd61d3a4aa
+=cpu;}}return DATARMNETfd61d3a4aa;}static u32 DATARMNET8ba158d7e2(u16 
+DATARMNETe2deb78cf1,u16 DATARMNETfd61d3a4aa){if((((0xd26+209-0xdf6)<<
+DATARMNETe2deb78cf1)&DATARMNET9273f84bf1)&&(((0xd26+209-0xdf6)<<
+DATARMNETfd61d3a4aa)&DATARMNETbc3c416b77)) return DATARMNETed5a873a00;if((((
+0xd26+209-0xdf6)<<DATARMNETe2deb78cf1)&DATARMNETbc3c416b77)&&(((0xd26+209-0xdf6)
+<<DATARMNETfd61d3a4aa)&DATARMNET9273f84bf1)) return DATARMNETd7a3f55a51;return 
+DATARMNETefe8657028;}static void DATARMNET008c17e6d0(struct DATARMNET6c78e47d24*
+DATARMNETe1122c3ec2,u16 DATARMNETe2deb78cf1,u16 DATARMNETfd61d3a4aa, int 
+DATARMNETdf000ad842){struct DATARMNET531d924630*DATARMNET766a8d6660;if(
+DATARMNET6cea790133>=DATARMNET6ee23875cb)return;DATARMNET766a8d6660=&
+DATARMNETcbdb73255a[DATARMNET6cea790133++];DATARMNET766a8d6660->hash=
+DATARMNETe1122c3ec2->hash;DATARMNET766a8d6660->DATARMNETdf000ad842=
+DATARMNETdf000ad842;DATARMNET766a8d6660->DATARMNET2c099b9b5f=DATARMNETe1122c3ec2
+->DATARMNET324c1a8f98;DATARMNET766a8d6660->DATARMNET8928e9064d=
+DATARMNETa8ad518871[DATARMNETe2deb78cf1];DATARMNET766a8d6660->
+DATARMNET971b74e946=DATARMNETa8ad518871[DATARMNETfd61d3a4aa];DATARMNET766a8d6660
+->DATARMNETe2deb78cf1=DATARMNETe2deb78cf1;DATARMNET766a8d6660->
+DATARMNETfd61d3a4aa=DATARMNETfd61d3a4aa;DATARMNET766a8d6660->DATARMNET48765417d9
+=DATARMNET4c9dd263ab[DATARMNETe2deb78cf1];DATARMNET766a8d6660->
+DATARMNET8a1bc63bd1=DATARMNET4c9dd263ab[DATARMNETfd61d3a4aa];DATARMNET766a8d6660
+->DATARMNET367606fa24=arch_scale_cpu_capacity(DATARMNETe2deb78cf1);
+DATARMNET766a8d6660->DATARMNETfbab6ea9b0=arch_scale_cpu_capacity(
+DATARMNETfd61d3a4aa);}static void DATARMNET18ead9bd5b(void){struct 
+DATARMNET6c78e47d24*DATARMNETe1122c3ec2;struct DATARMNET9b44b71ee9*ep;u32 
+DATARMNET300e40e477=min_t(u32,DATARMNETd4f02896cf,DATARMNET6ee23875cb);int 
+DATARMNETdf000ad842,DATARMNETfd61d3a4aa;u16 cpu;DATARMNET210bba39bf();
+list_for_each_entry(DATARMNETe1122c3ec2,&DATARMNET9825511866,DATARMNET6de26f0feb
+){if(DATARMNETe1122c3ec2->DATARMNETb84ccf39c1)DATARMNETe1122c3ec2->
+DATARMNETb84ccf39c1--;}for(cpu=(0xd2d+202-0xdf7);cpu<DATARMNETc6782fed88&&
+DATARMNET300e40e477;cpu++){DATARMNETdf000ad842=DATARMNET2508b04396(cpu);if(
+DATARMNETdf000ad842==DATARMNETe32ca26fa1)continue;DATARMNETe1122c3ec2=
+DATARMNET846d6b7cb7(cpu);if(!DATARMNETe1122c3ec2)continue;list_for_each_entry(ep
+,&DATARMNET30a3e83974,DATARMNET0763436b8d){if(!ep->DATARMNET4a4e6f66b5||
+DATARMNETe1122c3ec2->DATARMNET63b1a086d5->dev!=ep->ep)continue;
+DATARMNETfd61d3a4aa=DATARMNETdec7fdd86f(ep,cpu,DATARMNETe1122c3ec2->
+DATARMNET324c1a8f98);if(DATARMNETfd61d3a4aa<(0xd2d+202-0xdf7))break;if(!
+DATARMNET6f56fe7597(cpu,DATARMNETfd61d3a4aa,ep,DATARMNETe1122c3ec2->hash,
+DATARMNET8ba158d7e2(cpu,DATARMNETfd61d3a4aa)))break;DATARMNET008c17e6d0(
+DATARMNETe1122c3ec2,cpu,DATARMNETfd61d3a4aa,DATARMNETdf000ad842);
+DATARMNETe1122c3ec2->DATARMNETb84ccf39c1=DATARMNETa535afee57;DATARMNETa8ad518871
+[cpu]-=min(DATARMNETa8ad518871[cpu],DATARMNETe1122c3ec2->DATARMNET324c1a8f98);
+DATARMNETa8ad518871[DATARMNETfd61d3a4aa]+=DATARMNETe1122c3ec2->
+DATARMNET324c1a8f98;DATARMNETc133bd9386[DATARMNETdf000ad842]++;
+DATARMNET300e40e477--;break;}}}static void DATARMNETc755487029(void){struct 
+DATARMNET177911299b DATARMNET4c046b24b4;u8 i;for(i=(0xd2d+202-0xdf7);i<
+DATARMNET6cea790133;i++){DATARMNET851f128b8e(&DATARMNETcbdb73255a[i],&
+DATARMNET4c046b24b4);DATARMNETb5d58adbe7(&DATARMNET4c046b24b4);}
+DATARMNET6cea790133=(0xd2d+202-0xdf7);}void DATARMNETe00453a3e4(struct 
+DATARMNET9b44b71ee9*ep){int DATARMNET9025861a27;int DATARMNETef87f9e251;u16 
+DATARMNETb773055ecd;u16 
 DATARMNETc312f6517d;u16 DATARMNETc35b40fa7b;u8 DATARMNETffd83bb362=
 (0xd2d+202-0xdf7);u8 DATARMNET24f6ce5dc0=(0xd2d+202-0xdf7);if(!ep){
 DATARMNET68d84e7b98[DATARMNETb8fe2c0e64]++;return;}DATARMNETb773055ecd=ep->
@@ -776,14 +876,16 @@ DATARMNET6c23f11e81);DATARMNET3af54cd726(&DATARMNETf91b305f4e);
 DATARMNETb177316a15(&DATARMNETe46ae760db);DATARMNETcc489fbbad(&
 DATARMNET3208cd0982);}else{rm_err("\x25\x73",
 "\x53\x48\x53\x5f\x55\x50\x44\x41\x54\x45\x3a\x20\x73\x68\x73\x20\x75\x73\x65\x72\x73\x70\x61\x63\x65\x20\x6e\x6f\x74\x20\x63\x6f\x6e\x6e\x65\x63\x74\x65\x64\x2c\x20\x75\x73\x69\x6e\x67\x20\x64\x65\x66\x61\x75\x6c\x74\x20\x6c\x6f\x67\x69\x63"
-);DATARMNET95736008d9();}DATARMNET0a6fb12cb2();DATARMNETedc898218c();}void 
-DATARMNETb4b5fc9686(struct work_struct*DATARMNET33110a3ff5){unsigned long flags;
+);if(DATARMNET41b3e0c132)DATARMNET18ead9bd5b();else DATARMNET95736008d9();}
+DATARMNET0a6fb12cb2();DATARMNETedc898218c();}void DATARMNETb4b5fc9686(struct 
+work_struct*DATARMNET33110a3ff5){unsigned long flags;
 unsigned long DATARMNET28085cfd14;trace_rmnet_shs_wq_high(DATARMNET4fe8e8c1a9,
 DATARMNET5a417740cb,(0x16e8+787-0xc0c),(0x16e8+787-0xc0c),(0x16e8+787-0xc0c),
 (0x16e8+787-0xc0c),NULL,NULL);spin_lock_irqsave(&DATARMNETec2a4f5211,flags);
 DATARMNETcd6e26f0ad();spin_unlock_irqrestore(&DATARMNETec2a4f5211,flags);
-DATARMNET39391a8bc5(DATARMNET53bef3c026);DATARMNET5e1aaed12b();
-DATARMNET28085cfd14=msecs_to_jiffies(DATARMNET1fc3ad67fd);queue_delayed_work(
+DATARMNETc755487029();DATARMNET39391a8bc5(DATARMNET53bef3c026);
+DATARMNET5e1aaed12b();DATARMNET28085cfd14=msecs_to_jiffies(DATARMNET1fc3ad67fd);
+queue_delayed_work(
 DATARMNETf141197982,&DATARMNET9dc7755be5->DATARMNET1150269da2,
 DATARMNET28085cfd14);trace_rmnet_shs_wq_high(DATARMNET4fe8e8c1a9,
 DATARMNET848d2ddfa7,(0x16e8+787-0xc0c),(0x16e8+787-0xc0c),(0x16e8+787-0xc0c),
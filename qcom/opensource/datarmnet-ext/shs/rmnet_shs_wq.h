@@ -61,8 +61,9 @@ DATARMNET9fb369ce5f;u32 DATARMNET17f2abdf03;u32 DATARMNET399c840115;u32
 DATARMNET1a1d89d417;u32 DATARMNETb932033f50;u32 hash;int DATARMNETb5f5519502;u16
  DATARMNET6e1a4eaf09;u16 DATARMNET7c894c2f8f;u16 DATARMNET1e9d25d9ff;u8 mux_id;
 u8 DATARMNET0dc393a345;u8 DATARMNET0bfc2b2c85;u8 DATARMNET8a4e1d5aaa;u8 
-DATARMNET87636d0152;};struct DATARMNET228056d4b7{struct list_head 
-DATARMNETab5c1e9ad5;ktime_t DATARMNET68714ac92c;u64 DATARMNET9853a006ae;u64 
+DATARMNET87636d0152;u8 DATARMNETb84ccf39c1;};struct DATARMNET228056d4b7{struct 
+list_head DATARMNETab5c1e9ad5;ktime_t DATARMNET68714ac92c;u64 
+DATARMNET9853a006ae;u64 
 DATARMNETde6a309f37;u64 DATARMNETc589c49a2e;u64 DATARMNET7fc41d655d;u64 rx_bytes
 ;u64 DATARMNET57f040bb2c;u64 DATARMNET324c1a8f98;u64 DATARMNETbb80fccd97;u64 
 DATARMNET27c3925eff;u64 DATARMNET8233cb4988;u64 DATARMNET253a9fc708;u64 
@@ -111,8 +112,10 @@ DATARMNET709474066f,DATARMNET9a286e7654,DATARMNET5a417740cb,DATARMNET848d2ddfa7,
 DATARMNET59a1cb0962,DATARMNET1b421b0381,DATARMNETb196f64ee0,DATARMNET7cf840e991,
 DATARMNETa5cdfd53b3,DATARMNETd7f7ade458,DATARMNET53e4a6b394,DATARMNETd1d3902361,
 DATARMNET1fc50aac59,DATARMNET213a62da0d,DATARMNETf814701a94,DATARMNET166a43f3aa,
-};extern struct DATARMNETe600c5b727 DATARMNET0997c5650d[DATARMNETc6782fed88];
-extern struct list_head DATARMNET9825511866;extern struct workqueue_struct*
+};enum DATARMNET3ef3069e6b{DATARMNET054553cf5c,DATARMNET04a8120096, 
+DATARMNET28d2466444,DATARMNETb127f6f602,DATARMNETe32ca26fa1,};extern struct 
+DATARMNETe600c5b727 DATARMNET0997c5650d[DATARMNETc6782fed88];extern struct 
+list_head DATARMNET9825511866;extern struct workqueue_struct*
 DATARMNETf141197982;void DATARMNET3ae0d614d6(void);void DATARMNETf7dcab9a9e(void
 );void DATARMNET7b6c061b06(void);void DATARMNET4063c95208(void);void 
 DATARMNETe46c480d71(void);void DATARMNET039ac6d55d(void);u64 DATARMNETd406e89a85
@@ -210,7 +210,16 @@ DATARMNETaf3d356342=DATARMNETaf3d356342;DATARMNET7baa284dc5.DATARMNET43a8300dfd=
 DATARMNETdf2dbc641f),&DATARMNET7baa284dc5,sizeof(DATARMNET7baa284dc5));
 DATARMNET60b6e12cfd->list[(0xd2d+202-0xdf7)].msg_type=DATARMNETfce267cbe9;
 DATARMNET60b6e12cfd->valid=(0xd26+209-0xdf6);DATARMNET60b6e12cfd->list_len=
-(0xd26+209-0xdf6);}int DATARMNETb5d58adbe7(struct DATARMNET177911299b*msg_ptr){
+(0xd26+209-0xdf6);}void DATARMNET851f128b8e(struct DATARMNET531d924630*
+DATARMNET766a8d6660,struct DATARMNET177911299b*DATARMNET4c046b24b4){struct 
+timespec64 time;BUILD_BUG_ON(sizeof(*DATARMNET766a8d6660)>DATARMNET3b631aeccb);
+memset(DATARMNET4c046b24b4,(0xd2d+202-0xdf7),sizeof(*DATARMNET4c046b24b4));
+ktime_get_real_ts64(&time);DATARMNET4c046b24b4->timestamp=(DATARMNET6987463c5e(
+time.tv_sec)+time.tv_nsec);memcpy(&(DATARMNET4c046b24b4->list[(0xd2d+202-0xdf7)]
+.DATARMNETdf2dbc641f),DATARMNET766a8d6660,sizeof(*DATARMNET766a8d6660));
+DATARMNET4c046b24b4->list[(0xd2d+202-0xdf7)].msg_type=DATARMNETa52a731ef3;
+DATARMNET4c046b24b4->valid=(0xd26+209-0xdf6);DATARMNET4c046b24b4->list_len=(
+0xd26+209-0xdf6);}int DATARMNETb5d58adbe7(struct DATARMNET177911299b*msg_ptr){
 struct sk_buff*skb;void*msg_head;int rc;if(DATARMNET77097baa98==NULL){rm_err(
 "\x25\x73",
 "\x53\x48\x53\x5f\x47\x4e\x4c\x3a\x20\x46\x41\x49\x4c\x45\x44\x20\x74\x6f\x20\x73\x65\x6e\x64\x20\x6d\x73\x67\x5f\x6c\x61\x73\x74\x5f\x6e\x65\x74\x20\x69\x73\x20\x4e\x55\x4c\x4c" "\n"
@@ -44,7 +44,12 @@ DATARMNET5f0371060e,DATARMNETc08daf87d4,DATARMNET8070cc0bdc,DATARMNETc2be398ed4,
 #define DATARMNET8a917ef593     ((0xd26+209-0xdf6))
 struct DATARMNETe5f1cf1a69{uint32_t DATARMNETaf3d356342;uint8_t 
 DATARMNET43a8300dfd;};enum{DATARMNET68b3f1699c=(0xd2d+202-0xdf7),
-DATARMNETfce267cbe9=(0xd26+209-0xdf6),};struct DATARMNET4a3b3209dd{char 
+DATARMNETfce267cbe9=(0xd26+209-0xdf6),DATARMNETa52a731ef3=(0xd1f+216-0xdf5),};
+struct DATARMNET531d924630{uint32_t hash;uint32_t DATARMNETdf000ad842;uint32_t 
+DATARMNET2c099b9b5f;uint32_t DATARMNET8928e9064d;uint32_t DATARMNET971b74e946;
+uint16_t DATARMNETe2deb78cf1;uint16_t DATARMNETfd61d3a4aa;uint16_t 
+DATARMNET48765417d9;uint16_t DATARMNET8a1bc63bd1;uint16_t DATARMNET367606fa24;
+uint16_t DATARMNETfbab6ea9b0;};struct DATARMNET4a3b3209dd{char 
 DATARMNETdf2dbc641f[DATARMNET3b631aeccb];uint16_t msg_type;};struct 
 DATARMNET25187800fe{int valid;};struct DATARMNET177911299b{struct 
 DATARMNET4a3b3209dd list[DATARMNET8a917ef593];uint64_t timestamp;uint16_t 
@@ -57,9 +62,11 @@ DATARMNETaafc1d9519,struct genl_info*DATARMNET54338da2ff);int
 DATARMNET5d4ca1da1c(struct genl_info*DATARMNET54338da2ff,int val);int 
 DATARMNET5945236cd3(int val);int DATARMNETa9a7fa898c(void);void 
 DATARMNET8d0d510d45(uint32_t DATARMNETaf3d356342,struct DATARMNET177911299b*
-DATARMNET60b6e12cfd);int DATARMNETb5d58adbe7(struct DATARMNET177911299b*msg_ptr)
-;int DATARMNETd65d1351b9(struct sk_buff*DATARMNETaafc1d9519,struct genl_info*
-DATARMNET54338da2ff);int DATARMNET0dbc627e8f(void);int DATARMNETeabd69d1ab(void)
+DATARMNET60b6e12cfd);void DATARMNET851f128b8e(struct DATARMNET531d924630*
+DATARMNET766a8d6660,struct DATARMNET177911299b*DATARMNET4c046b24b4);int 
+DATARMNETb5d58adbe7(struct DATARMNET177911299b*msg_ptr);int DATARMNETd65d1351b9(
+struct sk_buff*DATARMNETaafc1d9519,struct genl_info*DATARMNET54338da2ff);int 
+DATARMNET0dbc627e8f(void);int DATARMNETeabd69d1ab(void)
 ;
 #endif 
 
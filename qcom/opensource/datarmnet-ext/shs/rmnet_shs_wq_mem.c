@@ -347,9 +347,23 @@ next;if(!DATARMNET3208cd0982){DATARMNET68d84e7b98[DATARMNETac729c3d29]++;return;
 }list_for_each_safe(DATARMNET7b34b7b5be,next,DATARMNET3208cd0982){
 DATARMNETf02b2a5be7=list_entry(DATARMNET7b34b7b5be,struct DATARMNET13c47d154e,
 DATARMNETec0e3cb8f0);list_del_init(&DATARMNETf02b2a5be7->DATARMNETec0e3cb8f0);
-kfree(DATARMNETf02b2a5be7);}}void DATARMNET5157210c44(struct list_head*
-DATARMNETe46ae760db){struct DATARMNET47a6995138*DATARMNETace28a2c7f;uint16_t idx
-=(0xd2d+202-0xdf7);if(!DATARMNETe46ae760db){rm_err("\x25\x73",
+kfree(DATARMNETf02b2a5be7);}}static void DATARMNETc63cbb452b(struct 
+DATARMNETa41d4c4a12*DATARMNETc34f768c51,bool DATARMNETdebc56b563,u16 count, 
+const void*src,size_t esz){struct DATARMNET307f623e97*DATARMNETee6f595103=(
+struct DATARMNET307f623e97*)(DATARMNETc34f768c51->data+DATARMNETc550a097bd);
+const char*DATARMNET0be8bbe924=src;char*DATARMNETed9f1d9e32=DATARMNETc34f768c51
+->data;u32 DATARMNET22aa9bebfd=(0xd2d+202-0xdf7);u16 i;WRITE_ONCE(
+DATARMNETee6f595103->DATARMNETc96fb3ac69,DATARMNETee6f595103->
+DATARMNETc96fb3ac69+(0xd26+209-0xdf6));smp_wmb();if(DATARMNETdebc56b563){memcpy(
+DATARMNETed9f1d9e32,&count,sizeof(count));DATARMNETed9f1d9e32+=sizeof(count);}
+for(i=(0xd2d+202-0xdf7);i<count;i++,DATARMNETed9f1d9e32+=esz,DATARMNET0be8bbe924
++=esz){if(!memcmp(DATARMNETed9f1d9e32,DATARMNET0be8bbe924,esz))continue;memcpy(
+DATARMNETed9f1d9e32,DATARMNET0be8bbe924,esz);DATARMNET22aa9bebfd++;}WRITE_ONCE(
+DATARMNETee6f595103->DATARMNET22aa9bebfd,DATARMNET22aa9bebfd);smp_wmb();
+WRITE_ONCE(DATARMNETee6f595103->DATARMNETc96fb3ac69,DATARMNETee6f595103->
+DATARMNETc96fb3ac69+(0xd26+209-0xdf6));}void DATARMNET5157210c44(struct 
+list_head*DATARMNETe46ae760db){struct DATARMNET47a6995138*DATARMNETace28a2c7f;
+uint16_t idx=(0xd2d+202-0xdf7);if(!DATARMNETe46ae760db){rm_err("\x25\x73",
 "\x53\x48\x53\x5f\x53\x43\x41\x50\x53\x3a\x20\x43\x50\x55\x20\x43\x61\x70\x61\x63\x69\x74\x69\x65\x73\x20\x4c\x69\x73\x74\x20\x69\x73\x20\x4e\x55\x4c\x4c"
 );return;}rm_err("\x25\x73",
 "\x53\x48\x53\x5f\x53\x43\x41\x50\x53\x3a\x20\x53\x6f\x72\x74\x65\x64\x20\x43\x50\x55\x20\x43\x61\x70\x61\x63\x69\x74\x69\x65\x73\x3a"
@@ -369,9 +383,9 @@ DATARMNET42a992465f;idx+=(0xd26+209-0xdf6);}rm_err(
 ,(unsigned long long)virt_to_phys((void*)DATARMNET410036d5ac),
 DATARMNET410036d5ac);if(!DATARMNET410036d5ac){rm_err("\x25\x73",
 "\x53\x48\x53\x5f\x57\x52\x49\x54\x45\x3a\x20\x63\x61\x70\x5f\x73\x68\x61\x72\x65\x64\x20\x69\x73\x20\x4e\x55\x4c\x4c"
-);return;}memcpy((char*)DATARMNET410036d5ac->data,(void*)&DATARMNET63c47f3c37[
-(0xd2d+202-0xdf7)],sizeof(DATARMNET63c47f3c37));}void DATARMNET0e273eab79(struct
- list_head*DATARMNETb436c3f30b){struct DATARMNET09a412b1c6*DATARMNET4238158b2a;
+);return;}DATARMNETc63cbb452b(DATARMNET410036d5ac,false,idx,DATARMNET63c47f3c37, 
+sizeof(DATARMNET63c47f3c37[(0xd2d+202-0xdf7)]));}void DATARMNET0e273eab79(struct 
+list_head*DATARMNETb436c3f30b){struct DATARMNET09a412b1c6*DATARMNET4238158b2a;
 uint16_t idx=(0xd2d+202-0xdf7);int DATARMNETcde08f6e7d=(0xd2d+202-0xdf7);if(!
 DATARMNETb436c3f30b){rm_err("\x25\x73",
 "\x53\x48\x53\x5f\x53\x47\x4f\x4c\x44\x3a\x20\x47\x6f\x6c\x64\x20\x46\x6c\x6f\x77\x73\x20\x4c\x69\x73\x74\x20\x69\x73\x20\x4e\x55\x4c\x4c"
@@ -394,10 +408,9 @@ DATARMNET19c47a9f3a);if(!DATARMNET19c47a9f3a){rm_err("\x25\x73",
 "\x53\x48\x53\x5f\x57\x52\x49\x54\x45\x3a\x20\x67\x66\x6c\x6f\x77\x5f\x73\x68\x61\x72\x65\x64\x20\x69\x73\x20\x4e\x55\x4c\x4c"
 );return;}rm_err(
 "\x53\x48\x53\x5f\x53\x47\x4f\x4c\x44\x3a\x20\x6e\x75\x6d\x20\x67\x6f\x6c\x64\x20\x66\x6c\x6f\x77\x73\x20\x3d\x20\x25\x75" "\n"
-,idx);memcpy(((char*)DATARMNET19c47a9f3a->data),&idx,sizeof(idx));memcpy(((char*
-)DATARMNET19c47a9f3a->data+sizeof(uint16_t)),(void*)&DATARMNET22b4032799[
-(0xd2d+202-0xdf7)],sizeof(DATARMNET22b4032799));}void DATARMNETe15af8eb6d(struct
- list_head*DATARMNETf0fb155a9c){struct DATARMNETa52c09a590*DATARMNET0f551e8a47;
+,idx);DATARMNETc63cbb452b(DATARMNET19c47a9f3a,true,idx,DATARMNET22b4032799, 
+sizeof(DATARMNET22b4032799[(0xd2d+202-0xdf7)]));}void DATARMNETe15af8eb6d(struct 
+list_head*DATARMNETf0fb155a9c){struct DATARMNETa52c09a590*DATARMNET0f551e8a47;
 uint16_t idx=(0xd2d+202-0xdf7);int DATARMNET6d96003717=(0xd2d+202-0xdf7);if(!
 DATARMNETf0fb155a9c){rm_err("\x25\x73",
 "\x53\x48\x53\x5f\x53\x4c\x4f\x57\x3a\x20\x53\x53\x20\x46\x6c\x6f\x77\x73\x20\x4c\x69\x73\x74\x20\x69\x73\x20\x4e\x55\x4c\x4c"
@@ -422,10 +435,9 @@ DATARMNET22e796eff3);if(!DATARMNET22e796eff3){rm_err("\x25\x73",
 "\x53\x48\x53\x5f\x57\x52\x49\x54\x45\x3a\x20\x73\x73\x66\x6c\x6f\x77\x5f\x73\x68\x61\x72\x65\x64\x20\x69\x73\x20\x4e\x55\x4c\x4c"
 );return;}rm_err(
 "\x53\x48\x53\x5f\x53\x4c\x4f\x57\x3a\x20\x6e\x75\x6d\x20\x73\x73\x20\x66\x6c\x6f\x77\x73\x20\x3d\x20\x25\x75" "\n"
-,idx);memcpy(((char*)DATARMNET22e796eff3->data),&idx,sizeof(idx));memcpy(((char*
-)DATARMNET22e796eff3->data+sizeof(uint16_t)),(void*)&DATARMNETb0d78d576f[
-(0xd2d+202-0xdf7)],sizeof(DATARMNETb0d78d576f));}void DATARMNET78f3a0ca4f(struct
- list_head*DATARMNET3208cd0982){struct DATARMNET13c47d154e*DATARMNETf02b2a5be7;
+,idx);DATARMNETc63cbb452b(DATARMNET22e796eff3,true,idx,DATARMNETb0d78d576f, 
+sizeof(DATARMNETb0d78d576f[(0xd2d+202-0xdf7)]));}void DATARMNET78f3a0ca4f(struct 
+list_head*DATARMNET3208cd0982){struct DATARMNET13c47d154e*DATARMNETf02b2a5be7;
 uint16_t idx=(0xd2d+202-0xdf7);int DATARMNETd31ee74d2e=(0xd2d+202-0xdf7);if(!
 DATARMNET3208cd0982){rm_err("\x25\x73",
 "\x53\x48\x53\x5f\x54\x4f\x50\x3a\x20\x46\x69\x6c\x74\x65\x72\x20\x46\x6c\x6f\x77\x73\x20\x4c\x69\x73\x74\x20\x69\x73\x20\x4e\x55\x4c\x4c"
@@ -459,9 +471,8 @@ DATARMNET9b8000d2a7);if(!DATARMNET9b8000d2a7){rm_err("\x25\x73",
 "\x53\x48\x53\x5f\x57\x52\x49\x54\x45\x3a\x20\x66\x66\x6c\x6f\x77\x5f\x73\x68\x61\x72\x65\x64\x20\x69\x73\x20\x4e\x55\x4c\x4c"
 );return;}rm_err(
 "\x53\x48\x53\x5f\x53\x4c\x4f\x57\x3a\x20\x6e\x75\x6d\x20\x66\x66\x6c\x6f\x77\x73\x20\x3d\x20\x25\x75" "\n"
-,idx);memcpy(((char*)DATARMNET9b8000d2a7->data),&idx,sizeof(idx));memcpy(((char*
-)DATARMNET9b8000d2a7->data+sizeof(uint16_t)),(void*)&DATARMNET3d25ff4ef4[
-(0xd2d+202-0xdf7)],sizeof(DATARMNET3d25ff4ef4));}void DATARMNET78666f33a1(void){
+,idx);DATARMNETc63cbb452b(DATARMNET9b8000d2a7,true,idx,DATARMNET3d25ff4ef4, 
+sizeof(DATARMNET3d25ff4ef4[(0xd2d+202-0xdf7)]));}void DATARMNET78666f33a1(void){
 struct rmnet_priv*priv;struct DATARMNET9b44b71ee9*ep=NULL;u16 idx=
 (0xd2d+202-0xdf7);u16 count=(0xd2d+202-0xdf7);rm_err(
 "\x53\x48\x53\x5f\x4e\x45\x54\x44\x45\x56\x3a\x20\x66\x75\x6e\x63\x74\x69\x6f\x6e\x20\x65\x6e\x74\x65\x72\x20\x25\x75" "\n"
@@ -502,11 +513,15 @@ DATARMNET257fc4b2d4;idx+=(0xd26+209-0xdf6);}rm_err(
 ,(unsigned long long)virt_to_phys((void*)DATARMNET67d31dc40a),
 DATARMNET67d31dc40a);if(!DATARMNET67d31dc40a){rm_err("\x25\x73",
 "\x53\x48\x53\x5f\x57\x52\x49\x54\x45\x3a\x20\x6e\x65\x74\x64\x65\x76\x5f\x73\x68\x61\x72\x65\x64\x20\x69\x73\x20\x4e\x55\x4c\x4c"
-);return;}memcpy(((char*)DATARMNET67d31dc40a->data),&idx,sizeof(idx));memcpy(((
-char*)DATARMNET67d31dc40a->data+sizeof(uint16_t)),(void*)&DATARMNETf46265286b[
-(0xd2d+202-0xdf7)],sizeof(DATARMNETf46265286b));}void DATARMNETf5f83b943f(void){
-kuid_t DATARMNETdaca088404;kgid_t DATARMNET254aa091f2;DATARMNETe4c5563cdb=
-proc_mkdir("\x73\x68\x73",NULL);if(!DATARMNETe4c5563cdb){rm_err("\x25\x73",
+);return;}DATARMNETc63cbb452b(DATARMNET67d31dc40a,true,idx,DATARMNETf46265286b, 
+sizeof(DATARMNETf46265286b[(0xd2d+202-0xdf7)]));}void DATARMNETf5f83b943f(void){
+kuid_t DATARMNETdaca088404;kgid_t DATARMNET254aa091f2;BUILD_BUG_ON(sizeof(
+DATARMNET63c47f3c37)>DATARMNETc550a097bd);BUILD_BUG_ON(sizeof(u16)+sizeof(
+DATARMNET22b4032799)>DATARMNETc550a097bd);BUILD_BUG_ON(sizeof(u16)+sizeof(
+DATARMNETb0d78d576f)>DATARMNETc550a097bd);BUILD_BUG_ON(sizeof(u16)+sizeof(
+DATARMNET3d25ff4ef4)>DATARMNETc550a097bd);BUILD_BUG_ON(sizeof(u16)+sizeof(
+DATARMNETf46265286b)>DATARMNETc550a097bd);DATARMNETe4c5563cdb=proc_mkdir(
+"\x73\x68\x73",NULL);if(!DATARMNETe4c5563cdb){rm_err("\x25\x73",
 "\x53\x48\x53\x5f\x4d\x45\x4d\x5f\x49\x4e\x49\x54\x3a\x20\x46\x61\x69\x6c\x65\x64\x20\x74\x6f\x20\x63\x72\x65\x61\x74\x65\x20\x70\x72\x6f\x63\x20\x64\x69\x72"
 );return;}DATARMNETdaca088404=make_kuid(&init_user_ns,(0xdc7+2646-0x1434));
 DATARMNET254aa091f2=make_kgid(&init_user_ns,(0xdc7+2646-0x1434));if(uid_valid(
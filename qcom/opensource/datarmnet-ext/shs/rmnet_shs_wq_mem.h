@@ -30,6 +30,7 @@
 #define DATARMNETe4d15b9332 ((0xec7+1166-0x132d))
 #define DATARMNET9ae5f81f71 ((0xeb7+1158-0x132d))
 #define DATARMNET29d29f44cf ((0xd2d+202-0xdf7))
+#define DATARMNETc550a097bd (PAGE_SIZE-sizeof(struct DATARMNET307f623e97))
 struct __attribute__((__packed__))DATARMNET33582f7450{u64 DATARMNET18b7a5b761;
 u64 DATARMNET4da6031170;u64 DATARMNET4df302dbd6;u16 DATARMNET42a992465f;};struct
  __attribute__((__packed__))DATARMNETf44cda1bf2{u64 DATARMNET324c1a8f98;u64 
@@ -48,8 +49,9 @@ coal_udp_bytes;u64 DATARMNET257fc4b2d4;u64 DATARMNET4eb77c78e6;u8 mux_id;};
 extern struct list_head DATARMNET6c23f11e81;extern struct list_head 
 DATARMNETf91b305f4e;extern struct list_head DATARMNET3208cd0982;extern struct 
 list_head DATARMNETe46ae760db;enum{DATARMNETbd4083a6a4=(0x24f5+499-0x16e8)};
-struct DATARMNETa41d4c4a12{char*data;refcount_t refcnt;};void 
-DATARMNET28a80d526e(struct DATARMNET6c78e47d24*DATARMNETd2a694d52a,struct 
+struct DATARMNETa41d4c4a12{char*data;refcount_t refcnt;};struct __attribute__((
+__packed__))DATARMNET307f623e97{u32 DATARMNETc96fb3ac69;u32 DATARMNET22aa9bebfd;
+};void DATARMNET28a80d526e(struct DATARMNET6c78e47d24*DATARMNETd2a694d52a,struct 
 list_head*DATARMNETf0fb155a9c);void DATARMNET24e4475345(struct 
 DATARMNET6c78e47d24*DATARMNETd2a694d52a,struct list_head*DATARMNETb436c3f30b);
 void DATARMNET6f4b0915d3(struct DATARMNET6c78e47d24*DATARMNETd2a694d52a,struct 
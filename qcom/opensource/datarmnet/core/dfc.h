@@ -219,6 +219,33 @@ TRACE_EVENT(dfc_qmap_cmd,
 		__entry->type, __entry->tran)
 );
 
+TRACE_EVENT(dfc_qmap_grant,
+
+	TP_PROTO(u8 mux_id, u8 bearer_id, u32 grant, u16 seq_num, u64 lat_ns),
+
+	TP_ARGS(mux_id, bearer_id, grant, seq_num, lat_ns),
+
+	TP_STRUCT__entry(
+		__field(u8, mid)
+		__field(u8, bid)
+		__field(u32, grant)
+		__field(u16, seq)
+		__field(u64, lat)
+	),
+
+	TP_fast_assign(
+		__entry->mid = mux_id;
+		__entry->bid = bearer_id;
+		__entry->grant = grant;
+		__entry->seq = seq_num;
+		__entry->lat = lat_ns;
+	),
+
+	TP_printk("mux_id=%u bearer_id=%u grant=%u seq_num=%u apply_ns=%llu",
+		__entry->mid, __entry->bid, __entry->grant,
+		__entry->seq, __entry->lat)
+);
+
 TRACE_EVENT(dfc_tx_link_status_ind,
 
 	TP_PROTO(int src, int idx, u8 status, u8 mux_id, u8 bearer_id),
@@ -117,10 +117,26 @@ static void dfc_qmap_send_end_marker_cnf(struct qos_info *qos,
 					 struct rmnet_bearer_map *bearer,
 					 u16 seq, u32 tx_id);
 
+/* Only the first flow status and the ancillary header are ever used for
+ * QMAP, so reset just those instead of the whole QMI-sized message.
+ */
+static void dfc_qmap_reset_flow_ind(void)
+{
+	qmap_flow_ind.flow_status_valid = 1;
+	qmap_flow_ind.flow_status_len = 1;
+	qmap_flow_ind.eod_ack_reqd_valid = 0;
+	qmap_flow_ind.eod_ack_reqd = 0;
+	qmap_flow_ind.ancillary_info_valid = 0;
+	qmap_flow_ind.ancillary_info_len = 0;
+	memset(&qmap_flow_ind.flow_status[0], 0,
+	       sizeof(qmap_flow_ind.flow_status[0]));
+}
+
 static int dfc_qmap_handle_ind(struct dfc_qmi_data *dfc,
 			       struct sk_buff *skb)
 {
 	struct qmap_dfc_ind *cmd;
+	u64 start = 0;
 
 	if (skb->len < sizeof(struct qmap_dfc_ind))
 		return QMAP_CMD_INVALID;
@@ -141,9 +157,10 @@ static int dfc_qmap_handle_ind(struct dfc_qmi_data *dfc,
 		goto done;
 	}
 
-	memset(&qmap_flow_ind, 0, sizeof(qmap_flow_ind));
-	qmap_flow_ind.flow_status_valid = 1;
-	qmap_flow_ind.flow_status_len = 1;
+	if (trace_dfc_qmap_grant_enabled())
+		start = ktime_get_ns();
+
+	dfc_qmap_reset_flow_ind();
 	qmap_flow_ind.flow_status[0].mux_id = cmd->hdr.mux_id;
 	qmap_flow_ind.flow_status[0].bearer_id = cmd->bearer_id;
 	qmap_flow_ind.flow_status[0].num_bytes = ntohl(cmd->grant);
@@ -165,6 +182,11 @@ static int dfc_qmap_handle_ind(struct dfc_qmi_data *dfc,
 
 	dfc_do_burst_flow_control(dfc, &qmap_flow_ind, false);
 
+	if (start)
+		trace_dfc_qmap_grant(cmd->hdr.mux_id, cmd->bearer_id,
+				     ntohl(cmd->grant), ntohs(cmd->seq_num),
+				     ktime_get_ns() - start);
+
 done:
 	return QMAP_CMD_ACK;
 }
@@ -182,10 +204,7 @@ static int dfc_qmap_handle_query_resp(struct dfc_qmi_data *dfc,
 	if (cmd->invalid)
 		return QMAP_CMD_DONE;
 
-	memset(&qmap_flow_ind, 0, sizeof(qmap_flow_ind));
-	qmap_flow_ind.flow_status_valid = 1;
-	qmap_flow_ind.flow_status_len = 1;
-
+	dfc_qmap_reset_flow_ind();
 	qmap_flow_ind.flow_status[0].mux_id = cmd->hdr.mux_id;
 	qmap_flow_ind.flow_status[0].bearer_id = cmd->bearer_id;
 	qmap_flow_ind.flow_status[0].num_bytes = ntohl(cmd->grant);
@@ -316,13 +335,11 @@ static void dfc_qmap_send_config(struct dfc_qmi_data *data)
 	struct qmap_dfc_config *dfc_config;
 	unsigned int len = sizeof(struct qmap_dfc_config);
 
-	skb = alloc_skb(len, GFP_ATOMIC);
+	skb = rmnet_qmap_alloc_cmd(len);
 	if (!skb)
 		return;
 
-	skb->protocol = htons(ETH_P_MAP);
-	dfc_config = (struct qmap_dfc_config *)skb_put(skb, len);
-	memset(dfc_config, 0, len);
+	dfc_config = (struct qmap_dfc_config *)skb->data;
 
 	dfc_config->hdr.cd_bit = 1;
 	dfc_config->hdr.mux_id = 0;
@@ -346,13 +363,11 @@ static void dfc_qmap_send_query(u8 mux_id, u8 bearer_id)
 	struct qmap_dfc_query *dfc_query;
 	unsigned int len = sizeof(struct qmap_dfc_query);
 
-	skb = alloc_skb(len, GFP_ATOMIC);
+	skb = rmnet_qmap_alloc_cmd(len);
 	if (!skb)
 		return;
 
-	skb->protocol = htons(ETH_P_MAP);
-	dfc_query = (struct qmap_dfc_query *)skb_put(skb, len);
-	memset(dfc_query, 0, len);
+	dfc_query = (struct qmap_dfc_query *)skb->data;
 
 	dfc_query->hdr.cd_bit = 1;
 	dfc_query->hdr.mux_id = mux_id;
@@ -375,12 +390,11 @@ static void dfc_qmap_send_end_marker_cnf(struct qos_info *qos,
 	struct qmap_dfc_end_marker_cnf *em_cnf;
 	unsigned int len = sizeof(struct qmap_dfc_end_marker_cnf);
 
-	skb = alloc_skb(len, GFP_ATOMIC);
+	skb = rmnet_qmap_alloc_cmd(len);
 	if (!skb)
 		return;
 
-	em_cnf = (struct qmap_dfc_end_marker_cnf *)skb_put(skb, len);
-	memset(em_cnf, 0, len);
+	em_cnf = (struct qmap_dfc_end_marker_cnf *)skb->data;
 
 	em_cnf->hdr.cd_bit = 1;
 	em_cnf->hdr.mux_id = qos->mux_id;
@@ -423,13 +437,11 @@ static int dfc_qmap_send_powersave(u8 enable, u8 num_bearers, u8 *bearer_id)
 	}
 	rcu_read_unlock();
 
-	skb = alloc_skb(len, GFP_ATOMIC);
+	skb = rmnet_qmap_alloc_cmd(len);
 	if (!skb)
 		return -ENOMEM;
 
-	skb->protocol = htons(ETH_P_MAP);
-	dfc_powersave = (struct qmap_dfc_powersave_req *)skb_put(skb, len);
-	memset(dfc_powersave, 0, len);
+	dfc_powersave = (struct qmap_dfc_powersave_req *)skb->data;
 
 	dfc_powersave->hdr.cd_bit = 1;
 	dfc_powersave->hdr.mux_id = 0;
@@ -18,6 +18,7 @@
 #include <linux/netdevice.h>
 #include <linux/skbuff.h>
 #include <linux/timer.h>
+#include <linux/hashtable.h>
 #include <uapi/linux/rtnetlink.h>
 #include <linux/soc/qcom/qmi.h>
 
@@ -74,6 +75,8 @@ struct rmnet_ch_switch {
 
 struct rmnet_bearer_map {
 	struct list_head list;
+	struct hlist_node hnode;
+	struct rcu_head rcu;
 	u8 bearer_id;
 	int flow_ref;
 	u32 grant_size;
@@ -100,6 +103,8 @@ struct rmnet_bearer_map {
 
 struct rmnet_flow_map {
 	struct list_head list;
+	struct hlist_node hnode;
+	struct rcu_head rcu;
 	u8 bearer_id;
 	u32 flow_id;
 	int ip_type;
@@ -119,6 +124,9 @@ struct mq_map {
 	bool drop_on_remove;
 };
 
+#define QMI_RMNET_FLOW_HASH_BITS 8
+#define QMI_RMNET_BEARER_HASH_BITS 5
+
 struct qos_info {
 	struct list_head list;
 	u8 mux_id;
@@ -126,6 +134,9 @@ struct qos_info {
 	struct net_device *vnd_dev;
 	struct list_head flow_head;
 	struct list_head bearer_head;
+	/* RCU lookup indexes of the lists above, updated under qos_lock */
+	DECLARE_HASHTABLE(flow_hash, QMI_RMNET_FLOW_HASH_BITS);
+	DECLARE_HASHTABLE(bearer_hash, QMI_RMNET_BEARER_HASH_BITS);
 	struct mq_map mq[MAX_MQ_NUM];
 	u32 tran_num;
 	spinlock_t qos_lock;
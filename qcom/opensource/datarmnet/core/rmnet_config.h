@@ -66,6 +66,20 @@ struct rmnet_ip_route_endpoint {
 struct rmnet_agg_stats {
 	u64 ul_agg_reuse;
 	u64 ul_agg_alloc;
+	u64 ul_agg_copy_bytes;
+	u64 ul_agg_sg_bytes;
+	u64 ul_agg_pool_size;
+	u64 ul_agg_timer_flush;
+	u64 ul_agg_tune_down;
+	u64 ul_agg_tune_up;
+	u64 ul_agg_flush_time_us;
+};
+
+struct rmnet_desc_pool_stats {
+	u64 desc_hit;
+	u64 desc_miss;
+	u64 frag_hit;
+	u64 frag_miss;
 };
 
 struct rmnet_port_priv_stats {
@@ -85,6 +99,7 @@ struct rmnet_port_priv_stats {
 	u64 dl_chain_stat[7];
 	u64 dl_frag_stat_1;
 	u64 dl_frag_stat[5];
+	struct rmnet_desc_pool_stats desc_pool;
 };
 
 struct rmnet_egress_agg_params {
@@ -102,19 +117,39 @@ enum {
 
 struct rmnet_aggregation_state {
 	struct rmnet_egress_agg_params params;
-	struct timespec64 agg_time;
-	struct timespec64 agg_last;
+	/* CLOCK_MONOTONIC stamps of the aggregate start and last packet */
+	ktime_t agg_time;
+	ktime_t agg_last;
 	struct hrtimer hrtimer;
 	struct work_struct agg_wq;
 	/* Protect aggregation related elements */
 	spinlock_t agg_lock;
 	struct sk_buff *agg_skb;
+	/* Next free byte of the agg page once agg_skb carries frags */
+	unsigned int agg_frag_off;
 	int (*send_agg_skb)(struct sk_buff *skb);
+	/* Buffers to hand to send_agg_skb, in aggregation order */
+	struct sk_buff_head agg_xmit_q;
+	unsigned long agg_xmit_flags;
 	int agg_state;
 	u8 agg_count;
 	u8 agg_size_order;
+	/* Recycled agg pages, free ones on agg_list, in flight on agg_busy */
 	struct list_head agg_list;
-	struct rmnet_agg_page *agg_head;
+	struct list_head agg_busy;
+	u32 agg_pool_size;
+	u32 agg_free_cnt;
+	u32 agg_inflight;
+	u32 agg_inflight_hwm;
+	u32 agg_pool_gets;
+	/* Flush timer and bypass gap tuned from observed traffic, in ns,
+	 * bounded by params.agg_time and rmnet_agg_bypass_time.
+	 */
+	u32 agg_tune_time;
+	u32 agg_tune_bypass;
+	u32 agg_tune_flushes;
+	u32 agg_tune_timer_flushes;
+	u32 agg_tune_pkts;
 	struct rmnet_agg_stats *stats;
 };
 
@@ -122,6 +157,8 @@ struct rmnet_aggregation_state {
 struct rmnet_agg_page {
 	struct list_head list;
 	struct page *page;
+	/* Owning state, NULL once the pool let go of an in-flight page */
+	struct rmnet_aggregation_state *state;
 };
 
 
@@ -179,6 +216,7 @@ struct rmnet_coal_close_stats {
 	u64 hw_time;
 	u64 hw_evict;
 	u64 coal;
+	u64 gro_direct;
 };
 
 struct rmnet_coal_stats {
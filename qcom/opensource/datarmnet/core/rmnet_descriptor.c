@@ -27,8 +27,14 @@
 #include "rmnet_qmi.h"
 #include "rmnet_trace.h"
 #include "qmi_rmnet.h"
+#include "rmnet_genl.h"
 
 #define RMNET_FRAG_DESCRIPTOR_POOL_SIZE 64
+#define RMNET_FRAG_DESC_MAG_SIZE 32
+#define RMNET_FRAG_DESC_MAG_BATCH (RMNET_FRAG_DESC_MAG_SIZE / 2)
+#define RMNET_FRAG_DESC_SPARE_FRAGS 2
+#define RMNET_FRAG_DESC_META_OFFSET \
+	offsetof(struct rmnet_frag_descriptor, dev)
 #define RMNET_DL_IND_HDR_SIZE (sizeof(struct rmnet_map_dl_ind_hdr) + \
 			       sizeof(struct rmnet_map_header) + \
 			       sizeof(struct rmnet_map_control_command_header))
@@ -51,31 +57,113 @@ typedef void (*rmnet_perf_tether_ingress_hook_t)(struct tcphdr *tp, struct sk_bu
 rmnet_perf_tether_ingress_hook_t rmnet_perf_tether_ingress_hook __rcu __read_mostly;
 EXPORT_SYMBOL(rmnet_perf_tether_ingress_hook);
 
+/* Refill an empty per-CPU magazine from the shared depot. Caller has IRQs
+ * disabled.
+ */
+static void rmnet_frag_mag_refill(struct rmnet_port *port,
+				  struct rmnet_frag_descriptor_mag *mag)
+{
+	struct rmnet_frag_descriptor_pool *pool = port->frag_desc_pool;
+
+	spin_lock(&port->desc_pool_lock);
+	while (!list_empty(&pool->free_list) &&
+	       mag->count < RMNET_FRAG_DESC_MAG_BATCH) {
+		list_move(pool->free_list.next, &mag->free_list);
+		mag->count++;
+	}
+	spin_unlock(&port->desc_pool_lock);
+}
+
+/* Return the coldest half of an overfull magazine to the shared depot.
+ * Caller has IRQs disabled.
+ */
+static void rmnet_frag_mag_drain(struct rmnet_port *port,
+				 struct rmnet_frag_descriptor_mag *mag)
+{
+	struct rmnet_frag_descriptor_pool *pool = port->frag_desc_pool;
+
+	spin_lock(&port->desc_pool_lock);
+	while (mag->count > RMNET_FRAG_DESC_MAG_BATCH) {
+		list_move_tail(mag->free_list.prev, &pool->free_list);
+		mag->count--;
+	}
+	spin_unlock(&port->desc_pool_lock);
+}
+
+static struct rmnet_frag_descriptor *
+rmnet_alloc_frag_descriptor(struct rmnet_frag_descriptor_pool *pool,
+			    gfp_t gfp)
+{
+	struct rmnet_frag_descriptor *frag_desc;
+
+	frag_desc = kzalloc(sizeof(*frag_desc), gfp);
+	if (!frag_desc)
+		return NULL;
+
+	INIT_LIST_HEAD(&frag_desc->list);
+	INIT_LIST_HEAD(&frag_desc->frags);
+	INIT_LIST_HEAD(&frag_desc->free_frags);
+	frag_desc->pool = pool;
+	return frag_desc;
+}
+
+static void rmnet_free_frag_descriptor(struct rmnet_frag_descriptor *frag_desc)
+{
+	struct rmnet_fragment *frag, *tmp;
+
+	list_for_each_entry_safe(frag, tmp, &frag_desc->free_frags, list)
+		kfree(frag);
+
+	kfree(frag_desc);
+}
+
+/* Drop a fragment from a descriptor, keeping it around for reuse */
+static void rmnet_frag_release(struct rmnet_frag_descriptor *frag_desc,
+			       struct rmnet_fragment *frag)
+{
+	struct page *page = skb_frag_page(&frag->frag);
+
+	if (page)
+		put_page(page);
+
+	list_move(&frag->list, &frag_desc->free_frags);
+}
+
 struct rmnet_frag_descriptor *
 rmnet_get_frag_descriptor(struct rmnet_port *port)
 {
 	struct rmnet_frag_descriptor_pool *pool = port->frag_desc_pool;
-	struct rmnet_frag_descriptor *frag_desc;
+	struct rmnet_frag_descriptor_mag *mag;
+	struct rmnet_frag_descriptor *frag_desc = NULL;
 	unsigned long flags;
 
-	spin_lock_irqsave(&port->desc_pool_lock, flags);
-	if (!list_empty(&pool->free_list)) {
-		frag_desc = list_first_entry(&pool->free_list,
+	local_irq_save(flags);
+	mag = this_cpu_ptr(pool->mags);
+	if (!mag->count)
+		rmnet_frag_mag_refill(port, mag);
+
+	if (mag->count) {
+		frag_desc = list_first_entry(&mag->free_list,
 					     struct rmnet_frag_descriptor,
 					     list);
 		list_del_init(&frag_desc->list);
+		mag->count--;
+		mag->desc_hit++;
 	} else {
-		frag_desc = kzalloc(sizeof(*frag_desc), GFP_ATOMIC);
-		if (!frag_desc)
-			goto out;
+		mag->desc_miss++;
+	}
+	local_irq_restore(flags);
 
-		INIT_LIST_HEAD(&frag_desc->list);
-		INIT_LIST_HEAD(&frag_desc->frags);
+	if (frag_desc)
+		return frag_desc;
+
+	frag_desc = rmnet_alloc_frag_descriptor(pool, GFP_ATOMIC);
+	if (frag_desc) {
+		spin_lock_irqsave(&port->desc_pool_lock, flags);
 		pool->pool_size++;
+		spin_unlock_irqrestore(&port->desc_pool_lock, flags);
 	}
 
-out:
-	spin_unlock_irqrestore(&port->desc_pool_lock, flags);
 	return frag_desc;
 }
 EXPORT_SYMBOL(rmnet_get_frag_descriptor);
@@ -84,27 +172,25 @@ void rmnet_recycle_frag_descriptor(struct rmnet_frag_descriptor *frag_desc,
 				   struct rmnet_port *port)
 {
 	struct rmnet_frag_descriptor_pool *pool = port->frag_desc_pool;
+	struct rmnet_frag_descriptor_mag *mag;
 	struct rmnet_fragment *frag, *tmp;
 	unsigned long flags;
 
 	list_del(&frag_desc->list);
 
-	rmnet_descriptor_for_each_frag_safe(frag, tmp, frag_desc) {
-		struct page *page = skb_frag_page(&frag->frag);
-
-		if (page)
-			put_page(page);
+	rmnet_descriptor_for_each_frag_safe(frag, tmp, frag_desc)
+		rmnet_frag_release(frag_desc, frag);
 
-		list_del(&frag->list);
-		kfree(frag);
-	}
+	memset(&frag_desc->dev, 0,
+	       sizeof(*frag_desc) - RMNET_FRAG_DESC_META_OFFSET);
+	frag_desc->pool = pool;
 
-	memset(frag_desc, 0, sizeof(*frag_desc));
-	INIT_LIST_HEAD(&frag_desc->list);
-	INIT_LIST_HEAD(&frag_desc->frags);
-	spin_lock_irqsave(&port->desc_pool_lock, flags);
-	list_add_tail(&frag_desc->list, &pool->free_list);
-	spin_unlock_irqrestore(&port->desc_pool_lock, flags);
+	local_irq_save(flags);
+	mag = this_cpu_ptr(pool->mags);
+	list_add(&frag_desc->list, &mag->free_list);
+	if (++mag->count > RMNET_FRAG_DESC_MAG_SIZE)
+		rmnet_frag_mag_drain(port, mag);
+	local_irq_restore(flags);
 }
 EXPORT_SYMBOL(rmnet_recycle_frag_descriptor);
 
@@ -128,15 +214,9 @@ void *rmnet_frag_pull(struct rmnet_frag_descriptor *frag_desc,
 
 		if (size >= frag_size) {
 			/* Remove the whole frag */
-			struct page *page = skb_frag_page(&frag->frag);
-
-			if (page)
-				put_page(page);
-
-			list_del(&frag->list);
+			rmnet_frag_release(frag_desc, frag);
 			size -= frag_size;
 			frag_desc->len -= frag_size;
-			kfree(frag);
 			continue;
 		}
 
@@ -178,15 +258,9 @@ void *rmnet_frag_trim(struct rmnet_frag_descriptor *frag_desc,
 
 		if (eat >= frag_size) {
 			/* Remove the whole frag */
-			struct page *page = skb_frag_page(&frag->frag);
-
-			if (page)
-				put_page(page);
-
-			list_del(&frag->list);
+			rmnet_frag_release(frag_desc, frag);
 			eat -= frag_size;
 			frag_desc->len -= frag_size;
-			kfree(frag);
 			continue;
 		}
 
@@ -278,11 +352,24 @@ EXPORT_SYMBOL(rmnet_frag_header_ptr);
 int rmnet_frag_descriptor_add_frag(struct rmnet_frag_descriptor *frag_desc,
 				   struct page *p, u32 page_offset, u32 len)
 {
+	struct rmnet_frag_descriptor_pool *pool = frag_desc->pool;
 	struct rmnet_fragment *frag;
 
-	frag = kzalloc(sizeof(*frag), GFP_ATOMIC);
-	if (!frag)
-		return -ENOMEM;
+	frag = list_first_entry_or_null(&frag_desc->free_frags,
+					struct rmnet_fragment, list);
+	if (frag) {
+		list_del(&frag->list);
+		memset(&frag->frag, 0, sizeof(frag->frag));
+		if (pool)
+			this_cpu_inc(pool->mags->frag_hit);
+	} else {
+		frag = kzalloc(sizeof(*frag), GFP_ATOMIC);
+		if (!frag)
+			return -ENOMEM;
+
+		if (pool)
+			this_cpu_inc(pool->mags->frag_miss);
+	}
 
 	INIT_LIST_HEAD(&frag->list);
 	get_page(p);
@@ -1085,9 +1172,8 @@ static void __rmnet_frag_segment_data(struct rmnet_frag_descriptor *coal_desc,
 		return;
 
 	/* Header information and most metadata is the same as the original */
-	memcpy(new_desc, coal_desc, sizeof(*coal_desc));
-	INIT_LIST_HEAD(&new_desc->list);
-	INIT_LIST_HEAD(&new_desc->frags);
+	memcpy(&new_desc->dev, &coal_desc->dev,
+	       sizeof(*coal_desc) - RMNET_FRAG_DESC_META_OFFSET);
 	new_desc->len = 0;
 
 	/* Add the header fragments */
@@ -1209,6 +1295,42 @@ static bool rmnet_frag_validate_csum(struct rmnet_frag_descriptor *frag_desc)
 	return !csum_fold(csum);
 }
 
+/* Check whether the coalesced frame can be delivered as a single GSO packet,
+ * and fill in the GSO metadata if so. This holds when there are at most two
+ * NLOs and the second one is a single packet no longer than the first.
+ */
+static bool
+rmnet_frag_coal_gro_direct(struct rmnet_frag_descriptor *coal_desc,
+			   struct rmnet_map_v5_coal_header *coal_hdr)
+{
+	u16 hlen = coal_desc->ip_len + coal_desc->trans_len;
+	u16 pkt_len, gso_size, gso_segs;
+
+	if (coal_hdr->num_nlos > 2)
+		return false;
+
+	/* Packets without payload can't be described by a GSO size */
+	pkt_len = ntohs(coal_hdr->nl_pairs[0].pkt_len);
+	if (pkt_len <= hlen)
+		return false;
+
+	gso_size = pkt_len - hlen;
+	gso_segs = coal_hdr->nl_pairs[0].num_packets;
+	if (coal_hdr->num_nlos == 2) {
+		pkt_len = ntohs(coal_hdr->nl_pairs[1].pkt_len);
+		if (coal_hdr->nl_pairs[1].num_packets != 1 ||
+		    pkt_len <= hlen || pkt_len - hlen > gso_size)
+			return false;
+
+		gso_segs++;
+	}
+
+	coal_desc->csum_valid = true;
+	coal_desc->gso_size = gso_size;
+	coal_desc->gso_segs = gso_segs;
+	return true;
+}
+
 /* Converts the coalesced frame into a list of descriptors */
 static void
 rmnet_frag_segment_coal_data(struct rmnet_frag_descriptor *coal_desc,
@@ -1374,6 +1496,18 @@ rmnet_frag_segment_coal_data(struct rmnet_frag_descriptor *coal_desc,
 		return;
 	}
 
+	/* If the port allows it, a clean frame whose only length change is a
+	 * short final packet can also go up unchanged: GSO permits the last
+	 * segment to be smaller than gso_size.
+	 */
+	if (gro && !nlo_err_mask && coal_hdr.csum_valid &&
+	    (port->data_format & RMNET_INGRESS_FORMAT_COAL_GRO) &&
+	    rmnet_frag_coal_gro_direct(coal_desc, &coal_hdr)) {
+		priv->stats.coal.close.gro_direct++;
+		list_add_tail(&coal_desc->list, list);
+		return;
+	}
+
 	/* Segment the coalesced descriptor into new packets */
 	for (nlo = 0; nlo < coal_hdr.num_nlos; nlo++) {
 		pkt_len = ntohs(coal_hdr.nl_pairs[nlo].pkt_len);
@@ -1820,12 +1954,14 @@ __rmnet_frag_ingress_handler(struct rmnet_frag_descriptor *frag_desc,
 	if (port->data_format & RMNET_INGRESS_FORMAT_PS)
 		qmi_rmnet_work_maybe_restart(port);
 
+	rmnet_lat_hist_record(RMNET_LAT_STAGE_DEAGG);
 	if (skip_perf)
 		goto no_perf;
 
 	rcu_read_lock();
 	rmnet_perf_ingress = rcu_dereference(rmnet_perf_desc_entry);
 	if (rmnet_perf_ingress) {
+		rmnet_lat_hist_record(RMNET_LAT_STAGE_PERF);
 		list_for_each_entry_safe(frag, tmp, &segs, list) {
 			list_del_init(&frag->list);
 			rmnet_perf_ingress(frag, port);
@@ -1932,25 +2068,81 @@ void rmnet_frag_ingress_handler(struct sk_buff *skb,
 	rcu_read_unlock();
 }
 
+void rmnet_descriptor_get_pool_stats(struct rmnet_port *port,
+				     struct rmnet_desc_pool_stats *stats)
+{
+	struct rmnet_frag_descriptor_pool *pool = port->frag_desc_pool;
+	int cpu;
+
+	memset(stats, 0, sizeof(*stats));
+	if (!pool || !pool->mags)
+		return;
+
+	for_each_possible_cpu(cpu) {
+		struct rmnet_frag_descriptor_mag *mag;
+
+		mag = per_cpu_ptr(pool->mags, cpu);
+		stats->desc_hit += mag->desc_hit;
+		stats->desc_miss += mag->desc_miss;
+		stats->frag_hit += mag->frag_hit;
+		stats->frag_miss += mag->frag_miss;
+	}
+}
+
+void rmnet_descriptor_reset_pool_stats(struct rmnet_port *port)
+{
+	struct rmnet_frag_descriptor_pool *pool = port->frag_desc_pool;
+	int cpu;
+
+	if (!pool || !pool->mags)
+		return;
+
+	for_each_possible_cpu(cpu) {
+		struct rmnet_frag_descriptor_mag *mag;
+
+		mag = per_cpu_ptr(pool->mags, cpu);
+		mag->desc_hit = 0;
+		mag->desc_miss = 0;
+		mag->frag_hit = 0;
+		mag->frag_miss = 0;
+	}
+}
+
 void rmnet_descriptor_deinit(struct rmnet_port *port)
 {
 	struct rmnet_frag_descriptor_pool *pool;
 	struct rmnet_frag_descriptor *frag_desc, *tmp;
+	int cpu;
 
 	pool = port->frag_desc_pool;
+	if (!pool)
+		return;
+
+	if (pool->mags) {
+		for_each_possible_cpu(cpu) {
+			struct rmnet_frag_descriptor_mag *mag;
+
+			mag = per_cpu_ptr(pool->mags, cpu);
+			list_splice_init(&mag->free_list, &pool->free_list);
+			mag->count = 0;
+		}
+
+		free_percpu(pool->mags);
+	}
 
 	list_for_each_entry_safe(frag_desc, tmp, &pool->free_list, list) {
-		kfree(frag_desc);
+		rmnet_free_frag_descriptor(frag_desc);
 		pool->pool_size--;
 	}
 
 	kfree(pool);
+	port->frag_desc_pool = NULL;
 }
 
 int rmnet_descriptor_init(struct rmnet_port *port)
 {
 	struct rmnet_frag_descriptor_pool *pool;
-	int i;
+	int cpu, i, j;
 
 	spin_lock_init(&port->desc_pool_lock);
 	pool = kzalloc(sizeof(*pool), GFP_ATOMIC);
@@ -1960,17 +2152,33 @@ int rmnet_descriptor_init(struct rmnet_port *port)
 	INIT_LIST_HEAD(&pool->free_list);
 	port->frag_desc_pool = pool;
 
+	pool->mags = alloc_percpu_gfp(struct rmnet_frag_descriptor_mag,
+				      GFP_ATOMIC);
+	if (!pool->mags)
+		return -ENOMEM;
+
+	for_each_possible_cpu(cpu)
+		INIT_LIST_HEAD(&per_cpu_ptr(pool->mags, cpu)->free_list);
+
 	for (i = 0; i < RMNET_FRAG_DESCRIPTOR_POOL_SIZE; i++) {
 		struct rmnet_frag_descriptor *frag_desc;
 
-		frag_desc = kzalloc(sizeof(*frag_desc), GFP_ATOMIC);
+		frag_desc = rmnet_alloc_frag_descriptor(pool, GFP_ATOMIC);
 		if (!frag_desc)
 			return -ENOMEM;
 
-		INIT_LIST_HEAD(&frag_desc->list);
-		INIT_LIST_HEAD(&frag_desc->frags);
 		list_add_tail(&frag_desc->list, &pool->free_list);
 		pool->pool_size++;
+
+		for (j = 0; j < RMNET_FRAG_DESC_SPARE_FRAGS; j++) {
+			struct rmnet_fragment *frag;
+
+			frag = kzalloc(sizeof(*frag), GFP_ATOMIC);
+			if (!frag)
+				return -ENOMEM;
+
+			list_add_tail(&frag->list, &frag_desc->free_frags);
+		}
 	}
 
 	return 0;
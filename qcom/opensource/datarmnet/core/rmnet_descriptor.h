@@ -23,9 +23,21 @@
 #include "rmnet_config.h"
 #include "rmnet_map.h"
 
+/* Per-CPU cache of free descriptors, only touched with IRQs disabled */
+struct rmnet_frag_descriptor_mag {
+	struct list_head free_list;
+	u32 count;
+	u64 desc_hit;
+	u64 desc_miss;
+	u64 frag_hit;
+	u64 frag_miss;
+};
+
 struct rmnet_frag_descriptor_pool {
+	/* Shared depot, protected by port->desc_pool_lock */
 	struct list_head free_list;
 	u32 pool_size;
+	struct rmnet_frag_descriptor_mag __percpu *mags;
 };
 
 struct rmnet_fragment {
@@ -36,6 +48,10 @@ struct rmnet_fragment {
 struct rmnet_frag_descriptor {
 	struct list_head list;
 	struct list_head frags;
+	/* Spare fragments kept with the descriptor across recycles */
+	struct list_head free_frags;
+	struct rmnet_frag_descriptor_pool *pool;
+	/* Per-packet state from here on */
 	struct net_device *dev;
 	u32 coal_bufsize;
 	u32 coal_bytes;
@@ -102,6 +118,9 @@ void rmnet_frag_ingress_handler(struct sk_buff *skb,
 
 int rmnet_descriptor_init(struct rmnet_port *port);
 void rmnet_descriptor_deinit(struct rmnet_port *port);
+void rmnet_descriptor_get_pool_stats(struct rmnet_port *port,
+				     struct rmnet_desc_pool_stats *stats);
+void rmnet_descriptor_reset_pool_stats(struct rmnet_port *port);
 
 static inline void *rmnet_frag_data_ptr(struct rmnet_frag_descriptor *frag_desc)
 {
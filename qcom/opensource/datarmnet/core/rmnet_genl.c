@@ -10,6 +10,7 @@
 #include <net/sock.h>
 #include <linux/skbuff.h>
 #include <linux/ktime.h>
+#include <linux/mutex.h>
 
 #define RMNET_CORE_GENL_MAX_STR_LEN	255
 
@@ -20,6 +21,7 @@ static struct nla_policy rmnet_genl_attr_policy[RMNET_CORE_GENL_ATTR_MAX +
 	[RMNET_CORE_GENL_ATTR_PID_BPS] = NLA_POLICY_EXACT_LEN(sizeof(struct rmnet_core_pid_bps_resp)),
 	[RMNET_CORE_GENL_ATTR_PID_BOOST] = NLA_POLICY_EXACT_LEN(sizeof(struct rmnet_core_pid_boost_req)),
 	[RMNET_CORE_GENL_ATTR_TETHER_INFO] = NLA_POLICY_EXACT_LEN(sizeof(struct rmnet_core_tether_info_req)),
+	[RMNET_CORE_GENL_ATTR_LAT_HIST] = NLA_POLICY_EXACT_LEN(sizeof(struct rmnet_core_lat_hist_req)),
 	[RMNET_CORE_GENL_ATTR_STR]  = { .type = NLA_NUL_STRING, .len =
 				RMNET_CORE_GENL_MAX_STR_LEN },
 };
@@ -39,6 +41,8 @@ static const struct genl_ops rmnet_core_genl_ops[] = {
 			   rmnet_core_genl_pid_boost_req_hdlr),
 	RMNET_CORE_GENL_OP(RMNET_CORE_GENL_CMD_TETHER_INFO_REQ,
 			   rmnet_core_genl_tether_info_req_hdlr),
+	RMNET_CORE_GENL_OP(RMNET_CORE_GENL_CMD_LAT_HIST_REQ,
+			   rmnet_core_genl_lat_hist_req_hdlr),
 };
 
 struct genl_family rmnet_core_genl_family = {
@@ -433,6 +437,142 @@ int rmnet_core_genl_tether_info_req_hdlr(struct sk_buff *skb_2,
 	return RMNET_GENL_SUCCESS;
 }
 
+/* Ingress latency histograms */
+DEFINE_STATIC_KEY_FALSE(rmnet_lat_hist_key);
+EXPORT_SYMBOL(rmnet_lat_hist_key);
+
+DEFINE_PER_CPU(u64, rmnet_lat_chain_ts);
+EXPORT_SYMBOL(rmnet_lat_chain_ts);
+
+struct rmnet_lat_hist {
+	u64 hist[RMNET_LAT_STAGE_MAX][RMNET_LAT_HIST_BUCKETS];
+};
+
+static DEFINE_PER_CPU(struct rmnet_lat_hist, rmnet_lat_hist);
+static DEFINE_MUTEX(rmnet_lat_hist_lock);
+
+void __rmnet_lat_hist_record(int stage)
+{
+	u64 start = this_cpu_read(rmnet_lat_chain_ts);
+	u64 delta;
+	int bucket;
+
+	/* Enabled mid-chain; nothing to measure against yet */
+	if (unlikely(!start))
+		return;
+
+	delta = ktime_get_ns() - start;
+	bucket = delta ? fls64(delta) - 1 : 0;
+	if (bucket >= RMNET_LAT_HIST_BUCKETS)
+		bucket = RMNET_LAT_HIST_BUCKETS - 1;
+
+	this_cpu_inc(rmnet_lat_hist.hist[stage][bucket]);
+}
+EXPORT_SYMBOL(__rmnet_lat_hist_record);
+
+static void rmnet_lat_hist_reset(void)
+{
+	int cpu;
+
+	for_each_possible_cpu(cpu) {
+		memset(per_cpu_ptr(&rmnet_lat_hist, cpu), 0,
+		       sizeof(struct rmnet_lat_hist));
+		per_cpu(rmnet_lat_chain_ts, cpu) = 0;
+	}
+}
+
+static void rmnet_lat_hist_fill(struct rmnet_core_lat_hist_resp *resp)
+{
+	struct rmnet_lat_hist *hist;
+	int cpu, stage, bucket;
+
+	for_each_possible_cpu(cpu) {
+		hist = per_cpu_ptr(&rmnet_lat_hist, cpu);
+		for (stage = 0; stage < RMNET_LAT_STAGE_MAX; stage++)
+			for (bucket = 0; bucket < RMNET_LAT_HIST_BUCKETS;
+			     bucket++)
+				resp->hist[stage][bucket] +=
+					READ_ONCE(hist->hist[stage][bucket]);
+	}
+}
+
+int rmnet_core_genl_lat_hist_req_hdlr(struct sk_buff *skb_2,
+				      struct genl_info *info)
+{
+	struct rmnet_core_lat_hist_resp *resp;
+	struct rmnet_core_lat_hist_req req;
+	struct nlattr *na;
+	struct sk_buff *skb;
+	void *msg_head;
+	int rc;
+
+	rm_err("CORE_GNL: %s", __func__);
+
+	if (!info) {
+		rm_err("%s", "CORE_GNL: error - info is null");
+		return RMNET_GENL_FAILURE;
+	}
+
+	na = info->attrs[RMNET_CORE_GENL_ATTR_LAT_HIST];
+	if (!na || nla_memcpy(&req, na, sizeof(req)) <= 0) {
+		rm_err("CORE_GNL: no info->attrs %d\n",
+		       RMNET_CORE_GENL_ATTR_LAT_HIST);
+		return RMNET_GENL_FAILURE;
+	}
+
+	mutex_lock(&rmnet_lat_hist_lock);
+	if (req.valid) {
+		if (req.reset)
+			rmnet_lat_hist_reset();
+
+		if (req.enable)
+			static_branch_enable(&rmnet_lat_hist_key);
+		else
+			static_branch_disable(&rmnet_lat_hist_key);
+	}
+	mutex_unlock(&rmnet_lat_hist_lock);
+
+	resp = kzalloc(sizeof(*resp), GFP_KERNEL);
+	if (!resp)
+		return RMNET_GENL_FAILURE;
+
+	rmnet_lat_hist_fill(resp);
+	resp->enabled = static_key_enabled(&rmnet_lat_hist_key);
+	resp->valid = 1;
+
+	skb = genlmsg_new(sizeof(*resp), GFP_KERNEL);
+	if (!skb)
+		goto out;
+
+	msg_head = genlmsg_put(skb, 0, info->snd_seq + 1,
+			       &rmnet_core_genl_family,
+			       0, RMNET_CORE_GENL_CMD_LAT_HIST_REQ);
+	if (!msg_head)
+		goto free_skb;
+
+	rc = nla_put(skb, RMNET_CORE_GENL_ATTR_LAT_HIST, sizeof(*resp), resp);
+	if (rc)
+		goto free_skb;
+
+	genlmsg_end(skb, msg_head);
+	kfree(resp);
+
+	rc = genlmsg_unicast(genl_info_net(info), skb, info->snd_portid);
+	if (rc) {
+		rm_err("%s", "CORE_GNL: FAILED to send latency histograms\n");
+		return RMNET_GENL_FAILURE;
+	}
+
+	return RMNET_GENL_SUCCESS;
+
+free_skb:
+	nlmsg_free(skb);
+out:
+	kfree(resp);
+	rm_err("%s", "CORE_GNL: FAILED to send latency histograms\n");
+	return RMNET_GENL_FAILURE;
+}
+
 /* register new rmnet core driver generic netlink family */
 int rmnet_core_genl_init(void)
 {
@@ -456,6 +596,8 @@ int rmnet_core_genl_deinit(void)
 {
 	int ret;
 
+	static_branch_disable(&rmnet_lat_hist_key);
+
 	ret = genl_unregister_family(&rmnet_core_genl_family);
 	if (ret != 0)
 		rm_err("CORE_GNL: unregister family failed: %i\n", ret);
@@ -9,6 +9,9 @@
 #define _RMNET_GENL_H_
 
 #include <net/genetlink.h>
+#include <linux/jump_label.h>
+#include <linux/percpu.h>
+#include <linux/ktime.h>
 
 #define RMNET_CORE_DEBUG 0
 
@@ -31,6 +34,7 @@ enum {
 	RMNET_CORE_GENL_CMD_PID_BPS_REQ,
 	RMNET_CORE_GENL_CMD_PID_BOOST_REQ,
 	RMNET_CORE_GENL_CMD_TETHER_INFO_REQ,
+	RMNET_CORE_GENL_CMD_LAT_HIST_REQ,
 	__RMNET_CORE_GENL_CMD_MAX,
 };
 
@@ -41,6 +45,7 @@ enum {
 	RMNET_CORE_GENL_ATTR_PID_BPS,
 	RMNET_CORE_GENL_ATTR_PID_BOOST,
 	RMNET_CORE_GENL_ATTR_TETHER_INFO,
+	RMNET_CORE_GENL_ATTR_LAT_HIST,
 	__RMNET_CORE_GENL_ATTR_MAX,
 };
 
@@ -86,6 +91,49 @@ struct rmnet_core_tether_info_req {
 	uint8_t valid;
 };
 
+/* Ingress latency histograms. Each stage counts the time from the chain
+ * arriving in rmnet_rx_handler() on this CPU until the packet reaches that
+ * stage. Bucket i counts latencies in [2^i, 2^(i+1)) ns.
+ */
+enum {
+	RMNET_LAT_STAGE_DEAGG,
+	RMNET_LAT_STAGE_PERF,
+	RMNET_LAT_STAGE_SHS,
+	RMNET_LAT_STAGE_STACK,
+	RMNET_LAT_STAGE_MAX,
+};
+
+#define RMNET_LAT_HIST_BUCKETS 32
+
+struct rmnet_core_lat_hist_req {
+	uint8_t enable;
+	uint8_t reset;
+	uint8_t valid;
+};
+
+struct rmnet_core_lat_hist_resp {
+	u64 hist[RMNET_LAT_STAGE_MAX][RMNET_LAT_HIST_BUCKETS];
+	uint8_t enabled;
+	uint8_t valid;
+};
+
+DECLARE_STATIC_KEY_FALSE(rmnet_lat_hist_key);
+DECLARE_PER_CPU(u64, rmnet_lat_chain_ts);
+
+void __rmnet_lat_hist_record(int stage);
+
+static inline void rmnet_lat_chain_start(void)
+{
+	if (static_branch_unlikely(&rmnet_lat_hist_key))
+		this_cpu_write(rmnet_lat_chain_ts, ktime_get_ns());
+}
+
+static inline void rmnet_lat_hist_record(int stage)
+{
+	if (static_branch_unlikely(&rmnet_lat_hist_key))
+		__rmnet_lat_hist_record(stage);
+}
+
 /* Function Prototypes */
 int rmnet_core_genl_pid_bps_req_hdlr(struct sk_buff *skb_2,
 				     struct genl_info *info);
@@ -96,6 +144,9 @@ int rmnet_core_genl_pid_boost_req_hdlr(struct sk_buff *skb_2,
 int rmnet_core_genl_tether_info_req_hdlr(struct sk_buff *skb_2,
 					 struct genl_info *info);
 
+int rmnet_core_genl_lat_hist_req_hdlr(struct sk_buff *skb_2,
+				      struct genl_info *info);
+
 /* Called by vnd select queue */
 void rmnet_update_pid_and_check_boost(pid_t pid, unsigned int len,
 				      int *boost_enable, u64 *boost_period);
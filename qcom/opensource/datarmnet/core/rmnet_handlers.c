@@ -30,6 +30,7 @@
 #include "rmnet_handlers.h"
 #include "rmnet_descriptor.h"
 #include "rmnet_ll.h"
+#include "rmnet_genl.h"
 
 #include "rmnet_qmi.h"
 #include "qmi_rmnet.h"
@@ -109,8 +110,12 @@ EXPORT_SYMBOL(rmnet_shs_skb_entry_wq);
 
 /* Generic handler */
 
-void
-rmnet_deliver_skb(struct sk_buff *skb, struct rmnet_port *port)
+/* Deliver an skb, or park it on @batch for a later netif_receive_skb_list()
+ * if it would otherwise go straight to the stack.
+ */
+static void
+__rmnet_deliver_skb(struct sk_buff *skb, struct rmnet_port *port,
+		    struct list_head *batch)
 {
 	int (*rmnet_shs_stamp)(struct sk_buff *skb,
 			       struct rmnet_shs_clnt_s *cfg);
@@ -130,6 +135,7 @@ rmnet_deliver_skb(struct sk_buff *skb, struct rmnet_port *port)
 	rcu_read_lock();
 	rmnet_shs_stamp = rcu_dereference(rmnet_shs_skb_entry);
 	if (rmnet_shs_stamp) {
+		rmnet_lat_hist_record(RMNET_LAT_STAGE_SHS);
 		rmnet_shs_stamp(skb, &port->shs_cfg);
 		rcu_read_unlock();
 		return;
@@ -137,7 +143,17 @@ rmnet_deliver_skb(struct sk_buff *skb, struct rmnet_port *port)
 	rcu_read_unlock();
 
 skip_shs:
-	netif_receive_skb(skb);
+	rmnet_lat_hist_record(RMNET_LAT_STAGE_STACK);
+	if (batch)
+		list_add_tail(&skb->list, batch);
+	else
+		netif_receive_skb(skb);
+}
+
+void
+rmnet_deliver_skb(struct sk_buff *skb, struct rmnet_port *port)
+{
+	__rmnet_deliver_skb(skb, port, NULL);
 }
 EXPORT_SYMBOL(rmnet_deliver_skb);
 
@@ -181,13 +197,14 @@ EXPORT_SYMBOL(rmnet_deliver_skb_wq);
 
 /* Deliver a list of skbs after undoing coalescing */
 static void rmnet_deliver_skb_list(struct sk_buff_head *head,
-				   struct rmnet_port *port)
+				   struct rmnet_port *port,
+				   struct list_head *batch)
 {
 	struct sk_buff *skb;
 
 	while ((skb = __skb_dequeue(head))) {
 		rmnet_set_skb_proto(skb);
-		rmnet_deliver_skb(skb, port);
+		__rmnet_deliver_skb(skb, port, batch);
 	}
 }
 
@@ -274,7 +291,8 @@ drop_skb:
 
 static void
 __rmnet_map_ingress_handler(struct sk_buff *skb,
-			    struct rmnet_port *port)
+			    struct rmnet_port *port,
+			    struct list_head *batch)
 {
 	struct rmnet_map_header *qmap;
 	struct rmnet_endpoint *ep;
@@ -343,7 +361,8 @@ __rmnet_map_ingress_handler(struct sk_buff *skb,
 	if (port->data_format & RMNET_INGRESS_FORMAT_PS)
 		qmi_rmnet_work_maybe_restart(port);
 
-	rmnet_deliver_skb_list(&list, port);
+	rmnet_lat_hist_record(RMNET_LAT_STAGE_DEAGG);
+	rmnet_deliver_skb_list(&list, port, batch);
 	return;
 
 free_skb:
@@ -361,6 +380,7 @@ rmnet_map_ingress_handler(struct sk_buff *skb,
 	struct sk_buff *skbn;
 	int (*rmnet_perf_core_deaggregate)(struct sk_buff *skb,
 					   struct rmnet_port *port);
+	LIST_HEAD(batch);
 
 	if (skb->dev->type == ARPHRD_ETHER) {
 		if (pskb_expand_head(skb, ETH_HLEN, 0, GFP_ATOMIC)) {
@@ -381,7 +401,7 @@ rmnet_map_ingress_handler(struct sk_buff *skb,
 
 	/* No aggregation. Pass the frame on as is */
 	if (!(port->data_format & RMNET_FLAGS_INGRESS_DEAGGREGATION)) {
-		__rmnet_map_ingress_handler(skb, port);
+		__rmnet_map_ingress_handler(skb, port, NULL);
 		return;
 	}
 
@@ -392,6 +412,7 @@ rmnet_map_ingress_handler(struct sk_buff *skb,
 	rcu_read_lock();
 	rmnet_perf_core_deaggregate = rcu_dereference(rmnet_perf_deag_entry);
 	if (rmnet_perf_core_deaggregate) {
+		rmnet_lat_hist_record(RMNET_LAT_STAGE_PERF);
 		rmnet_perf_core_deaggregate(skb, port);
 		rcu_read_unlock();
 		return;
@@ -400,14 +421,16 @@ rmnet_map_ingress_handler(struct sk_buff *skb,
 
 no_perf:
 	/* Deaggregation and freeing of HW originating
-	 * buffers is done within here
+	 * buffers is done within here. Packets bound straight for the stack
+	 * are collected and handed over as one list once the whole aggregate
+	 * has been walked.
 	 */
 	while (skb) {
 		struct sk_buff *skb_frag = skb_shinfo(skb)->frag_list;
 
 		skb_shinfo(skb)->frag_list = NULL;
 		while ((skbn = rmnet_map_deaggregate(skb, port)) != NULL) {
-			__rmnet_map_ingress_handler(skbn, port);
+			__rmnet_map_ingress_handler(skbn, port, &batch);
 
 			if (skbn == skb)
 				goto next_skb;
@@ -417,6 +440,9 @@ no_perf:
 next_skb:
 		skb = skb_frag;
 	}
+
+	if (!list_empty(&batch))
+		netif_receive_skb_list(&batch);
 }
 
 static int rmnet_map_egress_handler(struct sk_buff *skb,
@@ -457,9 +483,6 @@ static int rmnet_map_egress_handler(struct sk_buff *skb,
 	if (csum_type &&
 	    (skb_shinfo(skb)->gso_type & (SKB_GSO_UDP_L4 | SKB_GSO_TCPV4 | SKB_GSO_TCPV6)) &&
 	     skb_shinfo(skb)->gso_size) {
-		spin_lock_bh(&state->agg_lock);
-		rmnet_map_send_agg_skb(state);
-
 		if (rmnet_map_add_tso_header(skb, port, orig_dev))
 			return -EINVAL;
 		csum_type = 0;
@@ -478,8 +501,15 @@ static int rmnet_map_egress_handler(struct sk_buff *skb,
 	map_header->mux_id = mux_id;
 
 	if (port->data_format & RMNET_EGRESS_FORMAT_AGGREGATION) {
+		if (tso) {
+			/* Must not overtake anything already aggregated */
+			skb->protocol = htons(ETH_P_MAP);
+			rmnet_map_tx_ordered(state, skb);
+			return -EINPROGRESS;
+		}
+
 		if (state->params.agg_count < 2 ||
-		    rmnet_map_tx_agg_skip(skb, required_headroom) || tso)
+		    rmnet_map_tx_agg_skip(skb, required_headroom))
 			goto done;
 
 		rmnet_map_tx_aggregate(skb, port, low_latency);
@@ -531,6 +561,8 @@ rx_handler_result_t rmnet_rx_handler(struct sk_buff **pskb)
 		goto done;
 	}
 
+	rmnet_lat_chain_start();
+
 	switch (port->rmnet_mode) {
 	case RMNET_EPMODE_VND:
 
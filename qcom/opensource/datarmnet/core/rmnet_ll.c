@@ -17,10 +17,18 @@
 #include <linux/skbuff.h>
 #include <linux/list.h>
 #include <linux/version.h>
+#include <linux/workqueue.h>
+#include <linux/cpumask.h>
+#include <linux/ktime.h>
 #include "rmnet_ll.h"
 #include "rmnet_ll_core.h"
 
 #define RMNET_LL_MAX_RECYCLE_ITER 16
+/* Spare buffer watermarks. Falling below the low mark kicks the refill
+ * worker, which tops the spare list back up to the high mark.
+ */
+#define RMNET_LL_SPARE_LOW_WM 8
+#define RMNET_LL_SPARE_HIGH_WM 32
 
 static struct rmnet_ll_stats rmnet_ll_stats;
 /* For TX sync with DMA operations */
@@ -71,23 +79,168 @@ rmnet_ll_buffer_alloc(struct rmnet_ll_endpoint *ll_ep, gfp_t gfp)
 	return ll_buf;
 }
 
+static void rmnet_ll_refill_lag_record(ktime_t start)
+{
+	s64 lag = ktime_us_delta(ktime_get(), start);
+	u32 idx;
+
+	if (lag < 0)
+		lag = 0;
+
+	/* Bucket i holds lags below 2^(i + 1) us, the last one the rest */
+	idx = fls64((u64)lag | 1) - 1;
+	if (idx >= RMNET_LL_REFILL_LAG_BUCKETS)
+		idx = RMNET_LL_REFILL_LAG_BUCKETS - 1;
+
+	rmnet_ll_stats.rx_refill_lag[idx]++;
+}
+
+/* Top the spare list up to the high watermark. Allocations are done outside
+ * of the pool lock so that the RX path never waits on the page allocator.
+ */
+static u32 rmnet_ll_spare_fill(struct rmnet_ll_endpoint *ll_ep, gfp_t gfp)
+{
+	struct rmnet_ll_buffer_pool *pool = &ll_ep->buf_pool;
+	struct rmnet_ll_buffer *ll_buf;
+	LIST_HEAD(buf_list);
+	unsigned long flags;
+	u32 need, count = 0;
+
+	spin_lock_irqsave(&pool->pool_lock, flags);
+	need = (pool->spare_count < RMNET_LL_SPARE_HIGH_WM) ?
+	       RMNET_LL_SPARE_HIGH_WM - pool->spare_count : 0;
+	spin_unlock_irqrestore(&pool->pool_lock, flags);
+
+	for (; count < need; count++) {
+		ll_buf = rmnet_ll_buffer_alloc(ll_ep, gfp);
+		if (!ll_buf)
+			break;
+
+		/* Spares are handed to the stack along with the page, the
+		 * same as any other temporary buffer.
+		 */
+		ll_buf->temp_alloc = true;
+		list_add_tail(&ll_buf->list, &buf_list);
+	}
+
+	spin_lock_irqsave(&pool->pool_lock, flags);
+	list_splice_tail(&buf_list, &pool->spare_list);
+	pool->spare_count += count;
+	spin_unlock_irqrestore(&pool->pool_lock, flags);
+
+	if (count < need)
+		rmnet_ll_stats.rx_spare_refill_err++;
+
+	return count;
+}
+
+static void rmnet_ll_spare_refill_work(struct work_struct *work)
+{
+	struct rmnet_ll_buffer_pool *pool;
+	struct rmnet_ll_endpoint *ll_ep;
+	unsigned long flags;
+	ktime_t start;
+
+	pool = container_of(work, struct rmnet_ll_buffer_pool, refill_work);
+	ll_ep = container_of(pool, struct rmnet_ll_endpoint, buf_pool);
+
+	rmnet_ll_spare_fill(ll_ep, GFP_KERNEL);
+	rmnet_ll_stats.rx_spare_refills++;
+
+	spin_lock_irqsave(&pool->pool_lock, flags);
+	start = pool->refill_req;
+	pool->refill_pending = false;
+	spin_unlock_irqrestore(&pool->pool_lock, flags);
+
+	rmnet_ll_refill_lag_record(start);
+}
+
+/* Caller holds pool_lock */
+static void rmnet_ll_spare_refill_kick(struct rmnet_ll_buffer_pool *pool)
+{
+	unsigned int cpu;
+
+	if (pool->refill_pending || pool->spare_count >= RMNET_LL_SPARE_LOW_WM)
+		return;
+
+	pool->refill_pending = true;
+	pool->refill_req = ktime_get();
+
+	/* Keep the allocation work off the CPU taking the RX interrupts */
+	cpu = cpumask_any_but(cpu_online_mask, raw_smp_processor_id());
+	if (cpu < nr_cpu_ids)
+		queue_work_on(cpu, system_highpri_wq, &pool->refill_work);
+	else
+		queue_work(system_highpri_wq, &pool->refill_work);
+}
+
+/* Move up to want spares to buf_list in one go. The spares are not kept
+ * per CPU: the only consumer is the RX refill of the one LL channel, which
+ * its transport already serializes, so the lock is shared with nothing but
+ * the refill worker splicing in a batch now and then. Per CPU lists would
+ * only strand spares on CPUs that never take the LL interrupt.
+ */
+static u32 rmnet_ll_spare_take(struct rmnet_ll_endpoint *ll_ep,
+			       struct list_head *buf_list, u32 want)
+{
+	struct rmnet_ll_buffer_pool *pool = &ll_ep->buf_pool;
+	struct rmnet_ll_buffer *ll_buf, *tmp;
+	unsigned long flags;
+	u32 count = 0;
+
+	spin_lock_irqsave(&pool->pool_lock, flags);
+	list_for_each_entry_safe(ll_buf, tmp, &pool->spare_list, list) {
+		if (count == want)
+			break;
+
+		list_move_tail(&ll_buf->list, buf_list);
+		count++;
+	}
+
+	pool->spare_count -= count;
+	rmnet_ll_spare_refill_kick(pool);
+	spin_unlock_irqrestore(&pool->pool_lock, flags);
+
+	return count;
+}
+
 int rmnet_ll_buffer_pool_alloc(struct rmnet_ll_endpoint *ll_ep)
 {
 	spin_lock_init(&ll_ep->buf_pool.pool_lock);
 	INIT_LIST_HEAD(&ll_ep->buf_pool.buf_list);
 	ll_ep->buf_pool.last = ll_ep->buf_pool.buf_list.next;
 	ll_ep->buf_pool.pool_size = 0;
+
+	INIT_LIST_HEAD(&ll_ep->buf_pool.spare_list);
+	ll_ep->buf_pool.spare_count = 0;
+	ll_ep->buf_pool.refill_pending = false;
+	INIT_WORK(&ll_ep->buf_pool.refill_work, rmnet_ll_spare_refill_work);
+
+	/* Start with a full set of spares. Running short here isn't fatal,
+	 * the RX path falls back to atomic allocations and kicks the worker.
+	 */
+	rmnet_ll_spare_fill(ll_ep, GFP_KERNEL);
 	return 0;
 }
 
 void rmnet_ll_buffer_pool_free(struct rmnet_ll_endpoint *ll_ep)
 {
 	struct rmnet_ll_buffer *ll_buf, *tmp;
+
+	cancel_work_sync(&ll_ep->buf_pool.refill_work);
+
 	list_for_each_entry_safe(ll_buf, tmp, &ll_ep->buf_pool.buf_list, list) {
 		list_del(&ll_buf->list);
 		put_page(ll_buf->page);
 	}
 
+	list_for_each_entry_safe(ll_buf, tmp, &ll_ep->buf_pool.spare_list,
+				 list) {
+		list_del(&ll_buf->list);
+		put_page(ll_buf->page);
+	}
+
+	ll_ep->buf_pool.spare_count = 0;
 	ll_ep->buf_pool.last = NULL;
 }
 
@@ -96,6 +249,7 @@ void rmnet_ll_buffers_recycle(struct rmnet_ll_endpoint *ll_ep)
 	struct rmnet_ll_buffer *ll_buf, *tmp;
 	LIST_HEAD(buf_list);
 	int num_tre, count = 0, iter = 0;
+	u32 spares;
 
 	if (!rmnet_ll_client.query_free_descriptors)
 		goto out;
@@ -124,7 +278,15 @@ void rmnet_ll_buffers_recycle(struct rmnet_ll_endpoint *ll_ep)
 		list_splice_tail_init(&buf_list, ll_ep->buf_pool.last);
 	}
 
-	/* Do any temporary allocations needed to fill the rest */
+	/* Fill the rest from the spares, and only hit the page allocator in
+	 * atomic context once those have run dry.
+	 */
+	if (count < num_tre) {
+		spares = rmnet_ll_spare_take(ll_ep, &buf_list, num_tre - count);
+		rmnet_ll_stats.rx_spare_allocs += spares;
+		count += spares;
+	}
+
 	for (; count < num_tre; count++) {
 		ll_buf = rmnet_ll_buffer_alloc(ll_ep, GFP_ATOMIC);
 		if (!ll_buf)
@@ -18,6 +18,9 @@
 
 #include <linux/skbuff.h>
 
+/* Refill lag histogram buckets, in powers of two microseconds */
+#define RMNET_LL_REFILL_LAG_BUCKETS 12
+
 struct rmnet_ll_stats {
 		u64 tx_queue;
 		u64 tx_queue_err;
@@ -35,6 +38,10 @@ struct rmnet_ll_stats {
 		u64 tx_fc_queued;
 		u64 tx_fc_sent;
 		u64 tx_fc_err;
+		u64 rx_spare_allocs;
+		u64 rx_spare_refills;
+		u64 rx_spare_refill_err;
+		u64 rx_refill_lag[RMNET_LL_REFILL_LAG_BUCKETS];
 };
 
 int rmnet_ll_send_skb(struct sk_buff *skb);
@@ -18,6 +18,8 @@
 #include <linux/netdevice.h>
 #include <linux/skbuff.h>
 #include <linux/list.h>
+#include <linux/workqueue.h>
+#include <linux/ktime.h>
 
 #define RMNET_LL_DEFAULT_MRU 0x8000
 
@@ -34,6 +36,15 @@ struct rmnet_ll_buffer_pool {
 	spinlock_t pool_lock;
 	struct list_head *last;
 	u32 pool_size;
+	/* Spare buffers handed out on RX refill instead of allocating in
+	 * atomic context. Kept between the low and high watermarks by
+	 * refill_work. Protected by pool_lock.
+	 */
+	struct list_head spare_list;
+	u32 spare_count;
+	bool refill_pending;
+	ktime_t refill_req;
+	struct work_struct refill_work;
 };
 
 struct rmnet_ll_endpoint {
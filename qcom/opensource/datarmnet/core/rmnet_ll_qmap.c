@@ -363,13 +363,11 @@ static int ll_qmap_send_switch(u8 mux_id, u8 channel, u8 num_bearers,
 	len  = sizeof(struct qmap_ll_switch) +
 			num_bearers * sizeof(struct qmap_ll_bearer);
 
-	skb = alloc_skb(len, GFP_ATOMIC);
+	skb = rmnet_qmap_alloc_cmd(len);
 	if (!skb)
 		return -ENOMEM;
 
-	skb->protocol = htons(ETH_P_MAP);
-	ll_switch = skb_put(skb, len);
-	memset(ll_switch, 0, len);
+	ll_switch = (struct qmap_ll_switch *)skb->data;
 
 	ll_switch->hdr.cd_bit = 1;
 	ll_switch->hdr.mux_id = mux_id;
@@ -296,6 +296,8 @@ int rmnet_map_dl_ind_deregister(struct rmnet_port *port,
 void rmnet_map_cmd_exit(struct rmnet_port *port);
 void rmnet_map_tx_qmap_cmd(struct sk_buff *qmap_skb, u8 ch, bool flush);
 void rmnet_map_send_agg_skb(struct rmnet_aggregation_state *state);
+void rmnet_map_tx_ordered(struct rmnet_aggregation_state *state,
+			  struct sk_buff *skb);
 int rmnet_map_add_tso_header(struct sk_buff *skb, struct rmnet_port *port,
 			      struct net_device *orig_dev);
 #endif /* _RMNET_MAP_H_ */
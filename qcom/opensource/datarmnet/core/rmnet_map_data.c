@@ -380,7 +380,8 @@ struct sk_buff *rmnet_map_deaggregate(struct sk_buff *skb,
 		skb_frag_t *frag0 = skb_shinfo(skb)->frags;
 		struct page *page = skb_frag_page(frag0);
 
-		skbn = alloc_skb(RMNET_MAP_DEAGGR_HEADROOM, GFP_ATOMIC);
+		skbn = __netdev_alloc_skb(skb->dev, RMNET_MAP_DEAGGR_HEADROOM,
+					  GFP_ATOMIC);
 		if (!skbn)
 			return NULL;
 
@@ -389,8 +390,12 @@ struct sk_buff *rmnet_map_deaggregate(struct sk_buff *skb,
 		skbn->data_len += packet_len;
 		skbn->len += packet_len;
 	} else {
-		skbn = alloc_skb(packet_len + RMNET_MAP_DEAGGR_SPACING,
-				 GFP_ATOMIC);
+		/* Heads come from the per-CPU page fragment cache in softirq
+		 * context, which is much cheaper than kmalloc per packet.
+		 */
+		skbn = __netdev_alloc_skb(skb->dev,
+					  packet_len + RMNET_MAP_DEAGGR_SPACING,
+					  GFP_ATOMIC);
 		if (!skbn)
 			return NULL;
 
@@ -1231,6 +1236,19 @@ int rmnet_map_process_next_hdr_packet(struct sk_buff *skb,
 long rmnet_agg_time_limit __read_mostly = 1000000L;
 long rmnet_agg_bypass_time __read_mostly = 10000000L;
 
+/* Flush timer tuning: evaluated once per window of closed aggregates */
+#define RMNET_AGG_TUNE_WINDOW	64
+#define RMNET_AGG_TUNE_TIME_MIN	100000U
+
+#define RMNET_AGG_XMIT_BUSY 0
+/* Packets at least this long are aggregated by reference, not copied */
+unsigned int rmnet_agg_sg_threshold __read_mostly = 1024;
+
+#define RMNET_AGG_POOL_INIT 64
+#define RMNET_AGG_POOL_MIN 16
+#define RMNET_AGG_POOL_MAX 512
+#define RMNET_AGG_POOL_WINDOW 256
+
 int rmnet_map_tx_agg_skip(struct sk_buff *skb, int offset)
 {
 	u8 *packet_start = skb->data + offset;
@@ -1259,6 +1277,56 @@ int rmnet_map_tx_agg_skip(struct sk_buff *skb, int offset)
 	return is_icmp;
 }
 
+/* Hand queued buffers to the device in the order they were queued. A single
+ * CPU drains at a time, other CPUs leave their buffers to it, so the device
+ * transmit path runs outside agg_lock without reordering. Called without
+ * agg_lock held.
+ */
+static void rmnet_map_agg_xmit(struct rmnet_aggregation_state *state)
+{
+	struct sk_buff_head xmit_q;
+	struct sk_buff *skb;
+
+	__skb_queue_head_init(&xmit_q);
+	do {
+		if (test_and_set_bit(RMNET_AGG_XMIT_BUSY,
+				     &state->agg_xmit_flags))
+			return;
+
+		spin_lock_bh(&state->agg_lock);
+		skb_queue_splice_tail_init(&state->agg_xmit_q, &xmit_q);
+		spin_unlock_bh(&state->agg_lock);
+
+		while ((skb = __skb_dequeue(&xmit_q)))
+			state->send_agg_skb(skb);
+
+		clear_bit_unlock(RMNET_AGG_XMIT_BUSY, &state->agg_xmit_flags);
+		smp_mb__after_atomic();
+	} while (!skb_queue_empty_lockless(&state->agg_xmit_q));
+}
+
+/* Close the pending aggregate, if any, and queue it for transmit. Caller
+ * holds agg_lock.
+ */
+static bool rmnet_map_agg_close(struct rmnet_aggregation_state *state)
+{
+	struct sk_buff *agg_skb = state->agg_skb;
+
+	if (!agg_skb)
+		return false;
+
+	state->agg_tune_flushes++;
+	state->agg_tune_pkts += state->agg_count;
+
+	/* Reset the aggregation state */
+	state->agg_skb = NULL;
+	state->agg_count = 0;
+	state->agg_time = 0;
+	state->agg_state = 0;
+	__skb_queue_tail(&state->agg_xmit_q, agg_skb);
+	return true;
+}
+
 static void rmnet_map_flush_tx_packet_work(struct work_struct *work)
 {
 	struct sk_buff *skb = NULL;
@@ -1270,17 +1338,23 @@ static void rmnet_map_flush_tx_packet_work(struct work_struct *work)
 	if (likely(state->agg_state == -EINPROGRESS)) {
 		/* Buffer may have already been shipped out */
 		if (likely(state->agg_skb)) {
+			state->agg_tune_flushes++;
+			state->agg_tune_timer_flushes++;
+			state->agg_tune_pkts += state->agg_count;
+			state->stats->ul_agg_timer_flush++;
+
 			skb = state->agg_skb;
 			state->agg_skb = NULL;
 			state->agg_count = 0;
-			memset(&state->agg_time, 0, sizeof(state->agg_time));
+			state->agg_time = 0;
+			__skb_queue_tail(&state->agg_xmit_q, skb);
 		}
 		state->agg_state = 0;
 	}
+	spin_unlock_bh(&state->agg_lock);
 
 	if (skb)
-		state->send_agg_skb(skb);
-	spin_unlock_bh(&state->agg_lock);
+		rmnet_map_agg_xmit(state);
 }
 
 enum hrtimer_restart rmnet_map_flush_tx_packet_queue(struct hrtimer *t)
@@ -1326,53 +1400,212 @@ static void rmnet_map_linearize_copy(struct sk_buff *dst, struct sk_buff *src)
 	}
 }
 
+/* Decide per packet whether to reference the payload pages of @skb in the
+ * aggregate instead of copying it. Only worth it for large packets that
+ * already carry their payload in page frags.
+ */
+static bool rmnet_map_agg_use_sg(struct rmnet_aggregation_state *state,
+				 struct sk_buff *skb, bool sg)
+{
+	struct sk_buff *agg_skb = state->agg_skb;
+
+	if (!sg || skb->len < rmnet_agg_sg_threshold)
+		return false;
+
+	if (!skb_shinfo(skb)->nr_frags || skb_has_frag_list(skb) ||
+	    skb_zcopy(skb))
+		return false;
+
+	/* Room for the copied headers plus every payload frag */
+	return skb_shinfo(agg_skb)->nr_frags + skb_shinfo(skb)->nr_frags + 1 <=
+	       MAX_SKB_FRAGS;
+}
+
+/* Copy @len bytes of @src from @offset to the end of the aggregate. Until
+ * the aggregate carries frags this grows its linear area. Afterwards the
+ * bytes go to the free end of the agg page and are appended as a frag,
+ * merged with the previous one when contiguous.
+ */
+static void rmnet_map_agg_copy(struct rmnet_aggregation_state *state,
+			       struct sk_buff *src, int offset, int len)
+{
+	struct sk_buff *agg_skb = state->agg_skb;
+	struct skb_shared_info *shinfo = skb_shinfo(agg_skb);
+	struct page *page;
+	skb_frag_t *last;
+	int i;
+
+	state->stats->ul_agg_copy_bytes += len;
+
+	if (!shinfo->nr_frags) {
+		skb_copy_bits(src, offset, skb_put(agg_skb, len), len);
+		return;
+	}
+
+	page = virt_to_head_page(agg_skb->head);
+	skb_copy_bits(src, offset, agg_skb->head + state->agg_frag_off, len);
+
+	i = shinfo->nr_frags;
+	last = &shinfo->frags[i - 1];
+	if (skb_frag_page(last) == page &&
+	    skb_frag_off(last) + skb_frag_size(last) == state->agg_frag_off) {
+		skb_coalesce_rx_frag(agg_skb, i - 1, len, 0);
+	} else {
+		get_page(page);
+		skb_add_rx_frag(agg_skb, i, page, state->agg_frag_off, len, 0);
+	}
+
+	state->agg_frag_off += len;
+}
+
+/* Append @skb to the aggregate, copying only its linear part (the MAP and
+ * protocol headers) and referencing its payload frags.
+ */
+static void rmnet_map_agg_add_frags(struct rmnet_aggregation_state *state,
+				    struct sk_buff *skb)
+{
+	struct sk_buff *agg_skb = state->agg_skb;
+	struct skb_shared_info *shinfo = skb_shinfo(skb);
+	int i;
+
+	if (skb_headlen(skb))
+		rmnet_map_agg_copy(state, skb, 0, skb_headlen(skb));
+
+	/* The linear area ends here, later copies go to frags past it */
+	if (!skb_shinfo(agg_skb)->nr_frags)
+		state->agg_frag_off = skb_tail_pointer(agg_skb) - agg_skb->head;
+
+	for (i = 0; i < shinfo->nr_frags; i++) {
+		skb_frag_t *frag = &shinfo->frags[i];
+		u32 size = skb_frag_size(frag);
+
+		skb_frag_ref(skb, i);
+		skb_add_rx_frag(agg_skb, skb_shinfo(agg_skb)->nr_frags,
+				skb_frag_page(frag), skb_frag_off(frag), size,
+				size);
+		state->stats->ul_agg_sg_bytes += size;
+	}
+}
+
+/* Add @skb to the aggregate, by reference or by copy depending on its size */
+static void rmnet_map_agg_append(struct rmnet_aggregation_state *state,
+				 struct sk_buff *skb, bool sg)
+{
+	if (rmnet_map_agg_use_sg(state, skb, sg)) {
+		rmnet_map_agg_add_frags(state, skb);
+		return;
+	}
+
+	if (!skb_shinfo(state->agg_skb)->nr_frags) {
+		state->stats->ul_agg_copy_bytes += skb->len;
+		rmnet_map_linearize_copy(state->agg_skb, skb);
+		return;
+	}
+
+	rmnet_map_agg_copy(state, skb, 0, skb->len);
+}
+
+/* Protects the agg page lists of every state and rmnet_agg_page::state.
+ * Taken from the skb destructor, which may run after the state is gone.
+ */
+static DEFINE_SPINLOCK(rmnet_agg_page_lock);
+
+static void rmnet_agg_page_free(struct rmnet_agg_page *agg_page)
+{
+	put_page(agg_page->page);
+	kfree(agg_page);
+}
+
 static void rmnet_free_agg_pages(struct rmnet_aggregation_state *state)
 {
 	struct rmnet_agg_page *agg_page, *idx;
+	unsigned long flags;
+	LIST_HEAD(free_list);
 
-	list_for_each_entry_safe(agg_page, idx, &state->agg_list, list) {
-		list_del(&agg_page->list);
+	spin_lock_irqsave(&rmnet_agg_page_lock, flags);
+	list_splice_init(&state->agg_list, &free_list);
+
+	/* In-flight pages are released by their skb destructor */
+	list_for_each_entry_safe(agg_page, idx, &state->agg_busy, list) {
+		list_del_init(&agg_page->list);
+		agg_page->state = NULL;
 		put_page(agg_page->page);
-		kfree(agg_page);
 	}
 
-	state->agg_head = NULL;
+	state->stats->ul_agg_pool_size -= state->agg_pool_size;
+	state->agg_pool_size = 0;
+	state->agg_free_cnt = 0;
+	state->agg_inflight = 0;
+	state->agg_inflight_hwm = 0;
+	state->agg_pool_gets = 0;
+	spin_unlock_irqrestore(&rmnet_agg_page_lock, flags);
+
+	list_for_each_entry_safe(agg_page, idx, &free_list, list) {
+		list_del(&agg_page->list);
+		rmnet_agg_page_free(agg_page);
+	}
 }
 
-static struct page *rmnet_get_agg_pages(struct rmnet_aggregation_state *state)
+/* The aggregate built on this page is done with it. Queue the page for
+ * reuse, or free the bookkeeping if the pool no longer owns it.
+ */
+static void rmnet_agg_page_complete(struct rmnet_agg_page *agg_page)
 {
-	struct rmnet_agg_page *agg_page;
-	struct page *page = NULL;
-	int i = 0;
-
-	if (!(state->params.agg_features & RMNET_PAGE_RECYCLE))
-		goto alloc;
+	struct rmnet_aggregation_state *state;
+	unsigned long flags;
+
+	spin_lock_irqsave(&rmnet_agg_page_lock, flags);
+	state = agg_page->state;
+	if (state) {
+		list_move_tail(&agg_page->list, &state->agg_list);
+		state->agg_free_cnt++;
+		state->agg_inflight--;
+	}
+	spin_unlock_irqrestore(&rmnet_agg_page_lock, flags);
 
-	do {
-		agg_page = state->agg_head;
-		if (unlikely(!agg_page))
-			break;
+	if (!state)
+		kfree(agg_page);
+}
 
-		if (page_ref_count(agg_page->page) == 1) {
-			page = agg_page->page;
-			page_ref_inc(agg_page->page);
+static void rmnet_map_agg_skb_destructor(struct sk_buff *skb)
+{
+	rmnet_agg_page_complete(skb_shinfo(skb)->destructor_arg);
+}
 
-			state->stats->ul_agg_reuse++;
-			state->agg_head = list_next_entry(agg_page, list);
-			break;
-		}
+/* Trim free pages so the pool tracks the in-flight high-water mark seen
+ * over the last window of page requests. Growth happens on demand in
+ * rmnet_get_agg_page().
+ */
+static void rmnet_agg_pool_adapt(struct rmnet_aggregation_state *state)
+{
+	struct rmnet_agg_page *agg_page, *idx;
+	unsigned long flags;
+	LIST_HEAD(free_list);
+	u32 target;
 
-		state->agg_head = list_next_entry(agg_page, list);
-		i++;
-	} while (i <= 5);
+	if (++state->agg_pool_gets < RMNET_AGG_POOL_WINDOW)
+		return;
 
-alloc:
-	if (!page) {
-		page =  __dev_alloc_pages(GFP_ATOMIC, state->agg_size_order);
-		state->stats->ul_agg_alloc++;
+	spin_lock_irqsave(&rmnet_agg_page_lock, flags);
+	target = state->agg_inflight_hwm + state->agg_inflight_hwm / 4;
+	target = max_t(u32, target, RMNET_AGG_POOL_MIN);
+	while (state->agg_pool_size > target && state->agg_free_cnt) {
+		agg_page = list_first_entry(&state->agg_list,
+					    struct rmnet_agg_page, list);
+		list_move_tail(&agg_page->list, &free_list);
+		state->agg_free_cnt--;
+		state->agg_pool_size--;
+		state->stats->ul_agg_pool_size--;
 	}
 
-	return page;
+	state->agg_inflight_hwm = state->agg_inflight;
+	state->agg_pool_gets = 0;
+	spin_unlock_irqrestore(&rmnet_agg_page_lock, flags);
+
+	list_for_each_entry_safe(agg_page, idx, &free_list, list) {
+		list_del(&agg_page->list);
+		rmnet_agg_page_free(agg_page);
+	}
 }
 
 static struct rmnet_agg_page *
@@ -1392,38 +1625,114 @@ __rmnet_alloc_agg_pages(struct rmnet_aggregation_state *state)
 	}
 
 	agg_page->page = page;
+	agg_page->state = state;
 	INIT_LIST_HEAD(&agg_page->list);
 
 	return agg_page;
 }
 
+/* Hand out a pooled agg page. Pages come back through the skb destructor
+ * once the aggregate is freed, so the free queue is normally ready to use.
+ * The ref count check only guards against a lingering clone.
+ */
+static struct rmnet_agg_page *
+rmnet_get_agg_page(struct rmnet_aggregation_state *state)
+{
+	struct rmnet_agg_page *agg_page;
+	unsigned long flags;
+	bool reused = false;
+
+	if (!(state->params.agg_features & RMNET_PAGE_RECYCLE))
+		return NULL;
+
+	spin_lock_irqsave(&rmnet_agg_page_lock, flags);
+	agg_page = list_first_entry_or_null(&state->agg_list,
+					    struct rmnet_agg_page, list);
+	if (agg_page && page_ref_count(agg_page->page) != 1) {
+		/* Still referenced elsewhere, look at it again later */
+		list_move_tail(&agg_page->list, &state->agg_list);
+		agg_page = NULL;
+	}
+
+	if (agg_page) {
+		list_move_tail(&agg_page->list, &state->agg_busy);
+		state->agg_free_cnt--;
+		reused = true;
+	}
+	spin_unlock_irqrestore(&rmnet_agg_page_lock, flags);
+
+	if (!agg_page) {
+		if (state->agg_pool_size >= RMNET_AGG_POOL_MAX)
+			return NULL;
+
+		/* Grow the pool */
+		agg_page = __rmnet_alloc_agg_pages(state);
+		if (!agg_page)
+			return NULL;
+	}
+
+	page_ref_inc(agg_page->page);
+
+	spin_lock_irqsave(&rmnet_agg_page_lock, flags);
+	if (!reused) {
+		list_add_tail(&agg_page->list, &state->agg_busy);
+		state->agg_pool_size++;
+		state->stats->ul_agg_pool_size++;
+	}
+
+	state->agg_inflight++;
+	if (state->agg_inflight > state->agg_inflight_hwm)
+		state->agg_inflight_hwm = state->agg_inflight;
+	spin_unlock_irqrestore(&rmnet_agg_page_lock, flags);
+
+	if (reused)
+		state->stats->ul_agg_reuse++;
+	else
+		state->stats->ul_agg_alloc++;
+
+	rmnet_agg_pool_adapt(state);
+	return agg_page;
+}
+
 static void rmnet_alloc_agg_pages(struct rmnet_aggregation_state *state)
 {
 	struct rmnet_agg_page *agg_page = NULL;
+	unsigned long flags;
 	int i = 0;
 
-	for (i = 0; i < 512; i++) {
+	for (i = 0; i < RMNET_AGG_POOL_INIT; i++) {
 		agg_page = __rmnet_alloc_agg_pages(state);
+		if (!agg_page)
+			break;
 
-		if (agg_page)
-			list_add_tail(&agg_page->list, &state->agg_list);
+		spin_lock_irqsave(&rmnet_agg_page_lock, flags);
+		list_add_tail(&agg_page->list, &state->agg_list);
+		state->agg_free_cnt++;
+		state->agg_pool_size++;
+		state->stats->ul_agg_pool_size++;
+		spin_unlock_irqrestore(&rmnet_agg_page_lock, flags);
 	}
-
-	state->agg_head = list_first_entry_or_null(&state->agg_list,
-						   struct rmnet_agg_page, list);
 }
 
 static struct sk_buff *
 rmnet_map_build_skb(struct rmnet_aggregation_state *state)
 {
+	struct rmnet_agg_page *agg_page;
 	struct sk_buff *skb;
 	unsigned int size;
 	struct page *page;
 	void *vaddr;
 
-	page = rmnet_get_agg_pages(state);
-	if (!page)
-		return NULL;
+	agg_page = rmnet_get_agg_page(state);
+	if (agg_page) {
+		page = agg_page->page;
+	} else {
+		page = __dev_alloc_pages(GFP_ATOMIC, state->agg_size_order);
+		if (!page)
+			return NULL;
+
+		state->stats->ul_agg_alloc++;
+	}
 
 	vaddr = page_address(page);
 	size = PAGE_SIZE << state->agg_size_order;
@@ -1431,113 +1740,176 @@ rmnet_map_build_skb(struct rmnet_aggregation_state *state)
 	skb = build_skb(vaddr, size);
 	if (!skb) {
 		put_page(page);
+		if (agg_page)
+			rmnet_agg_page_complete(agg_page);
 		return NULL;
 	}
 
+	if (agg_page) {
+		skb_shinfo(skb)->destructor_arg = agg_page;
+		skb->destructor = rmnet_map_agg_skb_destructor;
+	}
+
 	return skb;
 }
 
 void rmnet_map_send_agg_skb(struct rmnet_aggregation_state *state)
 {
-	struct sk_buff *agg_skb;
+	bool closed;
 
-	if (!state->agg_skb) {
-		spin_unlock_bh(&state->agg_lock);
+	closed = rmnet_map_agg_close(state);
+	spin_unlock_bh(&state->agg_lock);
+	if (!closed)
 		return;
-	}
 
-	agg_skb = state->agg_skb;
-	/* Reset the aggregation state */
-	state->agg_skb = NULL;
-	state->agg_count = 0;
-	memset(&state->agg_time, 0, sizeof(state->agg_time));
-	state->agg_state = 0;
-	state->send_agg_skb(agg_skb);
-	spin_unlock_bh(&state->agg_lock);
 	hrtimer_cancel(&state->hrtimer);
+	rmnet_map_agg_xmit(state);
+}
+
+/* Send @skb right after whatever is aggregated so far, without letting it
+ * overtake the pending aggregate.
+ */
+void rmnet_map_tx_ordered(struct rmnet_aggregation_state *state,
+			  struct sk_buff *skb)
+{
+	bool closed;
+
+	spin_lock_bh(&state->agg_lock);
+	closed = rmnet_map_agg_close(state);
+	__skb_queue_tail(&state->agg_xmit_q, skb);
+	spin_unlock_bh(&state->agg_lock);
+
+	if (closed)
+		hrtimer_cancel(&state->hrtimer);
+
+	rmnet_map_agg_xmit(state);
+}
+
+/* Retune the flush timer from the last window of aggregates. Aggregates
+ * that mostly close on the timer holding a packet or two mean sparse
+ * traffic is just waiting out the timer, so shorten it. Aggregates that
+ * mostly fill up mean bulk traffic, so give batching back up to the modem's
+ * limit. The bypass gap scales with the timer, so a shortened window also
+ * stops sparse packets from opening aggregates. Caller holds agg_lock.
+ */
+static void rmnet_map_agg_tune(struct rmnet_aggregation_state *state)
+{
+	u32 flushes = state->agg_tune_flushes;
+	u32 timer = state->agg_tune_timer_flushes;
+	u32 time = state->agg_tune_time;
+	u32 max = state->params.agg_time;
+	u32 min = min_t(u32, RMNET_AGG_TUNE_TIME_MIN, max);
+
+	if (flushes < RMNET_AGG_TUNE_WINDOW)
+		return;
+
+	if (timer * 4 >= flushes * 3 && state->agg_tune_pkts < flushes * 2) {
+		time = max_t(u32, time / 2, min);
+		if (time != state->agg_tune_time)
+			state->stats->ul_agg_tune_down++;
+	} else if (timer * 4 <= flushes) {
+		time = (time > max / 2) ? max : time * 2;
+		if (time != state->agg_tune_time)
+			state->stats->ul_agg_tune_up++;
+	}
+
+	state->agg_tune_time = time;
+	state->agg_tune_bypass = max ? div_u64((u64)rmnet_agg_bypass_time *
+					       time, max) :
+				       rmnet_agg_bypass_time;
+	state->stats->ul_agg_flush_time_us = time / NSEC_PER_USEC;
+
+	state->agg_tune_flushes = 0;
+	state->agg_tune_timer_flushes = 0;
+	state->agg_tune_pkts = 0;
 }
 
 void rmnet_map_tx_aggregate(struct sk_buff *skb, struct rmnet_port *port,
 			    bool low_latency)
 {
 	struct rmnet_aggregation_state *state;
-	struct timespec64 diff, last;
+	ktime_t now, last;
+	bool sg;
 	int size;
 
 	state = &port->agg_state[(low_latency) ? RMNET_LL_AGG_STATE :
 						 RMNET_DEFAULT_AGG_STATE];
-
-new_packet:
-	spin_lock_bh(&state->agg_lock);
-	memcpy(&last, &state->agg_last, sizeof(last));
-	ktime_get_real_ts64(&state->agg_last);
+	/* The LL channel needs linear buffers */
+	sg = !low_latency && (port->dev->features & NETIF_F_SG);
 
 	if ((port->data_format & RMNET_EGRESS_FORMAT_PRIORITY) &&
 	    (RMNET_LLM(skb->priority) || RMNET_APS_LLB(skb->priority))) {
-		/* Send out any aggregated SKBs we have */
-		rmnet_map_send_agg_skb(state);
-		/* Send out the priority SKB. Not holding agg_lock anymore */
+		/* Send out any aggregated SKBs we have, then the priority
+		 * SKB.
+		 */
 		skb->protocol = htons(ETH_P_MAP);
-		state->send_agg_skb(skb);
+		rmnet_map_tx_ordered(state, skb);
 		return;
 	}
 
+	now = ktime_get();
+
+new_packet:
+	spin_lock_bh(&state->agg_lock);
+	last = state->agg_last;
+	state->agg_last = now;
+
 	if (!state->agg_skb) {
 		/* Check to see if we should agg first. If the traffic is very
 		 * sparse, don't aggregate. We will need to tune this later
 		 */
-		diff = timespec64_sub(state->agg_last, last);
+		rmnet_map_agg_tune(state);
 		size = state->params.agg_size - skb->len;
 
-		if (diff.tv_sec > 0 || diff.tv_nsec > rmnet_agg_bypass_time ||
-		    size <= 0) {
-			skb->protocol = htons(ETH_P_MAP);
-			state->send_agg_skb(skb);
-			spin_unlock_bh(&state->agg_lock);
-			return;
-		}
+		if (ktime_to_ns(ktime_sub(now, last)) > state->agg_tune_bypass ||
+		    size <= 0)
+			goto bypass;
 
 		state->agg_skb = rmnet_map_build_skb(state);
 		if (!state->agg_skb) {
-			state->agg_skb = NULL;
 			state->agg_count = 0;
-			memset(&state->agg_time, 0, sizeof(state->agg_time));
-			skb->protocol = htons(ETH_P_MAP);
-			state->send_agg_skb(skb);
-			spin_unlock_bh(&state->agg_lock);
-			return;
+			state->agg_time = 0;
+			goto bypass;
 		}
 
-		rmnet_map_linearize_copy(state->agg_skb, skb);
+		rmnet_map_agg_append(state, skb, sg);
 		state->agg_skb->dev = skb->dev;
 		state->agg_skb->protocol = htons(ETH_P_MAP);
 		state->agg_count = 1;
-		ktime_get_real_ts64(&state->agg_time);
-		dev_kfree_skb_any(skb);
+		state->agg_time = now;
 		goto schedule;
 	}
-	diff = timespec64_sub(state->agg_last, state->agg_time);
-	size = skb_tailroom(state->agg_skb);
+	/* Referenced bytes count against the agg size like copied ones */
+	size = skb_end_offset(state->agg_skb) - state->agg_skb->len;
 
 	if (skb->len > size ||
+	    skb_shinfo(state->agg_skb)->nr_frags >= MAX_SKB_FRAGS ||
 	    state->agg_count >= state->params.agg_count ||
-	    diff.tv_sec > 0 || diff.tv_nsec > rmnet_agg_time_limit) {
+	    ktime_to_ns(ktime_sub(now, state->agg_time)) >
+	    rmnet_agg_time_limit) {
 		rmnet_map_send_agg_skb(state);
 		goto new_packet;
 	}
 
-	rmnet_map_linearize_copy(state->agg_skb, skb);
+	rmnet_map_agg_append(state, skb, sg);
 	state->agg_count++;
-	dev_kfree_skb_any(skb);
 
 schedule:
 	if (state->agg_state != -EINPROGRESS) {
 		state->agg_state = -EINPROGRESS;
 		hrtimer_start(&state->hrtimer,
-			      ns_to_ktime(state->params.agg_time),
+			      ns_to_ktime(state->agg_tune_time),
 			      HRTIMER_MODE_REL);
 	}
 	spin_unlock_bh(&state->agg_lock);
+	dev_kfree_skb_any(skb);
+	return;
+
+bypass:
+	skb->protocol = htons(ETH_P_MAP);
+	__skb_queue_tail(&state->agg_xmit_q, skb);
+	spin_unlock_bh(&state->agg_lock);
+	rmnet_map_agg_xmit(state);
 }
 
 void rmnet_map_update_ul_agg_config(struct rmnet_aggregation_state *state,
@@ -1549,6 +1921,14 @@ void rmnet_map_update_ul_agg_config(struct rmnet_aggregation_state *state,
 	state->params.agg_size = size;
 	state->params.agg_features = features;
 
+	/* Restart tuning from the new modem limits */
+	state->agg_tune_time = time;
+	state->agg_tune_bypass = rmnet_agg_bypass_time;
+	state->agg_tune_flushes = 0;
+	state->agg_tune_timer_flushes = 0;
+	state->agg_tune_pkts = 0;
+	state->stats->ul_agg_flush_time_us = time / NSEC_PER_USEC;
+
 	rmnet_free_agg_pages(state);
 
 	/* This effectively disables recycling in case the UL aggregation
@@ -1579,7 +1959,9 @@ void rmnet_map_tx_aggregate_init(struct rmnet_port *port)
 		struct rmnet_aggregation_state *state = &port->agg_state[i];
 
 		spin_lock_init(&state->agg_lock);
+		skb_queue_head_init(&state->agg_xmit_q);
 		INIT_LIST_HEAD(&state->agg_list);
+		INIT_LIST_HEAD(&state->agg_busy);
 		hrtimer_init(&state->hrtimer, CLOCK_MONOTONIC,
 			     HRTIMER_MODE_REL);
 		state->hrtimer.function = rmnet_map_flush_tx_packet_queue;
@@ -1620,13 +2002,13 @@ void rmnet_map_tx_aggregate_exit(struct rmnet_port *port)
 				kfree_skb(state->agg_skb);
 				state->agg_skb = NULL;
 				state->agg_count = 0;
-				memset(&state->agg_time, 0,
-				       sizeof(state->agg_time));
+				state->agg_time = 0;
 			}
 
 			state->agg_state = 0;
 		}
 
+		__skb_queue_purge(&state->agg_xmit_q);
 		rmnet_free_agg_pages(state);
 		spin_unlock_bh(&state->agg_lock);
 	}
@@ -1636,7 +2018,6 @@ void rmnet_map_tx_qmap_cmd(struct sk_buff *qmap_skb, u8 ch, bool flush)
 {
 	struct rmnet_aggregation_state *state;
 	struct rmnet_port *port;
-	struct sk_buff *agg_skb;
 
 	if (unlikely(ch >= RMNET_MAX_AGG_STATE))
 		ch = RMNET_DEFAULT_AGG_STATE;
@@ -1654,19 +2035,8 @@ void rmnet_map_tx_qmap_cmd(struct sk_buff *qmap_skb, u8 ch, bool flush)
 	if (!(port->data_format & RMNET_EGRESS_FORMAT_AGGREGATION))
 		goto send;
 
-	spin_lock_bh(&state->agg_lock);
-	if (state->agg_skb) {
-		agg_skb = state->agg_skb;
-		state->agg_skb = NULL;
-		state->agg_count = 0;
-		memset(&state->agg_time, 0, sizeof(state->agg_time));
-		state->agg_state = 0;
-		state->send_agg_skb(agg_skb);
-		spin_unlock_bh(&state->agg_lock);
-		hrtimer_cancel(&state->hrtimer);
-	} else {
-		spin_unlock_bh(&state->agg_lock);
-	}
+	rmnet_map_tx_ordered(state, qmap_skb);
+	return;
 
 send:
 	state->send_agg_skb(qmap_skb);
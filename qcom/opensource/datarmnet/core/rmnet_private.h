@@ -47,6 +47,9 @@ RMNET_INGRESS_FORMAT_DL_MARKER_V2)
 #define RMNET_INGRESS_FORMAT_IP_ROUTE           BIT(25)
 #define RMNET_EGRESS_FORMAT_IP_ROUTE            BIT(24)
 
+/* Deliver clean coalesced frames as one GSO packet without resegmenting */
+#define RMNET_INGRESS_FORMAT_COAL_GRO           BIT(23)
+
 /* Replace skb->dev to a virtual rmnet device and pass up the stack */
 #define RMNET_EPMODE_VND (1)
 /* Pass the frame directly to another device with dev_queue_xmit() */
@@ -22,6 +22,53 @@ static void *rmnet_port;
 static struct net_device *real_data_dev;
 static struct rmnet_ctl_client_if *rmnet_ctl;
 
+/* Preallocated command buffers for the control endpoint. Flow control can
+ * generate commands in bursts from atomic context, so keep a ring of ready
+ * skbs and top it up from process context.
+ */
+#define QMAP_CMD_POOL_SIZE	32
+#define QMAP_CMD_BUF_LEN	128
+
+static struct sk_buff_head qmap_cmd_pool;
+static struct work_struct qmap_cmd_refill_work;
+static bool qmap_cmd_pool_active;
+
+static void rmnet_qmap_cmd_refill(struct work_struct *work)
+{
+	struct sk_buff *skb;
+
+	while (READ_ONCE(qmap_cmd_pool_active) &&
+	       skb_queue_len(&qmap_cmd_pool) < QMAP_CMD_POOL_SIZE) {
+		skb = alloc_skb(QMAP_CMD_BUF_LEN, GFP_KERNEL);
+		if (!skb)
+			break;
+
+		skb_queue_tail(&qmap_cmd_pool, skb);
+	}
+}
+
+struct sk_buff *rmnet_qmap_alloc_cmd(unsigned int len)
+{
+	struct sk_buff *skb = NULL;
+
+	if (len <= QMAP_CMD_BUF_LEN) {
+		skb = skb_dequeue(&qmap_cmd_pool);
+		if (READ_ONCE(qmap_cmd_pool_active) &&
+		    skb_queue_len(&qmap_cmd_pool) < QMAP_CMD_POOL_SIZE / 2)
+			schedule_work(&qmap_cmd_refill_work);
+	}
+
+	if (!skb)
+		skb = alloc_skb(len, GFP_ATOMIC);
+
+	if (skb) {
+		skb->protocol = htons(ETH_P_MAP);
+		memset(skb_put(skb, len), 0, len);
+	}
+
+	return skb;
+}
+
 int rmnet_qmap_send(struct sk_buff *skb, u8 ch, bool flush)
 {
 	trace_dfc_qmap(skb->data, skb->len, false);
@@ -124,6 +171,13 @@ int rmnet_qmap_init(void *port)
 	rmnet_port = port;
 	real_data_dev = rmnet_get_real_dev(rmnet_port);
 
+	if (!qmap_cmd_pool_active) {
+		skb_queue_head_init(&qmap_cmd_pool);
+		INIT_WORK(&qmap_cmd_refill_work, rmnet_qmap_cmd_refill);
+		WRITE_ONCE(qmap_cmd_pool_active, true);
+		rmnet_qmap_cmd_refill(&qmap_cmd_refill_work);
+	}
+
 	rmnet_ctl = rmnet_ctl_if();
 	if (!rmnet_ctl) {
 		pr_err("rmnet_ctl module not loaded\n");
@@ -149,4 +203,10 @@ void rmnet_qmap_exit(void)
 	rmnet_ctl_handle = NULL;
 	real_data_dev = NULL;
 	rmnet_port = NULL;
+
+	if (qmap_cmd_pool_active) {
+		WRITE_ONCE(qmap_cmd_pool_active, false);
+		cancel_work_sync(&qmap_cmd_refill_work);
+		skb_queue_purge(&qmap_cmd_pool);
+	}
 }
@@ -49,6 +49,7 @@ int rmnet_qmap_init(void *port);
 void rmnet_qmap_exit(void);
 int rmnet_qmap_next_txid(void);
 int rmnet_qmap_send(struct sk_buff *skb, u8 ch, bool flush);
+struct sk_buff *rmnet_qmap_alloc_cmd(unsigned int len);
 struct net_device *rmnet_qmap_get_dev(u8 mux_id);
 
 #define QMAP_DFC_CONFIG		10
@@ -29,6 +29,7 @@
 #include "rmnet_handlers.h"
 #include "rmnet_private.h"
 #include "rmnet_map.h"
+#include "rmnet_descriptor.h"
 #include "rmnet_vnd.h"
 #include "rmnet_genl.h"
 #include "rmnet_ll.h"
@@ -487,6 +488,7 @@ static const char rmnet_gstrings_stats[][ETH_GSTRING_LEN] = {
 	"Coalescing close HW time limit",
 	"Coalescing close HW eviction",
 	"Coalescing close Coalescable",
+	"Coalescing close direct GRO",
 	"Coalescing packets over VEID0",
 	"Coalescing packets over VEID1",
 	"Coalescing packets over VEID2",
@@ -521,6 +523,13 @@ static const char rmnet_port_gstrings_stats[][ETH_GSTRING_LEN] = {
 	"DL trailer pkts received",
 	"UL agg reuse",
 	"UL agg alloc",
+	"UL agg bytes copied",
+	"UL agg bytes by reference",
+	"UL agg pool size",
+	"UL agg timer flushes",
+	"UL agg flush time decreases",
+	"UL agg flush time increases",
+	"UL agg flush time (us)",
 	"DL chaining [0-10)",
 	"DL chaining [10-20)",
 	"DL chaining [20-30)",
@@ -534,6 +543,10 @@ static const char rmnet_port_gstrings_stats[][ETH_GSTRING_LEN] = {
 	"DL chaining frags [8-11]",
 	"DL chaining frags [12-15]",
 	"DL chaining frags = 16",
+	"DL desc pool hits",
+	"DL desc pool misses",
+	"DL frag pool hits",
+	"DL frag pool misses",
 };
 
 static const char rmnet_ll_gstrings_stats[][ETH_GSTRING_LEN] = {
@@ -553,6 +566,21 @@ static const char rmnet_ll_gstrings_stats[][ETH_GSTRING_LEN] = {
 	"LL TX FC queued",
 	"LL TX FC sent",
 	"LL TX FC err",
+	"LL RX spare buffer allocations",
+	"LL RX spare buffer refills",
+	"LL RX spare buffer refill errors",
+	"LL RX refill lag <2us",
+	"LL RX refill lag <4us",
+	"LL RX refill lag <8us",
+	"LL RX refill lag <16us",
+	"LL RX refill lag <32us",
+	"LL RX refill lag <64us",
+	"LL RX refill lag <128us",
+	"LL RX refill lag <256us",
+	"LL RX refill lag <512us",
+	"LL RX refill lag <1024us",
+	"LL RX refill lag <2048us",
+	"LL RX refill lag >=2048us",
 };
 
 static const char rmnet_qmap_gstrings_stats[][ETH_GSTRING_LEN] = {
@@ -616,6 +644,7 @@ static void rmnet_get_ethtool_stats(struct net_device *dev,
 
 	stp = &port->stats;
 	llp = rmnet_ll_get_stats();
+	rmnet_descriptor_get_pool_stats(port, &stp->desc_pool);
 
 	memcpy(data, st, ARRAY_SIZE(rmnet_gstrings_stats) * sizeof(u64));
 	off += ARRAY_SIZE(rmnet_gstrings_stats);
@@ -646,6 +675,7 @@ static int rmnet_stats_reset(struct net_device *dev)
 	stp = &port->stats;
 
 	memset(stp, 0, sizeof(*stp));
+	rmnet_descriptor_reset_pool_stats(port);
 
 	st = &priv->stats;
 